@@ -941,8 +941,11 @@ void AppComboTrading::HandleMenuActionSaveSymbolSubset( void ) {
 
   std::cout << "Subsetting symbols ... " << std::endl;
   ou::tf::iqfeed::InMemoryMktSymbolList listIQFeedSymbols;
-  ou::tf::IQFeedSymbolListOps::SelectSymbols selection( m_vClassifiers, listIQFeedSymbols );
-  m_listIQFeedSymbols.SelectSymbolsByExchange( m_vExchanges.begin(), m_vExchanges.end(), selection );
+  if ( !m_pIQFeedSymbolListOps->SelectSymbolsFromCache( m_vExchanges, m_vClassifiers, listIQFeedSymbols ) ) {
+    // no current cache file, so from the list as loaded
+    ou::tf::IQFeedSymbolListOps::SelectSymbols selection( m_vClassifiers, listIQFeedSymbols );
+    m_listIQFeedSymbols.SelectSymbolsByExchange( m_vExchanges.begin(), m_vExchanges.end(), selection );
+  }
   std::cout << "  " << listIQFeedSymbols.Size() << " symbols in subset." << std::endl;
 
   //std::string sFileName( sFileNameMarketSymbolSubset );
@@ -40,6 +40,7 @@
 #include <TFOptions/CalcExpiry.h>
 
 #include <TFIQFeed/BuildSymbolName.h>
+#include <TFIQFeed/MktSymbolListCache.h>
 
 #include "HedgedBollinger.h"
 
@@ -449,7 +450,9 @@ void AppHedgedBollinger::HandleObtainNewIQFeedSymbolListRemote( void ) {
   std::cout << "Downloading Text File ... " << std::endl;
   ou::tf::iqfeed::LoadMktSymbols( m_listIQFeedSymbols, ou::tf::iqfeed::MktSymbolLoadType::Download, true ); 
   std::cout << "Saving Binary File ... " << std::endl;
-  m_listIQFeedSymbols.SaveToFile( "../symbols.ser" );
+  m_listIQFeedSymbols.SaveToFile( ou::tf::iqfeed::detail::sFileNameMarketSymbolsBinary );
+  std::cout << "Saving Cache File ... " << std::endl;
+  ou::tf::iqfeed::MktSymbolListCache::Write( m_listIQFeedSymbols, ou::tf::iqfeed::detail::sFileNameMarketSymbolsCache );
   std::cout << " ... done." << std::endl;
 }
 
@@ -462,7 +465,9 @@ void AppHedgedBollinger::HandleObtainNewIQFeedSymbolListLocal( void ) {
   std::cout << "Loading From Text File ... " << std::endl;
   ou::tf::iqfeed::LoadMktSymbols( m_listIQFeedSymbols, ou::tf::iqfeed::MktSymbolLoadType::LoadTextFromDisk, false ); 
   std::cout << "Saving Binary File ... " << std::endl;
-  m_listIQFeedSymbols.SaveToFile( "../symbols.ser" );
+  m_listIQFeedSymbols.SaveToFile( ou::tf::iqfeed::detail::sFileNameMarketSymbolsBinary );
+  std::cout << "Saving Cache File ... " << std::endl;
+  ou::tf::iqfeed::MktSymbolListCache::Write( m_listIQFeedSymbols, ou::tf::iqfeed::detail::sFileNameMarketSymbolsCache );
   std::cout << " ... done." << std::endl;
 }
 
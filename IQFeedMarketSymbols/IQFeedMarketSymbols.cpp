@@ -30,6 +30,8 @@ using namespace boost::gregorian;
 #include <OUCommon/ReadSicCodeList.h>
 #include <OUCommon/ReadNaicsToSicCodeList.h>
 
+#include <TFIQFeed/MktSymbolListCache.h>
+
 #include "IQFeedMarketSymbols.h"
 
 IMPLEMENT_APP(AppIQFeedMarketSymbols)
@@ -145,6 +147,8 @@ void AppIQFeedMarketSymbols::HandleObtainNewIQFeedSymbolListRemote( void ) {
   ou::tf::iqfeed::LoadMktSymbols( m_listIQFeedSymbols, ou::tf::iqfeed::MktSymbolLoadType::Download, true ); 
   std::cout << "Saving Binary File ... " << std::endl;
   m_listIQFeedSymbols.SaveToFile( ou::tf::iqfeed::detail::sFileNameMarketSymbolsBinary );
+  std::cout << "Saving Cache File ... " << std::endl;
+  ou::tf::iqfeed::MktSymbolListCache::Write( m_listIQFeedSymbols, ou::tf::iqfeed::detail::sFileNameMarketSymbolsCache );
   std::cout << " ... done." << std::endl;
 }
 
@@ -158,6 +162,8 @@ void AppIQFeedMarketSymbols::HandleObtainNewIQFeedSymbolListLocal( void ) {
   ou::tf::iqfeed::LoadMktSymbols( m_listIQFeedSymbols, ou::tf::iqfeed::MktSymbolLoadType::LoadTextFromDisk, false ); 
   std::cout << "Saving Binary File ... " << std::endl;
   m_listIQFeedSymbols.SaveToFile( ou::tf::iqfeed::detail::sFileNameMarketSymbolsBinary );
+  std::cout << "Saving Cache File ... " << std::endl;
+  ou::tf::iqfeed::MktSymbolListCache::Write( m_listIQFeedSymbols, ou::tf::iqfeed::detail::sFileNameMarketSymbolsCache );
   std::cout << " ... done." << std::endl;
 }
 
@@ -28,7 +28,10 @@
 #include <TFTrading/OrderManager.h>
 #include <TFTrading/PortfolioManager.h>
 
+#include <TFSimulation/ReplayCache.h>
+
 #include <OUGP/Population.h>
+#include <OUGP/CompiledSignals.h>
 #include <TFGP/NodeTimeSeries.h>
 
 #include "OptimizeStrategy.h"
@@ -106,7 +109,8 @@ void AppOptimizeStrategy::Optimizer( void ) {
   * at end of time series, calculate 'winner'
   */
 
-  // add optimization code so that copied individuals are not recomputed
+  // each day of data is read once, individuals replay copies of it
+  ou::tf::ReplayCache::GlobalInstance().Enable();
 
   std::stringstream ss;
   struct PreProcessNodes {
@@ -129,93 +133,84 @@ void AppOptimizeStrategy::Optimizer( void ) {
     }
   };
 
-  struct ProcessIndividual {
+  struct ProcessIndividual: public ou::gp::FitnessScheduler::Evaluation {
     ProcessIndividual( ou::gp::Individual& ind, pInstrument_t pInstrument )
-      : m_ind( ind ), m_pInstrument( pInstrument ), m_pswStrategy( new StrategyWrapper )
+      : m_ind( ind ), m_pInstrument( pInstrument ), m_pswStrategy( 0 ), m_pControl( 0 )
     {
     }
     ~ProcessIndividual( void ) {
+      delete m_pswStrategy;  // when built but not run
     }
     void Init( void ) {  // run synchronously
+      const_cast<ou::gp::Individual&>(m_ind).m_Signals.EachSignal( PreProcessNodes() );
+      m_signals.Compile( m_ind.m_Signals );  // after PreProcess, time series need to be assigned
+      m_ind.TreeToString( m_ind.m_ssFormula );
+    }
+    ou::gp::FitnessScheduler::key_t Key( void ) const {
+      return m_signals.Hash();
+    }
+    void Build( void ) {  // run synchronously, only when the key is not cached
       // /app/semiauto/2012-Jul-22 18:08:14.285807
       // /app/semiauto/2012-Jul-23 18:41:49.332859
       // /app/semiauto/2012-Jul-24 18:37:57.017369
       // /app/semiauto/2012-Jul-25 18:50:17.756534
       // /app/semiauto/2012-Jul-26 19:17:28.757619
       StrategyEquity::registrations_t m_registrations; // contains a static component, be careful, which is used in Init of next step
+      m_pswStrategy = new StrategyWrapper;
       m_pswStrategy->Init( 
         m_registrations,
         m_pInstrument, date( 2012, 7, 22 ), "/app/semiauto/2012-Jul-22 18:08:14.285807",
-        fastdelegate::MakeDelegate( m_ind.m_Signals.rnLong, &ou::gp::RootNode::EvaluateBoolean ),
-        fastdelegate::MakeDelegate( m_ind.m_Signals.rnShort, &ou::gp::RootNode::EvaluateBoolean ) );
-      const_cast<ou::gp::Individual&>(m_ind).m_Signals.EachSignal( PreProcessNodes() );
-      m_ind.TreeToString( m_ind.m_ssFormula );
+        fastdelegate::MakeDelegate( &m_signals, &ou::gp::CompiledSignals::Evaluate ),  // evaluates long and short together
+        fastdelegate::MakeDelegate( &m_signals, &ou::gp::CompiledSignals::Short ) );
+      m_pswStrategy->SetContinue( fastdelegate::MakeDelegate( this, &ProcessIndividual::Continue ) );
     }
-    void Run( void ) { // run asynchronously
+    double Run( const ou::gp::FitnessScheduler::Control& control ) { // run asynchronously
+      assert( 0 != m_pswStrategy );
+      m_pControl = &control;
       m_pswStrategy->Start(); 
       std::stringstream ss;
       ss << m_ind.m_ssFormula.str() << std::endl;
-      m_ind.m_dblRawFitness = m_pswStrategy->GetPL( ss );
+      double dblFitness = m_pswStrategy->GetPL( ss );
 //      std::cout << ss.str() << "---- " << m_ind.m_id << " ----------------------------" << std::endl;
       delete m_pswStrategy;
       m_pswStrategy = 0;
+      m_pControl = 0;
+      return dblFitness;
+    }
+    bool Continue( double dblPL, double dblProgress ) {
+      return m_pControl->Continue( dblPL, dblProgress );
     }
   private:
     ou::gp::Individual& m_ind;
     pInstrument_t m_pInstrument;
     StrategyWrapper* m_pswStrategy;
+    const ou::gp::FitnessScheduler::Control* m_pControl;
+    ou::gp::CompiledSignals m_signals;
   };  // struct ProcessIndividual
 
-  std::vector<ProcessIndividual*> vpi;
+  struct PrepareIndividual {
+    PrepareIndividual( pInstrument_t pInstrument ): m_pInstrument( pInstrument ) {}
+    ou::gp::FitnessScheduler::pEvaluation_t operator()( ou::gp::Individual& ind ) {  // run synchronously
+      boost::shared_ptr<ProcessIndividual> ppi( new ProcessIndividual( ind, m_pInstrument ) );
+      ppi->Init();  // compiles, for the key, the strategy is built only if it is to be run
+      return ppi;
+    }
+  private:
+    pInstrument_t m_pInstrument;
+  };  // struct PrepareIndividual
 
-  // http://boost.2283326.n4.nabble.com/Is-thread-pool-using-asio-and-thread-group-working-as-intended-td4552297.html
-  // set up some threads for running the strategy
+  // threads, sized to the machine, persist in the population's scheduler across generations
     while ( pop.MakeNewGeneration() ) {
       std::cout << "==== N:" << pop.m_nNew << ",E:" << pop.m_nElites << ",R:" << pop.m_nReproductions << ",X:" << pop.m_nCrossOvers << " ====" << std::endl;
       const vGeneration_t& gen( pop.CurrentGeneration() );
 
-      boost::asio::io_service srvc;
-      boost::thread_group threads;
-
-      {
-
-        boost::asio::io_service::work work( srvc );  // keep things running while real work arrives
-        for ( std::size_t ix = 0; ix < 12; ix++ ) {
-          threads.create_thread( boost::bind( &boost::asio::io_service::run, &srvc ) ); // add handlers
-        }
-
-        BOOST_FOREACH( const ou::gp::Individual& ind, gen ) {
-          
-          if ( ind.IsComputed() ) {
-            std::cout 
-              << "Computed: " 
-              << ind.m_dblRawFitness << std::endl
-              << ind.m_ssFormula.str() << std::endl;
-            std::cout << "---- " << ind.m_id << " ----------------------------" << std::endl;
-          }
-          else {
-            ou::gp::Individual& i( const_cast<ou::gp::Individual&>( ind ) );
-            i.SetComputed();
-            //ProcessIndividual pi( i, m_pInstrument );
-            ProcessIndividual* ppi( new ProcessIndividual( i, m_pInstrument ) );
-            vpi.push_back( ppi );
-            ppi->Init();
-            //std::cout << ind.m_ssFormula.str() << std::endl;
-  //          pi.Run();  // can't run asynchronously due to singleton managers and singleton hdf5 manager
-            srvc.post( boost::bind( &ProcessIndividual::Run, ppi ) );  
-          }
-        }
-
-      }
-
-      // at some point, add the above Formula strings to master table, so random calcs which match prior randoms aren't computed
-
-      threads.join_all();  // wait for all work to complete
+      pop.EvaluateGeneration( PrepareIndividual( m_pInstrument ) );  // returns once all individuals have a fitness
 
-      for ( std::vector<ProcessIndividual*>::iterator iter = vpi.begin(); vpi.end() != iter; iter++ ) {
-        delete *iter;
-      }
-      vpi.clear();
+      const ou::gp::FitnessScheduler& scheduler( pop.Scheduler() );
+      std::cout 
+        << "Evaluated: " << scheduler.CountEvaluated() 
+        << ", Cached: " << scheduler.CountCacheHits() 
+        << ", Abandoned: " << scheduler.CountAbandoned() << std::endl;
 
       pop.CalcFitness();
 
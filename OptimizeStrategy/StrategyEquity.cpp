@@ -23,6 +23,7 @@ StrategyEquity::StrategyEquity( pProviderSim_t pProvider, pInstrument_t pInstrum
   : m_pProvider( pProvider ), m_pUnderlying( pInstrument ),
     m_stateTimeFrame( EPreOpen ), m_stateTrading( ENeutral ),
     m_pfnLong( 0 ), m_pfnShort( 0 ),
+    m_pfnContinue( 0 ), m_cntQuotesSinceCheck( 0 ),
     m_portfolio( "gp" ), 
     m_timeOpeningBell( 19, 0, 0 ),
     m_timeCancelTrades( 16, 40, 0 ),
@@ -165,7 +166,14 @@ void StrategyEquity::HandleQuote( const ou::tf::Quote& quote ) {
         m_stateTimeFrame = ECancelling;
       }
       else {
-        Trade();
+        if ( Continue( dt ) ) {
+          Trade();
+        }
+        else {
+          // abandoned, no need to process the remainder of the day
+          m_stateTimeFrame = EAfterHours;
+          m_pProvider->Stop();
+        }
       }
       break;
     case ECancelling:
@@ -189,6 +197,19 @@ void StrategyEquity::HandleQuote( const ou::tf::Quote& quote ) {
   }
 }
 
+bool StrategyEquity::Continue( const ptime& dt ) {
+  bool bContinue( true );
+  if ( 0 != m_pfnContinue ) {
+    ++m_cntQuotesSinceCheck;
+    if ( 1000 <= m_cntQuotesSinceCheck ) {
+      m_cntQuotesSinceCheck = 0;
+      double dblProgress = (double) ( dt - m_dtStartTrading ).total_seconds() / (double) ( m_dtCancelTrades - m_dtStartTrading ).total_seconds();
+      bContinue = m_pfnContinue( m_portfolio.GetRow().dblRealizedPL - m_portfolio.GetRow().dblCommissionsPaid, dblProgress );
+    }
+  }
+  return bContinue;
+}
+
 void StrategyEquity::Trade( void ) {
 
   assert( 0 != m_pfnLong );
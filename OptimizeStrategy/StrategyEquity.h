@@ -49,6 +49,7 @@ public:
   typedef ou::tf::SimulationProvider::pProvider_t pProviderSim_t;
   typedef ou::tf::Instrument::pInstrument_t pInstrument_t;
   typedef fastdelegate::FastDelegate0<bool> fdEvaluate_t;
+  typedef fastdelegate::FastDelegate2<double,double,bool> fdContinue_t;  // pl so far, progress through trading period; false to abandon
   typedef boost::fusion::set<
       ou::gp::TimeSeriesRegistration<ou::tf::Quotes>,
       ou::gp::TimeSeriesRegistration<ou::tf::Trades>,
@@ -76,6 +77,7 @@ public:
   void Init( 
     StrategyEquity::registrations_t& registrations,
     fdEvaluate_t pfnLong, fdEvaluate_t pfnShort );  // for simulation
+  void SetContinue( fdContinue_t pfnContinue ) { m_pfnContinue = pfnContinue; };  // optional, checked periodically while trading
   double GetPL( std::stringstream& );
   void End( void );
 
@@ -95,6 +97,9 @@ private:
   fdEvaluate_t m_pfnLong;
   fdEvaluate_t m_pfnShort;
 
+  fdContinue_t m_pfnContinue;
+  unsigned int m_cntQuotesSinceCheck;
+
   ou::tf::Quotes m_quotes;
   ou::tf::Trades m_trades;
 
@@ -131,6 +136,7 @@ private:
   void Register( registrations_t&, ou::tf::Prices* series );
 
   void Trade( void );
+  bool Continue( const ptime& dt );
 
   void HandleQuote( const ou::tf::Quote& );
   void HandleTrade( const ou::tf::Trade& );
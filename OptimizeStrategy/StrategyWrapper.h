@@ -28,6 +28,7 @@ public:
 
   typedef ou::tf::Instrument::pInstrument_t pInstrument_t;
   typedef StrategyEquity::fdEvaluate_t fdEvaluate_t;
+  typedef StrategyEquity::fdContinue_t fdContinue_t;
 
   StrategyWrapper(void);
   ~StrategyWrapper(void);
@@ -38,6 +39,7 @@ public:
     const boost::gregorian::date& dateStart, 
     const std::string& sSourcePath, 
     fdEvaluate_t pfnLong, fdEvaluate_t pfnShort );
+  void SetContinue( fdContinue_t pfnContinue ) { m_pStrategy->SetContinue( pfnContinue ); };  // after Init
   void Start( void );
   double GetPL( std::stringstream& );
 //  void Stop( void );
@@ -62,7 +62,9 @@ public:
     double dblXMax;
     double dblYMin;
     double dblYMax;
-    structChartAttributes( void ) : dblXMin( 0 ), dblXMax( 0 ), dblYMin( 0 ), dblYMax( 0 ) {};
+    unsigned int nPixelWidth;  // in: width of plot area, entries may reduce their points to this resolution, 0 for none
+    size_t nSignature;  // out: summary of what was drawn, unchanged when a redraw would look the same, 0 if not known
+    structChartAttributes( void ) : dblXMin( 0 ), dblXMax( 0 ), dblYMin( 0 ), dblYMax( 0 ), nPixelWidth( 0 ), nSignature( 0 ) {};
   };
 
   ChartEntryBase( void );
@@ -154,6 +156,8 @@ protected:
   
   size_type Size( void ) const { return m_vDateTime.size(); }
 
+  double ChartTime( size_type ix ) const { return m_vChartTime[ ix ]; }
+
 private:
   
   ou::tf::Queue<boost::posix_time::ptime> m_queue;
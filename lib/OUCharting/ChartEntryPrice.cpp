@@ -18,6 +18,7 @@
  * Created on May 6, 2017, 7:03 PM
  */
 
+#include <boost/functional/hash.hpp>
 #include <boost/phoenix/core.hpp>
 #include <boost/phoenix/bind/bind_member_function.hpp>
 
@@ -25,7 +26,7 @@
 
 namespace ou { // One Unified
 
-ChartEntryPrice::ChartEntryPrice( void ): ChartEntryTime() {
+ChartEntryPrice::ChartEntryPrice( void ): ChartEntryTime(), m_nGeneration( 0 ) {
 }
 
 ChartEntryPrice::~ChartEntryPrice( void ) {
@@ -37,6 +38,8 @@ void ChartEntryPrice::Reserve( size_type nSize ) {
 
 void ChartEntryPrice::Clear( void ) {
   m_vDouble.clear();
+  m_pyramid.Clear();
+  ++m_nGeneration;
 }
 
 void ChartEntryPrice::Append( const ou::tf::Price& price) {
@@ -55,16 +58,70 @@ void ChartEntryPrice::ClearQueue( void ) {
 void ChartEntryPrice::Pop( const ou::tf::Price& price ) {
   ChartEntryTime::AppendFg( price.DateTime() );
   m_vDouble.push_back( price.Value() );
+  m_pyramid.Append( price.Value() );
+}
+
+bool ChartEntryPrice::Decimate( unsigned int nPixelWidth ) {
+
+  size_type nElements( m_nElements );
+  if ( ( 0 == nPixelWidth ) || ( nElements <= ( 4 * nPixelWidth ) ) ) return false;  // a bucket needs up to four points
+
+  m_vDecimatedTime.clear();
+  m_vDecimatedPrice.clear();
+  m_vDecimatedTime.reserve( 4 * nPixelWidth );
+  m_vDecimatedPrice.reserve( 4 * nPixelWidth );
+
+  const double* pPrice( &m_vDouble[ 0 ] );
+  for ( unsigned int ixPixel = 0; ixPixel < nPixelWidth; ++ixPixel ) {
+    size_type ixBegin( m_ixStart + ( nElements * ixPixel ) / nPixelWidth );
+    size_type ixEnd( m_ixStart + ( nElements * ( ixPixel + 1 ) ) / nPixelWidth );  // one past
+    if ( ixBegin == ixEnd ) continue;
+    size_type ixLast( ixEnd - 1 );
+    MinMaxPyramid::MinMax mm( m_pyramid.Range( pPrice, ixBegin, ixEnd ) );
+    double dtBegin( ChartTime( ixBegin ) );
+    double dtLast( ChartTime( ixLast ) );
+    double dtMid( dtBegin + ( dtLast - dtBegin ) / 2.0 );
+    // open, the extremes in the direction of travel, then close
+    bool bUp( pPrice[ ixBegin ] <= pPrice[ ixLast ] );
+    m_vDecimatedTime.push_back( dtBegin ); m_vDecimatedPrice.push_back( pPrice[ ixBegin ] );
+    m_vDecimatedTime.push_back( dtMid ); m_vDecimatedPrice.push_back( bUp ? mm.dblMin : mm.dblMax );
+    m_vDecimatedTime.push_back( dtMid ); m_vDecimatedPrice.push_back( bUp ? mm.dblMax : mm.dblMin );
+    m_vDecimatedTime.push_back( dtLast ); m_vDecimatedPrice.push_back( pPrice[ ixLast ] );
+  }
+
+  return true;
+}
+
+size_t ChartEntryPrice::Signature( bool bDecimated ) const {
+  size_t seed( 0 );
+  if ( bDecimated ) {
+    boost::hash_range( seed, m_vDecimatedTime.begin(), m_vDecimatedTime.end() );
+    boost::hash_range( seed, m_vDecimatedPrice.begin(), m_vDecimatedPrice.end() );
+  }
+  else {
+    // appended values don't change, so the range in view, since the last Clear, identifies the points drawn
+    boost::hash_combine( seed, m_nGeneration );
+    boost::hash_combine( seed, m_ixStart );
+    boost::hash_combine( seed, m_nElements );
+    if ( 0 != m_nElements ) {
+      boost::hash_combine( seed, ChartTime( m_ixStart + m_nElements - 1 ) );
+      boost::hash_combine( seed, m_vDouble[ m_ixStart + m_nElements - 1 ] );
+    }
+  }
+  boost::hash_combine( seed, static_cast<int>( m_eColour ) );
+  return ( 0 == seed ) ? 1 : seed;  // 0 is 'not known'
 }
 
 bool ChartEntryPrice::AddEntryToChart(XYChart *pXY, structChartAttributes *pAttributes)  {
   bool bAdded( false );
   ClearQueue();
   if ( 0 != this->ChartEntryTime::Size() ) {
-    DoubleArray daXData = ChartEntryTime::GetDateTimes();
+    bool bDecimated = Decimate( pAttributes->nPixelWidth );
+    DoubleArray daXData = bDecimated ? GetDecimatedDateTimes() : ChartEntryTime::GetDateTimes();
     if ( 0 != daXData.len ) {
-      LineLayer *ll = pXY->addLineLayer( this->GetPrices() );
+      LineLayer *ll = pXY->addLineLayer( bDecimated ? GetDecimatedPrices() : this->GetPrices() );
       ll->setXData( daXData );
+      pAttributes->nSignature = Signature( bDecimated );
       pAttributes->dblXMin = daXData[0];
       pAttributes->dblXMax = daXData[ daXData.len - 1 ];
       DataSet *pds = ll->getDataSet(0);
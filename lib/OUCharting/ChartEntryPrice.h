@@ -25,6 +25,7 @@
 #include <TFTimeSeries/DoubleBuffer.h>
 
 #include "ChartEntryBase.h"
+#include "MinMaxPyramid.h"
 
 namespace ou { // One Unified
 
@@ -55,9 +56,21 @@ protected:
     return DoubleArray( &m_vDouble[ m_ixStart ], m_nElements );
   }
 
+  // when the viewport holds more than a few points per pixel, reduce to first/min/max/last per pixel,
+  //   which draws the same line, returns false when no reduction is needed
+  bool Decimate( unsigned int nPixelWidth );
+  DoubleArray GetDecimatedDateTimes( void ) const { return DoubleArray( &m_vDecimatedTime[ 0 ], m_vDecimatedTime.size() ); }
+  DoubleArray GetDecimatedPrices( void ) const { return DoubleArray( &m_vDecimatedPrice[ 0 ], m_vDecimatedPrice.size() ); }
+  size_t Signature( bool bDecimated ) const;
+
 private:
   
   vDouble_t m_vDouble;
+  MinMaxPyramid m_pyramid;  // summaries of m_vDouble for Decimate
+  size_t m_nGeneration;  // counts Clear, for Signature, a refill may have the same count as before
+
+  vDouble_t m_vDecimatedTime;  // re-used between draws
+  vDouble_t m_vDecimatedPrice;
   
   ou::tf::Queue<ou::tf::Price> m_queue;
 
@@ -15,6 +15,8 @@
 
 #include <vector>
 
+#include <boost/functional/hash.hpp>
+
 //#include <OUCommon/Colour.h>
 
 #include "ChartMaster.h"
@@ -25,7 +27,8 @@ namespace ou { // One Unified
 : m_pCdv( NULL),
   m_nChartWidth( 600 ), m_nChartHeight( 900 ),
   m_dblViewPortXBegin( 0 ), m_dblViewPortXEnd( 0 ),
-  m_bCreated( false )
+  m_bCreated( false ),
+  m_bRedrawOnChangeOnly( false ), m_nLastSignature( 0 )
 {
   Initialize();
 }
@@ -34,7 +37,8 @@ ChartMaster::ChartMaster( unsigned int width, unsigned int height )
 : m_pCdv( NULL),
   m_nChartWidth( width ), m_nChartHeight( height ),
   m_dblViewPortXBegin( 0 ), m_dblViewPortXEnd( 0 ),
-  m_bCreated( false )
+  m_bCreated( false ),
+  m_bRedrawOnChangeOnly( false ), m_nLastSignature( 0 )
 {
   Initialize();
 }
@@ -165,10 +169,19 @@ void ChartMaster::DrawChart( bool bViewPortChanged ) {
       // determine XAxis min/max while adding chart data
       double dblXBegin = m_dblViewPortXBegin;
       double dblXEnd = m_dblViewPortXEnd;
+      size_t nSignature( 0 );  // combined from the entries, remains known only if all entries supply one
+      bool bSignatureKnown( true );
+      boost::hash_combine( nSignature, m_nChartWidth );
+      boost::hash_combine( nSignature, m_nChartHeight );
+      boost::hash_combine( nSignature, sTitle );
       for ( ChartDataView::iterator iter = m_pCdv->begin(); m_pCdv->end() != iter; ++iter ) {
         size_t ixChart = iter->GetActualChartId();
         ChartEntryBase::structChartAttributes Attributes;
+        Attributes.nPixelWidth = m_nChartWidth - 2 * x;  // plot area width
         if ( iter->GetChartEntry()->AddEntryToChart( vCharts[ ixChart ].xy, &Attributes ) ) {
+          if ( 0 == Attributes.nSignature ) bSignatureKnown = false;
+          boost::hash_combine( nSignature, ixChart );
+          boost::hash_combine( nSignature, Attributes.nSignature );
           // following assumes values are always > 0
           if( 0 == m_dblViewPortXBegin ) {
             dblXBegin = ( 0 == dblXBegin ) 
@@ -199,8 +212,18 @@ void ChartMaster::DrawChart( bool bViewPortChanged ) {
         //std::cout << "Time Scales match" << std::endl;
       }
 
-      MemBlock m = multi.makeChart( BMP );
-      if ( 0 != m_OnDrawChart ) m_OnDrawChart( m );
+      boost::hash_combine( nSignature, dblXBegin );
+      boost::hash_combine( nSignature, dblXEnd );
+      if ( !bSignatureKnown || ( 0 == nSignature ) ) nSignature = 0;
+
+      if ( m_bRedrawOnChangeOnly && !bViewPortChanged && ( 0 != nSignature ) && ( m_nLastSignature == nSignature ) ) {
+        // same content as the bitmap already delivered, skip the render
+      }
+      else {
+        MemBlock m = multi.makeChart( BMP );
+        if ( 0 != m_OnDrawChart ) m_OnDrawChart( m );
+        m_nLastSignature = nSignature;
+      }
 
       for ( std::vector<structSubChart>::iterator iter = vCharts.begin(); iter < vCharts.end(); ++iter ) {
         delete (*iter).xy;
@@ -40,6 +40,10 @@ public:
 
   bool GetChartDataViewChanged( void ) { return ( NULL == m_pCdv ) ? false : m_pCdv->GetChanged(); };  // flag is reset during call
   void DrawChart( bool bViewPortChanged = false );  // recalc viewport zoom effects when true
+
+  // for periodic refreshes where the caller retains the last bitmap:
+  //   OnDrawChart is skipped when every entry reports the same drawn content as last time
+  void SetRedrawOnChangeOnly( bool bRedrawOnChangeOnly ) { m_bRedrawOnChangeOnly = bRedrawOnChangeOnly; m_nLastSignature = 0; };
   bool isCreated( void ) const { return m_bCreated; };
 
   typedef FastDelegate1<const MemBlock&> OnDrawChart_t;
@@ -62,6 +66,9 @@ protected:
 
   bool m_bCreated;
 
+  bool m_bRedrawOnChangeOnly;
+  size_t m_nLastSignature;  // of prior draw, 0 when not known
+
 
 private:
 
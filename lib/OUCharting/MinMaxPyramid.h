@@ -0,0 +1,110 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// min/max summaries of a growing series at power of two block sizes:
+//   level k holds the min and max of each aligned block of 2^k values, level 0 being the values themselves
+//   an append updates the trailing block of each level, so the pyramid is never rebuilt
+//   the min/max of any range is then assembled from O(log n) blocks, rather than a scan of the range
+
+#include <vector>
+#include <cassert>
+#include <algorithm>
+
+namespace ou { // One Unified
+
+class MinMaxPyramid {
+public:
+
+  typedef std::vector<double>::size_type size_type;
+
+  struct MinMax {
+    double dblMin;
+    double dblMax;
+    MinMax( void ): dblMin( 0.0 ), dblMax( 0.0 ) {};
+    MinMax( double dblMin_, double dblMax_ ): dblMin( dblMin_ ), dblMax( dblMax_ ) {};
+    void Merge( const MinMax& rhs ) {
+      dblMin = std::min<double>( dblMin, rhs.dblMin );
+      dblMax = std::max<double>( dblMax, rhs.dblMax );
+    }
+  };
+
+  MinMaxPyramid( void ): m_nSize( 0 ) {};
+  ~MinMaxPyramid( void ) {};
+
+  void Append( double value ) {
+    size_type ix( m_nSize );
+    ++m_nSize;
+    MinMax mm( value, value );
+    if ( 0 == ix ) m_mmAll = mm;
+    else m_mmAll.Merge( mm );
+    for ( size_type nLevel = 1; nLevel <= m_vLevels.size(); ++nLevel ) {
+      vMinMax_t& level( m_vLevels[ nLevel - 1 ] );
+      size_type ixBlock( ix >> nLevel );
+      if ( level.size() == ixBlock ) {
+        level.push_back( mm );
+      }
+      else {
+        level[ ixBlock ].Merge( mm );
+      }
+    }
+    if ( ( size_type( 1 ) << ( m_vLevels.size() + 1 ) ) == m_nSize ) {  // series now fills the first block of a new level
+      m_vLevels.push_back( vMinMax_t( 1, m_mmAll ) );
+    }
+  }
+
+  // min/max of values[ ixBegin, ixEnd ), values being the level 0 series maintained by the caller
+  MinMax Range( const double* values, size_type ixBegin, size_type ixEnd ) const {
+    assert( ixBegin < ixEnd );
+    assert( ixEnd <= m_nSize );
+    MinMax mm( values[ ixBegin ], values[ ixBegin ] );
+    while ( ixBegin < ixEnd ) {
+      // largest aligned block starting at ixBegin which fits in the range
+      size_type nLevel( 0 );
+      while ( ( nLevel < m_vLevels.size() )
+        && ( 0 == ( ixBegin & ( ( size_type( 1 ) << ( nLevel + 1 ) ) - 1 ) ) )
+        && ( ( ixBegin + ( size_type( 1 ) << ( nLevel + 1 ) ) ) <= ixEnd ) ) {
+        ++nLevel;
+      }
+      if ( 0 == nLevel ) {
+        mm.Merge( MinMax( values[ ixBegin ], values[ ixBegin ] ) );
+      }
+      else {
+        mm.Merge( m_vLevels[ nLevel - 1 ][ ixBegin >> nLevel ] );
+      }
+      ixBegin += ( size_type( 1 ) << nLevel );
+    }
+    return mm;
+  }
+
+  size_type Size( void ) const { return m_nSize; };
+
+  void Clear( void ) {
+    m_vLevels.clear();
+    m_nSize = 0;
+  }
+
+protected:
+private:
+
+  typedef std::vector<MinMax> vMinMax_t;
+  typedef std::vector<vMinMax_t> vLevels_t;  // index 0 is level 1, blocks of 2
+
+  size_type m_nSize;  // count of values appended
+  MinMax m_mmAll;  // across all values, seeds each new level
+  vLevels_t m_vLevels;
+
+};
+
+} // namespace ou
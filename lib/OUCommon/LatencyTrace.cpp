@@ -0,0 +1,244 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+//#include "stdafx.h"
+
+#include <vector>
+#include <cstring>
+#include <iomanip>
+
+#include <boost/thread/thread.hpp>
+
+#include "LatencyTrace.h"
+
+namespace ou { // One Unified
+
+// LatencyHistogram
+
+size_t LatencyHistogram::Bucket( boost::uint64_t nValue ) {
+  if ( nSub > nValue ) return static_cast<size_t>( nValue );
+  const boost::uint64_t nMax( ( boost::uint64_t( 1 ) << nMaxBits ) - 1 );
+  if ( nMax < nValue ) nValue = nMax;
+  unsigned int nMsb( 0 );  // position of the highest bit set
+#if defined _MSC_VER && defined _M_X64
+  unsigned long ix;
+  _BitScanReverse64( &ix, nValue );
+  nMsb = ix;
+#elif defined __GNUC__
+  nMsb = 63 - __builtin_clzll( nValue );
+#else
+  for ( boost::uint64_t n = nValue >> 1; 0 != n; n >>= 1 ) ++nMsb;
+#endif
+  const unsigned int nShift( nMsb - nSubBits );
+  return ( nShift + 1 ) * nSub + static_cast<size_t>( ( nValue >> nShift ) & ( nSub - 1 ) );
+}
+
+boost::uint64_t LatencyHistogram::Highest( size_t ix ) {
+  if ( nSub > ix ) return ix;
+  const unsigned int nShift( static_cast<unsigned int>( ix / nSub ) - 1 );
+  const boost::uint64_t nLowest( static_cast<boost::uint64_t>( nSub + ( ix % nSub ) ) << nShift );
+  return nLowest + ( boost::uint64_t( 1 ) << nShift ) - 1;
+}
+
+void LatencyHistogram::Record( boost::uint64_t nValue ) {
+  ++m_rBucket[ Bucket( nValue ) ];
+  ++m_nCount;
+  m_nSum += nValue;
+  if ( m_nMin > nValue ) m_nMin = nValue;
+  if ( m_nMax < nValue ) m_nMax = nValue;
+}
+
+void LatencyHistogram::Merge( const LatencyHistogram& rhs ) {
+  for ( size_t ix = 0; ix < nBuckets; ++ix ) {
+    m_rBucket[ ix ] += rhs.m_rBucket[ ix ];
+  }
+  m_nCount += rhs.m_nCount;
+  m_nSum += rhs.m_nSum;
+  if ( m_nMin > rhs.m_nMin ) m_nMin = rhs.m_nMin;
+  if ( m_nMax < rhs.m_nMax ) m_nMax = rhs.m_nMax;
+}
+
+void LatencyHistogram::Reset( void ) {
+  std::memset( m_rBucket, 0, sizeof( m_rBucket ) );
+  m_nCount = m_nSum = m_nMax = 0;
+  m_nMin = ~boost::uint64_t( 0 );
+}
+
+boost::uint64_t LatencyHistogram::Percentile( double dblPercent ) const {
+  if ( 0 == m_nCount ) return 0;
+  boost::uint64_t nRank( static_cast<boost::uint64_t>( ( dblPercent / 100.0 ) * m_nCount + 0.5 ) );
+  if ( 1 > nRank ) nRank = 1;
+  if ( m_nCount < nRank ) nRank = m_nCount;
+  boost::uint64_t nSeen( 0 );
+  for ( size_t ix = 0; ix < nBuckets; ++ix ) {
+    nSeen += m_rBucket[ ix ];
+    if ( nRank <= nSeen ) {
+      boost::uint64_t n( Highest( ix ) );
+      return ( m_nMax < n ) ? m_nMax : n;
+    }
+  }
+  return m_nMax;
+}
+
+// LatencyTrace
+
+OU_THREAD_LOCAL LatencyTrace::Trace LatencyTrace::m_trace = { 0, 0, 0, 0 };
+
+const char* LatencyTrace::Name( EStage stage ) {
+  static const char* rName[ EStageCount ] = { "line", "parse", "dispatch", "watch", "position", "strategy" };
+  return ( EStageCount > stage ) ? rName[ stage ] : "?";
+}
+
+// LatencyStages
+
+void LatencyStages::Copy( LatencyHistogram* rHistogram ) {
+  m_lock.lock();
+  for ( int ix = 0; ix < LatencyTrace::EStageCount; ++ix ) {
+    rHistogram[ ix ] = m_rHistogram[ ix ];
+  }
+  m_lock.unlock();
+}
+
+void LatencyStages::Merge( LatencyHistogram* rHistogram ) {
+  m_lock.lock();
+  for ( int ix = 0; ix < LatencyTrace::EStageCount; ++ix ) {
+    rHistogram[ ix ].Merge( m_rHistogram[ ix ] );
+  }
+  m_lock.unlock();
+}
+
+void LatencyStages::Reset( void ) {
+  m_lock.lock();
+  for ( int ix = 0; ix < LatencyTrace::EStageCount; ++ix ) {
+    m_rHistogram[ ix ].Reset();
+  }
+  m_lock.unlock();
+}
+
+// LatencyRegistry
+
+LatencyRegistry::LatencyRegistry( void )
+  : m_nTicksStart( LatencyTrace::Ticks() ),
+  m_dtStart( boost::posix_time::microsec_clock::universal_time() )
+{
+}
+
+double LatencyRegistry::TicksPerNanosecond( void ) {
+  boost::posix_time::time_duration td( boost::posix_time::microsec_clock::universal_time() - m_dtStart );
+  if ( boost::posix_time::milliseconds( 20 ) > td ) {  // too short a base for a steady figure
+    boost::this_thread::sleep( boost::posix_time::milliseconds( 20 ) - td );
+  }
+  boost::uint64_t nTicks( LatencyTrace::Ticks() );
+  td = boost::posix_time::microsec_clock::universal_time() - m_dtStart;
+  return static_cast<double>( nTicks - m_nTicksStart ) / ( 1000.0 * td.total_microseconds() );
+}
+
+LatencyStages* LatencyRegistry::Register( const std::string& sProvider, const std::string& sSymbol ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  key_t key( sProvider, sSymbol );
+  mapStages_t::iterator iter = m_mapStages.find( key );
+  if ( m_mapStages.end() == iter ) {
+    iter = m_mapStages.insert( mapStages_t::value_type( key, pLatencyStages_t( new LatencyStages( sProvider, sSymbol ) ) ) ).first;
+  }
+  return iter->second.get();
+}
+
+LatencyRegistry::Summary LatencyRegistry::Query( const std::string& sProvider, const std::string& sSymbol, LatencyTrace::EStage stage ) {
+  LatencyHistogram rHistogram[ LatencyTrace::EStageCount ];
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    for ( mapStages_t::iterator iter = m_mapStages.lower_bound( key_t( sProvider, std::string() ) );
+      ( m_mapStages.end() != iter ) && ( sProvider == iter->first.first ); ++iter ) {
+      if ( sSymbol.empty() || ( sSymbol == iter->first.second ) ) {
+        iter->second->Merge( rHistogram );
+      }
+    }
+  }
+  return Summarize( rHistogram[ stage ], TicksPerNanosecond() );
+}
+
+void LatencyRegistry::Reset( void ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  for ( mapStages_t::iterator iter = m_mapStages.begin(); m_mapStages.end() != iter; ++iter ) {
+    iter->second->Reset();
+  }
+}
+
+LatencyRegistry::Summary LatencyRegistry::Summarize( const LatencyHistogram& histogram, double dblTicksPerNanosecond ) const {
+  Summary summary;
+  summary.nCount = histogram.Count();
+  if ( 0 != summary.nCount ) {
+    summary.dblMin = histogram.Min() / dblTicksPerNanosecond;
+    summary.dblMean = histogram.Mean() / dblTicksPerNanosecond;
+    summary.dblP50 = histogram.Percentile( 50.0 ) / dblTicksPerNanosecond;
+    summary.dblP90 = histogram.Percentile( 90.0 ) / dblTicksPerNanosecond;
+    summary.dblP99 = histogram.Percentile( 99.0 ) / dblTicksPerNanosecond;
+    summary.dblP999 = histogram.Percentile( 99.9 ) / dblTicksPerNanosecond;
+    summary.dblMax = histogram.Max() / dblTicksPerNanosecond;
+  }
+  return summary;
+}
+
+void LatencyRegistry::Dump( std::ostream& os, const std::string& sName, LatencyHistogram* rHistogram, double dblTicksPerNanosecond ) const {
+  for ( int ix = 0; ix < LatencyTrace::EStageCount; ++ix ) {
+    if ( 0 == rHistogram[ ix ].Count() ) continue;
+    Summary summary( Summarize( rHistogram[ ix ], dblTicksPerNanosecond ) );
+    os
+      << sName << " " << std::setw( 8 ) << std::left << LatencyTrace::Name( static_cast<LatencyTrace::EStage>( ix ) ) << std::right
+      << " n=" << summary.nCount
+      << std::fixed << std::setprecision( 2 )
+      << " min=" << summary.dblMin / 1000.0
+      << " mean=" << summary.dblMean / 1000.0
+      << " p50=" << summary.dblP50 / 1000.0
+      << " p90=" << summary.dblP90 / 1000.0
+      << " p99=" << summary.dblP99 / 1000.0
+      << " p99.9=" << summary.dblP999 / 1000.0
+      << " max=" << summary.dblMax / 1000.0
+      << " us"
+      << std::endl;
+  }
+}
+
+void LatencyRegistry::Dump( std::ostream& os, bool bBySymbol ) {
+  double dblTicksPerNanosecond( TicksPerNanosecond() );
+  // copies are taken under the lock, and written out after, so the feed is not held up by the stream
+  typedef std::vector<LatencyStages*> vStages_t;
+  vStages_t vStages;
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    for ( mapStages_t::iterator iter = m_mapStages.begin(); m_mapStages.end() != iter; ++iter ) {
+      vStages.push_back( iter->second.get() );  // entries are never removed
+    }
+  }
+  LatencyHistogram rProvider[ LatencyTrace::EStageCount ];
+  LatencyHistogram rSymbol[ LatencyTrace::EStageCount ];
+  for ( vStages_t::iterator iter = vStages.begin(); vStages.end() != iter; ++iter ) {
+    (*iter)->Copy( rSymbol );
+    for ( int ix = 0; ix < LatencyTrace::EStageCount; ++ix ) {
+      rProvider[ ix ].Merge( rSymbol[ ix ] );
+    }
+    if ( bBySymbol ) {
+      Dump( os, (*iter)->Provider() + " " + (*iter)->Symbol(), rSymbol, dblTicksPerNanosecond );
+    }
+    vStages_t::iterator next( iter + 1 );
+    if ( ( vStages.end() == next ) || ( (*next)->Provider() != (*iter)->Provider() ) ) {
+      Dump( os, (*iter)->Provider(), rProvider, dblTicksPerNanosecond );
+      for ( int ix = 0; ix < LatencyTrace::EStageCount; ++ix ) {
+        rProvider[ ix ].Reset();
+      }
+    }
+  }
+}
+
+} // namespace ou
@@ -0,0 +1,241 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// stage by stage latency of a tick, from the socket read to the strategy:
+//   a feed's read, parse and dispatch run on its network thread, down to the strategy's handler,
+//     so the stamps of the tick in flight are carried in a thread local trace, alongside the datum,
+//     rather than in the datum, which is a stored structure
+//   stamps are cpu time stamp counter ticks, converted to nanoseconds only when reported
+//   each stage records the ticks since the read into a log linear histogram (hdr style, 1/16 resolution)
+//     of the symbol the line was for, provider figures are the merge of their symbols
+//   a stage is recorded once per line, so a line giving a quote and a trade counts at the first handler reached
+
+// the stamps compile out unless OU_LATENCY_TRACE is defined (project wide):
+//   OU_LATENCY_BEGIN()  network read completes
+//   OU_LATENCY_LINE()  a line is taken from the read buffer
+//   OU_LATENCY_KEY( p )  the line's symbol is known, p from OU_LATENCY_REGISTER( provider, symbol ), 0 to not trace it
+//   OU_LATENCY_STAGE( stage )  the line reaches a stage
+
+// usage, in a strategy's quote handler:
+//   OU_LATENCY_STAGE( ou::LatencyTrace::EStrategy );
+// and at any time, from any thread:
+//   ou::LatencyRegistry::Instance().Dump( std::cout );
+
+#include <map>
+#include <string>
+#include <ostream>
+
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#if defined _MSC_VER
+#include <intrin.h>
+#define OU_THREAD_LOCAL __declspec( thread )
+#else
+#if defined __i386__ || defined __x86_64__
+#include <x86intrin.h>
+#endif
+#define OU_THREAD_LOCAL __thread
+#endif
+
+#include "Singleton.h"
+#include "SpinLock.h"
+
+namespace ou { // One Unified
+
+class LatencyHistogram {
+public:
+
+  LatencyHistogram( void ) { Reset(); };
+
+  void Record( boost::uint64_t nValue );
+  void Merge( const LatencyHistogram& rhs );
+  void Reset( void );
+
+  boost::uint64_t Count( void ) const { return m_nCount; };
+  boost::uint64_t Min( void ) const { return ( 0 == m_nCount ) ? 0 : m_nMin; };
+  boost::uint64_t Max( void ) const { return m_nMax; };
+  double Mean( void ) const { return ( 0 == m_nCount ) ? 0.0 : static_cast<double>( m_nSum ) / m_nCount; };
+  boost::uint64_t Percentile( double dblPercent ) const;  // the highest value in the bucket holding it, 0 to 100
+
+protected:
+private:
+
+  // values below nSub have a bucket each, above, each power of two is split into nSub buckets
+  //   values are clamped at 2^nMaxBits, some minutes of ticks
+  enum { nSubBits = 4, nSub = 1 << nSubBits, nMaxBits = 41, nBuckets = ( nMaxBits - nSubBits + 1 ) * nSub };
+
+  boost::uint32_t m_rBucket[ nBuckets ];
+  boost::uint64_t m_nCount;
+  boost::uint64_t m_nSum;
+  boost::uint64_t m_nMin;
+  boost::uint64_t m_nMax;
+
+  static size_t Bucket( boost::uint64_t nValue );
+  static boost::uint64_t Highest( size_t ix );  // highest value in the bucket
+};
+
+class LatencyStages;
+
+class LatencyTrace {
+public:
+
+  enum EStage {
+    ELine = 0,  // taken from the read buffer, time spent behind earlier lines of the read
+    EParse,  // fields decoded
+    EDispatch,  // handed to the symbol's quote and trade delegates
+    EWatch,  // Watch::HandleQuote or HandleTrade
+    EPosition,  // Position::HandleQuote or HandleTrade
+    EStrategy,  // marked by the strategy
+    EStageCount
+  };
+
+  static const char* Name( EStage stage );
+
+  static boost::uint64_t Ticks( void ) {
+#if defined _MSC_VER || defined __i386__ || defined __x86_64__
+    return __rdtsc();
+#else
+    return ( boost::posix_time::microsec_clock::universal_time() - boost::posix_time::ptime( boost::gregorian::date( 1970, 1, 1 ) ) ).total_microseconds();
+#endif
+  }
+
+  static void Begin( void ) {
+    m_trace.nRead = Ticks();
+    m_trace.pStages = 0;
+  }
+
+  static void Line( void ) {
+    m_trace.nLine = Ticks();
+    m_trace.pStages = 0;  // until the line's symbol is known
+    m_trace.nRecorded = 0;
+  }
+
+  static void Key( LatencyStages* pStages );
+
+  static void Stage( EStage stage );
+
+protected:
+private:
+
+  struct Trace {  // plain, to be thread local
+    boost::uint64_t nRead;
+    boost::uint64_t nLine;
+    LatencyStages* pStages;
+    unsigned int nRecorded;  // stages done, a bit each
+  };
+
+  static OU_THREAD_LOCAL Trace m_trace;
+};
+
+class LatencyStages {  // the histograms of one provider and symbol
+public:
+
+  LatencyStages( const std::string& sProvider, const std::string& sSymbol ): m_sProvider( sProvider ), m_sSymbol( sSymbol ) {};
+
+  void Record( LatencyTrace::EStage stage, boost::uint64_t nTicks ) {
+    m_lock.lock();
+    m_rHistogram[ stage ].Record( nTicks );
+    m_lock.unlock();
+  }
+
+  const std::string& Provider( void ) const { return m_sProvider; };
+  const std::string& Symbol( void ) const { return m_sSymbol; };
+
+  void Copy( LatencyHistogram* rHistogram );  // rHistogram[ LatencyTrace::EStageCount ]
+  void Merge( LatencyHistogram* rHistogram );
+  void Reset( void );
+
+protected:
+private:
+  std::string m_sProvider;
+  std::string m_sSymbol;
+  SpinLock m_lock;  // recorded on the feed's thread, read from others, rarely contended
+  LatencyHistogram m_rHistogram[ LatencyTrace::EStageCount ];
+};
+
+inline void LatencyTrace::Key( LatencyStages* pStages ) {
+  m_trace.pStages = pStages;
+  if ( 0 != pStages ) {
+    pStages->Record( ELine, m_trace.nLine - m_trace.nRead );
+  }
+}
+
+inline void LatencyTrace::Stage( EStage stage ) {
+  unsigned int nBit( 1 << stage );
+  if ( ( 0 != m_trace.pStages ) && ( 0 == ( nBit & m_trace.nRecorded ) ) ) {
+    m_trace.nRecorded |= nBit;
+    m_trace.pStages->Record( stage, Ticks() - m_trace.nRead );
+  }
+}
+
+class LatencyRegistry: public Singleton<LatencyRegistry> {
+public:
+
+  struct Summary {  // nanoseconds
+    boost::uint64_t nCount;
+    double dblMin, dblMean, dblP50, dblP90, dblP99, dblP999, dblMax;
+    Summary( void ): nCount( 0 ), dblMin( 0 ), dblMean( 0 ), dblP50( 0 ), dblP90( 0 ), dblP99( 0 ), dblP999( 0 ), dblMax( 0 ) {};
+  };
+
+  LatencyRegistry( void );
+  ~LatencyRegistry( void ) {};
+
+  // the same pointer for the same pair, valid for the life of the program
+  LatencyStages* Register( const std::string& sProvider, const std::string& sSymbol );
+
+  // empty sSymbol merges all of the provider's symbols
+  Summary Query( const std::string& sProvider, const std::string& sSymbol, LatencyTrace::EStage stage );
+
+  void Dump( std::ostream& os, bool bBySymbol = false );  // a line per stage, per provider, and per symbol if asked
+  void Reset( void );
+
+  double TicksPerNanosecond( void );  // measured against the wall clock since construction
+
+protected:
+private:
+
+  typedef std::pair<std::string, std::string> key_t;  // provider, symbol
+  typedef boost::shared_ptr<LatencyStages> pLatencyStages_t;
+  typedef std::map<key_t, pLatencyStages_t> mapStages_t;
+
+  boost::mutex m_mutex;
+  mapStages_t m_mapStages;
+
+  boost::uint64_t m_nTicksStart;
+  boost::posix_time::ptime m_dtStart;
+
+  Summary Summarize( const LatencyHistogram& histogram, double dblTicksPerNanosecond ) const;
+  void Dump( std::ostream& os, const std::string& sName, LatencyHistogram* rHistogram, double dblTicksPerNanosecond ) const;
+};
+
+} // namespace ou
+
+#if defined OU_LATENCY_TRACE
+#define OU_LATENCY_BEGIN() ou::LatencyTrace::Begin()
+#define OU_LATENCY_LINE() ou::LatencyTrace::Line()
+#define OU_LATENCY_KEY( p ) ou::LatencyTrace::Key( p )
+#define OU_LATENCY_STAGE( stage ) ou::LatencyTrace::Stage( stage )
+#define OU_LATENCY_REGISTER( provider, symbol ) ou::LatencyRegistry::Instance().Register( provider, symbol )
+#else
+#define OU_LATENCY_BEGIN()
+#define OU_LATENCY_LINE()
+#define OU_LATENCY_KEY( p )
+#define OU_LATENCY_STAGE( stage )
+#define OU_LATENCY_REGISTER( provider, symbol ) 0
+#endif
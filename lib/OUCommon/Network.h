@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 #include <cassert>
+#include <cstring>
 
 #include <typeinfo>
 #include <sstream>
@@ -31,11 +32,13 @@
 #include <boost/array.hpp>
 #include <boost/bind.hpp>
 #include <boost/foreach.hpp>
+#include <boost/static_assert.hpp>
 #include <boost/interprocess/detail/atomic.hpp>
 
 #include <OUCommon/Debug.h>
 
-#include "ReusableBuffers.h"
+#include "ReusableBuffersLockFree.h"
+#include "LatencyTrace.h"
 
 // custom on
 // http://msdn.microsoft.com/en-us/library/e5ewb1h3.aspx
@@ -100,10 +103,11 @@ public:
 
   // factor a couple of these out as traits for here and for IQFeedMessages.
   typedef charT bufferelement_t;
+  BOOST_STATIC_ASSERT( 1 == sizeof( bufferelement_t ) );  // line scanning is done with memchr
   typedef boost::array<bufferelement_t, NETWORK_INPUT_BUF_SIZE> inputbuffer_t; // bulk input buffer via asio
-  typedef BufferRepository<inputbuffer_t> inputrepository_t;
+  typedef BufferRepositoryLockFree<inputbuffer_t> inputrepository_t;
   typedef std::vector<bufferelement_t> linebuffer_t;  // used for composing lines of data for processing
-  typedef BufferRepository<linebuffer_t> linerepository_t;
+  typedef BufferRepositoryLockFree<linebuffer_t> linerepository_t;  // checked out on asio thread, returned on consumer thread
 
   Network( void );
   Network( const structConnection& connection );
@@ -161,6 +165,7 @@ private:
   size_t m_cntAsyncReads;
   size_t m_cntBytesTransferred_input;
   size_t m_cntLinesProcessed;
+  size_t m_cntLinesStraddled;  // lines continued across reads
 
   size_t m_cntSends;
   size_t m_cntBytesTransferred_send;
@@ -171,6 +176,7 @@ private:
   void OnSendDone( const boost::system::error_code& error, std::size_t bytes_transferred, linebuffer_t* );
   void OnSendDoneNoNotify( const boost::system::error_code& error, std::size_t bytes_transferred, linebuffer_t* );
   void OnReadDone( const boost::system::error_code& error, std::size_t bytes_transferred, inputbuffer_t* );
+  inline void AppendToLine( const bufferelement_t* pBgn, const bufferelement_t* pEnd );
   void AsyncRead( void );
 
   void AsioThread( void );
@@ -191,7 +197,7 @@ Network<ownerT,charT>::Network( void )
   m_psocket( NULL ), 
   m_cntBytesTransferred_input( 0 ), m_cntAsyncReads( 0 ),
   m_cntSends( 0 ), m_cntBytesTransferred_send( 0 ),
-  m_cntLinesProcessed( 0 ),
+  m_cntLinesProcessed( 0 ), m_cntLinesStraddled( 0 ),
   m_cntActiveSends( 0 ), m_lReadProgress( 0 ),
   m_timer( m_io )
 {
@@ -210,7 +216,7 @@ Network<ownerT,charT>::Network( const structConnection& connection )
   m_psocket( NULL ), 
   m_cntBytesTransferred_input( 0 ), m_cntAsyncReads( 0 ),
   m_cntSends( 0 ), m_cntBytesTransferred_send( 0 ),
-  m_cntLinesProcessed( 0 ),
+  m_cntLinesProcessed( 0 ), m_cntLinesStraddled( 0 ),
   m_cntActiveSends( 0 ), m_lReadProgress( 0 ),
   m_timer( m_io )
 
@@ -230,7 +236,7 @@ Network<ownerT,charT>::Network( const ipaddress_t& sAddress, port_t nPort )
   m_psocket( NULL ), 
   m_cntBytesTransferred_input( 0 ), m_cntAsyncReads( 0 ),
   m_cntSends( 0 ), m_cntBytesTransferred_send( 0 ),
-  m_cntLinesProcessed( 0 ),
+  m_cntLinesProcessed( 0 ), m_cntLinesStraddled( 0 ),
   m_cntActiveSends( 0 ), m_lReadProgress( 0 ),
   m_timer( m_io )
 {
@@ -291,7 +297,8 @@ Network<ownerT,charT>::~Network(void) {
 #if defined _DEBUG
   DEBUGOUT( typeid( this ).name()
     << " " << m_cntBytesTransferred_input << " bytes in on "
-    << m_cntAsyncReads << " reads with " << m_cntLinesProcessed << " lines out, "
+    << m_cntAsyncReads << " reads with " << m_cntLinesProcessed << " lines out ("
+    << m_cntLinesStraddled << " straddled), "
     << m_cntBytesTransferred_send << " bytes out on " 
     << m_cntSends << " sends." 
     << std::endl
@@ -484,22 +491,31 @@ void Network<ownerT,charT>::OnReadDone( const boost::system::error_code& error,
   else {
     assert( ( NS_CONNECTED == m_stateNetwork ) || ( NS_DISCONNECTING == m_stateNetwork) );
 
+    OU_LATENCY_BEGIN();
+
     ++m_cntAsyncReads;
     m_cntBytesTransferred_input += bytes_transferred;
 
     AsyncRead();  // set up for another read while processing existing buffer
 
     // process the buffer:
-    // need current linebuffer, need stats on how often it waits for subsequent bulk data
-    bufferelement_t ch;
-    typename inputbuffer_t::const_iterator input = pbuffer->begin();
-    while ( 0 != bytes_transferred ) {
-      ch = *input;
-      ++input;
-      if ( 0 == ch ) {
-//        OutputDebugString( "Network::ReadHandler: have a 0x00 character.\n" );
+    // scan for line ends with memchr, and append whole segments to the current line buffer,
+    // rather than pushing character by character.  A line straddling two reads
+    // is completed by the segment arriving at the start of the subsequent buffer.
+    const bufferelement_t* pBgn = pbuffer->data();
+    const bufferelement_t* pEnd = pBgn + bytes_transferred;
+    if ( 0 != m_pline->size() ) {
+      ++m_cntLinesStraddled;
+    }
+    while ( pBgn != pEnd ) {
+      const bufferelement_t* pEol
+        = reinterpret_cast<const bufferelement_t*>( std::memchr( pBgn, 0x0a, pEnd - pBgn ) );
+      if ( NULL == pEol ) {
+        AppendToLine( pBgn, pEnd );  // partial line, remainder arrives on next read
+        pBgn = pEnd;
       }
-      if ( 0x0a == ch ) {
+      else {
+        AppendToLine( pBgn, pEol );
         // send the buffer off 
         if ( &Network<ownerT, charT>::OnNetworkLineBuffer != &ownerT::OnNetworkLineBuffer ) {
           static_cast<ownerT*>( this )->OnNetworkLineBuffer( m_pline );
@@ -508,16 +524,8 @@ void Network<ownerT,charT>::OnReadDone( const boost::system::error_code& error,
         // and allocate another buffer
         m_pline = m_reposLineBuffers.CheckOutL();
         m_pline->clear();
+        pBgn = pEol + 1;
       }
-      else {
-        if ( 0x0d == ch ) {
-          // ignore the character
-        }
-        else {
-          m_pline->push_back( ch );
-        }
-      }
-      --bytes_transferred;
     } // end while
 
   }
@@ -527,6 +535,27 @@ void Network<ownerT,charT>::OnReadDone( const boost::system::error_code& error,
   boost::interprocess::ipcdetail::atomic_dec32( &m_lReadProgress );
 }
 
+//
+// AppendToLine
+//   copy a segment in bulk to the current line, dropping any 0x0d characters
+//
+
+template <typename ownerT, typename charT>
+void Network<ownerT,charT>::AppendToLine( const bufferelement_t* pBgn, const bufferelement_t* pEnd ) {
+  while ( pBgn != pEnd ) {
+    const bufferelement_t* pCR
+      = reinterpret_cast<const bufferelement_t*>( std::memchr( pBgn, 0x0d, pEnd - pBgn ) );
+    if ( NULL == pCR ) {
+      m_pline->insert( m_pline->end(), pBgn, pEnd );
+      pBgn = pEnd;
+    }
+    else {
+      m_pline->insert( m_pline->end(), pBgn, pCR );  // ignore the character
+      pBgn = pCR + 1;
+    }
+  }
+}
+
 //
 // Send
 //
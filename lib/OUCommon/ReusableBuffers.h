@@ -18,6 +18,7 @@
 #include <sstream>
 //#include <typeinfo.h>
 #include <cassert>
+#include <algorithm>
 
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/locks.hpp>
@@ -56,6 +57,16 @@
 
 namespace ou {
 
+struct BufferRepositoryStatistics {
+  std::size_t nCheckins, nCheckouts;
+  std::size_t nCreated, nDestroyed;
+  std::size_t nMaxQSize;  // BufferRepository only
+  std::size_t nSharedPops, nSharedPushes;  // BufferRepositoryLockFree only
+  BufferRepositoryStatistics( void )
+    : nCheckins( 0 ), nCheckouts( 0 ), nCreated( 0 ), nDestroyed( 0 ), nMaxQSize( 0 ),
+      nSharedPops( 0 ), nSharedPushes( 0 ) {};
+};
+
 template<typename bufferT> 
 class BufferRepository {
 public:
@@ -68,13 +79,14 @@ public:
   void CheckInL( buffer_t Buffer );  // locked version
   buffer_t CheckOutL();  // locked version
   bool Outstanding( void ) { return ( cntCheckins != cntCheckouts ); };
+  void GetStatistics( BufferRepositoryStatistics& );
 protected:
   boost::mutex m_mutex;
   std::vector<buffer_t> m_vStack;
 private:
   std::size_t cntCheckins, cntCheckouts;
-#ifdef _DEBUG
   std::size_t cntCreated, cntDestroyed, maxQsize;
+#ifdef _DEBUG
   bool m_bCheckingOut;
   bool m_bCheckingIn;
   std::string m_sType;
@@ -83,10 +95,10 @@ private:
 
 
 template<typename bufferT> BufferRepository<bufferT>::BufferRepository(void) 
-: cntCheckins( 0 ), cntCheckouts( 0 )
+: cntCheckins( 0 ), cntCheckouts( 0 ),
+  cntCreated( 0 ), cntDestroyed( 0 ), maxQsize( 0 )
 #ifdef _DEBUG
-  , cntCreated( 0 ), cntDestroyed( 0 ), maxQsize( 0 ),
-  m_bCheckingOut( false ), m_bCheckingIn( false )
+  , m_bCheckingOut( false ), m_bCheckingIn( false )
 #endif
 {
 #ifdef _DEBUG
@@ -101,9 +113,7 @@ template<typename bufferT> BufferRepository<bufferT>::~BufferRepository(void) {
     pBuffer = m_vStack.back();
     m_vStack.pop_back();
     delete pBuffer;
-#ifdef _DEBUG
     ++cntDestroyed;
-#endif
   }
 #ifdef _DEBUG
   std::stringstream ss;
@@ -137,8 +147,8 @@ template<typename bufferT> inline void BufferRepository<bufferT>::CheckIn(buffer
 #endif
   m_vStack.push_back( pBuffer );
   ++cntCheckins;
-#ifdef _DEBUG
   maxQsize = std::max<std::size_t>( maxQsize, m_vStack.size() );
+#ifdef _DEBUG
   m_bCheckingIn = false;
 #endif
 }
@@ -148,6 +158,15 @@ template<typename bufferT> inline bufferT* BufferRepository<bufferT>::CheckOutL(
   return CheckOut();
 }
 
+template<typename bufferT> void BufferRepository<bufferT>::GetStatistics( BufferRepositoryStatistics& stats ) {
+  boost::mutex::scoped_lock lock(m_mutex);
+  stats.nCheckins = cntCheckins;
+  stats.nCheckouts = cntCheckouts;
+  stats.nCreated = cntCreated;
+  stats.nDestroyed = cntDestroyed;
+  stats.nMaxQSize = maxQsize;
+}
+
 template<typename bufferT> inline bufferT* BufferRepository<bufferT>::CheckOut() {
   bufferT* pBuffer;
 #ifdef _DEBUG
@@ -156,9 +175,7 @@ template<typename bufferT> inline bufferT* BufferRepository<bufferT>::CheckOut()
 #endif
   if ( m_vStack.empty() ) {
     pBuffer = new bufferT();
-#ifdef _DEBUG
     ++cntCreated;
-#endif
   }
   else {
     pBuffer = m_vStack.back();
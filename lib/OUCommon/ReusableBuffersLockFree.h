@@ -0,0 +1,176 @@
+/************************************************************************
+ * Copyright(c) 2009, One Unified. All rights reserved.                 *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// variation of BufferRepository, without the mutex:
+//   each thread keeps its own small stack of buffers, no locking required
+//   when a thread's stack reaches its cap, half of it is moved to a shared lock-free free list
+//   a thread with an empty stack refills from the shared list before creating new buffers
+// this suits the cross thread returns in Network, where lines are checked out on the asio thread
+//   and given back on the consuming thread
+
+// the per thread stacks and the shared list are held by reference from the thread specific storage,
+//   so a thread exiting after the repository is destroyed still cleans up properly
+
+#include <vector>
+#include <cassert>
+
+#include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/lockfree/stack.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "ReusableBuffers.h"
+
+namespace ou {
+
+template<typename bufferT>
+class BufferRepositoryLockFree {
+public:
+
+  typedef bufferT* buffer_t;
+
+  BufferRepositoryLockFree( size_t nThreadCap = 64, size_t nSharedCap = 1024 );
+  ~BufferRepositoryLockFree(void);
+
+  inline void CheckIn( buffer_t Buffer );
+  inline buffer_t CheckOut();
+  void CheckInL( buffer_t Buffer ) { CheckIn( Buffer ); };  // for interface compatibility with BufferRepository
+  buffer_t CheckOutL() { return CheckOut(); };
+  bool Outstanding( void ) const { return ( m_pShared->cntCheckins != m_pShared->cntCheckouts ); };
+
+  void GetStatistics( BufferRepositoryStatistics& ) const;
+
+protected:
+private:
+
+  struct Shared {
+    const size_t nThreadCap;
+    boost::lockfree::stack<buffer_t> stack;  // buffers returned from threads with full caches
+    boost::atomic<size_t> cntCheckins, cntCheckouts;
+    boost::atomic<size_t> cntCreated, cntDestroyed;
+    boost::atomic<size_t> cntSharedPops, cntSharedPushes;
+    Shared( size_t nThreadCap_, size_t nSharedCap )
+      : nThreadCap( nThreadCap_ ), stack( nSharedCap ),
+        cntCheckins( 0 ), cntCheckouts( 0 ), cntCreated( 0 ), cntDestroyed( 0 ),
+        cntSharedPops( 0 ), cntSharedPushes( 0 ) {}
+    ~Shared( void ) {
+      buffer_t pBuffer;
+      while ( stack.pop( pBuffer ) ) {
+        delete pBuffer;
+      }
+    }
+    void Release( buffer_t pBuffer ) {  // to the shared list, or deleted if the list is at its cap
+      if ( stack.bounded_push( pBuffer ) ) {
+        ++cntSharedPushes;
+      }
+      else {
+        delete pBuffer;
+        ++cntDestroyed;
+      }
+    }
+  };
+
+  typedef boost::shared_ptr<Shared> pShared_t;
+
+  struct ThreadCache {
+    pShared_t pShared;
+    std::vector<buffer_t> vStack;
+    ThreadCache( pShared_t pShared_ ): pShared( pShared_ ) {
+      vStack.reserve( pShared->nThreadCap );
+    }
+    ~ThreadCache( void ) {  // thread exiting, or repository destroyed on this thread
+      while ( !vStack.empty() ) {
+        pShared->Release( vStack.back() );
+        vStack.pop_back();
+      }
+    }
+  };
+
+  pShared_t m_pShared;
+  boost::thread_specific_ptr<ThreadCache> m_pCache;
+
+  inline ThreadCache& Cache( void );
+
+};
+
+template<typename bufferT>
+BufferRepositoryLockFree<bufferT>::BufferRepositoryLockFree( size_t nThreadCap, size_t nSharedCap )
+: m_pShared( boost::make_shared<Shared>( nThreadCap, nSharedCap ) )
+{
+  assert( 0 < nThreadCap );
+}
+
+template<typename bufferT>
+BufferRepositoryLockFree<bufferT>::~BufferRepositoryLockFree(void) {
+  m_pCache.reset();  // this thread's buffers go to the shared list, which is cleaned up with the last reference
+}
+
+template<typename bufferT>
+inline typename BufferRepositoryLockFree<bufferT>::ThreadCache& BufferRepositoryLockFree<bufferT>::Cache( void ) {
+  ThreadCache* pCache = m_pCache.get();
+  if ( ( NULL == pCache ) || ( pCache->pShared != m_pShared ) ) {  // second test: stale entry from a prior repository at this address
+    pCache = new ThreadCache( m_pShared );
+    m_pCache.reset( pCache );
+  }
+  return *pCache;
+}
+
+template<typename bufferT>
+inline void BufferRepositoryLockFree<bufferT>::CheckIn( buffer_t pBuffer ) {
+  ThreadCache& cache( Cache() );
+  if ( cache.vStack.size() >= m_pShared->nThreadCap ) {
+    // keep half for local re-use, hand the rest over for other threads
+    while ( cache.vStack.size() > ( m_pShared->nThreadCap / 2 ) ) {
+      m_pShared->Release( cache.vStack.back() );
+      cache.vStack.pop_back();
+    }
+  }
+  cache.vStack.push_back( pBuffer );
+  ++m_pShared->cntCheckins;
+}
+
+template<typename bufferT>
+inline bufferT* BufferRepositoryLockFree<bufferT>::CheckOut() {
+  ThreadCache& cache( Cache() );
+  buffer_t pBuffer;
+  if ( !cache.vStack.empty() ) {
+    pBuffer = cache.vStack.back();
+    cache.vStack.pop_back();
+  }
+  else {
+    if ( m_pShared->stack.pop( pBuffer ) ) {
+      ++m_pShared->cntSharedPops;
+    }
+    else {
+      pBuffer = new bufferT();
+      ++m_pShared->cntCreated;
+    }
+  }
+  ++m_pShared->cntCheckouts;
+  return pBuffer;
+}
+
+template<typename bufferT>
+void BufferRepositoryLockFree<bufferT>::GetStatistics( BufferRepositoryStatistics& stats ) const {
+  stats.nCheckins = m_pShared->cntCheckins;
+  stats.nCheckouts = m_pShared->cntCheckouts;
+  stats.nCreated = m_pShared->cntCreated;
+  stats.nDestroyed = m_pShared->cntDestroyed;
+  stats.nSharedPops = m_pShared->cntSharedPops;
+  stats.nSharedPushes = m_pShared->cntSharedPushes;
+}
+
+} // ou
@@ -43,16 +43,27 @@ unsigned char WuManber::rchExtendedAscii[] = {
     0x00 };
 
 WuManber::WuManber( void ):
-  m_k( 0 ), m_lcpl( 0 ), m_bInitialized( false ) {
+  m_k( 0 ), m_lcpl( 0 ), m_bInitialized( false ), m_pPatterns( 0 ), m_ShiftTable( 0 ), m_vPatternMap( 0 ) {
 }
 
 WuManber::~WuManber( void ) {
+  Release();
+}
+
+void WuManber::Release( void ) {
+  delete [] m_ShiftTable;
+  m_ShiftTable = 0;
+  delete [] m_vPatternMap;
+  m_vPatternMap = 0;
+  m_bInitialized = false;
 }
 
 void WuManber::Initialize( const std::vector<const char *>& patterns,
                           bool bCaseSensitive, bool bIncludeSpecialCharacters, bool bIncludeExtendedAscii ) {
 // bIncludeExtendedAscii, bIncludeSpecialCharacters matched as whitespace when false
 
+  Release();
+
   m_k = patterns.size();
   m_lcpl = 0; // start with 0 and grow from there
   for ( unsigned int i = 0; i < m_k; ++i ) {
@@ -84,14 +95,14 @@ void WuManber::Initialize( const std::vector<const char *>& patterns,
     for ( unsigned short i = 'A'; i <= 'Z'; ++i ) {
       char letter = i - 'A' + 'a';  // map upper case to lower case
       m_lu[i].letter = letter; // map upper case to lower case
-      m_lu[i].offset = m_lu[letter].offset;
+      m_lu[i].offset = m_lu[(unsigned char) letter].offset;
       // no unique characters so don't increment size
     }
   }
   if ( bIncludeSpecialCharacters ) {
     for ( char *c = rchSpecialCharacters; 0 != *c; ++c ) {
-      m_lu[*c].letter = *c;
-      m_lu[*c].offset = m_nSizeOfAlphabet++;
+      m_lu[(unsigned char) *c].letter = *c;
+      m_lu[(unsigned char) *c].offset = m_nSizeOfAlphabet++;
     }
   }
   if ( bIncludeExtendedAscii ) {
@@ -114,21 +125,23 @@ void WuManber::Initialize( const std::vector<const char *>& patterns,
 
   m_vPatternMap = new std::vector<structPatternMap>[ m_nTableSize ];
 
+  // characters are looked up as unsigned, extended ascii would otherwise index before the table
   for ( std::size_t j = 0; j < m_k; ++j ) {  // loop through patterns
+    const unsigned char* pattern = reinterpret_cast<const unsigned char*>( patterns[j] );
     for ( std::size_t q = m_lcpl; q >= B; --q ) {
       unsigned int hash;
-      hash  = m_lu[patterns[j][q - 2 - 1]].offset; // bring in offsets of X in pattern j
+      hash  = m_lu[pattern[q - 2 - 1]].offset; // bring in offsets of X in pattern j
       hash <<= m_nBitsInShift;
-      hash += m_lu[patterns[j][q - 1 - 1]].offset;
+      hash += m_lu[pattern[q - 1 - 1]].offset;
       hash <<= m_nBitsInShift;
-      hash += m_lu[patterns[j][q     - 1]].offset;
+      hash += m_lu[pattern[q     - 1]].offset;
       std::size_t shiftlen = m_lcpl - q;
       m_ShiftTable[ hash ] = std::min<std::size_t>( m_ShiftTable[ hash ], shiftlen );
       if ( 0 == shiftlen ) {
         m_PatternMapElement.ix = j;
-        m_PatternMapElement.PrefixHash = m_lu[patterns[j][0]].offset;
+        m_PatternMapElement.PrefixHash = m_lu[pattern[0]].offset;
         m_PatternMapElement.PrefixHash <<= m_nBitsInShift;
-        m_PatternMapElement.PrefixHash += m_lu[patterns[j][1]].offset;
+        m_PatternMapElement.PrefixHash += m_lu[pattern[1]].offset;
         m_vPatternMap[ hash ].push_back( m_PatternMapElement );
       }
     }
@@ -136,11 +149,22 @@ void WuManber::Initialize( const std::vector<const char *>& patterns,
   m_bInitialized = true;
 }
 
+void WuManber::PrintMatch( std::size_t ixPattern, std::size_t /* ixOffset */ ) {
+  std::cout << "match found: " << (*m_pPatterns)[ ixPattern ] << std::endl;
+}
+
 void WuManber::Search( std::size_t TextLength, const char *Text, const std::vector<const char *> &patterns ) {
+  m_pPatterns = &patterns;
+  Search( TextLength, Text, patterns, fastdelegate::MakeDelegate( this, &WuManber::PrintMatch ) );
+}
+
+void WuManber::Search( std::size_t TextLength, const char *Text_, const std::vector<const char *> &patterns, OnMatch_t fMatch ) {
 
   assert( m_k == patterns.size() );
-  assert( m_lcpl < TextLength );
   assert( m_bInitialized );
+  if ( m_lcpl > TextLength ) return;  // nothing fits
+  const unsigned char* Text = reinterpret_cast<const unsigned char*>( Text_ );
+  const unsigned char* TextEnd = Text + TextLength;
   std::size_t ix = m_lcpl - 1; // start off by matching end of largest common pattern
   while ( ix < TextLength ) {
     unsigned int hash1;
@@ -163,9 +187,9 @@ void WuManber::Search( std::size_t TextLength, const char *Text, const std::vect
       while ( element.end() != iter ) {
         if ( hash2 == (*iter).PrefixHash ) {
           // since prefix matches, compare target substring with pattern
-          const char *ixTarget = Text + ix - m_lcpl + 3; // we know first two characters already match
-          const char *ixPattern = patterns[ (*iter).ix ] + 2;  // ditto
-          while ( ( 0 != *ixTarget ) && ( 0 != *ixPattern ) ) { // match until we reach end of either string
+          const unsigned char *ixTarget = Text + ix - m_lcpl + 3; // we know first two characters already match
+          const unsigned char *ixPattern = reinterpret_cast<const unsigned char*>( patterns[ (*iter).ix ] ) + 2;  // ditto
+          while ( ( TextEnd != ixTarget ) && ( 0 != *ixPattern ) ) { // match until we reach end of either string
             if ( m_lu[ *ixTarget ].letter == m_lu[ *ixPattern ].letter ) {  // match against chosen case sensitivity
               ++ixTarget;
               ++ixPattern;
@@ -175,7 +199,7 @@ void WuManber::Search( std::size_t TextLength, const char *Text, const std::vect
             }
           }
           if ( 0 == *ixPattern ) {  // we found the end of the pattern, so match found
-            std::cout << "match found: " << patterns[ (*iter).ix ] << std::endl;
+            fMatch( (*iter).ix, ix - m_lcpl + 1 );
           }
         }
         ++iter;
@@ -20,15 +20,23 @@
 
 #include <vector>
 
+#include "FastDelegate.h"
+
 namespace ou {
 
 class WuManber {
 public:
+  // index of the pattern in patterns, offset in Text of the start of the match
+  typedef fastdelegate::FastDelegate2<std::size_t, std::size_t> OnMatch_t;
+
   WuManber( void );
   ~WuManber( void );
+  // may be called again to replace the patterns
   void Initialize( const std::vector<const char *> &patterns, 
                    bool bCaseSensitive = false, bool bIncludeSpecialCharacters = false, bool bIncludeExtendedAscii = false );
-  void Search( std::size_t TextLength, const char *Text, const std::vector<const char *> &patterns );
+  void Search( std::size_t TextLength, const char *Text, const std::vector<const char *> &patterns );  // writes matches to std::cout
+  // Text need not be null terminated, patterns must be those given to Initialize, nothing is allocated
+  void Search( std::size_t TextLength, const char *Text, const std::vector<const char *> &patterns, OnMatch_t fMatch );
 protected:
 private:
   std::size_t m_k;  // number of patterns;
@@ -42,6 +50,11 @@ private:
 
   bool m_bInitialized;
 
+  void Release( void );
+  void PrintMatch( std::size_t ixPattern, std::size_t ixOffset );
+
+  const std::vector<const char *>* m_pPatterns;  // for PrintMatch
+
   struct structAlphabet {
     char letter;  // letter for matching purposes
     unsigned char offset; // index of character in offsetted alphabet for shift and hash tables
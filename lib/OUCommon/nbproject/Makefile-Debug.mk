@@ -39,6 +39,7 @@ OBJECTFILES= \
 	${OBJECTDIR}/ConsoleStream.o \
 	${OBJECTDIR}/CountryCode.o \
 	${OBJECTDIR}/CurrencyCode.o \
+	${OBJECTDIR}/LatencyTrace.o \
 	${OBJECTDIR}/ReadCodeListCommon.o \
 	${OBJECTDIR}/ReadNaicsToSicCodeList.o \
 	${OBJECTDIR}/ReadSicCodeList.o \
@@ -95,6 +96,11 @@ ${OBJECTDIR}/CurrencyCode.o: CurrencyCode.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/CurrencyCode.o CurrencyCode.cpp
 
+${OBJECTDIR}/LatencyTrace.o: LatencyTrace.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/LatencyTrace.o LatencyTrace.cpp
+
 ${OBJECTDIR}/ReadCodeListCommon.o: ReadCodeListCommon.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -0,0 +1,247 @@
+/************************************************************************
+ * Copyright(c) 2012, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#include <cassert>
+#include <math.h>
+#include <algorithm>
+
+#include "NodeBoolean.h"
+#include "NodeCompare.h"
+#include "NodeDouble.h"
+
+#include "CompiledSignals.h"
+
+namespace ou { // One Unified
+namespace gp { // genetic programming
+
+namespace {
+  const CompiledSignals::hash_t nFnvBasis( 14695981039346656037ULL );
+  const CompiledSignals::hash_t nFnvPrime( 1099511628211ULL );
+
+  // fixed, rather than std::hash, so a hash is the same from run to run
+  CompiledSignals::hash_t HashBytes( CompiledSignals::hash_t hash, const void* p, size_t n ) {
+    const unsigned char* pByte( reinterpret_cast<const unsigned char*>( p ) );
+    for ( size_t ix = 0; ix < n; ++ix ) {
+      hash ^= pByte[ ix ];
+      hash *= nFnvPrime;
+    }
+    return hash;
+  }
+}
+
+bool CompiledSignals::Key::operator<( const Key& rhs ) const {
+  if ( op != rhs.op ) return op < rhs.op;
+  if ( ixLeft != rhs.ixLeft ) return ixLeft < rhs.ixLeft;
+  if ( ixRight != rhs.ixRight ) return ixRight < rhs.ixRight;
+  if ( dblConst != rhs.dblConst ) return dblConst < rhs.dblConst;
+  return sNode < rhs.sNode;
+}
+
+CompiledSignals::CompiledSignals( void ): m_ixLong( 0 ), m_ixShort( 0 ), m_hash( 0 ) {
+}
+
+CompiledSignals::~CompiledSignals( void ) {
+}
+
+void CompiledSignals::Compile( const Individual::Signals_t& signals ) {
+
+  assert( 0 != signals.rnLong );
+  assert( 0 != signals.rnShort );
+
+  m_vInstruction.clear();
+  m_vRegister.clear();
+  m_vIsConst.clear();
+  m_vHash.clear();
+  m_mapKey.clear();
+
+  // RootNode has a single boolean child
+  m_ixLong = CompileNode( signals.rnLong->ChildCenter() );
+  m_ixShort = CompileNode( signals.rnShort->ChildCenter() );
+
+  m_hash = Combine( Combine( nFnvBasis, m_vHash[ m_ixLong ] ), m_vHash[ m_ixShort ] );  // long and short are not interchangeable
+
+  m_mapKey.clear();  // not needed at run time
+  m_vIsConst.clear();
+  m_vHash.clear();
+}
+
+bool CompiledSignals::Evaluate( void ) {
+
+  double* r( &m_vRegister[ 0 ] );
+
+  for ( std::vector<Instruction>::const_iterator iter = m_vInstruction.begin(); m_vInstruction.end() != iter; ++iter ) {
+    const Instruction& in( *iter );
+    double& dest( r[ in.ixDest ] );
+    switch ( in.op ) {
+      case OpCallDouble:  dest = in.pNode->EvaluateDouble(); break;
+      case OpCallBoolean: dest = in.pNode->EvaluateBoolean() ? 1.0 : 0.0; break;
+      case OpAbs: dest = std::abs( r[ in.ixLeft ] ); break;
+      case OpAdd: dest = r[ in.ixLeft ] + r[ in.ixRight ]; break;
+      case OpSub: dest = r[ in.ixLeft ] - r[ in.ixRight ]; break;
+      case OpMlt: dest = r[ in.ixLeft ] * r[ in.ixRight ]; break;
+      case OpDvd: dest = ( 0.0 == r[ in.ixRight ] ) ? HUGE : r[ in.ixLeft ] / r[ in.ixRight ]; break;
+      case OpGT:  dest = ( r[ in.ixLeft ] >  r[ in.ixRight ] ) ? 1.0 : 0.0; break;
+      case OpGE:  dest = ( r[ in.ixLeft ] >= r[ in.ixRight ] ) ? 1.0 : 0.0; break;
+      case OpLT:  dest = ( r[ in.ixLeft ] <  r[ in.ixRight ] ) ? 1.0 : 0.0; break;
+      case OpLE:  dest = ( r[ in.ixLeft ] <= r[ in.ixRight ] ) ? 1.0 : 0.0; break;
+      case OpNot: dest = ( 0.0 == r[ in.ixLeft ] ) ? 1.0 : 0.0; break;
+      case OpAnd: dest = ( ( 0.0 != r[ in.ixLeft ] ) && ( 0.0 != r[ in.ixRight ] ) ) ? 1.0 : 0.0; break;
+      case OpOr:  dest = ( ( 0.0 != r[ in.ixLeft ] ) || ( 0.0 != r[ in.ixRight ] ) ) ? 1.0 : 0.0; break;
+      default:
+        assert( false );
+    }
+  }
+
+  return Long();
+}
+
+double CompiledSignals::Fold( EOp op, double dblLeft, double dblRight ) {
+  switch ( op ) {
+    case OpAbs: return std::abs( dblLeft );
+    case OpAdd: return dblLeft + dblRight;
+    case OpSub: return dblLeft - dblRight;
+    case OpMlt: return dblLeft * dblRight;
+    case OpDvd: return ( 0.0 == dblRight ) ? HUGE : dblLeft / dblRight;
+    case OpGT:  return ( dblLeft >  dblRight ) ? 1.0 : 0.0;
+    case OpGE:  return ( dblLeft >= dblRight ) ? 1.0 : 0.0;
+    case OpLT:  return ( dblLeft <  dblRight ) ? 1.0 : 0.0;
+    case OpLE:  return ( dblLeft <= dblRight ) ? 1.0 : 0.0;
+    case OpNot: return ( 0.0 == dblLeft ) ? 1.0 : 0.0;
+    case OpAnd: return ( ( 0.0 != dblLeft ) && ( 0.0 != dblRight ) ) ? 1.0 : 0.0;
+    case OpOr:  return ( ( 0.0 != dblLeft ) || ( 0.0 != dblRight ) ) ? 1.0 : 0.0;
+    default:
+      assert( false );
+  }
+  return 0.0;
+}
+
+CompiledSignals::hash_t CompiledSignals::Combine( hash_t hash, hash_t value ) {
+  return HashBytes( hash, &value, sizeof( value ) );
+}
+
+CompiledSignals::ix_t CompiledSignals::Constant( double dbl ) {
+  Key key( OpConst, 0, 0, dbl, "" );
+  mapKey_t::const_iterator iter = m_mapKey.find( key );
+  if ( m_mapKey.end() != iter ) return iter->second;
+  ix_t ix( m_vRegister.size() );
+  m_vRegister.push_back( dbl );
+  m_vIsConst.push_back( true );
+  if ( 0.0 == dbl ) dbl = 0.0;  // -0.0 evaluates as 0.0
+  m_vHash.push_back( HashBytes( Combine( nFnvBasis, OpConst ), &dbl, sizeof( dbl ) ) );
+  m_mapKey.insert( mapKey_t::value_type( key, ix ) );
+  return ix;
+}
+
+CompiledSignals::ix_t CompiledSignals::Emit( EOp op, ix_t ixLeft, ix_t ixRight, Node* pNode, const std::string& sNode ) {
+
+  bool bOpaque( ( OpCallDouble == op ) || ( OpCallBoolean == op ) );
+  bool bUnary( ( OpAbs == op ) || ( OpNot == op ) );
+
+  if ( !bOpaque ) {
+    bool bLeftConst( m_vIsConst[ ixLeft ] );
+    bool bRightConst( bUnary ? true : m_vIsConst[ ixRight ] );
+    if ( bLeftConst && bRightConst ) {
+      return Constant( Fold( op, m_vRegister[ ixLeft ], bUnary ? 0.0 : m_vRegister[ ixRight ] ) );
+    }
+    // boolean identities with one constant side
+    if ( ( OpAnd == op ) || ( OpOr == op ) ) {
+      if ( bLeftConst || bRightConst ) {
+        ix_t ixConst( bLeftConst ? ixLeft : ixRight );
+        ix_t ixOther( bLeftConst ? ixRight : ixLeft );
+        bool bConst( 0.0 != m_vRegister[ ixConst ] );
+        if ( OpAnd == op ) return bConst ? ixOther : Constant( 0.0 );
+        else               return bConst ? Constant( 1.0 ) : ixOther;
+      }
+    }
+    if ( bUnary ) ixRight = 0;
+    // commutative operations share a key regardless of operand order
+    if ( ( OpAdd == op ) || ( OpMlt == op ) || ( OpAnd == op ) || ( OpOr == op ) ) {
+      if ( ixRight < ixLeft ) std::swap( ixLeft, ixRight );
+    }
+  }
+
+  Key key( op, ixLeft, ixRight, 0.0, sNode );
+  mapKey_t::const_iterator iter = m_mapKey.find( key );
+  if ( m_mapKey.end() != iter ) return iter->second;  // common sub-expression
+
+  hash_t hash( Combine( nFnvBasis, op ) );
+  if ( bOpaque ) {
+    hash = HashBytes( hash, sNode.data(), sNode.size() );
+  }
+  else {
+    hash_t hashLeft( m_vHash[ ixLeft ] );
+    hash_t hashRight( bUnary ? 0 : m_vHash[ ixRight ] );
+    if ( ( OpAdd == op ) || ( OpMlt == op ) || ( OpAnd == op ) || ( OpOr == op ) ) {
+      if ( hashRight < hashLeft ) std::swap( hashLeft, hashRight );
+    }
+    hash = Combine( Combine( hash, hashLeft ), hashRight );
+  }
+
+  ix_t ix( m_vRegister.size() );
+  m_vRegister.push_back( 0.0 );
+  m_vIsConst.push_back( false );
+  m_vHash.push_back( hash );
+  m_vInstruction.push_back( Instruction( op, ix, ixLeft, ixRight, pNode ) );
+  m_mapKey.insert( mapKey_t::value_type( key, ix ) );
+  return ix;
+}
+
+CompiledSignals::ix_t CompiledSignals::CompileNode( Node& node ) {
+
+  // terminals
+  if ( 0 != dynamic_cast<NodeBooleanFalse*>( &node ) ) return Constant( 0.0 );
+  if ( 0 != dynamic_cast<NodeBooleanTrue*>( &node ) ) return Constant( 1.0 );
+  if ( 0 != dynamic_cast<NodeDoubleZero*>( &node ) ) return Constant( 0.0 );
+  if ( NodeDoubleRandom* p = dynamic_cast<NodeDoubleRandom*>( &node ) ) return Constant( p->Value() );
+
+  // functions
+  EOp op( OpConst );
+  if      ( 0 != dynamic_cast<NodeBooleanNot*>( &node ) ) op = OpNot;
+  else if ( 0 != dynamic_cast<NodeBooleanAnd*>( &node ) ) op = OpAnd;
+  else if ( 0 != dynamic_cast<NodeBooleanOr*>( &node ) ) op = OpOr;
+  else if ( 0 != dynamic_cast<NodeCompareGT*>( &node ) ) op = OpGT;
+  else if ( 0 != dynamic_cast<NodeCompareGE*>( &node ) ) op = OpGE;
+  else if ( 0 != dynamic_cast<NodeCompareLT*>( &node ) ) op = OpLT;
+  else if ( 0 != dynamic_cast<NodeCompareLE*>( &node ) ) op = OpLE;
+  else if ( 0 != dynamic_cast<NodeDoubleAbs*>( &node ) ) op = OpAbs;
+  else if ( 0 != dynamic_cast<NodeDoubleAdd*>( &node ) ) op = OpAdd;
+  else if ( 0 != dynamic_cast<NodeDoubleSub*>( &node ) ) op = OpSub;
+  else if ( 0 != dynamic_cast<NodeDoubleMlt*>( &node ) ) op = OpMlt;
+  else if ( 0 != dynamic_cast<NodeDoubleDvd*>( &node ) ) op = OpDvd;
+
+  if ( OpConst == op ) {
+    // not known here: time series terminals, or other registered node types, called as a whole
+    std::stringstream ss;
+    node.TreeToString( ss );
+    return Emit( ( NodeType::Bool == node.ReturnType() ) ? OpCallBoolean : OpCallDouble, 0, 0, &node, ss.str() );
+  }
+
+  switch ( node.NodeCount() ) {
+    case 1: {
+      ix_t ixCenter = CompileNode( node.ChildCenter() );
+      return Emit( op, ixCenter, 0, 0, "" );
+    }
+    case 2: {
+      ix_t ixLeft = CompileNode( node.ChildLeft() );
+      ix_t ixRight = CompileNode( node.ChildRight() );
+      return Emit( op, ixLeft, ixRight, 0, "" );
+    }
+    default:
+      assert( false );
+  }
+  return 0;
+}
+
+} // namespace gp
+} // namespace ou
@@ -0,0 +1,118 @@
+/************************************************************************
+ * Copyright(c) 2012, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// flattens the long and short signal trees of an Individual into one register program:
+//   constants are folded at compile time,
+//   identical sub-expressions in either tree are computed once,
+//   terminals not known here (time series nodes from TFGP) are called through their EvaluateDouble,
+//   evaluation is then a single loop over a compact instruction array, rather than a recursion of virtual calls
+
+// compile after the nodes have been PreProcess'd, as ToString on time series nodes identifies the series
+
+// Evaluate() computes both signals, returning the long signal, Short() returns the short signal of the
+//   last Evaluate(), which matches the long then short calling order of the strategy delegates
+
+// Hash() identifies the program rather than the text of the trees:  operands of commutative operations
+//   are ordered by their own hash, and folded constants hash as their value, so trees differing only in
+//   those respects, and so evaluating identically, share a hash
+
+#include <map>
+#include <vector>
+#include <string>
+
+#include <boost/cstdint.hpp>
+
+#include "Individual.h"
+
+namespace ou { // One Unified
+namespace gp { // genetic programming
+
+class CompiledSignals {
+public:
+
+  CompiledSignals( void );
+  ~CompiledSignals( void );
+
+  void Compile( const Individual::Signals_t& signals );
+
+  bool Evaluate( void );  // evaluates both signals, returns long
+  bool Long( void ) const { return 0.0 != m_vRegister[ m_ixLong ]; };  // result of last Evaluate
+  bool Short( void ) const { return 0.0 != m_vRegister[ m_ixShort ]; };  // result of last Evaluate
+
+  size_t InstructionCount( void ) const { return m_vInstruction.size(); };
+  size_t RegisterCount( void ) const { return m_vRegister.size(); };
+
+  typedef boost::uint64_t hash_t;
+  hash_t Hash( void ) const { return m_hash; };  // canonical, of the long and short signals as compiled
+
+protected:
+private:
+
+  typedef size_t ix_t;  // index into register file
+
+  enum EOp {
+    OpCallDouble = 0, OpCallBoolean,  // opaque nodes
+    OpAbs, OpAdd, OpSub, OpMlt, OpDvd,
+    OpGT, OpGE, OpLT, OpLE,
+    OpNot, OpAnd, OpOr,
+    OpConst  // only used during compilation, constants are preloaded into the register file
+  };
+
+  struct Instruction {
+    EOp op;
+    ix_t ixDest;
+    ix_t ixLeft;
+    ix_t ixRight;
+    Node* pNode;  // for OpCallX
+    Instruction( EOp op_, ix_t ixDest_, ix_t ixLeft_, ix_t ixRight_, Node* pNode_ )
+      : op( op_ ), ixDest( ixDest_ ), ixLeft( ixLeft_ ), ixRight( ixRight_ ), pNode( pNode_ ) {};
+  };
+
+  struct Key {  // identifies a sub-expression for re-use
+    EOp op;
+    ix_t ixLeft;
+    ix_t ixRight;
+    double dblConst;
+    std::string sNode;  // text of opaque node or sub-tree
+    Key( EOp op_, ix_t ixLeft_, ix_t ixRight_, double dblConst_, const std::string& sNode_ )
+      : op( op_ ), ixLeft( ixLeft_ ), ixRight( ixRight_ ), dblConst( dblConst_ ), sNode( sNode_ ) {};
+    bool operator<( const Key& rhs ) const;
+  };
+
+  typedef std::map<Key,ix_t> mapKey_t;
+
+  std::vector<Instruction> m_vInstruction;
+  std::vector<double> m_vRegister;
+  std::vector<bool> m_vIsConst;  // compile time only, register holds a constant
+  std::vector<hash_t> m_vHash;  // compile time only, canonical hash of the expression in the register
+
+  mapKey_t m_mapKey;
+
+  ix_t m_ixLong;
+  ix_t m_ixShort;
+
+  hash_t m_hash;
+
+  ix_t CompileNode( Node& node );
+  ix_t Constant( double dbl );
+  ix_t Emit( EOp op, ix_t ixLeft, ix_t ixRight, Node* pNode, const std::string& sNode );
+  static double Fold( EOp op, double dblLeft, double dblRight );
+  static hash_t Combine( hash_t hash, hash_t value );
+
+};
+
+} // namespace gp
+} // namespace ou
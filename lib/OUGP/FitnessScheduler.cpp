@@ -0,0 +1,172 @@
+/************************************************************************
+ * Copyright(c) 2012, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#include <cassert>
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/unordered_set.hpp>
+
+#include "FitnessScheduler.h"
+
+namespace ou { // One Unified
+namespace gp { // genetic programming
+
+bool FitnessScheduler::Control::Continue( double dblFitnessSoFar, double dblProgress ) const {
+  if ( m_scheduler.m_bAbandonEnabled ) {
+    if ( ( m_scheduler.m_dblAbandonMinProgress <= dblProgress ) && ( m_scheduler.m_dblAbandonFitness > dblFitnessSoFar ) ) {
+      m_bAbandoned = true;
+    }
+  }
+  return !m_bAbandoned;
+}
+
+FitnessScheduler::FitnessScheduler( unsigned int nThreads )
+  : m_nThreads( nThreads ), m_pWork( 0 ), m_cntOutstanding( 0 ),
+  m_bAbandonEnabled( false ), m_dblAbandonFitness( 0.0 ), m_dblAbandonMinProgress( 1.0 ),
+  m_cntEvaluated( 0 ), m_cntCacheHits( 0 ), m_cntAbandoned( 0 ), m_cntFailed( 0 )
+{
+  if ( 0 == m_nThreads ) {
+    m_nThreads = boost::thread::hardware_concurrency();
+    if ( 0 == m_nThreads ) m_nThreads = 1;  // not determinable
+  }
+  m_pWork = new boost::asio::io_service::work( m_srvc );  // keep things running while real work arrives
+  for ( unsigned int ix = 0; ix < m_nThreads; ++ix ) {
+    m_threads.create_thread( boost::bind( &boost::asio::io_service::run, &m_srvc ) );
+  }
+}
+
+FitnessScheduler::~FitnessScheduler( void ) {
+  delete m_pWork;
+  m_pWork = 0;
+  m_threads.join_all();
+}
+
+void FitnessScheduler::SetAbandonThreshold( double dblFitness, double dblMinProgress ) {
+  m_dblAbandonFitness = dblFitness;
+  m_dblAbandonMinProgress = dblMinProgress;
+  m_bAbandonEnabled = true;
+}
+
+void FitnessScheduler::Evaluate( vGeneration_t& generation, fPrepare_t fPrepare ) {
+
+  typedef boost::unordered_set<key_t> setKey_t;
+  setKey_t setQueued;  // keys submitted during this generation
+  vDuplicates_t vDuplicates;
+
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    m_mapGeneration.clear();
+  }
+
+  for ( vGeneration_t::iterator iter = generation.begin(); generation.end() != iter; ++iter ) {
+    Individual& ind( *iter );
+    if ( ind.IsComputed() ) continue;  // carried over from the prior generation
+    ind.SetComputed();
+
+    pEvaluation_t pEvaluation = fPrepare( ind );
+    key_t key( pEvaluation->Key() );
+
+    bool bCached( false );
+    {
+      boost::mutex::scoped_lock lock( m_mutex );
+      mapFitness_t::const_iterator iterFitness = m_mapFitness.find( key );
+      if ( m_mapFitness.end() != iterFitness ) {
+        ind.m_dblRawFitness = iterFitness->second;
+        ++m_cntCacheHits;
+        bCached = true;
+      }
+      else {
+        if ( setQueued.end() != setQueued.find( key ) ) {
+          vDuplicates.push_back( vDuplicates_t::value_type( &ind, key ) );  // filled in once the first completes
+          ++m_cntCacheHits;
+          bCached = true;
+        }
+      }
+    }
+
+    if ( !bCached ) {
+      pEvaluation->Build();  // on this thread, and only for what is to be run
+      setQueued.insert( key );
+      boost::mutex::scoped_lock lock( m_mutex );
+      ++m_cntOutstanding;
+      m_srvc.post( boost::bind( &FitnessScheduler::Run, this, &ind, key, pEvaluation ) );
+    }
+  }
+
+  boost::mutex::scoped_lock lock( m_mutex );
+  while ( 0 != m_cntOutstanding ) {
+    m_cvDone.wait( lock );
+  }
+
+  for ( vDuplicates_t::iterator iter = vDuplicates.begin(); vDuplicates.end() != iter; ++iter ) {
+    mapFitness_t::const_iterator iterFitness = m_mapGeneration.find( iter->second );
+    assert( m_mapGeneration.end() != iterFitness );
+    iter->first->m_dblRawFitness = iterFitness->second;
+    if ( m_mapFitness.end() == m_mapFitness.find( iter->second ) ) {
+      iter->first->SetComputed( false );  // shares the partial fitness, so is re-evaluated with the next generation
+    }
+  }
+}
+
+void FitnessScheduler::Run( Individual* pIndividual, key_t key, pEvaluation_t pEvaluation ) {
+
+  Control control( *this );
+  double dblFitness;
+  bool bFailed( false );
+  try {
+    dblFitness = pEvaluation->Run( control );
+  }
+  catch ( std::exception& e ) {
+    std::cout << "FitnessScheduler::Run " << key << " failed: " << e.what() << std::endl;
+    bFailed = true;
+  }
+  catch ( ... ) {
+    std::cout << "FitnessScheduler::Run " << key << " failed" << std::endl;
+    bFailed = true;
+  }
+  if ( bFailed ) {
+    dblFitness = -std::numeric_limits<double>::max();  // ranks last, CalcFitness gives it no adjusted fitness
+  }
+  pIndividual->m_dblRawFitness = dblFitness;
+
+  boost::mutex::scoped_lock lock( m_mutex );
+  // an abandoned individual keeps its fitness at abandonment for this generation, it was already below the threshold,
+  //   but the fitness is partial, and the threshold may be lower in a later generation, so is not cached,
+  //   and is not carried over as computed
+  m_mapGeneration[ key ] = dblFitness;
+  if ( bFailed ) {
+    ++m_cntFailed;
+    pIndividual->SetComputed( false );
+  }
+  else {
+    if ( control.m_bAbandoned ) {
+      ++m_cntAbandoned;
+      pIndividual->SetComputed( false );
+    }
+    else {
+      m_mapFitness[ key ] = dblFitness;
+    }
+  }
+  ++m_cntEvaluated;
+  --m_cntOutstanding;
+  if ( 0 == m_cntOutstanding ) {
+    m_cvDone.notify_all();
+  }
+}
+
+} // namespace gp
+} // namespace ou
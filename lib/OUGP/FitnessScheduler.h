@@ -0,0 +1,125 @@
+/************************************************************************
+ * Copyright(c) 2012, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// runs the fitness evaluations of a generation:
+//   a persistent pool of threads, sized to the machine, is kept across generations,
+//     individuals are queued individually so idle threads pick up the next available evaluation
+//   fitness is cached by the canonical hash of the trees (CompiledSignals::Hash), so an individual
+//     re-created by crossover or reproduction with trees matching a prior individual is not re-run
+//   an evaluation reports progress through Control, and can be abandoned part way through
+//     when it is clearly below the threshold set from the prior generation, an abandoned
+//     fitness is partial, so is used for the generation, but is not cached
+
+// Prepare is called synchronously for each individual, on the calling thread, and returns its Evaluation,
+//   which is to be cheap to construct, with its Key available (time series are only available after PreProcess).
+//   Build is then called, also synchronously, only when the key is not already known, and
+//   Run is called on a pool thread, returning the raw fitness.
+
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/thread.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "Individual.h"
+
+namespace ou { // One Unified
+namespace gp { // genetic programming
+
+class FitnessScheduler {
+public:
+
+  typedef std::vector<Individual> vGeneration_t;
+
+  class Control {
+    friend class FitnessScheduler;
+  public:
+    // called periodically by the evaluation, false indicates evaluation should be abandoned
+    //   dblProgress: 0.0 to 1.0 through the replay
+    bool Continue( double dblFitnessSoFar, double dblProgress ) const;
+  protected:
+  private:
+    Control( const FitnessScheduler& scheduler ): m_scheduler( scheduler ), m_bAbandoned( false ) {};
+    const FitnessScheduler& m_scheduler;
+    mutable bool m_bAbandoned;
+  };
+
+  typedef boost::uint64_t key_t;
+
+  class Evaluation {
+  public:
+    virtual ~Evaluation( void ) {};
+    virtual key_t Key( void ) const = 0;  // canonical hash of the individual's trees
+    virtual void Build( void ) = 0;  // the setup for Run, skipped when the key is cached
+    virtual double Run( const Control& control ) = 0;  // raw fitness
+  };
+  typedef boost::shared_ptr<Evaluation> pEvaluation_t;
+
+  typedef boost::function<pEvaluation_t( Individual& )> fPrepare_t;
+
+  FitnessScheduler( unsigned int nThreads = 0 );  // 0 uses hardware concurrency
+  ~FitnessScheduler( void );
+
+  void Evaluate( vGeneration_t& generation, fPrepare_t fPrepare );  // returns when all have been evaluated
+
+  // no abandonment until dblMinProgress, and then only if below dblFitness
+  void SetAbandonThreshold( double dblFitness, double dblMinProgress = 0.5 );
+  void ClearAbandonThreshold( void ) { m_bAbandonEnabled = false; };
+
+  unsigned int Threads( void ) const { return m_nThreads; };
+
+  size_t CountEvaluated( void ) const { return m_cntEvaluated; };
+  size_t CountCacheHits( void ) const { return m_cntCacheHits; };
+  size_t CountAbandoned( void ) const { return m_cntAbandoned; };
+  size_t CountFailed( void ) const { return m_cntFailed; };  // evaluations which threw
+
+protected:
+private:
+
+  typedef boost::unordered_map<key_t,double> mapFitness_t;  // canonical hash, raw fitness
+  typedef std::vector<std::pair<Individual*,key_t> > vDuplicates_t;  // matches an evaluation in progress
+
+  unsigned int m_nThreads;
+
+  boost::asio::io_service m_srvc;
+  boost::asio::io_service::work* m_pWork;
+  boost::thread_group m_threads;
+
+  boost::mutex m_mutex;
+  boost::condition_variable m_cvDone;
+  size_t m_cntOutstanding;
+
+  mapFitness_t m_mapFitness;  // completed evaluations
+  mapFitness_t m_mapGeneration;  // evaluations of the current generation, completed or abandoned
+
+  volatile bool m_bAbandonEnabled;
+  double m_dblAbandonFitness;
+  double m_dblAbandonMinProgress;
+
+  size_t m_cntEvaluated;
+  size_t m_cntCacheHits;
+  size_t m_cntAbandoned;
+  size_t m_cntFailed;
+
+  void Run( Individual* pIndividual, key_t key, pEvaluation_t pEvaluation );
+
+};
+
+} // namespace gp
+} // namespace ou
@@ -42,6 +42,7 @@ public:
   ~NodeDoubleRandom( void );
   void ToString( std::stringstream& ss ) const { ss << m_val; };
   double EvaluateDouble( void );
+  double Value( void ) const { return m_val; };
 protected:
 private:
   double m_val;
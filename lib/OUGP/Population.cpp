@@ -367,6 +367,10 @@ bool Population::CrossOver( pRootNode_t& rn1, pRootNode_t& rn2 ) {
   return bSuccessful;
 }
 
+void Population::EvaluateGeneration( FitnessScheduler::fPrepare_t fPrepare ) {
+  m_scheduler.Evaluate( *m_pvCurGeneration, fPrepare );
+}
+
 void Population::CalcFitness( void ) {
   double dblMax( 0.0 );
   double dblMin( 0.0 );
@@ -401,6 +405,11 @@ void Population::CalcFitness( void ) {
   vGeneration_t& gen( *m_pvCurGeneration );
 
   std::sort( gen.begin(), gen.end(), arg1 > arg2 );
+
+  // next generation's evaluations can be abandoned when losing and already below the above average set
+  if ( m_cntAboveAverage < gen.size() ) {
+    m_scheduler.SetAbandonThreshold( std::min<double>( 0.0, gen[ m_cntAboveAverage ].m_dblRawFitness ) );
+  }
 }
 
 } // namespace gp
@@ -22,6 +22,7 @@
 
 #include "TreeBuilder.h"
 #include "Individual.h"
+#include "FitnessScheduler.h"
 
 namespace ou { // One Unified
 namespace gp { // genetic programming
@@ -48,8 +49,11 @@ public:
   const vGeneration_t& CurrentGeneration( void ) { return *m_pvCurGeneration; };
 
   bool MakeNewGeneration( void );
+  void EvaluateGeneration( FitnessScheduler::fPrepare_t fPrepare );  // raw fitness of current generation, in parallel
   void CalcFitness( void );
 
+  const FitnessScheduler& Scheduler( void ) const { return m_scheduler; };
+
 protected:
 private:
 
@@ -91,6 +95,8 @@ private:
 
   TreeBuilder m_tb;
 
+  FitnessScheduler m_scheduler;
+
   void BuildIndividuals( vGeneration_t& vGeneration );
   unsigned int TournamentSelection( unsigned int cntAboveAverage );
   bool IsMatchInGeneration( const Individual&, const vGeneration_t&, vGeneration_t::size_type ixMax );
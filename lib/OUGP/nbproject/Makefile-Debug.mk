@@ -35,6 +35,8 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
+	${OBJECTDIR}/CompiledSignals.o \
+	${OBJECTDIR}/FitnessScheduler.o \
 	${OBJECTDIR}/Individual.o \
 	${OBJECTDIR}/Node.o \
 	${OBJECTDIR}/NodeBoolean.o \
@@ -71,6 +73,16 @@ ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libougp.a: ${OBJECTFILES}
 	${AR} -rv ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libougp.a ${OBJECTFILES} 
 	$(RANLIB) ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libougp.a
 
+${OBJECTDIR}/CompiledSignals.o: CompiledSignals.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/CompiledSignals.o CompiledSignals.cpp
+
+${OBJECTDIR}/FitnessScheduler.o: FitnessScheduler.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/FitnessScheduler.o FitnessScheduler.cpp
+
 ${OBJECTDIR}/Individual.o: Individual.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -37,6 +37,7 @@ public:
   void Close( void );
 
   bool IsOpen( void ) { return m_bOpened; }
+  const std::string& DbFileName( void ) const { return m_sDbFileName; }  // as opened, for a second connection
 
 protected:
 
@@ -69,6 +70,7 @@ template<class S, class T>
 void SessionBase<S,T>::Open( const std::string& sDbFileName, enumOpenFlags flags ) {
 
   if ( !m_bOpened ) {
+    m_sDbFileName = sDbFileName;
     if ( boost::filesystem::exists( sDbFileName ) ) {
       // open already created and loaded database
       dynamic_cast<S*>( this )->ImplOpen( sDbFileName, flags );
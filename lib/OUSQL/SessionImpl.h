@@ -21,7 +21,7 @@
 // 2011-01-30
 // need to work on:
 //   getting key back when inserting new record with auto-increment
-//   adding transactions with rollback and commit
+//   adding transactions with rollback and commit (BeginTransaction, CommitTransaction, RollbackTransaction)
 
 // OUSqlite Library
 // was going to be pimpl, but couldn't, as templates are in use, no 'export' keyword
@@ -38,6 +38,8 @@
 // independently of a supplied structure.  A new structure may be required on each execution of the statement.
 // Currently, the same physical structure needs to be re-used.  Structure is provided during statement construction,
 // not necessarily a good thing all the time.
+// QueryFields can now be re-pointed at a new structure, which SQLCached/InsertCached/UpdateCached use
+// to keep one prepared statement per query text and type, re-bound on each execution.
 
 
 #include <string>
@@ -45,6 +47,7 @@
 #include <vector>
 #include <stdexcept>
 #include <typeinfo>
+#include <cassert>
 
 #include <boost/cstdint.hpp>
 #include <boost/intrusive_ptr.hpp>
@@ -61,7 +64,7 @@ namespace db {
 // will need to figure out a better way to handle this
 struct NoBind {
   template<class A>
-  void Fields( A& a ) { };
+  void Fields( A& /* a */ ) { };
 };
 
 // CQuery contains:
@@ -116,12 +119,14 @@ class QueryFields:
 {
 public:
   typedef boost::intrusive_ptr<QueryFields<F> > pQueryFields_t;
-  explicit QueryFields( F& f ): QueryBase(), var( f ) {};
+  explicit QueryFields( F& f ): QueryBase(), m_pVar( &f ) {};
   ~QueryFields( void ) {};
-  F& var;  // 2011/03/07  I want to make this a reference to a constant var at some point
+  F& Var( void ) { return *m_pVar; };  // 2011/03/07  I want to make this a reference to a constant var at some point
    // will require mods to Bind, and will need Fields( A& a ) const, hopefully will work with the Actions passed in
+  void Rebind( F& f ) { m_pVar = &f; };  // a cached statement is bound to the caller's structure on each use
 protected:
 private:
+  F* m_pVar;
 };
 
 // =====
@@ -266,6 +271,7 @@ public:
   void CreateTables( void );
 
   boost::int64_t GetLastRowId( void ) { return m_db.GetLastRowId(); };
+  bool IsBusy( void ) { return m_db.IsBusy(); };  // the last failure may succeed on a retry
 
   template<class F>
   void Bind( QueryFields<F>& qf ) {
@@ -276,7 +282,7 @@ public:
       qf.SetPrepared();
     }
     typename IDatabase::Action_Bind_Values action( StatementState );
-    qf.var.Fields( action );
+    qf.Var().Fields( action );
   }
 
   template<class F>
@@ -284,7 +290,7 @@ public:
     Bind( *pQuery.get() );
   }
 
-  void Bind( QueryFields<NoBind>& qf ) {
+  void Bind( QueryFields<NoBind>& /* qf */ ) {
   }
 
   bool Execute( QueryBase& qb ) {
@@ -392,6 +398,101 @@ public:
     return SQL( sSqlQuery, f );
   }
 
+  // cached variants:  the statement is prepared on first use of the query text with the type F,
+  //   and is reset, re-bound to f, and executed on subsequent uses, for statements issued repeatedly.
+  //   sSqlQuery is the complete statement, including any where clause.
+  //   f is only referenced during the call.
+  template<class F>
+  typename QueryFields<F>::pQueryFields_t SQLCached( const std::string& sSqlQuery, F& f ) {
+    typedef QueryState<typename IDatabase::structStatementState, F, session_t> query_t;
+    std::string sKey( typeid( F ).name() );
+    sKey += ':' + sSqlQuery;
+    query_t* pQuery = LookupCached<query_t>( sKey, f );
+    if ( 0 == pQuery ) {
+      pQuery = new query_t( *this, f );
+      Action_Compose action;
+      f.Fields( action );
+      if ( 0 < action.FieldCount() ) pQuery->SetHasFields();
+      pQuery->UpdateQueryText() = sSqlQuery;
+      m_mapCachedQueries.insert( mapCachedQueries_pair_t( sKey, pQuery ) );
+    }
+    return ExecuteCached( *pQuery );
+  }
+
+  template<class F>
+  typename QueryFields<F>::pQueryFields_t InsertCached( F& f ) {
+    return ComposeSqlCached<F, typename IDatabase::Action_Compose_Insert>( f );
+  }
+
+  template<class F>
+  typename QueryFields<F>::pQueryFields_t UpdateCached( F& f ) {
+    return ComposeSqlCached<F, typename IDatabase::Action_Compose_Update>( f );
+  }
+
+  void BeginTransaction( void ) {
+    NoBind nb;
+    SQLCached<NoBind>( "begin transaction", nb );
+  }
+
+  void CommitTransaction( void ) {
+    NoBind nb;
+    SQLCached<NoBind>( "commit", nb );
+  }
+
+  void RollbackTransaction( void ) {
+    NoBind nb;
+    SQLCached<NoBind>( "rollback", nb );
+  }
+
+  // inserts each row of [begin, end), which dereference to F, through one prepared statement,
+  //   committing every nRowsPerTransaction rows, with database durability relaxed for the duration (IDatabase::BeginBulk).
+  //   On an exception, the open transaction is rolled back and the exception is re-thrown:  prior transactions remain.
+  //   Returns the number of rows inserted.
+  template<class F, class Iterator>
+  size_t BulkInsert( Iterator begin, Iterator end, size_t nRowsPerTransaction = 10000 ) {
+    assert( 0 < nRowsPerTransaction );
+    size_t cntRows( 0 );
+    bool bInTransaction( false );
+    m_db.BeginBulk();
+    try {
+      while ( end != begin ) {
+        BeginTransaction();
+        bInTransaction = true;
+        size_t cnt( 0 );
+        for ( ; ( end != begin ) && ( nRowsPerTransaction > cnt ); ++begin, ++cnt ) {
+          InsertCached<F>( const_cast<F&>( static_cast<const F&>( *begin ) ) );
+        }
+        CommitTransaction();
+        bInTransaction = false;
+        cntRows += cnt;
+      }
+    }
+    catch (...) {
+      if ( bInTransaction ) {
+        try {
+          RollbackTransaction();
+        }
+        catch (...) {
+          // sqlite will have already rolled back on some errors
+        }
+      }
+      try {
+        m_db.EndBulk();
+      }
+      catch (...) {
+        // the original exception is the one to report
+      }
+      throw;
+    }
+    m_db.EndBulk();
+    return cntRows;
+  }
+
+  template<class F, class Range>
+  size_t BulkInsert( const Range& range, size_t nRowsPerTransaction = 10000 ) {
+    return BulkInsert<F>( range.begin(), range.end(), nRowsPerTransaction );
+  }
+
   template<class F>
   void MapRowDefToTableName( const std::string& sTableName ) {
     std::string sF( typeid( F ).name() );
@@ -438,6 +539,60 @@ protected:
     return *pQuery;
   }
 
+  template<class F, class Action>
+  typename QueryFields<F>::pQueryFields_t ComposeSqlCached( F& f ) {
+    typedef QueryState<typename IDatabase::structStatementState, F, session_t> query_t;
+    std::string sKey( typeid( F ).name() );
+    sKey += ':';
+    sKey += typeid( Action ).name();
+    query_t* pQuery = LookupCached<query_t>( sKey, f );
+    if ( 0 == pQuery ) {
+      pQuery = new query_t( *this, f );
+      Action action( GetTableName<F>() );
+      f.Fields( action );
+      if ( 0 < action.FieldCount() ) pQuery->SetHasFields();
+      action.ComposeStatement( pQuery->UpdateQueryText() );
+      m_mapCachedQueries.insert( mapCachedQueries_pair_t( sKey, pQuery ) );
+    }
+    return ExecuteCached( *pQuery );
+  }
+
+  // cached query for the key, reset and re-pointed at f, or 0 when not yet prepared, or when the reset failed:
+  //   the failed statement is closed and dropped from the cache, so the caller prepares it afresh
+  template<class Q, class F>
+  Q* LookupCached( const std::string& sKey, F& f ) {
+    mapCachedQueries_iter_t iter = m_mapCachedQueries.find( sKey );
+    if ( m_mapCachedQueries.end() == iter ) {
+      return 0;
+    }
+    Q* pQuery = dynamic_cast<Q*>( iter->second.get() );
+    assert( 0 != pQuery );
+    try {
+      m_db.ResetStatement( *pQuery );
+    }
+    catch ( std::runtime_error& ) {
+      try {
+        m_db.CloseStatement( *pQuery );
+      }
+      catch ( std::runtime_error& ) {
+        // finalize reports the same error, the statement is released regardless
+      }
+      m_mapCachedQueries.erase( iter );
+      return 0;
+    }
+    pQuery->Rebind( f );
+    return pQuery;
+  }
+
+  template<class F>
+  typename QueryFields<F>::pQueryFields_t ExecuteCached( QueryFields<F>& qf ) {
+    if ( qf.HasFields() ) {
+      Bind( qf );
+    }
+    Execute( qf );
+    return typename QueryFields<F>::pQueryFields_t( &qf );
+  }
+
 private:
 
   bool m_bOpened;
@@ -459,6 +614,11 @@ private:
   // in one application there are 32,000 queries, and none are closed,
   // resulting in very long times to reclaim space at the end
 
+  typedef std::map<std::string, pQueryBase_t> mapCachedQueries_t;  // type and query text, prepared statement
+  typedef typename mapCachedQueries_t::iterator mapCachedQueries_iter_t;
+  typedef std::pair<std::string, pQueryBase_t> mapCachedQueries_pair_t;
+  mapCachedQueries_t m_mapCachedQueries;
+
   typedef std::map<std::string, std::string> mapFieldsToTable_t;
   typedef mapFieldsToTable_t::iterator mapFieldsToTable_iter_t;
   typedef std::pair<std::string, std::string> mapFieldsToTable_pair_t;
@@ -500,6 +660,10 @@ void SessionImpl<IDatabase>::ImplClose( void ) {
       iter->reset();
     }
     m_vQuery.clear();
+    for ( mapCachedQueries_iter_t iter = m_mapCachedQueries.begin(); iter != m_mapCachedQueries.end(); ++iter ) {
+      m_db.CloseStatement( *dynamic_cast<typename IDatabase::structStatementState*>( iter->second.get() ) );
+    }
+    m_mapCachedQueries.clear();
     m_db.SessionClose();
     m_bOpened = false;
     // 2013/08/26 process memory doesn't appear to be relaimed after this
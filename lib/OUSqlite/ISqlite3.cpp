@@ -42,6 +42,9 @@ void ISqlite3::SessionOpen( const std::string& sDbFileName, enumOpenFlags flags
     throw std::runtime_error( "Db open error" );
   }
 
+  // wait on, rather than fail with, a lock held by another connection, such as the OrderManager journal's
+  sqlite3_busy_timeout( m_db, 5000 );
+
 }
 
 void ISqlite3::SessionClose( void ) {
@@ -134,6 +137,37 @@ void ISqlite3::ResetStatement( structStatementState& statement ) {
   }
 }
 
+std::string ISqlite3::Pragma( const std::string& sPragma ) {
+  std::string sResult;
+  sqlite3_stmt* pStmt( 0 );
+  int rtn = sqlite3_prepare_v2( m_db, sPragma.c_str(), -1, &pStmt, NULL );
+  if ( SQLITE_OK != rtn ) {
+    std::string sErr( "ISqlite3::Pragma: " );
+    sErr += " error in prepare(";
+    sErr += boost::lexical_cast<std::string>( rtn );
+    sErr += ")";
+    throw std::runtime_error( sErr );
+  }
+  if ( SQLITE_ROW == sqlite3_step( pStmt ) ) {
+    const unsigned char* p = sqlite3_column_text( pStmt, 0 );
+    if ( 0 != p ) sResult = reinterpret_cast<const char*>( p );
+  }
+  sqlite3_finalize( pStmt );
+  return sResult;
+}
+
+void ISqlite3::BeginBulk( void ) {
+  m_sSynchronous = Pragma( "pragma synchronous" );
+  Pragma( "pragma synchronous=normal" );  // off, or an in-memory journal, risk corrupting the database on a crash
+}
+
+void ISqlite3::EndBulk( void ) {
+  if ( !m_sSynchronous.empty() ) {
+    Pragma( "pragma synchronous=" + m_sSynchronous );
+    m_sSynchronous.clear();
+  }
+}
+
 void ISqlite3::CloseStatement( structStatementState& statement ) {
   if ( 0 != statement.pStmt ) { // it shouldn't be zero, but test anyway
     int rtn = sqlite3_finalize( statement.pStmt );
@@ -59,12 +59,28 @@ public:
     return sqlite3_last_insert_rowid( m_db );
   }
 
+  bool IsBusy( void ) {  // the last error was a lock held elsewhere, so a retry may succeed
+    int rtn = sqlite3_errcode( m_db );
+    return ( SQLITE_BUSY == rtn ) || ( SQLITE_LOCKED == rtn );
+  }
+
+  // relaxes durability for the duration of a bulk load:  synchronous=normal, so fewer syncs to disk per commit.
+  //   The journal stays on disk, so a crash rolls back an incomplete transaction, but a power loss may lose
+  //   the most recent commits.  The pragma is connection wide:  it applies to every write on this connection
+  //   until EndBulk, which restores the setting in effect at BeginBulk.
+  void BeginBulk( void );
+  void EndBulk( void );
+
 protected:
 
 private:
 
   sqlite3* m_db;
 
+  std::string m_sSynchronous;  // saved by BeginBulk
+
+  std::string Pragma( const std::string& sPragma );  // returns the first column of the first row, if any
+
 };
 
 } // db
@@ -34,7 +34,7 @@ ReturnMatrix OLSError(Matrix& x,Matrix& y,ColumnVector& beta,int df) {
   return diag;
 }
 
-void adfTest(double* x,int obs,int k,double* dfs,double* pv) {
+double adfPValue(double tStatistic,int rows) {
   double xAxis[8]={
     0.01,0.025,0.05,0.1,0.9,0.95,0.975,0.99
   };
@@ -50,34 +50,9 @@ void adfTest(double* x,int obs,int k,double* dfs,double* pv) {
     -3.96,-3.66,-3.41,-3.12,-1.25,-0.94,-0.66,-0.33,
   };
 
-  int lags=k+1;
-  int cols=(lags-1)+3;
-  int rows=obs-lags;
-
-  Matrix xMat(rows,cols);
-  ColumnVector yMat(rows);
-
-  double* delta=new double[obs-1];
-  for(int i=0;i<(obs-1);i++)
-    delta[i]=x[i+1]-x[i];
-
-  xMat.Column(1)=1.0;
-  for(int i=0;i<rows;i++)
-  {
-    yMat(i+1)=delta[lags+i-1];
-    xMat(i+1,2)=x[lags+i-1];
-    xMat(i+1,3)=lags+i;
-    for(int j=1;j<lags;j++)
-      xMat(i+1,j+3)=delta[lags+i-j-1];
-  }
-
-  int df=rows-cols;
-  ColumnVector beta=OLS(xMat,yMat);
-  DiagonalMatrix stderror=OLSError(xMat,yMat,beta,df);
-
   int lx,ux;
-  double* zSection=new double[8];
-  Real yLookup=rows-1;
+  double zSection[8];
+  double yLookup=rows-1;
   GetNeighbourIndices(6,yAxis,yLookup,&lx,&ux);
   for(int i=0;i<8;i++)
   {
@@ -97,7 +72,6 @@ void adfTest(double* x,int obs,int k,double* dfs,double* pv) {
 
   int lz,uz;
   double pValue=0.0;
-  Real tStatistic=beta(2)/stderror(2);
   GetNeighbourIndices(8,zSection,tStatistic,&lz,&uz);
   if(lz==uz)
   {
@@ -112,9 +86,40 @@ void adfTest(double* x,int obs,int k,double* dfs,double* pv) {
     pValue=z1+(z2-z1)*((y-y1)/(y2-y1));
   }
 
+  return pValue;
+}
+
+void adfTest(double* x,int obs,int k,double* dfs,double* pv) {
+
+  int lags=k+1;
+  int cols=(lags-1)+3;
+  int rows=obs-lags;
+
+  Matrix xMat(rows,cols);
+  ColumnVector yMat(rows);
+
+  double* delta=new double[obs-1];
+  for(int i=0;i<(obs-1);i++)
+    delta[i]=x[i+1]-x[i];
+
+  xMat.Column(1)=1.0;
+  for(int i=0;i<rows;i++)
+  {
+    yMat(i+1)=delta[lags+i-1];
+    xMat(i+1,2)=x[lags+i-1];
+    xMat(i+1,3)=lags+i;
+    for(int j=1;j<lags;j++)
+      xMat(i+1,j+3)=delta[lags+i-j-1];
+  }
+
+  int df=rows-cols;
+  ColumnVector beta=OLS(xMat,yMat);
+  DiagonalMatrix stderror=OLSError(xMat,yMat,beta,df);
+
+  Real tStatistic=beta(2)/stderror(2);
+
   *dfs=tStatistic;
-  *pv=pValue;
-  delete[] zSection;
+  *pv=adfPValue(tStatistic,rows);
   delete[] delta;
 }
 
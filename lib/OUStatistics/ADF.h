@@ -2,3 +2,6 @@
 
 void adfTest(double* x, int obs, int k, double* dfs, double* pv);
 
+// p value of an adfTest t statistic, interpolated in its table of critical values by the rows regressed
+double adfPValue(double tStatistic, int rows);
+
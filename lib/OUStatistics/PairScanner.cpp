@@ -0,0 +1,309 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#include <math.h>
+
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "PairScanner.h"
+
+namespace ou { // One Unified
+
+namespace {
+
+  // sorts most negative first, and as a heap, keeps the least negative on top, the next to go
+  struct LessTStatistic {
+    bool operator()( const PairScanner::Result& lhs, const PairScanner::Result& rhs ) const {
+      return lhs.dblTStatistic < rhs.dblTStatistic;
+    }
+  };
+
+  // MacKinnon (2010), table 2, engle granger with two variables, constant and trend:
+  //   critical value = b0 + b1 / T + b2 / T^2 + b3 / T^3, for T observations in the regression
+  const double rEngleGranger1[] = { -4.32762, -15.4387, -35.679, 0.0 };
+  const double rEngleGranger5[] = { -3.78057, -9.5106, -12.074, 0.0 };
+  const double rEngleGranger10[] = { -3.49631, -7.0815, -7.538, 21.892 };
+
+  double EngleGrangerCritical( const double* b, double T ) {
+    return b[ 0 ] + b[ 1 ] / T + b[ 2 ] / ( T * T ) + b[ 3 ] / ( T * T * T );
+  }
+
+} // namespace anonymous
+
+struct PairScanner::Worker {
+
+  const PairScanner* pScanner;
+  const Options* pOptions;
+  boost::atomic<size_t>* pNextRow;
+  double dblCritical;  // pairs with a t statistic above are dropped
+
+  std::vector<double> vResidual;  // workspace
+  std::vector<double> vDelta;  // workspace
+  vResult_t vResult;
+  size_t nTests;
+
+  Worker( const PairScanner* pScanner_, const Options* pOptions_, boost::atomic<size_t>* pNextRow_, double dblCritical_ )
+    : pScanner( pScanner_ ), pOptions( pOptions_ ), pNextRow( pNextRow_ ), dblCritical( dblCritical_ ), nTests( 0 )
+  {
+    vResidual.resize( pScanner->m_nObservations );
+    vDelta.resize( pScanner->m_nObservations );
+    if ( 0 != pOptions->nTop ) vResult.reserve( pOptions->nTop + 1 );
+  }
+
+  void Run( void ) {
+    const size_t nSeries( pScanner->m_vName.size() );
+    while ( true ) {
+      size_t ixY( (*pNextRow)++ );
+      if ( nSeries <= ixY ) break;
+      for ( size_t ixX = ixY + 1; ixX < nSeries; ++ixX ) {
+        Result result;
+        bool bResult( Test( ixY, ixX, result ) );
+        if ( pOptions->bBothDirections ) {
+          Result reverse;
+          if ( Test( ixX, ixY, reverse ) ) {  // the pair once, in the direction with the more negative statistic
+            if ( !bResult || ( reverse.dblTStatistic < result.dblTStatistic ) ) result = reverse;
+            bResult = true;
+          }
+        }
+        if ( bResult ) Keep( result );
+      }
+    }
+  }
+
+  void Keep( const Result& result ) {
+    if ( dblCritical < result.dblTStatistic ) return;
+    if ( 0 == pOptions->nTop ) {
+      vResult.push_back( result );
+    }
+    else {
+      if ( ( pOptions->nTop == vResult.size() ) && ( vResult.front().dblTStatistic <= result.dblTStatistic ) ) return;
+      vResult.push_back( result );
+      std::push_heap( vResult.begin(), vResult.end(), LessTStatistic() );
+      if ( pOptions->nTop < vResult.size() ) {
+        std::pop_heap( vResult.begin(), vResult.end(), LessTStatistic() );
+        vResult.pop_back();
+      }
+    }
+  }
+
+  bool Test( size_t ixY, size_t ixX, Result& result );  // false when the residual is flat
+};
+
+bool PairScanner::Worker::Test( size_t ixY, size_t ixX, Result& result ) {
+
+  ++nTests;
+
+  const size_t nObs( pScanner->m_nObservations );
+  const double* y( &pScanner->m_vSeries[ ixY * nObs ] );
+  const double* x( &pScanner->m_vSeries[ ixX * nObs ] );
+
+  // hedge ratio, y = alpha + beta * x
+  const double dblMeanX( pScanner->m_vMean[ ixX ] );
+  double dblSxy( 0.0 );
+  for ( size_t ix = 0; ix < nObs; ++ix ) {
+    dblSxy += ( x[ ix ] - dblMeanX ) * y[ ix ];
+  }
+  result.ixY = ixY;
+  result.ixX = ixX;
+  result.dblBeta = dblSxy / pScanner->m_vSumSquares[ ixX ];
+  result.dblAlpha = pScanner->m_vMean[ ixY ] - result.dblBeta * dblMeanX;
+
+  double* e( &vResidual[ 0 ] );
+  for ( size_t ix = 0; ix < nObs; ++ix ) {
+    e[ ix ] = y[ ix ] - result.dblAlpha - result.dblBeta * x[ ix ];
+  }
+
+  // the regression of adfTest: delta e on a constant, the prior level, a trend, and k lagged deltas
+  const size_t lags( pOptions->nLags + 1 );
+  const size_t cols( pOptions->nLags + 3 );
+  const size_t rows( nObs - lags );
+
+  double* delta( &vDelta[ 0 ] );
+  for ( size_t ix = 0; ix < ( nObs - 1 ); ++ix ) {
+    delta[ ix ] = e[ ix + 1 ] - e[ ix ];
+  }
+
+  double XtX[ nMaxColumns * nMaxColumns ];  // lower triangle used
+  double Xty[ nMaxColumns ];
+  double yty( 0.0 );
+  for ( size_t a = 0; a < cols; ++a ) {
+    Xty[ a ] = 0.0;
+    for ( size_t b = 0; b <= a; ++b ) XtX[ a * cols + b ] = 0.0;
+  }
+  double r[ nMaxColumns ];
+  for ( size_t i = 0; i < rows; ++i ) {
+    const double dy( delta[ lags + i - 1 ] );
+    r[ 0 ] = 1.0;
+    r[ 1 ] = e[ lags + i - 1 ];
+    r[ 2 ] = static_cast<double>( lags + i );
+    for ( size_t j = 1; j < lags; ++j ) r[ j + 2 ] = delta[ lags + i - j - 1 ];
+    for ( size_t a = 0; a < cols; ++a ) {
+      Xty[ a ] += r[ a ] * dy;
+      for ( size_t b = 0; b <= a; ++b ) XtX[ a * cols + b ] += r[ a ] * r[ b ];
+    }
+    yty += dy * dy;
+  }
+
+  // cholesky, XtX = L L', in place
+  for ( size_t a = 0; a < cols; ++a ) {
+    for ( size_t b = 0; b <= a; ++b ) {
+      double sum( XtX[ a * cols + b ] );
+      for ( size_t c = 0; c < b; ++c ) sum -= XtX[ a * cols + c ] * XtX[ b * cols + c ];
+      if ( a == b ) {
+        if ( 0.0 >= sum ) return false;  // singular, a flat residual, nothing to test
+        XtX[ a * cols + a ] = sqrt( sum );
+      }
+      else {
+        XtX[ a * cols + b ] = sum / XtX[ b * cols + b ];
+      }
+    }
+  }
+
+  // coefficients, L z = X'y, L' b = z
+  double z[ nMaxColumns ];
+  for ( size_t a = 0; a < cols; ++a ) {
+    double sum( Xty[ a ] );
+    for ( size_t c = 0; c < a; ++c ) sum -= XtX[ a * cols + c ] * z[ c ];
+    z[ a ] = sum / XtX[ a * cols + a ];
+  }
+  double beta[ nMaxColumns ];
+  double zz( 0.0 );
+  for ( size_t a = cols; a-- > 0; ) {
+    double sum( z[ a ] );
+    for ( size_t c = a + 1; c < cols; ++c ) sum -= XtX[ c * cols + a ] * beta[ c ];
+    beta[ a ] = sum / XtX[ a * cols + a ];
+    zz += z[ a ] * z[ a ];
+  }
+
+  // residual sum of squares, y'y - b'X'y, which is y'y - z'z
+  const double rss( std::max<double>( yty - zz, 0.0 ) );
+  const double sigma2( rss / ( rows - cols ) );
+
+  // ( X'X )^-1 at the level's coefficient is | L^-1 e1 |^2
+  double w[ nMaxColumns ];
+  double dblInverse( 0.0 );
+  for ( size_t a = 1; a < cols; ++a ) {
+    double sum( ( 1 == a ) ? 1.0 : 0.0 );
+    for ( size_t c = 1; c < a; ++c ) sum -= XtX[ a * cols + c ] * w[ c ];
+    w[ a ] = sum / XtX[ a * cols + a ];
+    dblInverse += w[ a ] * w[ a ];
+  }
+
+  const double dblStdError( sqrt( sigma2 * dblInverse ) );
+  if ( 0.0 >= dblStdError ) return false;
+  result.dblTStatistic = beta[ 1 ] / dblStdError;
+  result.dblHalfLife = ( ( -1.0 < beta[ 1 ] ) && ( 0.0 > beta[ 1 ] ) ) ? -log( 2.0 ) / log( 1.0 + beta[ 1 ] ) : 0.0;
+
+  return true;
+}
+
+PairScanner::PairScanner( size_t nObservations )
+  : m_nObservations( nObservations )
+{
+}
+
+void PairScanner::Add( const std::string& sName, const double* pClose ) {
+  m_vName.push_back( sName );
+  m_vClose.insert( m_vClose.end(), pClose, pClose + m_nObservations );
+}
+
+PairScanner::Stats PairScanner::Scan( const Options& options, vResult_t& vResult ) {
+
+  boost::posix_time::ptime dtStart( boost::posix_time::microsec_clock::universal_time() );
+
+  vResult.clear();
+  Stats stats;
+  stats.nSeries = m_vName.size();
+
+  if ( nMaxColumns < ( options.nLags + 3 ) ) throw std::runtime_error( "PairScanner::Scan: too many lags" );
+  if ( m_nObservations <= ( 2 * options.nLags + 4 ) ) throw std::runtime_error( "PairScanner::Scan: too few observations for the lags" );
+
+  // the rows of each adf regression
+  const double T( static_cast<double>( m_nObservations - options.nLags - 1 ) );
+  stats.dblCritical1 = EngleGrangerCritical( rEngleGranger1, T );
+  stats.dblCritical5 = EngleGrangerCritical( rEngleGranger5, T );
+  stats.dblCritical10 = EngleGrangerCritical( rEngleGranger10, T );
+  double dblCritical( std::numeric_limits<double>::max() );
+  if ( 0.0 != options.dblSignificance ) {
+    if ( 0.01 == options.dblSignificance ) dblCritical = stats.dblCritical1;
+    else if ( 0.05 == options.dblSignificance ) dblCritical = stats.dblCritical5;
+    else if ( 0.10 == options.dblSignificance ) dblCritical = stats.dblCritical10;
+    else throw std::runtime_error( "PairScanner::Scan: dblSignificance is to be 0.01, 0.05 or 0.10" );
+  }
+
+  // the series as fitted, and what the hedge ratio needs of each, once, rather than once per pair
+  m_vSeries.resize( m_vClose.size() );
+  m_vMean.resize( m_vName.size() );
+  m_vSumSquares.resize( m_vName.size() );
+  for ( size_t ixSeries = 0; ixSeries < m_vName.size(); ++ixSeries ) {
+    const double* pClose( &m_vClose[ ixSeries * m_nObservations ] );
+    double* pSeries( &m_vSeries[ ixSeries * m_nObservations ] );
+    double dblSum( 0.0 );
+    for ( size_t ix = 0; ix < m_nObservations; ++ix ) {
+      if ( options.bLogPrices ) {
+        if ( 0.0 >= pClose[ ix ] ) throw std::runtime_error( "PairScanner::Scan: " + m_vName[ ixSeries ] + " has a price not above 0" );
+        pSeries[ ix ] = log( pClose[ ix ] );
+      }
+      else {
+        pSeries[ ix ] = pClose[ ix ];
+      }
+      dblSum += pSeries[ ix ];
+    }
+    const double dblMean( dblSum / m_nObservations );
+    double dblSumSquares( 0.0 );
+    for ( size_t ix = 0; ix < m_nObservations; ++ix ) {
+      dblSumSquares += ( pSeries[ ix ] - dblMean ) * ( pSeries[ ix ] - dblMean );
+    }
+    m_vMean[ ixSeries ] = dblMean;
+    m_vSumSquares[ ixSeries ] = ( 0.0 == dblSumSquares ) ? 1.0 : dblSumSquares;  // a flat series fits with beta of 0
+  }
+
+  unsigned int nThreads( options.nThreads );
+  if ( 0 == nThreads ) {
+    nThreads = boost::thread::hardware_concurrency();
+    if ( 0 == nThreads ) nThreads = 1;  // not determinable
+  }
+
+  boost::atomic<size_t> nNextRow( 0 );
+  std::vector<Worker> vWorker( nThreads, Worker( this, &options, &nNextRow, dblCritical ) );
+  if ( 1 == nThreads ) {
+    vWorker[ 0 ].Run();
+  }
+  else {
+    boost::thread_group threads;
+    for ( std::vector<Worker>::iterator iter = vWorker.begin(); vWorker.end() != iter; ++iter ) {
+      threads.create_thread( boost::bind( &Worker::Run, &( *iter ) ) );
+    }
+    threads.join_all();
+  }
+
+  for ( std::vector<Worker>::const_iterator iter = vWorker.begin(); vWorker.end() != iter; ++iter ) {
+    vResult.insert( vResult.end(), iter->vResult.begin(), iter->vResult.end() );
+    stats.nTests += iter->nTests;
+  }
+  std::sort( vResult.begin(), vResult.end(), LessTStatistic() );
+  if ( ( 0 != options.nTop ) && ( options.nTop < vResult.size() ) ) vResult.resize( options.nTop );
+
+  stats.tdElapsed = boost::posix_time::microsec_clock::universal_time() - dtStart;
+  return stats;
+}
+
+} // namespace ou
@@ -0,0 +1,111 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// engle granger style scan for cointegrated pairs over a universe of aligned closes:
+//   for each pair, the hedge ratio is the least squares fit of y = alpha + beta * x,
+//     then the residual gets the same augmented dickey fuller regression as adfTest (ADF.h),
+//     constant, trend and k lagged differences, with its t statistic
+//   the t statistic ranks the pairs, the more negative, the more the spread reverts
+//   the residual was fitted, so adfTest's critical values, for a series, are optimistic:  the statistic is
+//     compared with engle granger critical values instead, MacKinnon's (2010) response surface for two variables,
+//     with constant and trend, at the scan's sample size, in Stats, and used by dblSignificance
+//   the regressions are solved from their normal equations, with a cholesky factor, in workspaces
+//     kept by each thread, so a test allocates nothing, and costs O( observations * ( k + 3 )^2 )
+//   rows of the pair triangle are handed out to the threads as they finish the prior one
+
+// usage:
+//   PairScanner scanner( 250 );
+//   scanner.Add( "GLD", vGld.data() );  // ... for each symbol, closes aligned by date, oldest first
+//   PairScanner::vResult_t vResult;
+//   PairScanner::Stats stats = scanner.Scan( PairScanner::Options(), vResult );
+//   scanner.Name( vResult[ 0 ].ixY ), scanner.Name( vResult[ 0 ].ixX ) ...
+
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace ou { // One Unified
+
+class PairScanner {
+public:
+
+  struct Options {
+    unsigned int nLags;  // k of adfTest, lagged differences in the regression
+    bool bLogPrices;  // fit log prices, the hedge ratio is then in value rather than in shares
+    bool bBothDirections;  // fit each pair both ways, keeping the more negative
+    size_t nTop;  // pairs kept, 0 for all
+    double dblSignificance;  // 0.01, 0.05 or 0.10, pairs not cointegrated at the level are dropped, 0 keeps all
+    unsigned int nThreads;  // 0 for a thread per core
+    Options( void )
+      : nLags( 1 ), bLogPrices( true ), bBothDirections( false ), nTop( 100 ), dblSignificance( 0.0 ), nThreads( 0 ) {};
+  };
+
+  struct Result {
+    size_t ixY;  // dependent
+    size_t ixX;  // independent
+    double dblAlpha;
+    double dblBeta;  // hedge ratio
+    double dblTStatistic;
+    double dblHalfLife;  // observations for the spread to revert half way, 0 when it does not revert
+  };
+  typedef std::vector<Result> vResult_t;
+
+  struct Stats {
+    size_t nSeries;
+    size_t nTests;
+    double dblCritical1;  // engle granger critical values of the t statistic, at 1%, 5% and 10%
+    double dblCritical5;
+    double dblCritical10;
+    boost::posix_time::time_duration tdElapsed;
+    Stats( void ): nSeries( 0 ), nTests( 0 ), dblCritical1( 0.0 ), dblCritical5( 0.0 ), dblCritical10( 0.0 ) {};
+    double TestsPerSecond( void ) const {
+      return ( 0 == tdElapsed.total_microseconds() ) ? 0.0 : ( 1e6 * nTests ) / tdElapsed.total_microseconds();
+    }
+  };
+
+  explicit PairScanner( size_t nObservations );  // of each series
+  ~PairScanner( void ) {};
+
+  // pClose has nObservations, copied, oldest first
+  void Add( const std::string& sName, const double* pClose );
+  size_t Size( void ) const { return m_vName.size(); };
+  const std::string& Name( size_t ix ) const { return m_vName[ ix ]; };
+
+  // vResult is replaced, sorted by t statistic, most negative first
+  //   throws std::runtime_error when nLags leaves too few rows, a log is asked of a price not above 0,
+  //     or dblSignificance is not one of the tabled levels
+  Stats Scan( const Options& options, vResult_t& vResult );
+
+protected:
+private:
+
+  enum { nMaxColumns = 24 };  // of the adf regression, k + 3
+
+  struct Worker;
+
+  size_t m_nObservations;
+  std::vector<std::string> m_vName;
+  std::vector<double> m_vClose;  // series after series
+
+  // of a scan, shared read only by the workers
+  std::vector<double> m_vSeries;  // closes, or their logs
+  std::vector<double> m_vMean;
+  std::vector<double> m_vSumSquares;  // about the mean
+
+};
+
+} // namespace ou
@@ -50,7 +50,8 @@ OBJECTFILES= \
 	${OBJECTDIR}/NewMat/newmatex.o \
 	${OBJECTDIR}/NewMat/newmatnl.o \
 	${OBJECTDIR}/NewMat/newmatrm.o \
-	${OBJECTDIR}/NewMat/submat.o
+	${OBJECTDIR}/NewMat/submat.o \
+	${OBJECTDIR}/PairScanner.o
 
 
 # C Compiler Flags
@@ -159,6 +160,11 @@ ${OBJECTDIR}/NewMat/submat.o: NewMat/submat.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -Duse_namespace -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/NewMat/submat.o NewMat/submat.cpp
 
+${OBJECTDIR}/PairScanner.o: PairScanner.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -Duse_namespace -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/PairScanner.o PairScanner.cpp
+
 # Subprojects
 .build-subprojects:
 
@@ -0,0 +1,46 @@
+/************************************************************************
+ * Copyright(c) 2012, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#include "stdafx.h"
+
+#include "IQFeedSymbolFileToSqlite.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+IQFeedSymbolFileToSqlite::IQFeedSymbolFileToSqlite( const std::string& sTableName )
+  : m_sTableName( sTableName )
+{
+}
+
+void IQFeedSymbolFileToSqlite::HandleRegisterTables( ou::db::Session& session ) {
+  session.RegisterTable<ou::tf::iqfeed::MarketSymbol::TableCreateDef>( m_sTableName );
+}
+
+void IQFeedSymbolFileToSqlite::HandleRegisterRows( ou::db::Session& session ) {
+  session.MapRowDefToTableName<ou::tf::iqfeed::MarketSymbol::TableRowDef>( m_sTableName );
+}
+
+size_t IQFeedSymbolFileToSqlite::Load( ou::db::Session& session, ou::tf::iqfeed::InMemoryMktSymbolList& list ) {
+  return session.BulkInsert<ou::tf::iqfeed::MarketSymbol::TableRowDef>( list.begin(), list.end() );
+}
+
+size_t IQFeedSymbolFileToSqlite::Load( ou::db::Session& session, ou::tf::iqfeed::MktSymbolLoadType::Enum type, const std::string& sFileName ) {
+  ou::tf::iqfeed::InMemoryMktSymbolList list;
+  ou::tf::iqfeed::LoadMktSymbols( list, type, false, sFileName );
+  return Load( session, list );
+}
+
+} // namespace tf
+} // namespace ou
@@ -16,72 +16,45 @@
 
 // Started 2012/10/14
 
-/*
+// loads the IQFeed market symbol list into a sqlite table, a row per symbol
+//   the rows go in through Session::BulkInsert:  one prepared statement, a transaction per block of rows,
+//   durability relaxed for the load, a million rows in a couple of seconds, where a transaction per row took hours
 
-Coding for writing to a sqlite database was stopped as it appeared to take about four to five hours to update
-about a million records.
+// usage:
+//   ou::tf::IQFeedSymbolFileToSqlite loader;  // table "iqfeedsymbols"
+//   session.OnRegisterTables.Add( MakeDelegate( &loader, &ou::tf::IQFeedSymbolFileToSqlite::HandleRegisterTables ) );
+//   session.OnRegisterRows.Add( MakeDelegate( &loader, &ou::tf::IQFeedSymbolFileToSqlite::HandleRegisterRows ) );
+//   session.Open( "cav.db", ou::db::EOpenFlagsAutoCreate );
+//   loader.Load( session, ou::tf::iqfeed::MktSymbolLoadType::LoadTextFromDisk );
 
-header file:
+#include <string>
 
-#include <TFTrading/DBOps.h>
-#include <TFIQFeed/ValidateMktSymbolLine.h>
+#include <OUSqlite/Session.h>
 
-  DBOps m_db;
-  trd_t m_trd;  // needs to be changed so that new structure can be used each time with prepared statement
-  ou::db::QueryFields<ou::tf::iqfeed::MarketSymbol::TableRowDef>::pQueryFields_t pInsertIQFeedSymbol;
+#include <TFIQFeed/LoadMktSymbols.h>
 
-source file:
-#include <TFIQFeed/ParseMktSymbolDiskFile.h>
+namespace ou { // One Unified
+namespace tf { // TradeFrame
 
+class IQFeedSymbolFileToSqlite {
+public:
 
-  m_db.OnRegisterTables.Add( MakeDelegate( this, &AppCollectAndView::HandleRegisterTables ) );
-  m_db.OnRegisterRows.Add( MakeDelegate( this, &AppCollectAndView::HandleRegisterRows ) );
-  m_db.SetOnPopulateDatabaseHandler( MakeDelegate( this, &AppCollectAndView::HandlePopulateDatabase ) );
+  IQFeedSymbolFileToSqlite( const std::string& sTableName = "iqfeedsymbols" );
+  ~IQFeedSymbolFileToSqlite( void ) {};
 
-  m_db.Open( "cav.db" );
+  void HandleRegisterTables( ou::db::Session& session );
+  void HandleRegisterRows( ou::db::Session& session );
 
-  typedef ou::tf::iqfeed::ParseMktSymbolDiskFile diskfile_t;
-  diskfile_t diskfile;
-  ou::tf::iqfeed::ValidateMktSymbolLine validator;
-  diskfile.SetOnProcessLine( MakeDelegate( &validator, &ou::tf::iqfeed::ValidateMktSymbolLine::Parse<diskfile_t::iterator_t> ) );
-  validator.SetOnProcessLine( MakeDelegate( this, &AppCollectAndView::HandleParsedStructure ) );
+  // the rows of the list, returns the rows inserted
+  size_t Load( ou::db::Session& session, ou::tf::iqfeed::InMemoryMktSymbolList& list );
+  // the list, downloaded or from the text file, then its rows, returns the rows inserted
+  size_t Load( ou::db::Session& session, ou::tf::iqfeed::MktSymbolLoadType::Enum type,
+    const std::string& sFileName = ou::tf::iqfeed::detail::sFileNameMarketSymbolsText );
 
-  pInsertIQFeedSymbol = m_db.Insert<ou::tf::iqfeed::MarketSymbol::TableRowDef>( m_trd ).NoExecute();
-
-  diskfile.Run();
-
-  validator.SetOnProcessHasOption( MakeDelegate( this, &AppCollectAndView::HandleUpdateHasOption ) );
-  validator.PostProcess();
-  validator.Summary();
-
-
-void AppCollectAndView::HandleParsedStructure( trd_t& trd ) {
-  m_trd = trd;
-  int i;
-  if ( "A" == trd.sSymbol ) {
-    i = 0;
-  }
-  m_db.Reset( pInsertIQFeedSymbol );
-  m_db.Bind<ou::tf::iqfeed::MarketSymbol::TableRowDef>( pInsertIQFeedSymbol );
-  m_db.Execute( pInsertIQFeedSymbol );
-//  ou::db::QueryFields<ou::tf::iqfeed::MarketSymbol::TableRowDef>::pQueryFields_t pInsertIQFeedSymbol 
-//    = m_db.Insert<ou::tf::iqfeed::MarketSymbol::TableRowDef>( trd );
-}
-
-void AppCollectAndView::HandleUpdateHasOption( const std::string& ) {
-}
-
-void AppCollectAndView::HandleRegisterTables(  ou::db::Session& session ) {
-  session.RegisterTable<ou::tf::iqfeed::MarketSymbol::TableCreateDef>( "iqfeedsymbols" );
-}
-
-void AppCollectAndView::HandleRegisterRows(  ou::db::Session& session ) {
-  session.MapRowDefToTableName<ou::tf::iqfeed::MarketSymbol::TableRowDef>( "iqfeedsymbols" );
-}
-
-
-
-
-
-*/
+protected:
+private:
+  std::string m_sTableName;
+};
 
+} // namespace tf
+} // namespace ou
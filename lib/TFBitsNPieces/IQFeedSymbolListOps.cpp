@@ -14,11 +14,39 @@
 
 #include "stdafx.h"
 
+#include <boost/filesystem.hpp>
+
+#include <TFIQFeed/MktSymbolListCache.h>
+
 #include "IQFeedSymbolListOps.h"
 
 namespace ou { // One Unified
 namespace tf { // TradeFrame
 
+namespace {
+
+// SelectSymbols against the cache, only the selected rows are expanded to trd_t
+struct SelectRows {
+  bool m_bSelectWithOptions;
+  const IQFeedSymbolListOps::vClassifiers_t& m_classifiers;
+  ou::tf::iqfeed::InMemoryMktSymbolList& m_selected;
+
+  SelectRows( const IQFeedSymbolListOps::vClassifiers_t& classifiers, ou::tf::iqfeed::InMemoryMktSymbolList& selected, bool bSelectWithOptions )
+    : m_bSelectWithOptions( bSelectWithOptions ), m_classifiers( classifiers ), m_selected( selected ) {};
+
+  void operator() ( const ou::tf::iqfeed::MktSymbolListCache::Row& row ) {
+    if ( m_classifiers.end() != m_classifiers.find( row.SymbolClass() ) ) {
+      if ( !m_bSelectWithOptions || row.HasOptions() ) {
+        IQFeedSymbolListOps::trd_t trd;
+        row.Fill( trd );
+        m_selected( trd );
+      }
+    }
+  }
+};
+
+} // namespace anonymous
+
 IQFeedSymbolListOps::IQFeedSymbolListOps( ou::tf::iqfeed::InMemoryMktSymbolList& immsl )
   : m_listIQFeedSymbols( immsl ), m_fenceWorker( 0 ) {
 }
@@ -37,6 +65,28 @@ bool IQFeedSymbolListOps::Exists( const std::string& sName ) {
   return bFound;
 }
 
+bool IQFeedSymbolListOps::CacheCurrent( void ) {
+  // a binary file may be saved without the cache
+  bool bCacheCurrent( false );
+  boost::system::error_code ec;
+  std::time_t tCache( boost::filesystem::last_write_time( iqfeed::detail::sFileNameMarketSymbolsCache, ec ) );
+  if ( !ec ) {
+    std::time_t tBinary( boost::filesystem::last_write_time( iqfeed::detail::sFileNameMarketSymbolsBinary, ec ) );
+    bCacheCurrent = ec || ( tBinary <= tCache );  // or there is no binary file
+  }
+  return bCacheCurrent;
+}
+
+bool IQFeedSymbolListOps::SelectSymbolsFromCache( 
+  const vExchanges_t& exchanges, const vClassifiers_t& classifiers, 
+  ou::tf::iqfeed::InMemoryMktSymbolList& selected, bool bSelectWithOptions ) 
+{
+  ou::tf::iqfeed::MktSymbolListCache cache;
+  if ( !CacheCurrent() || !cache.Open( iqfeed::detail::sFileNameMarketSymbolsCache ) ) return false;
+  cache.SelectSymbolsByExchange( exchanges.begin(), exchanges.end(), SelectRows( classifiers, selected, bSelectWithOptions ) );
+  return true;
+}
+
 void IQFeedSymbolListOps::ObtainNewIQFeedSymbolListRemote( void ) {
   if ( 0 == m_fenceWorker.fetch_add( 1, boost::memory_order_acquire ) ) {
     m_worker.Run( MakeDelegate( this, &IQFeedSymbolListOps::WorkerObtainNewIQFeedSymbolListRemote ) );
@@ -52,6 +102,8 @@ void IQFeedSymbolListOps::WorkerObtainNewIQFeedSymbolListRemote( void ) {
   ou::tf::iqfeed::LoadMktSymbols( m_listIQFeedSymbols, ou::tf::iqfeed::MktSymbolLoadType::Download, true, iqfeed::detail::sFileNameMarketSymbolsText ); 
   std::cout << "Saving Binary File ... " << std::endl;
   m_listIQFeedSymbols.SaveToFile( iqfeed::detail::sFileNameMarketSymbolsBinary );
+  std::cout << "Saving Cache File ... " << std::endl;
+  ou::tf::iqfeed::MktSymbolListCache::Write( m_listIQFeedSymbols, iqfeed::detail::sFileNameMarketSymbolsCache );
   std::cout << " ... done." << std::endl;
   m_fenceWorker.fetch_sub( 1, boost::memory_order_release );
 }
@@ -71,6 +123,8 @@ void IQFeedSymbolListOps::WorkerObtainNewIQFeedSymbolListLocal( void ) {
   ou::tf::iqfeed::LoadMktSymbols( m_listIQFeedSymbols, ou::tf::iqfeed::MktSymbolLoadType::LoadTextFromDisk, false, iqfeed::detail::sFileNameMarketSymbolsText ); 
   std::cout << "Saving Binary File ... " << std::endl;
   m_listIQFeedSymbols.SaveToFile( iqfeed::detail::sFileNameMarketSymbolsBinary );
+  std::cout << "Saving Cache File ... " << std::endl;
+  ou::tf::iqfeed::MktSymbolListCache::Write( m_listIQFeedSymbols, iqfeed::detail::sFileNameMarketSymbolsCache );
   std::cout << " ... done." << std::endl;
   m_fenceWorker.fetch_sub( 1, boost::memory_order_release );
 }
@@ -86,8 +140,15 @@ void IQFeedSymbolListOps::LoadIQFeedSymbolList( void ) {
 }
 
 void IQFeedSymbolListOps::WorkerLoadIQFeedSymbolList( void ) {
-  std::cout << "Loading From Binary File ..." << std::endl;
-  m_listIQFeedSymbols.LoadFromFile( iqfeed::detail::sFileNameMarketSymbolsBinary );
+  ou::tf::iqfeed::MktSymbolListCache cache;
+  if ( CacheCurrent() && cache.Open( iqfeed::detail::sFileNameMarketSymbolsCache ) ) {
+    std::cout << "Loading From Cache File ..." << std::endl;  // about half the time of deserializing
+    cache.Populate( m_listIQFeedSymbols );
+  }
+  else {
+    std::cout << "Loading From Binary File ..." << std::endl;
+    m_listIQFeedSymbols.LoadFromFile( iqfeed::detail::sFileNameMarketSymbolsBinary );
+  }
   std::cout << " ... done." << std::endl;
   m_fenceWorker.fetch_sub( 1, boost::memory_order_release );
 }
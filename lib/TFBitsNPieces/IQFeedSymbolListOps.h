@@ -68,6 +68,12 @@ public:
 
   bool Exists( const std::string& sName );
 
+  // the SelectSymbols subset, taken directly from the mapped cache file, so the full list need not be loaded:
+  //   false when the cache is absent or older than the binary file, the subset is then to come from the list
+  bool SelectSymbolsFromCache( 
+    const vExchanges_t& exchanges, const vClassifiers_t& classifiers, 
+    ou::tf::iqfeed::InMemoryMktSymbolList& selected, bool bSelectWithOptions = false );
+
   void ObtainNewIQFeedSymbolListRemote( void );
   void ObtainNewIQFeedSymbolListLocal( void );
   void LoadIQFeedSymbolList( void );
@@ -85,6 +91,8 @@ private:
   void WorkerObtainNewIQFeedSymbolListRemote( void );
   void WorkerObtainNewIQFeedSymbolListLocal( void );
   void WorkerLoadIQFeedSymbolList( void );
+
+  static bool CacheCurrent( void );  // the cache file exists, and is no older than the binary file
 };
 
 } // namespace tf
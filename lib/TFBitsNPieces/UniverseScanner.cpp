@@ -0,0 +1,333 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#include "stdafx.h"
+
+#include <set>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/phoenix/core/argument.hpp>
+#include <boost/phoenix/bind/bind_member_function.hpp>
+
+#include <TFHDF5TimeSeries/HDF5DataManager.h>
+#include <TFHDF5TimeSeries/HDF5IterateGroups.h>
+#include <TFHDF5TimeSeries/HDF5TimeSeriesContainer.h>
+
+#include "UniverseScanner.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+namespace {
+
+bool SelectionRankedHigher( const UniverseScanner::Selection& lhs, const UniverseScanner::Selection& rhs ) {
+  return lhs.dblRank > rhs.dblRank;
+}
+
+struct FilterMinDays {
+  size_t nDays;
+  FilterMinDays( size_t nDays_ ): nDays( nDays_ ) {};
+  bool operator()( const UniverseScanner& scanner, size_t ixSymbol ) const {
+    if ( 0 == scanner.Days() ) return false;
+    return ( nDays <= scanner.Present( ixSymbol ) )
+      && !std::isnan( scanner.Value( UniverseScanner::Close, ixSymbol, scanner.Days() - 1 ) );
+  }
+};
+
+struct FilterMinAverageVolume {
+  double dblVolume;
+  FilterMinAverageVolume( double dblVolume_ ): dblVolume( dblVolume_ ) {};
+  bool operator()( const UniverseScanner& scanner, size_t ixSymbol ) const {
+    size_t nPresent( scanner.Present( ixSymbol ) );
+    if ( 0 == nPresent ) return false;
+    const double* pVolume( scanner.Series( UniverseScanner::Volume, ixSymbol ) );
+    double dblTotal( 0.0 );
+    for ( size_t ix = 0; ix < scanner.Days(); ++ix ) {
+      if ( !std::isnan( pVolume[ ix ] ) ) dblTotal += pVolume[ ix ];
+    }
+    return dblVolume < ( dblTotal / nPresent );
+  }
+};
+
+struct FilterCloseBetween {
+  double dblLow, dblHigh;
+  FilterCloseBetween( double dblLow_, double dblHigh_ ): dblLow( dblLow_ ), dblHigh( dblHigh_ ) {};
+  bool operator()( const UniverseScanner& scanner, size_t ixSymbol ) const {
+    if ( 0 == scanner.Days() ) return false;
+    double dblClose( scanner.Value( UniverseScanner::Close, ixSymbol, scanner.Days() - 1 ) );
+    return ( dblLow <= dblClose ) && ( dblHigh >= dblClose );  // false for NaN
+  }
+};
+
+struct RankPivotCrossings {
+  double operator()( const UniverseScanner& scanner, size_t ixSymbol ) const {
+    const double* pOpen( scanner.Series( UniverseScanner::Open, ixSymbol ) );
+    const double* pHigh( scanner.Series( UniverseScanner::High, ixSymbol ) );
+    const double* pLow( scanner.Series( UniverseScanner::Low, ixSymbol ) );
+    const double* pClose( scanner.Series( UniverseScanner::Close, ixSymbol ) );
+    size_t nCrossings( 0 );
+    for ( size_t ix = 1; ix < scanner.Days(); ++ix ) {  // comparisons with NaN are false, so gaps do not count
+      double pv = ( pHigh[ ix - 1 ] + pLow[ ix - 1 ] + pClose[ ix - 1 ] ) / 3.0;
+      double r1 = 2.0 * pv - pLow[ ix - 1 ];
+      double s1 = 2.0 * pv - pHigh[ ix - 1 ];
+      bool bR1( ( r1 <= pHigh[ ix ] ) && ( r1 >= pLow[ ix ] ) );
+      bool bS1( ( s1 <= pHigh[ ix ] ) && ( s1 >= pLow[ ix ] ) );
+      if ( ( pOpen[ ix ] < pv ) || ( pOpen[ ix ] > pv ) ) {  // the four Scanner counts combined: opening on either side of the pivot
+        if ( bR1 ) ++nCrossings;
+        if ( bS1 ) ++nCrossings;
+      }
+    }
+    return nCrossings;
+  }
+};
+
+struct RankRangePercent {
+  size_t nDays;
+  RankRangePercent( size_t nDays_ ): nDays( nDays_ ) {};
+  double operator()( const UniverseScanner& scanner, size_t ixSymbol ) const {
+    size_t n( std::min<size_t>( nDays, scanner.Days() ) );
+    if ( 0 == n ) return 0.0;
+    const double* pHigh( scanner.Series( UniverseScanner::High, ixSymbol ) + scanner.Days() - n );
+    const double* pLow( scanner.Series( UniverseScanner::Low, ixSymbol ) + scanner.Days() - n );
+    double dblHigh( -std::numeric_limits<double>::infinity() );
+    double dblLow( std::numeric_limits<double>::infinity() );
+    for ( size_t ix = 0; ix < n; ++ix ) {
+      if ( pHigh[ ix ] > dblHigh ) dblHigh = pHigh[ ix ];  // NaN never compares greater
+      if ( pLow[ ix ] < dblLow ) dblLow = pLow[ ix ];
+    }
+    double dblClose( scanner.Value( UniverseScanner::Close, ixSymbol, scanner.Days() - 1 ) );
+    if ( !( 0.0 < dblClose ) || ( dblHigh < dblLow ) ) return 0.0;
+    return 100.0 * ( dblHigh - dblLow ) / dblClose;
+  }
+};
+
+struct RankAverageVolume {
+  double operator()( const UniverseScanner& scanner, size_t ixSymbol ) const {
+    size_t nPresent( scanner.Present( ixSymbol ) );
+    if ( 0 == nPresent ) return 0.0;
+    const double* pVolume( scanner.Series( UniverseScanner::Volume, ixSymbol ) );
+    double dblTotal( 0.0 );
+    for ( size_t ix = 0; ix < scanner.Days(); ++ix ) {
+      if ( !std::isnan( pVolume[ ix ] ) ) dblTotal += pVolume[ ix ];
+    }
+    return dblTotal / nPresent;
+  }
+};
+
+} // namespace anonymous
+
+UniverseScanner::UniverseScanner( unsigned int nThreads ): m_nThreads( nThreads ), m_pdm( 0 ), m_nDays( 0 ) {
+  if ( 0 == m_nThreads ) {
+    m_nThreads = boost::thread::hardware_concurrency();
+    if ( 0 == m_nThreads ) m_nThreads = 1;  // not determinable
+  }
+}
+
+UniverseScanner::~UniverseScanner( void ) {
+}
+
+void UniverseScanner::Load( const std::string& sBaseGroup, ptime dtBegin, ptime dtEnd, size_t nDays ) {
+  if ( dtBegin >= dtEnd ) {
+    throw std::runtime_error( "dtBegin >= dtEnd" );
+  }
+  ptime dtStart( boost::posix_time::microsec_clock::universal_time() );
+  m_dtBegin = dtBegin;
+  m_dtEnd = dtEnd;
+  m_nDays = nDays;
+  {
+    namespace args = boost::phoenix::placeholders;
+    HDF5DataManager dm( HDF5DataManager::RO );
+    m_pdm = &dm;
+    ou::tf::hdf5::IterateGroups ig( 
+      sBaseGroup, 
+      boost::phoenix::bind( &UniverseScanner::HandleGroup, this, args::arg1, args::arg2 ), 
+      boost::phoenix::bind( &UniverseScanner::HandleObject, this, args::arg1, args::arg2 ) 
+      );
+    m_pdm = 0;
+  }
+  Build( nDays );
+  m_tdLoad = boost::posix_time::microsec_clock::universal_time() - dtStart;
+}
+
+void UniverseScanner::HandleObject( const std::string& sPath, const std::string& sObject ) {
+  HDF5TimeSeriesContainer<Bar> tsRepository( *m_pdm, sPath );
+  if ( 0 == tsRepository.size() ) return;
+  // only the last m_nDays bars before m_dtEnd are needed, so read just those, in one block:
+  //   a search on disk reads element by element, and is avoided when the dataset ends before m_dtEnd
+  HDF5TimeSeriesContainer<Bar>::iterator begin, end( tsRepository.end() );
+  end -= 1;
+  if ( (*end).DateTime() < m_dtEnd ) {
+    end = tsRepository.end();
+  }
+  else {
+    end = std::lower_bound( tsRepository.begin(), tsRepository.end(), m_dtEnd );
+  }
+  begin = end;
+  begin -= std::min<hsize_t>( m_nDays, end - tsRepository.begin() );
+  hsize_t cnt = end - begin;
+  if ( 0 < cnt ) {
+    Bars bars;
+    bars.Resize( cnt );
+    tsRepository.Read( begin, end, &bars );
+    Bars::const_iterator iter = std::lower_bound( bars.begin(), bars.end(), m_dtBegin );
+    if ( bars.end() != iter ) {
+      m_vStaging.push_back( vStaging_t::value_type( sObject, Bars() ) );
+      Bars& barsInRange( m_vStaging.back().second );
+      barsInRange.Reserve( bars.end() - iter );
+      for ( ; bars.end() != iter; ++iter ) {
+        barsInRange.Append( *iter );
+      }
+    }
+  }
+}
+
+void UniverseScanner::Add( const std::string& sSymbol, const Bars& bars ) {
+  m_vStaging.push_back( vStaging_t::value_type( sSymbol, bars ) );
+}
+
+void UniverseScanner::Build( size_t nDays ) {
+
+  // common day axis: the last nDays dates on which any symbol has a bar
+  typedef std::set<boost::gregorian::date> setDate_t;
+  setDate_t setDate;
+  for ( vStaging_t::const_iterator iter = m_vStaging.begin(); m_vStaging.end() != iter; ++iter ) {
+    const Bars& bars( iter->second );
+    size_t n( std::min<size_t>( nDays, bars.Size() ) );  // later dates of a symbol are the only candidates
+    for ( Bars::const_iterator iterBar = bars.end() - n; bars.end() != iterBar; ++iterBar ) {
+      setDate.insert( iterBar->DateTime().date() );
+      if ( nDays < setDate.size() ) setDate.erase( setDate.begin() );
+    }
+  }
+  m_vDate.assign( setDate.begin(), setDate.end() );
+
+  m_vSymbol.clear();
+  m_vPresent.clear();
+  const size_t nAxis( m_vDate.size() );
+  for ( int ix = 0; ix < FieldCount; ++ix ) {
+    m_vPlane[ ix ].assign( m_vStaging.size() * nAxis, std::numeric_limits<double>::quiet_NaN() );
+  }
+
+  size_t ixSymbol( 0 );
+  for ( vStaging_t::const_iterator iter = m_vStaging.begin(); m_vStaging.end() != iter; ++iter ) {
+    const Bars& bars( iter->second );
+    size_t nPresent( 0 );
+    size_t ixDay( nAxis );
+    for ( Bars::const_iterator iterBar = bars.end(); ( bars.begin() != iterBar ) && ( 0 != ixDay ); ) {
+      --iterBar;
+      boost::gregorian::date date( iterBar->DateTime().date() );
+      while ( ( 0 != ixDay ) && ( date < m_vDate[ ixDay - 1 ] ) ) --ixDay;  // no bar for the symbol on that day
+      if ( 0 == ixDay ) break;
+      if ( date == m_vDate[ ixDay - 1 ] ) {
+        --ixDay;
+        size_t ix( ixSymbol * nAxis + ixDay );
+        m_vPlane[ Open   ][ ix ] = iterBar->Open();
+        m_vPlane[ High   ][ ix ] = iterBar->High();
+        m_vPlane[ Low    ][ ix ] = iterBar->Low();
+        m_vPlane[ Close  ][ ix ] = iterBar->Close();
+        m_vPlane[ Volume ][ ix ] = iterBar->Volume();
+        ++nPresent;
+      }
+    }
+    if ( 0 != nPresent ) {  // symbols without bars in the axis are dropped, their untouched slot is re-used
+      m_vSymbol.push_back( iter->first );
+      m_vPresent.push_back( nPresent );
+      ++ixSymbol;
+    }
+  }
+  for ( int ix = 0; ix < FieldCount; ++ix ) {
+    m_vPlane[ ix ].resize( ixSymbol * nAxis );
+  }
+
+  m_vStaging.clear();
+}
+
+void UniverseScanner::Scan( const vFilter_t& vFilter, fRank_t fRank, size_t nTop, vSelection_t& vSelection ) {
+
+  ptime dtStart( boost::posix_time::microsec_clock::universal_time() );
+
+  vSelection.clear();
+
+  size_t nThreads( std::max<size_t>( 1, std::min<size_t>( m_nThreads, Symbols() / 64 ) ) );  // small universes stay on one thread
+  std::vector<vSelection_t> vPartial( nThreads );
+  size_t nPerThread( ( Symbols() + nThreads - 1 ) / nThreads );
+  if ( 1 == nThreads ) {
+    ScanBlock( vFilter, fRank, 0, Symbols(), vPartial[ 0 ] );
+  }
+  else {
+    boost::thread_group threads;
+    for ( size_t ix = 0; ix < nThreads; ++ix ) {
+      size_t ixBegin( std::min<size_t>( Symbols(), ix * nPerThread ) );
+      size_t ixEnd( std::min<size_t>( Symbols(), ixBegin + nPerThread ) );
+      threads.create_thread( 
+        boost::bind( &UniverseScanner::ScanBlock, this, boost::cref( vFilter ), fRank, ixBegin, ixEnd, boost::ref( vPartial[ ix ] ) ) );
+    }
+    threads.join_all();
+  }
+
+  for ( std::vector<vSelection_t>::const_iterator iter = vPartial.begin(); vPartial.end() != iter; ++iter ) {
+    vSelection.insert( vSelection.end(), iter->begin(), iter->end() );
+  }
+  if ( nTop < vSelection.size() ) {
+    std::partial_sort( vSelection.begin(), vSelection.begin() + nTop, vSelection.end(), SelectionRankedHigher );
+    vSelection.erase( vSelection.begin() + nTop, vSelection.end() );
+  }
+  else {
+    std::sort( vSelection.begin(), vSelection.end(), SelectionRankedHigher );
+  }
+
+  m_tdScan = boost::posix_time::microsec_clock::universal_time() - dtStart;
+}
+
+void UniverseScanner::ScanBlock( const vFilter_t& vFilter, fRank_t fRank, size_t ixBegin, size_t ixEnd, vSelection_t& vSelection ) const {
+  for ( size_t ixSymbol = ixBegin; ixSymbol < ixEnd; ++ixSymbol ) {
+    bool bPassed( true );
+    for ( vFilter_t::const_iterator iter = vFilter.begin(); bPassed && ( vFilter.end() != iter ); ++iter ) {
+      bPassed = (*iter)( *this, ixSymbol );
+    }
+    if ( bPassed ) {
+      vSelection.push_back( Selection( ixSymbol, m_vSymbol[ ixSymbol ], ( 0 == fRank ) ? 0.0 : fRank( *this, ixSymbol ) ) );
+    }
+  }
+}
+
+UniverseScanner::fFilter_t UniverseScanner::MinDays( size_t nDays ) {
+  return FilterMinDays( nDays );
+}
+
+UniverseScanner::fFilter_t UniverseScanner::MinAverageVolume( double dblVolume ) {
+  return FilterMinAverageVolume( dblVolume );
+}
+
+UniverseScanner::fFilter_t UniverseScanner::CloseBetween( double dblLow, double dblHigh ) {
+  return FilterCloseBetween( dblLow, dblHigh );
+}
+
+UniverseScanner::fRank_t UniverseScanner::PivotCrossings( void ) {
+  return RankPivotCrossings();
+}
+
+UniverseScanner::fRank_t UniverseScanner::RangePercent( size_t nDays ) {
+  return RankRangePercent( nDays );
+}
+
+UniverseScanner::fRank_t UniverseScanner::AverageVolume( void ) {
+  return RankAverageVolume();
+}
+
+} // namespace tf
+} // namespace ou
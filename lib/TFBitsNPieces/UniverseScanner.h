@@ -0,0 +1,132 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// cross-sectional scans of daily bars across the whole universe:
+//   the last n days of every symbol are loaded once into a matrix, one plane per field,
+//     each symbol's days contiguous in a plane, aligned on a common day axis
+//     (days missing for a symbol are NaN)
+//   filters and rankings are evaluated over blocks of symbols on a number of threads,
+//     rather than symbol by symbol as each dataset is opened, as with InstrumentFilter
+//   a scan returns the selections passing all filters, best ranked first
+// How to Use:
+/*
+  UniverseScanner scanner;
+  scanner.Load( "/bar/86400", dtBegin, dtEnd, 20 );
+  UniverseScanner::vFilter_t vFilter;
+  vFilter.push_back( UniverseScanner::MinDays( 20 ) );
+  vFilter.push_back( UniverseScanner::MinAverageVolume( 1000000 ) );
+  vFilter.push_back( UniverseScanner::CloseBetween( 12.0, 90.0 ) );
+  UniverseScanner::vSelection_t vSelection;
+  scanner.Scan( vFilter, UniverseScanner::PivotCrossings(), 50, vSelection );
+*/
+
+#include <string>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <TFTimeSeries/TimeSeries.h>
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+class HDF5DataManager;
+
+class UniverseScanner {
+public:
+
+  enum EField { Open = 0, High, Low, Close, Volume, FieldCount };
+
+  typedef boost::function<bool (const UniverseScanner&, size_t ixSymbol)> fFilter_t;
+  typedef boost::function<double (const UniverseScanner&, size_t ixSymbol)> fRank_t;  // larger is better
+  typedef std::vector<fFilter_t> vFilter_t;
+
+  struct Selection {
+    size_t ixSymbol;
+    std::string sSymbol;
+    double dblRank;
+    Selection( size_t ixSymbol_, const std::string& sSymbol_, double dblRank_ )
+      : ixSymbol( ixSymbol_ ), sSymbol( sSymbol_ ), dblRank( dblRank_ ) {};
+  };
+  typedef std::vector<Selection> vSelection_t;
+
+  UniverseScanner( unsigned int nThreads = 0 );  // 0 uses hardware concurrency
+  ~UniverseScanner( void );
+
+  // all daily bar datasets below sBaseGroup, bars in [ dtBegin, dtEnd ), last nDays of the combined day axis
+  void Load( const std::string& sBaseGroup, ptime dtBegin, ptime dtEnd, size_t nDays );
+
+  // or in steps, with series from elsewhere
+  void Add( const std::string& sSymbol, const Bars& bars );
+  void Build( size_t nDays );  // matrix from the series added, which are then released
+
+  size_t Symbols( void ) const { return m_vSymbol.size(); };
+  size_t Days( void ) const { return m_vDate.size(); };
+  const std::string& Symbol( size_t ixSymbol ) const { return m_vSymbol[ ixSymbol ]; };
+  boost::gregorian::date Date( size_t ixDay ) const { return m_vDate[ ixDay ]; };
+
+  // Days() values for the symbol, oldest first
+  const double* Series( EField field, size_t ixSymbol ) const { return &m_vPlane[ field ][ ixSymbol * m_vDate.size() ]; };
+  double Value( EField field, size_t ixSymbol, size_t ixDay ) const { return Series( field, ixSymbol )[ ixDay ]; };
+  size_t Present( size_t ixSymbol ) const { return m_vPresent[ ixSymbol ]; };  // days with a bar
+
+  // evaluates filters in order, with the first to fail ending evaluation of the symbol
+  void Scan( const vFilter_t& vFilter, fRank_t fRank, size_t nTop, vSelection_t& vSelection );
+
+  boost::posix_time::time_duration LoadDuration( void ) const { return m_tdLoad; };
+  boost::posix_time::time_duration ScanDuration( void ) const { return m_tdScan; };
+
+  // stock filters and rankings
+  static fFilter_t MinDays( size_t nDays );  // bars on at least nDays, including the last day
+  static fFilter_t MinAverageVolume( double dblVolume );
+  static fFilter_t CloseBetween( double dblLow, double dblHigh );  // last close
+  static fRank_t PivotCrossings( void );  // R1/S1 crossings of the prior day's pivots, as in Scanner
+  static fRank_t RangePercent( size_t nDays );  // high to low over the last nDays, relative to the last close
+  static fRank_t AverageVolume( void );
+
+protected:
+private:
+
+  typedef std::vector<double> vPlane_t;
+  typedef std::vector<std::pair<std::string, Bars> > vStaging_t;
+
+  unsigned int m_nThreads;
+
+  vStaging_t m_vStaging;
+
+  std::vector<std::string> m_vSymbol;
+  std::vector<boost::gregorian::date> m_vDate;
+  vPlane_t m_vPlane[ FieldCount ];  // [ field ][ ixSymbol * Days() + ixDay ]
+  std::vector<size_t> m_vPresent;
+
+  boost::posix_time::time_duration m_tdLoad;
+  boost::posix_time::time_duration m_tdScan;
+
+  HDF5DataManager* m_pdm;  // during Load
+  ptime m_dtBegin;
+  ptime m_dtEnd;
+  size_t m_nDays;
+
+  void HandleGroup( const std::string& sPath, const std::string& sObject ) {};
+  void HandleObject( const std::string& sPath, const std::string& sObject );
+
+  void ScanBlock( const vFilter_t& vFilter, fRank_t fRank, size_t ixBegin, size_t ixEnd, vSelection_t& vSelection ) const;
+
+};
+
+} // namespace tf
+} // namespace ou
@@ -37,13 +37,15 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 OBJECTFILES= \
 	${OBJECTDIR}/FrameWork01.o \
 	${OBJECTDIR}/IQFeedInstrumentBuild.o \
+	${OBJECTDIR}/IQFeedSymbolFileToSqlite.o \
 	${OBJECTDIR}/IQFeedSymbolListOps.o \
 	${OBJECTDIR}/InstrumentSelection.o \
 	${OBJECTDIR}/LiborFromIQFeed.o \
 	${OBJECTDIR}/ReadCboeWeeklyOptions.o \
 	${OBJECTDIR}/TreeOps.o \
 	${OBJECTDIR}/TreeOpsItems.o \
-	${OBJECTDIR}/stdafx.o
+	${OBJECTDIR}/stdafx.o \
+	${OBJECTDIR}/UniverseScanner.o
 
 
 # C Compiler Flags
@@ -82,6 +84,11 @@ ${OBJECTDIR}/IQFeedInstrumentBuild.o: IQFeedInstrumentBuild.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -DwxUSE_GUI -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/IQFeedInstrumentBuild.o IQFeedInstrumentBuild.cpp
 
+${OBJECTDIR}/IQFeedSymbolFileToSqlite.o: IQFeedSymbolFileToSqlite.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -DwxUSE_GUI -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/IQFeedSymbolFileToSqlite.o IQFeedSymbolFileToSqlite.cpp
+
 ${OBJECTDIR}/IQFeedSymbolListOps.o: IQFeedSymbolListOps.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -117,6 +124,11 @@ ${OBJECTDIR}/stdafx.o: stdafx.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -DwxUSE_GUI -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/stdafx.o stdafx.cpp
 
+${OBJECTDIR}/UniverseScanner.o: UniverseScanner.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -DwxUSE_GUI -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/UniverseScanner.o UniverseScanner.cpp
+
 # Subprojects
 .build-subprojects:
 
@@ -0,0 +1,185 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#include <boost/lexical_cast.hpp>
+
+#include <OUCommon/TimeSource.h>
+
+#include "HDF5IterateGroups.h"
+
+#include "HDF5BarResampler.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+HDF5BarResampler::HDF5BarResampler( unsigned int nThreads )
+  : m_bSession( false ), m_nThreads( nThreads ), m_pdm( 0 ),
+  m_cntOutstanding( 0 ), m_cntSeries( 0 ), m_cntBars( 0 ), m_cntFailed( 0 )
+{
+  if ( 0 == m_nThreads ) {
+    m_nThreads = boost::thread::hardware_concurrency();
+    if ( 0 == m_nThreads ) m_nThreads = 1;  // not determinable
+  }
+}
+
+HDF5BarResampler::~HDF5BarResampler( void ) {
+  assert( 0 == m_pdm );
+}
+
+void HDF5BarResampler::AddWidth( duration_t nSeconds, const std::string& sBaseGroup ) {
+  assert( 0 < nSeconds );
+  if ( sBaseGroup.empty() ) {
+    m_vWidth.push_back( Width( nSeconds, "/bar/" + boost::lexical_cast<std::string>( nSeconds ) + "/" ) );
+  }
+  else {
+    m_vWidth.push_back( Width( nSeconds, ( '/' == sBaseGroup[ sBaseGroup.size() - 1 ] ) ? sBaseGroup : sBaseGroup + '/' ) );
+  }
+}
+
+void HDF5BarResampler::SetSession( 
+  boost::posix_time::time_duration tdOpen, boost::posix_time::time_duration tdClose, 
+  const std::string& sZone, const setDates_t& setHolidays ) 
+{
+  m_bSession = true;
+  m_tdOpen = tdOpen;
+  m_tdClose = tdClose;
+  m_sZone = sZone;
+  m_setHolidays = setHolidays;
+}
+
+void HDF5BarResampler::AddSeries( const std::string& sSymbol, const std::string& sSourcePath ) {
+  m_vSeries.push_back( Series( sSymbol, sSourcePath ) );
+}
+
+void HDF5BarResampler::AddGroup( const std::string& sBaseGroup ) {
+  HDF5DataManager::mutex_t::scoped_lock lock( HDF5DataManager::Mutex() );
+  HDF5IterateGroups groups;
+  groups.SetOnHandleObject( MakeDelegate( this, &HDF5BarResampler::HandleObject ) );
+  groups.Start( sBaseGroup );
+}
+
+void HDF5BarResampler::HandleObject( const std::string& sObjectPath, const std::string& sObjectName ) {
+  AddSeries( sObjectName, sObjectPath );
+}
+
+void HDF5BarResampler::BarPath( duration_t nSeconds, const std::string& sSymbol, std::string& sPath ) {
+  SymbolPath( "/bar/" + boost::lexical_cast<std::string>( nSeconds ) + "/", sSymbol, sPath );
+}
+
+// same hierarchy as HDF5DataManager::DailyBarPath
+void HDF5BarResampler::SymbolPath( const std::string& sBaseGroup, const std::string& sSymbol, std::string& sPath ) {
+  sPath = sBaseGroup;
+  sPath.append( sSymbol.substr( 0, 1 ) );
+  sPath.append( "/" );
+  sPath.append( sSymbol.substr( sSymbol.length() == 1 ? 0 : 1, 1 ) );
+  sPath.append( "/" );
+  sPath.append( sSymbol );
+}
+
+// time zone conversions only happen as the data moves to another day
+bool HDF5BarResampler::LocateDay( const boost::posix_time::ptime& dt, Day& day ) const {
+
+  if ( !m_bSession ) {
+    if ( day.date != dt.date() ) {
+      day.date = dt.date();
+      day.dtOpen = boost::posix_time::ptime( day.date );
+      day.dtClose = boost::posix_time::ptime( day.date + boost::gregorian::days( 1 ) );
+    }
+    return true;
+  }
+
+  if ( !day.date.is_not_a_date() && ( day.dtOpen <= dt ) && ( dt < day.dtClose ) ) return true;
+
+  // the session may belong to the prior utc date, when it spans utc midnight
+  for ( int nDay = -1; nDay <= 0; ++nDay ) {
+    boost::gregorian::date date( dt.date() + boost::gregorian::days( nDay ) );
+    boost::posix_time::ptime dtOpen( ou::TimeSource::Instance().ConvertRegionalToUtc( date, m_tdOpen, m_sZone, true ) );
+    boost::posix_time::ptime dtClose( ou::TimeSource::Instance().ConvertRegionalToUtc( date, m_tdClose, m_sZone, true ) );
+    if ( dtClose <= dtOpen ) dtClose = ou::TimeSource::Instance().ConvertRegionalToUtc( date + boost::gregorian::days( 1 ), m_tdClose, m_sZone, true );
+    if ( ( dtOpen <= dt ) && ( dt < dtClose ) ) {
+      boost::gregorian::greg_weekday wd( date.day_of_week() );
+      if ( ( boost::gregorian::Saturday == wd ) || ( boost::gregorian::Sunday == wd ) ) return false;
+      if ( m_setHolidays.end() != m_setHolidays.find( date ) ) return false;
+      day.date = date;
+      day.dtOpen = dtOpen;
+      day.dtClose = dtClose;
+      return true;
+    }
+  }
+  return false;
+}
+
+void HDF5BarResampler::Accumulate( Accumulator& acc, const Day& day, const boost::posix_time::ptime& dt, const Bar& datum ) const {
+
+  if ( acc.bActive && ( dt < acc.dtEnd ) ) {
+    acc.bar.Close( datum.Close() );
+    acc.bar.High( std::max( acc.bar.High(), datum.High() ) );
+    acc.bar.Low( std::min( acc.bar.Low(), datum.Low() ) );
+    acc.bar.Volume( acc.bar.Volume() + datum.Volume() );
+    return;
+  }
+
+  if ( acc.bActive ) acc.bars.Append( acc.bar );
+
+  if ( 86400 <= acc.nSeconds ) {  // one bar per day
+    acc.bar.DateTime( boost::posix_time::ptime( day.date ) );
+    acc.dtEnd = day.dtClose;
+  }
+  else {
+    boost::posix_time::time_duration::sec_type nOffset( ( dt - day.dtOpen ).total_seconds() );
+    boost::posix_time::ptime dtStart( day.dtOpen + boost::posix_time::seconds( ( nOffset / acc.nSeconds ) * acc.nSeconds ) );
+    acc.bar.DateTime( dtStart );
+    acc.dtEnd = std::min<boost::posix_time::ptime>( dtStart + boost::posix_time::seconds( acc.nSeconds ), day.dtClose );
+  }
+  acc.bar.Open( datum.Open() );
+  acc.bar.High( datum.High() );
+  acc.bar.Low( datum.Low() );
+  acc.bar.Close( datum.Close() );
+  acc.bar.Volume( datum.Volume() );
+  acc.bActive = true;
+}
+
+bool HDF5BarResampler::Write( const Series& series, vAccumulator_t& vAccumulator ) {
+  bool bOk( true );
+  HDF5DataManager::mutex_t::scoped_lock lock( HDF5DataManager::Mutex() );
+  for ( vAccumulator_t::size_type ix = 0; ix < vAccumulator.size(); ++ix ) {
+    Bars& bars( vAccumulator[ ix ].bars );
+    if ( 0 != bars.Size() ) {
+      const Width& width( m_vWidth[ ix ] );
+      std::string sPath;
+      SymbolPath( width.sBaseGroup, series.sSymbol, sPath );
+      HDF5WriteTimeSeries<Bars> wts( *m_pdm, true, true, 5, 256 );
+      if ( !wts.Write( sPath, &bars ) ) bOk = false;  // the remaining widths are still written
+    }
+  }
+  return bOk;
+}
+
+void HDF5BarResampler::Done( bool bOk, size_t cntBars ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  if ( bOk ) {
+    ++m_cntSeries;
+    m_cntBars += cntBars;
+  }
+  else {
+    ++m_cntFailed;
+  }
+  --m_cntOutstanding;
+  if ( 0 == m_cntOutstanding ) {
+    m_cvDone.notify_all();
+  }
+}
+
+} // namespace tf
+} // namespace ou
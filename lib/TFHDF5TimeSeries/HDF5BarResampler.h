@@ -0,0 +1,240 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// resamples trade or bar datasets into wider bar datasets, across a universe of symbols,
+//   so scans can read precomputed bars rather than aggregating on each run:
+//   each source dataset is read once, in one call, and feeds all configured widths in the one pass
+//   symbols are aggregated in parallel on a pool of threads,
+//     hdf5 reads and writes are serialized, with other hdf5 users, by HDF5DataManager::Mutex, as the library is not re-entrant
+//   with a session set, data outside the session, on weekends, or on holidays is dropped,
+//     intraday bars are aligned to the session open and do not straddle the close,
+//     and daily bars carry the exchange date
+//   without a session, bars are aligned to midnight utc, as with BarFactory
+//   results are written to /bar/<seconds>/<x>/<y>/<symbol>, the layout of DailyBarPath
+
+// usage:
+//  HDF5BarResampler resampler;
+//  resampler.AddWidth( 300 );
+//  resampler.AddWidth( 86400 );
+//  resampler.SetSession( time_duration( 9, 30, 0 ), time_duration( 16, 0, 0 ) );
+//  resampler.AddGroup( "/bar/60/" );
+//  resampler.Run<ou::tf::Bar>();
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/asio.hpp>
+#include <boost/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <TFTimeSeries/TimeSeries.h>
+#include <TFTimeSeries/ExchangeHolidays.h>
+
+#include "HDF5DataManager.h"
+#include "HDF5WriteTimeSeries.h"
+#include "HDF5TimeSeriesContainer.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+class HDF5BarResampler {
+public:
+
+  typedef unsigned long duration_t;  // seconds
+  typedef holidays::exchange::setDates_t setDates_t;
+
+  HDF5BarResampler( unsigned int nThreads = 0 );  // 0 uses hardware concurrency
+  ~HDF5BarResampler( void );
+
+  void AddWidth( duration_t nSeconds, const std::string& sBaseGroup = "" );  // 86400 for daily bars, default group is /bar/<seconds>/
+  void SetSession( 
+    boost::posix_time::time_duration tdOpen, boost::posix_time::time_duration tdClose,  // exchange local time
+    const std::string& sZone = "America/New_York", const setDates_t& setHolidays = holidays::exchange::setUSDates );
+
+  void AddSeries( const std::string& sSymbol, const std::string& sSourcePath );
+  void AddGroup( const std::string& sBaseGroup );  // each dataset below the group, dataset name as symbol
+
+  template<typename DD>  // Trade or Bar
+  void Run( void );  // returns when all series have been written
+
+  static void BarPath( duration_t nSeconds, const std::string& sSymbol, std::string& sPath );
+
+  size_t CountSeries( void ) const { return m_cntSeries; };
+  size_t CountBars( void ) const { return m_cntBars; };
+  size_t CountFailed( void ) const { return m_cntFailed; };
+
+protected:
+private:
+
+  struct Width {
+    duration_t nSeconds;
+    std::string sBaseGroup;
+    Width( duration_t nSeconds_, const std::string& sBaseGroup_ ): nSeconds( nSeconds_ ), sBaseGroup( sBaseGroup_ ) {};
+  };
+  typedef std::vector<Width> vWidth_t;
+
+  struct Series {
+    std::string sSymbol;
+    std::string sSourcePath;
+    Series( const std::string& sSymbol_, const std::string& sSourcePath_ ): sSymbol( sSymbol_ ), sSourcePath( sSourcePath_ ) {};
+  };
+  typedef std::vector<Series> vSeries_t;
+
+  struct Day {  // session day the last datum fell in
+    boost::gregorian::date date;
+    boost::posix_time::ptime dtOpen;  // utc
+    boost::posix_time::ptime dtClose;  // utc
+  };
+
+  struct Accumulator {  // bars of one width for one series
+    duration_t nSeconds;
+    bool bActive;
+    boost::posix_time::ptime dtEnd;
+    Bar bar;
+    Bars bars;
+    Accumulator( duration_t nSeconds_ ): nSeconds( nSeconds_ ), bActive( false ) {};
+  };
+  typedef std::vector<Accumulator> vAccumulator_t;
+
+  vWidth_t m_vWidth;
+  vSeries_t m_vSeries;
+
+  bool m_bSession;
+  boost::posix_time::time_duration m_tdOpen;
+  boost::posix_time::time_duration m_tdClose;
+  std::string m_sZone;
+  setDates_t m_setHolidays;
+
+  unsigned int m_nThreads;
+
+  HDF5DataManager* m_pdm;
+
+  boost::mutex m_mutex;
+  boost::condition_variable m_cvDone;
+  size_t m_cntOutstanding;
+
+  size_t m_cntSeries;
+  size_t m_cntBars;
+  size_t m_cntFailed;
+
+  static void SymbolPath( const std::string& sBaseGroup, const std::string& sSymbol, std::string& sPath );
+
+  void HandleObject( const std::string& sObjectPath, const std::string& sObjectName );
+
+  bool LocateDay( const boost::posix_time::ptime& dt, Day& day ) const;  // false when outside of the session
+  void Accumulate( Accumulator& acc, const Day& day, const boost::posix_time::ptime& dt, const Bar& datum ) const;
+  bool Write( const Series& series, vAccumulator_t& vAccumulator );  // false when a width failed to write
+  void Done( bool bOk, size_t cntBars );
+
+  static Bar ToBar( const Trade& trade ) { return Bar( trade.DateTime(), trade.Price(), trade.Price(), trade.Price(), trade.Price(), trade.Volume() ); };
+  static const Bar& ToBar( const Bar& bar ) { return bar; };
+
+  template<typename DD>
+  void Resample( const Series& series );
+
+};
+
+template<typename DD>
+void HDF5BarResampler::Run( void ) {
+
+  m_cntSeries = m_cntBars = m_cntFailed = 0;
+  if ( m_vWidth.empty() || m_vSeries.empty() ) return;
+
+  {
+    HDF5DataManager::mutex_t::scoped_lock lock( HDF5DataManager::Mutex() );
+    m_pdm = new HDF5DataManager( HDF5DataManager::RDWR );
+  }
+
+  boost::asio::io_service srvc;
+  boost::thread_group threads;
+  m_cntOutstanding = m_vSeries.size();
+  for ( vSeries_t::const_iterator iter = m_vSeries.begin(); m_vSeries.end() != iter; ++iter ) {
+    srvc.post( boost::bind( &HDF5BarResampler::Resample<DD>, this, *iter ) );
+  }
+  for ( unsigned int ix = 0; ix < std::min<size_t>( m_nThreads, m_vSeries.size() ); ++ix ) {
+    threads.create_thread( boost::bind( &boost::asio::io_service::run, &srvc ) );  // run returns once the queue is drained
+  }
+
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    while ( 0 != m_cntOutstanding ) {
+      m_cvDone.wait( lock );
+    }
+  }
+  threads.join_all();
+
+  HDF5DataManager::mutex_t::scoped_lock lock( HDF5DataManager::Mutex() );
+  m_pdm->Flush();
+  delete m_pdm;
+  m_pdm = 0;
+}
+
+template<typename DD>
+void HDF5BarResampler::Resample( const Series& series ) {
+
+  vAccumulator_t vAccumulator;
+  for ( vWidth_t::const_iterator iter = m_vWidth.begin(); m_vWidth.end() != iter; ++iter ) {
+    vAccumulator.push_back( Accumulator( iter->nSeconds ) );
+  }
+
+  bool bOk( true );
+  size_t cntBars( 0 );
+  try {
+    Day day;
+    TimeSeries<DD> source;
+    {
+      // the whole range in one read, one open of the dataset, the aggregation then proceeds without the lock
+      HDF5DataManager::mutex_t::scoped_lock lock( HDF5DataManager::Mutex() );
+      HDF5TimeSeriesContainer<DD> repository( *m_pdm, series.sSourcePath );
+      typename HDF5TimeSeriesContainer<DD>::iterator begin( repository.begin() ), end( repository.end() );
+      source.Resize( end - begin );
+      repository.Read( begin, end, &source );
+    }
+    for ( typename TimeSeries<DD>::const_iterator iter = source.begin(); source.end() != iter; ++iter ) {
+      const boost::posix_time::ptime& dt( iter->DateTime() );
+      if ( LocateDay( dt, day ) ) {
+        for ( typename vAccumulator_t::iterator iterAcc = vAccumulator.begin(); vAccumulator.end() != iterAcc; ++iterAcc ) {
+          Accumulate( *iterAcc, day, dt, ToBar( *iter ) );
+        }
+      }
+    }
+
+    for ( typename vAccumulator_t::iterator iter = vAccumulator.begin(); vAccumulator.end() != iter; ++iter ) {
+      if ( iter->bActive ) iter->bars.Append( iter->bar );
+      cntBars += iter->bars.Size();
+    }
+    bOk = Write( series, vAccumulator );
+  }
+  catch ( std::runtime_error& e ) {
+    std::cout << "HDF5BarResampler::Resample " << series.sSourcePath << ": " << e.what() << std::endl;
+    bOk = false;
+  }
+  catch ( H5::Exception& e ) {
+    std::cout << "HDF5BarResampler::Resample " << series.sSourcePath << ": " << e.getDetailMsg() << std::endl;
+    bOk = false;
+  }
+  catch ( ... ) {
+    std::cout << "HDF5BarResampler::Resample " << series.sSourcePath << ": unknown error" << std::endl;
+    bOk = false;
+  }
+  Done( bOk, cntBars );
+}
+
+} // namespace tf
+} // namespace ou
@@ -18,12 +18,14 @@
 #include <stdexcept>
 
 #include "HDF5DataManager.h"
+#include "TickCodec.h"
 
 namespace ou { // One Unified
 namespace tf { // TradeFrame
 
 //const char HDF5DataManager::m_H5FileName[] = "TradeFrame.%03d.hdf5";
 const char HDF5DataManager::m_H5FileName[] = "TradeFrame.hdf5";
+HDF5DataManager::mutex_t HDF5DataManager::m_mutex;
 //H5::H5File HDF5DataManager::m_H5File;
 //unsigned int HDF5DataManager::m_RefCount = 0;
 
@@ -32,6 +34,7 @@ const char HDF5DataManager::m_H5FileName[] = "TradeFrame.hdf5";
 //  needs a good rethink and re-architect for file handle handling
 
 HDF5DataManager::HDF5DataManager( enumFileOptionType fot ) {
+  TickCodec::RegisterFilter();  // so datasets written with the tick codec can be read
 //  ++m_RefCount;
 //  if ( 1 == m_RefCount ) {
     //std::cout << "Opening DataManager" << std::endl;
@@ -18,6 +18,7 @@
 #include <hdf5/H5Cpp.h>
 
 #include <boost/function.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 
 namespace ou { // One Unified
 namespace tf { // TradeFrame
@@ -39,12 +40,18 @@ public:
 
   typedef boost::function<void (const std::string& )> callbackIteratePath_t;
   void IteratePathParts( const std::string& sPath, callbackIteratePath_t object );
+
+  // the hdf5 library is not built thread safe, and all instances share it:  a thread making hdf5 calls,
+  //   through any instance, and including construction and destruction, holds this lock for the duration
+  typedef boost::recursive_mutex mutex_t;
+  static mutex_t& Mutex( void ) { return m_mutex; };
 protected:
   static const char m_H5FileName[];
 //  static unsigned int m_RefCount;
 //  static H5::H5File m_H5File;
   H5::H5File m_H5File;
 private:
+  static mutex_t m_mutex;
 };
 
 } // namespace tf
@@ -0,0 +1,157 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#include <iostream>
+
+#include <boost/bind.hpp>
+
+#include "HDF5TickCapture.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+HDF5TickCapture::HDF5TickCapture( hsize_t nChunkSize, int nDeflate )
+  : m_nChunkSize( nChunkSize ), m_nDeflate( nDeflate ),
+  m_pdm( 0 ),
+  m_bWriting( false ), m_bStop( false )
+{
+  assert( 0 < m_nChunkSize );
+  assert( 0 < m_nDeflate );
+  {
+    HDF5DataManager::mutex_t::scoped_lock lock( HDF5DataManager::Mutex() );
+    m_pdm = new HDF5DataManager( HDF5DataManager::RDWR );
+  }
+  m_thread = boost::thread( boost::bind( &HDF5TickCapture::Run, this ) );
+}
+
+HDF5TickCapture::~HDF5TickCapture( void ) {
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    m_bStop = true;
+  }
+  m_cvQueue.notify_one();
+  m_thread.join();  // the queue is drained before the thread exits
+  HDF5DataManager::mutex_t::scoped_lock lock( HDF5DataManager::Mutex() );
+  delete m_pdm;
+  m_pdm = 0;
+}
+
+void HDF5TickCapture::Queue( pBatch_base_t pBatch ) {
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    m_qBatch.push_back( pBatch );
+    m_stats.nQueued += pBatch->Size();
+    if ( m_stats.nQueuedMax < m_stats.nQueued ) m_stats.nQueuedMax = m_stats.nQueued;
+  }
+  m_cvQueue.notify_one();
+}
+
+void HDF5TickCapture::Flush( void ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  while ( !m_qBatch.empty() || m_bWriting ) {
+    m_cvIdle.wait( lock );
+  }
+}
+
+HDF5TickCapture::Stats HDF5TickCapture::GetStats( void ) const {
+  boost::mutex::scoped_lock lock( m_mutex );
+  return m_stats;
+}
+
+void HDF5TickCapture::Run( void ) {
+  while ( true ) {
+    pBatch_base_t pBatch;
+    {
+      boost::mutex::scoped_lock lock( m_mutex );
+      while ( m_qBatch.empty() && !m_bStop ) {
+        m_cvQueue.wait( lock );
+      }
+      if ( m_qBatch.empty() ) break;  // stopping, and nothing left to write
+      pBatch = m_qBatch.front();
+      m_qBatch.pop_front();
+      m_bWriting = true;
+    }
+    Write( *pBatch );
+    {
+      boost::mutex::scoped_lock lock( m_mutex );
+      m_bWriting = false;
+      if ( m_qBatch.empty() ) m_cvIdle.notify_all();
+    }
+  }
+}
+
+bool HDF5TickCapture::DataSetExists( const std::string& sPathName ) {
+  try {
+    H5::DataSet dataset( m_pdm->GetH5File()->openDataSet( sPathName ) );
+    dataset.close();
+    return true;
+  }
+  catch ( H5::Exception& ) {
+    return false;
+  }
+}
+
+bool HDF5TickCapture::HasAttributes( const std::string& sPathName ) {
+  H5::DataSet dataset( m_pdm->GetH5File()->openDataSet( sPathName ) );
+  bool bHas( dataset.attrExists( "Signature" ) );  // as HDF5Attributes names it, the first one set
+  dataset.close();
+  return bHas;
+}
+
+void HDF5TickCapture::Write( Batch& batch ) {
+  bool bOk( true );
+  boost::posix_time::ptime dtStart( boost::posix_time::microsec_clock::universal_time() );
+  {
+    HDF5DataManager::mutex_t::scoped_lock lock( HDF5DataManager::Mutex() );
+    try {
+      bOk = batch.Write( *m_pdm, m_nChunkSize, m_nDeflate );  // hdf5 errors are reported there
+      // attributes go with the first batch written to a dataset, one from an earlier run has them
+      if ( bOk && ( m_setSeen.end() == m_setSeen.find( batch.sPathName ) ) ) {
+        if ( !HasAttributes( batch.sPathName ) ) {
+          HDF5Attributes attributes( *m_pdm, batch.sPathName );
+          attributes.SetSignature( batch.attributes.nSignature );
+          attributes.SetMultiplier( batch.attributes.nMultiplier );
+          attributes.SetSignificantDigits( batch.attributes.nSignificantDigits );
+          attributes.SetProviderType( batch.attributes.idProvider );
+        }
+        m_setSeen.insert( batch.sPathName );
+      }
+      m_pdm->Flush();  // what has been written survives a crash
+    }
+    catch ( std::exception& e ) {
+      std::cout << "HDF5TickCapture::Write " << batch.sPathName << ": " << e.what() << std::endl;
+      bOk = false;
+    }
+    catch ( H5::Exception& e ) {
+      std::cout << "HDF5TickCapture::Write " << batch.sPathName << ": " << e.getDetailMsg() << std::endl;
+      bOk = false;
+    }
+  }
+  boost::posix_time::time_duration td( boost::posix_time::microsec_clock::universal_time() - dtStart );
+
+  boost::mutex::scoped_lock lock( m_mutex );
+  m_stats.nQueued -= batch.Size();
+  m_stats.tdWriting += td;
+  if ( bOk ) {
+    ++m_stats.nBatches;
+    m_stats.nDatums += batch.Size();
+    m_stats.nBytes += batch.Bytes();
+  }
+  else {
+    ++m_stats.nFailed;
+  }
+}
+
+} // namespace tf
+} // namespace ou
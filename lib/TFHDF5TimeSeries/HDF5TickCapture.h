@@ -0,0 +1,180 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// write-behind capture of live series, in place of writing whole series at end of day:
+//   producers hand over batches of datums, a background thread appends each batch
+//     to the end of an extendable, chunked, deflated dataset
+//   the file is flushed after each batch, so a crash loses only what is still queued or staged,
+//     and LastCaptured gives the point to carry on from on restart
+//   batches are to be whole chunks (a multiple of nChunkSize), so a flushed chunk is not rewritten:
+//     a deflated chunk which is rewritten moves, and a crash during the move can take the flushed copy with it
+//   only the final batch of a session may be partial, so nothing staged is lost on shutdown:
+//     the next session's first batch tops up that chunk, sized from ChunkSize and the count from LastCaptured,
+//     so its later batches are whole chunks again, and the partial chunk is rewritten just the once
+//   hdf5 calls are made through one file handle, and hold HDF5DataManager::Mutex, as the library is not re-entrant:
+//     other hdf5 users in the process, such as Watch::SaveSeries, are serialized with the capture's writer thread
+
+// usage:
+//  HDF5TickCapture capture;
+//  boost::shared_ptr<Quotes> pQuotes( new Quotes );
+//  ... pQuotes->Append( quote ) ...
+//  capture.Append( "/quotes/GLD", pQuotes, attributes );  // pQuotes is not to be touched after
+//  capture.Flush();  // returns once queued batches are on disk
+
+#include <set>
+#include <deque>
+#include <string>
+
+#include <boost/thread.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <TFTrading/KeyTypes.h>
+
+#include "HDF5DataManager.h"
+#include "HDF5Attribute.h"
+#include "HDF5WriteTimeSeries.h"
+#include "HDF5TimeSeriesContainer.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+class HDF5TickCapture {
+public:
+
+  struct Attributes {  // written once to each dataset, on its first batch
+    boost::uint64_t nSignature;
+    unsigned short nMultiplier;
+    unsigned char nSignificantDigits;
+    keytypes::eidProvider_t idProvider;
+    Attributes( void ): nSignature( 0 ), nMultiplier( 1 ), nSignificantDigits( 2 ), idProvider( keytypes::EProviderUnknown ) {};
+    Attributes( boost::uint64_t nSignature_, unsigned short nMultiplier_, unsigned char nSignificantDigits_, keytypes::eidProvider_t idProvider_ )
+      : nSignature( nSignature_ ), nMultiplier( nMultiplier_ ), nSignificantDigits( nSignificantDigits_ ), idProvider( idProvider_ ) {};
+  };
+
+  struct Stats {
+    size_t nBatches;  // written
+    size_t nDatums;
+    size_t nBytes;  // in memory size of the datums written
+    size_t nQueued;  // datums waiting
+    size_t nQueuedMax;
+    size_t nFailed;  // batches
+    boost::posix_time::time_duration tdWriting;  // spent in hdf5, including flushes
+    Stats( void ): nBatches( 0 ), nDatums( 0 ), nBytes( 0 ), nQueued( 0 ), nQueuedMax( 0 ), nFailed( 0 ) {};
+    double DatumsPerSecond( void ) const {
+      return ( 0 == tdWriting.total_microseconds() ) ? 0.0 : ( 1e6 * nDatums ) / tdWriting.total_microseconds();
+    }
+  };
+
+  HDF5TickCapture( hsize_t nChunkSize = 256, int nDeflate = 5 );  // dataset chunking and compression
+  ~HDF5TickCapture( void );  // writes whatever is still queued
+
+  template<typename TS>
+  void Append( const std::string& sPathName, boost::shared_ptr<TS> pBatch, const Attributes& attributes );
+
+  // time of the last datum on disk, not_a_date_time when there is none, for carrying on after a restart,
+  //   with the count of datums on disk in *pnCaptured, when given
+  template<typename TS>
+  boost::posix_time::ptime LastCaptured( const std::string& sPathName, size_t* pnCaptured = 0 );
+
+  hsize_t ChunkSize( void ) const { return m_nChunkSize; };
+
+  void Flush( void );  // returns once the queue has been written
+
+  Stats GetStats( void ) const;
+
+protected:
+private:
+
+  struct Batch {
+    std::string sPathName;
+    Attributes attributes;
+    Batch( const std::string& sPathName_, const Attributes& attributes_ ): sPathName( sPathName_ ), attributes( attributes_ ) {};
+    virtual ~Batch( void ) {};
+    virtual size_t Size( void ) const = 0;
+    virtual size_t Bytes( void ) const = 0;
+    virtual bool Write( HDF5DataManager& dm, hsize_t nChunkSize, int nDeflate ) = 0;  // false when hdf5 failed
+  };
+  typedef boost::shared_ptr<Batch> pBatch_base_t;
+
+  template<typename TS>
+  struct BatchSeries: public Batch {
+    boost::shared_ptr<TS> pSeries;
+    BatchSeries( const std::string& sPathName_, const Attributes& attributes_, boost::shared_ptr<TS> pSeries_ )
+      : Batch( sPathName_, attributes_ ), pSeries( pSeries_ ) {};
+    virtual size_t Size( void ) const { return pSeries->Size(); };
+    virtual size_t Bytes( void ) const { return pSeries->Size() * sizeof( typename TS::datum_t ); };
+    virtual bool Write( HDF5DataManager& dm, hsize_t nChunkSize, int nDeflate ) {
+      HDF5WriteTimeSeries<TS> wts( dm, true, true, nDeflate, nChunkSize );
+      return wts.Append( sPathName, pSeries.get() );
+    }
+  };
+
+  typedef std::deque<pBatch_base_t> qBatch_t;
+  typedef std::set<std::string> setPathName_t;
+
+  hsize_t m_nChunkSize;
+  int m_nDeflate;
+
+  HDF5DataManager* m_pdm;  // used with HDF5DataManager::Mutex held
+  setPathName_t m_setSeen;  // datasets written to this session, with their attributes in place
+
+  mutable boost::mutex m_mutex;  // queue and stats
+  boost::condition_variable m_cvQueue;  // batch added, or stopping
+  boost::condition_variable m_cvIdle;  // queue emptied
+  qBatch_t m_qBatch;
+  bool m_bWriting;  // a batch is out of the queue, being written
+  bool m_bStop;
+  Stats m_stats;
+
+  boost::thread m_thread;
+
+  void Queue( pBatch_base_t pBatch );
+  void Run( void );  // the writer thread
+  void Write( Batch& batch );
+  bool DataSetExists( const std::string& sPathName );  // with HDF5DataManager::Mutex held
+  bool HasAttributes( const std::string& sPathName );  // with HDF5DataManager::Mutex held, the dataset is to exist
+
+};
+
+template<typename TS>
+void HDF5TickCapture::Append( const std::string& sPathName, boost::shared_ptr<TS> pBatch, const Attributes& attributes ) {
+  if ( 0 != pBatch->Size() ) {
+    Queue( pBatch_base_t( new BatchSeries<TS>( sPathName, attributes, pBatch ) ) );
+  }
+}
+
+template<typename TS>
+boost::posix_time::ptime HDF5TickCapture::LastCaptured( const std::string& sPathName, size_t* pnCaptured ) {
+  typedef typename TS::datum_t DD;
+  boost::posix_time::ptime dtLast( boost::posix_time::not_a_date_time );
+  if ( 0 != pnCaptured ) *pnCaptured = 0;
+  HDF5DataManager::mutex_t::scoped_lock lock( HDF5DataManager::Mutex() );
+  if ( DataSetExists( sPathName ) ) {
+    HDF5TimeSeriesContainer<DD> repository( *m_pdm, sPathName );
+    if ( 0 != pnCaptured ) *pnCaptured = repository.size();
+    if ( 0 != repository.size() ) {
+      typename HDF5TimeSeriesContainer<DD>::iterator iter( repository.end() );
+      iter -= 1;
+      dtLast = (*iter).DateTime();
+    }
+  }
+  return dtLast;
+}
+
+} // namespace tf
+} // namespace ou
@@ -15,6 +15,8 @@
 #pragma once
 
 #include <string>
+#include <stdexcept>
+#include <algorithm>
 
 #include <OUCommon/Delegate.h>
 
@@ -41,10 +43,13 @@ public:
   //void Read( const iterator &_begin, const iterator &_end, T* _dest ); 
   void Read( iterator &_begin, iterator &_end, typename ou::tf::TimeSeries<DD>* _dest ); 
   void Write( const DD* _begin, const DD* _end );
+  void Write( const ou::tf::TimeSeries<DD>& series );  // block by block when segmented
+  void Append( const ou::tf::TimeSeries<DD>& series );  // after the last element, regardless of time
 protected:
   iterator* m_end;
   virtual void SetNewSize( size_type newsize );
 private:
+  void WriteAt( hsize_t ix, const ou::tf::TimeSeries<DD>& series );
 };
 
 template<class DD> HDF5TimeSeriesContainer<DD>::HDF5TimeSeriesContainer( HDF5DataManager& dm, const std::string& sPathName ):
@@ -77,12 +82,21 @@ template<class DD> void HDF5TimeSeriesContainer<DD>::SetNewSize( size_type newsi
 
 template<class DD> void HDF5TimeSeriesContainer<DD>::Read( iterator& _begin, iterator& _end, typename ou::tf::TimeSeries<DD>* _dest ) {
   hsize_t cnt = _end - _begin;
-  H5::DataSpace* pDs = _dest->DefineDataSpace();
   if ( cnt > 0 ) {
-    HDF5TimeSeriesAccessor<DD>::Read( _begin.m_ItemIndex, cnt, pDs, const_cast<DD*>( &(*_dest->First()) ) );
+    if ( _dest->Size() < cnt ) {
+      throw std::runtime_error( "HDF5TimeSeriesContainer<DD>::Read destination is smaller than the range" );
+    }
+    // one read per block, so a segmented destination is filled in place, a contiguous one is the one block
+    hsize_t ix = _begin.m_ItemIndex;
+    for ( typename ou::tf::TimeSeries<DD>::size_type ixBlock = 0; ( 0 < cnt ) && ( ixBlock < _dest->Blocks() ); ++ixBlock ) {
+      hsize_t n = std::min<hsize_t>( cnt, _dest->BlockEnd( ixBlock ) - _dest->BlockBegin( ixBlock ) );
+      H5::DataSpace ds( 1, &n );
+      HDF5TimeSeriesAccessor<DD>::Read( ix, n, &ds, const_cast<DD*>( _dest->BlockBegin( ixBlock ) ) );
+      ds.close();
+      ix += n;
+      cnt -= n;
+    }
   }
-  pDs->close();
-  delete pDs;
 }
 
 template<class DD> void HDF5TimeSeriesContainer<DD>::Write( const DD* _begin, const DD* _end ) {
@@ -95,5 +109,26 @@ template<class DD> void HDF5TimeSeriesContainer<DD>::Write( const DD* _begin, co
   }
 }
 
+template<class DD> void HDF5TimeSeriesContainer<DD>::Write( const ou::tf::TimeSeries<DD>& series ) {
+  if ( 0 < series.Size() ) {
+    std::pair<HDF5TimeSeriesContainer<DD>::iterator, HDF5TimeSeriesContainer<DD>::iterator> p;
+    p = equal_range( begin(), end(), *series.BlockBegin( 0 ) );
+    WriteAt( p.first.m_ItemIndex, series );
+  }
+}
+
+template<class DD> void HDF5TimeSeriesContainer<DD>::Append( const ou::tf::TimeSeries<DD>& series ) {
+  WriteAt( this->size(), series );
+}
+
+template<class DD> void HDF5TimeSeriesContainer<DD>::WriteAt( hsize_t ix, const ou::tf::TimeSeries<DD>& series ) {
+  // later blocks follow on from the first, rather than being placed by their own first datum
+  for ( typename ou::tf::TimeSeries<DD>::size_type ixBlock = 0; ixBlock < series.Blocks(); ++ixBlock ) {
+    size_t cnt = series.BlockEnd( ixBlock ) - series.BlockBegin( ixBlock );
+    HDF5TimeSeriesAccessor<DD>::Write( ix, cnt, series.BlockBegin( ixBlock ) );
+    ix += cnt;
+  }
+}
+
 } // namespace tf
 } // namespace ou
@@ -18,6 +18,7 @@
 #include <stdexcept>
 
 #include "HDF5TimeSeriesContainer.h"
+#include "TickCodec.h"
 
 namespace ou { // One Unified
 namespace tf { // TradeFrame
@@ -31,7 +32,10 @@ public:
   HDF5WriteTimeSeries<TS>( HDF5DataManager& dm );  // dm needs to be read/write
   HDF5WriteTimeSeries<TS>( HDF5DataManager& dm, bool bDeflatable, bool bExpandable, int nDeflate = 5, hsize_t nChunkSize = 1024 );
   virtual ~HDF5WriteTimeSeries<TS>( void );
-  void Write( const std::string &sPathName, TS* timeseries );
+  bool Write( const std::string &sPathName, TS* timeseries );  // false when hdf5 failed, the error is reported to std::cout
+  bool Append( const std::string &sPathName, TS* timeseries );  // after what is already in the dataset, as with a capture, false as with Write
+  // new datasets of quotes, trades or bars use TickCodec in place of shuffle and deflate, needs bExpandable for the chunking
+  void SetTickCodec( double dblMinTick ) { m_bTickCodec = true; m_dblMinTick = dblMinTick; };
 
 protected:
 private:
@@ -40,15 +44,20 @@ private:
   int m_nDeflate;
   bool m_bExpandable;
   hsize_t m_nChunkSize;
+  bool m_bTickCodec;
+  double m_dblMinTick;
+  void CreateDataSet( const std::string &sPathName );  // when not already present
 };
 
 template<class TS> HDF5WriteTimeSeries<TS>::HDF5WriteTimeSeries( HDF5DataManager& dm ) 
-: m_dm( dm ), m_bDeflatable( false ), m_bExpandable( false ), m_nDeflate( 0 ), m_nChunkSize( 0 )
+: m_dm( dm ), m_bDeflatable( false ), m_bExpandable( false ), m_nDeflate( 0 ), m_nChunkSize( 0 ),
+  m_bTickCodec( false ), m_dblMinTick( 0.0 )
 {
 }
 
 template<class TS> HDF5WriteTimeSeries<TS>::HDF5WriteTimeSeries( HDF5DataManager& dm, bool bDeflatable, bool bExpandable, int nDeflate, hsize_t nChunkSize )
-: m_dm( dm ), m_bDeflatable( bDeflatable ), m_bExpandable( bExpandable ), m_nDeflate( nDeflate ), m_nChunkSize( nChunkSize )
+: m_dm( dm ), m_bDeflatable( bDeflatable ), m_bExpandable( bExpandable ), m_nDeflate( nDeflate ), m_nChunkSize( nChunkSize ),
+  m_bTickCodec( false ), m_dblMinTick( 0.0 )
 {
   if ( bDeflatable ) assert( 0 < nDeflate );
   if ( bExpandable ) assert( 0 < nChunkSize );
@@ -57,12 +66,60 @@ template<class TS> HDF5WriteTimeSeries<TS>::HDF5WriteTimeSeries( HDF5DataManager
 template<class TS> HDF5WriteTimeSeries<TS>::~HDF5WriteTimeSeries() {
 }
 
-template<class TS> void HDF5WriteTimeSeries<TS>::Write(const std::string &sPathName, TS* timeseries) {
+template<class TS> bool HDF5WriteTimeSeries<TS>::Write(const std::string &sPathName, TS* timeseries) {
 
   if ( 0 == timeseries->Size() ) {
     throw std::invalid_argument( "zero length time series found" );
   }
 
+  bool bOk( false );
+
+  CreateDataSet( sPathName );
+
+  try {
+    HDF5TimeSeriesContainer<DD> repository( m_dm, sPathName );
+    repository.Write( *timeseries );
+    bOk = true;
+    //dm.AddGroupForSymbol( m_sSymbol );
+    //dm.GetH5File()->link( H5L_type_t::H5L_TYPE_HARD, sFileName1, "/symbol/" + m_sSymbol + "/bar.86400" );
+  }
+  catch ( H5::FileIException e ) {
+    std::cout << "H5::FileIException " << e.getDetailMsg() << std::endl;
+    e.walkErrorStack( H5E_WALK_DOWNWARD, (H5E_walk2_t) &HDF5DataManager::PrintH5ErrorStackItem, this );
+  }
+  catch ( ... ) {
+    std::cout << "CHistoryCollectorDaily::WriteData:  unknown error 2" << std::endl;
+  }
+  return bOk;
+}
+
+template<class TS> bool HDF5WriteTimeSeries<TS>::Append(const std::string &sPathName, TS* timeseries) {
+
+  if ( 0 == timeseries->Size() ) {
+    throw std::invalid_argument( "zero length time series found" );
+  }
+
+  bool bOk( false );
+
+  CreateDataSet( sPathName );
+
+  try {
+    HDF5TimeSeriesContainer<DD> repository( m_dm, sPathName );
+    repository.Append( *timeseries );
+    bOk = true;
+  }
+  catch ( H5::FileIException e ) {
+    std::cout << "H5::FileIException " << e.getDetailMsg() << std::endl;
+    e.walkErrorStack( H5E_WALK_DOWNWARD, (H5E_walk2_t) &HDF5DataManager::PrintH5ErrorStackItem, this );
+  }
+  catch ( ... ) {
+    std::cout << "HDF5WriteTimeSeries::Append:  unknown error" << std::endl;
+  }
+  return bOk;
+}
+
+template<class TS> void HDF5WriteTimeSeries<TS>::CreateDataSet( const std::string &sPathName ) {
+
   H5::DataSet *dataset;
   bool bNeedToCreateDataSet = false;
   //HDF5DataManager dm( HDF5DataManager::RDWR );
@@ -99,9 +156,15 @@ template<class TS> void HDF5WriteTimeSeries<TS>::Write(const std::string &sPathN
       if ( m_bExpandable ) {
         pl.setChunk( 1, &m_nChunkSize );
       }
-      if ( m_bDeflatable ) {
-        pl.setShuffle();
-        pl.setDeflate(m_nDeflate);
+      TickCodec::EKind kind( TickCodec::Kind( static_cast<const DD*>( 0 ) ) );
+      if ( m_bTickCodec && m_bExpandable && ( TickCodec::ENone != kind ) ) {
+        TickCodec::SetFilter( pl, kind, m_dblMinTick );
+      }
+      else {
+        if ( m_bDeflatable ) {
+          pl.setShuffle();
+          pl.setDeflate(m_nDeflate);
+        }
       }
 
       dataset = new H5::DataSet( m_dm.GetH5File()->createDataSet( sPathName, *pdt, *pds, pl ) );
@@ -121,20 +184,6 @@ template<class TS> void HDF5WriteTimeSeries<TS>::Write(const std::string &sPathN
     std::cout << "H5::FileIException " << e.getDetailMsg() << std::endl;
     e.walkErrorStack( H5E_WALK_DOWNWARD, (H5E_walk2_t) &HDF5DataManager::PrintH5ErrorStackItem, this );
   }
-
-  try {
-    HDF5TimeSeriesContainer<DD> repository( m_dm, sPathName );
-    repository.Write( timeseries->First(), timeseries->Last() + 1 );
-    //dm.AddGroupForSymbol( m_sSymbol );
-    //dm.GetH5File()->link( H5L_type_t::H5L_TYPE_HARD, sFileName1, "/symbol/" + m_sSymbol + "/bar.86400" );
-  }
-  catch ( H5::FileIException e ) {
-    std::cout << "H5::FileIException " << e.getDetailMsg() << std::endl;
-    e.walkErrorStack( H5E_WALK_DOWNWARD, (H5E_walk2_t) &HDF5DataManager::PrintH5ErrorStackItem, this );
-  }
-  catch ( ... ) {
-    std::cout << "CHistoryCollectorDaily::WriteData:  unknown error 2" << std::endl;
-  }
 }
 
 
@@ -0,0 +1,613 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+//#include "StdAfx.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <cstring>
+#include <algorithm>
+
+#include "TickCodec.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+namespace {
+
+  const unsigned char rMagicBlock[] = { 'O', 'U', 'T', 'C' };
+  const size_t nMagicBlock = 4;
+  const unsigned char nVersionBlock = 1;
+
+  const char szMagicFile[] = "OUTICKS1";
+  const size_t nMagicFile = 8;
+  const boost::uint32_t nVersionFile = 1;
+  const size_t nHeaderFile = nMagicFile + 4 + 4 + 8;
+
+  // packed record layouts, as DefineDataType, packed: int64 time, doubles, then int32 sizes
+  const size_t nQuote = 32;  // time, bid, ask, bid size, ask size
+  const size_t nTrade = 20;  // time, price, size
+  const size_t nBar = 44;  // time, open, high, low, close, volume
+
+  const size_t nMaxVarint = 10;
+
+  // a price needs to be exact as an integer in a double, with room for the deltas
+  const double dblMaxUnits = 4503599627370496.0;  // 2^52
+
+  inline boost::int64_t GetInt64( const unsigned char* p ) { boost::int64_t n; std::memcpy( &n, p, 8 ); return n; }
+  inline boost::int32_t GetInt32( const unsigned char* p ) { boost::int32_t n; std::memcpy( &n, p, 4 ); return n; }
+  inline double GetDouble( const unsigned char* p ) { double d; std::memcpy( &d, p, 8 ); return d; }
+  inline void PutInt64( unsigned char* p, boost::int64_t n ) { std::memcpy( p, &n, 8 ); }
+  inline void PutInt32( unsigned char* p, boost::int32_t n ) { std::memcpy( p, &n, 4 ); }
+  inline void PutDouble( unsigned char* p, double d ) { std::memcpy( p, &d, 8 ); }
+
+  // differences wrap, rather than overflow, so raw doubles and extreme values are still lossless
+  inline boost::int64_t Difference( boost::int64_t a, boost::int64_t b ) {
+    return static_cast<boost::int64_t>( static_cast<boost::uint64_t>( a ) - static_cast<boost::uint64_t>( b ) );
+  }
+  inline boost::int64_t Sum( boost::int64_t a, boost::int64_t b ) {
+    return static_cast<boost::int64_t>( static_cast<boost::uint64_t>( a ) + static_cast<boost::uint64_t>( b ) );
+  }
+
+  inline boost::uint64_t ZigZag( boost::int64_t n ) {
+    return ( static_cast<boost::uint64_t>( n ) << 1 ) ^ static_cast<boost::uint64_t>( n >> 63 );
+  }
+  inline boost::int64_t UnZigZag( boost::uint64_t n ) {
+    return static_cast<boost::int64_t>( n >> 1 ) ^ -static_cast<boost::int64_t>( n & 1 );
+  }
+
+  class Writer {
+  public:
+    Writer( unsigned char* p ): m_p( p ) {};
+    void Varint( boost::uint64_t n ) {
+      while ( 0x80 <= n ) {
+        *m_p++ = static_cast<unsigned char>( 0x80 | ( n & 0x7f ) );
+        n >>= 7;
+      }
+      *m_p++ = static_cast<unsigned char>( n );
+    }
+    void Signed( boost::int64_t n ) { Varint( ZigZag( n ) ); };
+    unsigned char* Position( void ) const { return m_p; };
+  private:
+    unsigned char* m_p;
+  };
+
+  class Reader {
+  public:
+    Reader( const unsigned char* p, const unsigned char* pEnd ): m_p( p ), m_pEnd( pEnd ) {};
+    boost::uint64_t Varint( void ) {
+      if ( ( m_pEnd != m_p ) && ( 0x80 > *m_p ) ) return *m_p++;  // most are a byte
+      boost::uint64_t n( 0 );
+      unsigned int nShift( 0 );
+      while ( m_pEnd != m_p ) {
+        unsigned char c( *m_p++ );
+        n |= static_cast<boost::uint64_t>( c & 0x7f ) << nShift;
+        if ( 0 == ( c & 0x80 ) ) return n;
+        nShift += 7;
+        if ( 63 < nShift ) break;
+      }
+      throw std::runtime_error( "TickCodec::Decode: damaged varint" );
+    }
+    boost::int64_t Signed( void ) { return UnZigZag( Varint() ); };
+    const unsigned char* Position( void ) const { return m_p; };
+  private:
+    const unsigned char* m_p;
+    const unsigned char* m_pEnd;
+  };
+
+  // a price as an integer count of 1 / dblScale, or with a scale of 0, the bits of the double
+  inline boost::int64_t ToUnits( double dblPrice, double dblScale ) {
+    if ( 0.0 == dblScale ) {
+      boost::int64_t n;
+      std::memcpy( &n, &dblPrice, 8 );
+      return n;
+    }
+    return static_cast<boost::int64_t>( floor( dblPrice * dblScale + 0.5 ) );
+  }
+  inline double FromUnits( boost::int64_t nUnits, double dblScale ) {
+    if ( 0.0 == dblScale ) {
+      double d;
+      std::memcpy( &d, &nUnits, 8 );
+      return d;
+    }
+    return static_cast<double>( nUnits ) / dblScale;
+  }
+
+  // compared as bits, as -0.0 equals 0.0, yet decodes as 0.0, so is left to the raw doubles
+  bool Reproduces( double dblPrice, double dblScale ) {
+    double dblUnits( floor( dblPrice * dblScale + 0.5 ) );
+    if ( dblMaxUnits <= fabs( dblUnits ) ) return false;
+    double dblDecoded( dblUnits / dblScale );
+    return 0 == std::memcmp( &dblPrice, &dblDecoded, sizeof( double ) );
+  }
+
+  // the price fields of a record, by offset
+  const size_t rQuotePrices[] = { 8, 16 };
+  const size_t rTradePrices[] = { 8 };
+  const size_t rBarPrices[] = { 8, 16, 24, 32 };
+
+  void PriceOffsets( TickCodec::EKind kind, const size_t*& pOffsets, size_t& nOffsets ) {
+    switch ( kind ) {
+    case TickCodec::EQuote: pOffsets = rQuotePrices; nOffsets = 2; break;
+    case TickCodec::ETrade: pOffsets = rTradePrices; nOffsets = 1; break;
+    case TickCodec::EBar: pOffsets = rBarPrices; nOffsets = 4; break;
+    default: pOffsets = 0; nOffsets = 0; break;
+    }
+  }
+
+  bool ScaleFits( TickCodec::EKind kind, double dblScale, const unsigned char* pRecords, size_t nRecords ) {
+    const size_t nRecord( TickCodec::RecordSize( kind ) );
+    const size_t* pOffsets;
+    size_t nOffsets;
+    PriceOffsets( kind, pOffsets, nOffsets );
+    for ( size_t ixRecord = 0; ixRecord < nRecords; ++ixRecord ) {
+      const unsigned char* pRecord( pRecords + ixRecord * nRecord );
+      for ( size_t ix = 0; ix < nOffsets; ++ix ) {
+        if ( !Reproduces( GetDouble( pRecord + pOffsets[ ix ] ), dblScale ) ) return false;
+      }
+    }
+    return true;
+  }
+
+  // units per price, the minimum tick's inverse when it reproduces each price, else a power of ten, else 0
+  double FindScale( TickCodec::EKind kind, double dblMinTick, const unsigned char* pRecords, size_t nRecords ) {
+    if ( 0.0 < dblMinTick ) {
+      double dblScale( floor( 1.0 / dblMinTick + 0.5 ) );
+      if ( 1.0 > dblScale ) dblScale = 1.0;  // ticks of a point or more
+      if ( ScaleFits( kind, dblScale, pRecords, nRecords ) ) return dblScale;
+    }
+    double dblScale( 1.0 );
+    for ( size_t ix = 0; ix <= 8; ++ix ) {
+      if ( ScaleFits( kind, dblScale, pRecords, nRecords ) ) return dblScale;
+      dblScale *= 10.0;
+    }
+    return 0.0;
+  }
+
+  // the per record state shared by the encoder and decoder
+  struct Prior {
+    boost::int64_t nTime;
+    boost::int64_t nTimeDelta;
+    boost::int64_t rnPrice[ 2 ];  // bid and spread, trade price, or bar close
+    boost::int64_t rnSize[ 2 ];
+    Prior( void ): nTime( 0 ), nTimeDelta( 0 ) {
+      rnPrice[ 0 ] = rnPrice[ 1 ] = 0;
+      rnSize[ 0 ] = rnSize[ 1 ] = 0;
+    }
+  };
+
+  inline void EncodeTime( Writer& writer, Prior& prior, boost::int64_t nTime ) {
+    boost::int64_t nDelta( Difference( nTime, prior.nTime ) );
+    writer.Signed( Difference( nDelta, prior.nTimeDelta ) );
+    prior.nTime = nTime;
+    prior.nTimeDelta = nDelta;
+  }
+
+  inline boost::int64_t DecodeTime( Reader& reader, Prior& prior ) {
+    prior.nTimeDelta = Sum( prior.nTimeDelta, reader.Signed() );
+    prior.nTime = Sum( prior.nTime, prior.nTimeDelta );
+    return prior.nTime;
+  }
+
+  void EncodeRecords( TickCodec::EKind kind, double dblScale, const unsigned char* pRecords, size_t nRecords, Writer& writer ) {
+    Prior prior;
+    switch ( kind ) {
+    case TickCodec::EQuote:
+      for ( const unsigned char* p = pRecords; p != pRecords + nRecords * nQuote; p += nQuote ) {
+        EncodeTime( writer, prior, GetInt64( p ) );
+        boost::int64_t nBid( ToUnits( GetDouble( p + 8 ), dblScale ) );
+        boost::int64_t nSpread( Difference( ToUnits( GetDouble( p + 16 ), dblScale ), nBid ) );
+        writer.Signed( Difference( nBid, prior.rnPrice[ 0 ] ) );
+        writer.Signed( Difference( nSpread, prior.rnPrice[ 1 ] ) );
+        prior.rnPrice[ 0 ] = nBid;
+        prior.rnPrice[ 1 ] = nSpread;
+        boost::int64_t nBidSize( GetInt32( p + 24 ) );
+        boost::int64_t nAskSize( GetInt32( p + 28 ) );
+        writer.Signed( nBidSize - prior.rnSize[ 0 ] );
+        writer.Signed( nAskSize - prior.rnSize[ 1 ] );
+        prior.rnSize[ 0 ] = nBidSize;
+        prior.rnSize[ 1 ] = nAskSize;
+      }
+      break;
+    case TickCodec::ETrade:
+      for ( const unsigned char* p = pRecords; p != pRecords + nRecords * nTrade; p += nTrade ) {
+        EncodeTime( writer, prior, GetInt64( p ) );
+        boost::int64_t nPrice( ToUnits( GetDouble( p + 8 ), dblScale ) );
+        writer.Signed( Difference( nPrice, prior.rnPrice[ 0 ] ) );
+        prior.rnPrice[ 0 ] = nPrice;
+        writer.Signed( GetInt32( p + 16 ) );  // sizes of consecutive trades are unrelated
+      }
+      break;
+    case TickCodec::EBar:
+      for ( const unsigned char* p = pRecords; p != pRecords + nRecords * nBar; p += nBar ) {
+        EncodeTime( writer, prior, GetInt64( p ) );
+        boost::int64_t nOpen( ToUnits( GetDouble( p + 8 ), dblScale ) );
+        boost::int64_t nHigh( ToUnits( GetDouble( p + 16 ), dblScale ) );
+        boost::int64_t nLow( ToUnits( GetDouble( p + 24 ), dblScale ) );
+        boost::int64_t nClose( ToUnits( GetDouble( p + 32 ), dblScale ) );
+        writer.Signed( Difference( nOpen, prior.rnPrice[ 0 ] ) );
+        writer.Signed( Difference( nClose, nOpen ) );
+        writer.Signed( Difference( nHigh, std::max( nOpen, nClose ) ) );
+        writer.Signed( Difference( std::min( nOpen, nClose ), nLow ) );
+        prior.rnPrice[ 0 ] = nClose;
+        writer.Signed( GetInt32( p + 40 ) );
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  void DecodeRecords( TickCodec::EKind kind, double dblScale, Reader& reader, unsigned char* pRecords, size_t nRecords ) {
+    Prior prior;
+    switch ( kind ) {
+    case TickCodec::EQuote:
+      for ( unsigned char* p = pRecords; p != pRecords + nRecords * nQuote; p += nQuote ) {
+        PutInt64( p, DecodeTime( reader, prior ) );
+        prior.rnPrice[ 0 ] = Sum( prior.rnPrice[ 0 ], reader.Signed() );
+        prior.rnPrice[ 1 ] = Sum( prior.rnPrice[ 1 ], reader.Signed() );
+        PutDouble( p + 8, FromUnits( prior.rnPrice[ 0 ], dblScale ) );
+        PutDouble( p + 16, FromUnits( Sum( prior.rnPrice[ 0 ], prior.rnPrice[ 1 ] ), dblScale ) );
+        prior.rnSize[ 0 ] += reader.Signed();
+        prior.rnSize[ 1 ] += reader.Signed();
+        PutInt32( p + 24, static_cast<boost::int32_t>( prior.rnSize[ 0 ] ) );
+        PutInt32( p + 28, static_cast<boost::int32_t>( prior.rnSize[ 1 ] ) );
+      }
+      break;
+    case TickCodec::ETrade:
+      for ( unsigned char* p = pRecords; p != pRecords + nRecords * nTrade; p += nTrade ) {
+        PutInt64( p, DecodeTime( reader, prior ) );
+        prior.rnPrice[ 0 ] = Sum( prior.rnPrice[ 0 ], reader.Signed() );
+        PutDouble( p + 8, FromUnits( prior.rnPrice[ 0 ], dblScale ) );
+        PutInt32( p + 16, static_cast<boost::int32_t>( reader.Signed() ) );
+      }
+      break;
+    case TickCodec::EBar:
+      for ( unsigned char* p = pRecords; p != pRecords + nRecords * nBar; p += nBar ) {
+        PutInt64( p, DecodeTime( reader, prior ) );
+        boost::int64_t nOpen( Sum( prior.rnPrice[ 0 ], reader.Signed() ) );
+        boost::int64_t nClose( Sum( nOpen, reader.Signed() ) );
+        boost::int64_t nHigh( Sum( std::max( nOpen, nClose ), reader.Signed() ) );
+        boost::int64_t nLow( Difference( std::min( nOpen, nClose ), reader.Signed() ) );
+        PutDouble( p + 8, FromUnits( nOpen, dblScale ) );
+        PutDouble( p + 16, FromUnits( nHigh, dblScale ) );
+        PutDouble( p + 24, FromUnits( nLow, dblScale ) );
+        PutDouble( p + 32, FromUnits( nClose, dblScale ) );
+        prior.rnPrice[ 0 ] = nClose;
+        PutInt32( p + 40, static_cast<boost::int32_t>( reader.Signed() ) );
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  // the HDF5 filter, cd_values are the kind, and the minimum tick as the low and high words of its double
+  size_t FilterTick( unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[], size_t nbytes, size_t* buf_size, void** buf ) {
+    try {
+      std::vector<unsigned char> vOut;
+      if ( 0 != ( flags & H5Z_FLAG_REVERSE ) ) {
+        TickCodec::Decode( static_cast<const unsigned char*>( *buf ), nbytes, vOut );
+      }
+      else {
+        if ( 3 > cd_nelmts ) return 0;
+        TickCodec::EKind kind( static_cast<TickCodec::EKind>( cd_values[ 0 ] ) );
+        size_t nRecord( TickCodec::RecordSize( kind ) );
+        if ( ( 0 == nRecord ) || ( 0 != ( nbytes % nRecord ) ) ) return 0;
+        boost::uint64_t nBits( ( static_cast<boost::uint64_t>( cd_values[ 2 ] ) << 32 ) | cd_values[ 1 ] );
+        double dblMinTick;
+        std::memcpy( &dblMinTick, &nBits, 8 );
+        TickCodec::Encode( kind, dblMinTick, static_cast<const unsigned char*>( *buf ), nbytes / nRecord, vOut );
+        if ( vOut.size() >= nbytes ) return 0;  // the filter is optional, so the chunk is kept as is
+      }
+      if ( vOut.empty() ) return 0;
+      void* p( malloc( vOut.size() ) );  // as HDF5's own filters allocate
+      if ( 0 == p ) return 0;
+      std::memcpy( p, &vOut[ 0 ], vOut.size() );
+      free( *buf );
+      *buf = p;
+      *buf_size = vOut.size();
+      return vOut.size();
+    }
+    catch ( ... ) {
+      return 0;
+    }
+  }
+
+} // namespace anonymous
+
+//
+// TickCodec
+//
+
+size_t TickCodec::RecordSize( EKind kind ) {
+  switch ( kind ) {
+  case EQuote: return nQuote;
+  case ETrade: return nTrade;
+  case EBar: return nBar;
+  default: return 0;
+  }
+}
+
+void TickCodec::Pack( const Quote& quote, unsigned char* p ) {
+  std::memcpy( p, &quote.DateTime(), 8 );  // the ptime's count, as DatedDatum::DefineDataType stores it
+  PutDouble( p + 8, quote.Bid() );
+  PutDouble( p + 16, quote.Ask() );
+  PutInt32( p + 24, static_cast<boost::int32_t>( quote.BidSize() ) );
+  PutInt32( p + 28, static_cast<boost::int32_t>( quote.AskSize() ) );
+}
+
+void TickCodec::Pack( const Trade& trade, unsigned char* p ) {
+  std::memcpy( p, &trade.DateTime(), 8 );
+  PutDouble( p + 8, trade.Price() );
+  PutInt32( p + 16, static_cast<boost::int32_t>( trade.Volume() ) );
+}
+
+void TickCodec::Pack( const Bar& bar, unsigned char* p ) {
+  std::memcpy( p, &bar.DateTime(), 8 );
+  PutDouble( p + 8, bar.Open() );
+  PutDouble( p + 16, bar.High() );
+  PutDouble( p + 24, bar.Low() );
+  PutDouble( p + 32, bar.Close() );
+  PutInt32( p + 40, static_cast<boost::int32_t>( bar.Volume() ) );
+}
+
+void TickCodec::Unpack( const unsigned char* p, Quote& quote ) {
+  ptime dt;
+  std::memcpy( &dt, p, 8 );
+  quote = Quote( dt,
+    GetDouble( p + 8 ), static_cast<Quote::bidsize_t>( GetInt32( p + 24 ) ),
+    GetDouble( p + 16 ), static_cast<Quote::asksize_t>( GetInt32( p + 28 ) ) );
+}
+
+void TickCodec::Unpack( const unsigned char* p, Trade& trade ) {
+  ptime dt;
+  std::memcpy( &dt, p, 8 );
+  trade = Trade( dt, GetDouble( p + 8 ), static_cast<Trade::volume_t>( GetInt32( p + 16 ) ) );
+}
+
+void TickCodec::Unpack( const unsigned char* p, Bar& bar ) {
+  ptime dt;
+  std::memcpy( &dt, p, 8 );
+  bar = Bar( dt, GetDouble( p + 8 ), GetDouble( p + 16 ), GetDouble( p + 24 ), GetDouble( p + 32 ),
+    static_cast<Bar::volume_t>( GetInt32( p + 40 ) ) );
+}
+
+void TickCodec::Encode( EKind kind, double dblMinTick, const unsigned char* pRecords, size_t nRecords, std::vector<unsigned char>& vBlock ) {
+
+  const size_t nRecord( RecordSize( kind ) );
+  if ( 0 == nRecord ) throw std::runtime_error( "TickCodec::Encode: unknown kind" );
+
+  const double dblScale( FindScale( kind, dblMinTick, pRecords, nRecords ) );
+
+  // the worst case, a varint per field, each of the most bytes
+  const size_t nFields( nRecord / 4 );  // over counts, doubles and times are 8 bytes
+  const size_t ixBlock( vBlock.size() );
+  vBlock.resize( ixBlock + nMagicBlock + 2 + 2 * nMaxVarint + nRecords * nFields * nMaxVarint );
+
+  unsigned char* p( &vBlock[ ixBlock ] );
+  std::memcpy( p, rMagicBlock, nMagicBlock );
+  p[ nMagicBlock ] = nVersionBlock;
+  p[ nMagicBlock + 1 ] = static_cast<unsigned char>( kind );
+  Writer writer( p + nMagicBlock + 2 );
+  writer.Varint( nRecords );
+  writer.Varint( static_cast<boost::uint64_t>( dblScale ) );
+  EncodeRecords( kind, dblScale, pRecords, nRecords, writer );
+
+  vBlock.resize( writer.Position() - &vBlock[ 0 ] );
+}
+
+size_t TickCodec::Decode( const unsigned char* pBlock, size_t nBlock, std::vector<unsigned char>& vRecords, EKind* pKind ) {
+
+  if ( ( nMagicBlock + 2 ) > nBlock ) throw std::runtime_error( "TickCodec::Decode: short block" );
+  if ( 0 != std::memcmp( pBlock, rMagicBlock, nMagicBlock ) ) throw std::runtime_error( "TickCodec::Decode: not a block" );
+  if ( nVersionBlock != pBlock[ nMagicBlock ] ) throw std::runtime_error( "TickCodec::Decode: unknown version" );
+  EKind kind( static_cast<EKind>( pBlock[ nMagicBlock + 1 ] ) );
+  const size_t nRecord( RecordSize( kind ) );
+  if ( 0 == nRecord ) throw std::runtime_error( "TickCodec::Decode: unknown kind" );
+  if ( 0 != pKind ) *pKind = kind;
+
+  Reader reader( pBlock + nMagicBlock + 2, pBlock + nBlock );
+  boost::uint64_t nRecords( reader.Varint() );
+  // each record is a byte or more a field, so a count beyond the block is damage, not a reason to allocate
+  if ( nRecords > nBlock ) throw std::runtime_error( "TickCodec::Decode: damaged record count" );
+  double dblScale( static_cast<double>( reader.Varint() ) );
+
+  const size_t ixRecords( vRecords.size() );
+  vRecords.resize( ixRecords + static_cast<size_t>( nRecords ) * nRecord );
+  if ( 0 != nRecords ) {
+    DecodeRecords( kind, dblScale, reader, &vRecords[ ixRecords ], static_cast<size_t>( nRecords ) );
+  }
+
+  return reader.Position() - pBlock;
+}
+
+TickCodec::Stats TickCodec::Measure( EKind kind, double dblMinTick, const unsigned char* pRecords, size_t nRecords, size_t nBlock ) {
+
+  Stats stats;
+  const size_t nRecord( RecordSize( kind ) );
+  if ( 0 == nRecord ) throw std::runtime_error( "TickCodec::Measure: unknown kind" );
+  if ( 0 == nBlock ) nBlock = nRecords;
+  stats.nRecords = nRecords;
+  stats.nBytesRaw = nRecords * nRecord;
+
+  std::vector<unsigned char> vBlocks;
+  std::vector<size_t> vLength;
+  vBlocks.reserve( stats.nBytesRaw / 2 );
+
+  boost::posix_time::ptime dtStart( boost::posix_time::microsec_clock::universal_time() );
+  for ( size_t ix = 0; ix < nRecords; ix += nBlock ) {
+    size_t ixBlock( vBlocks.size() );
+    Encode( kind, dblMinTick, pRecords + ix * nRecord, std::min( nBlock, nRecords - ix ), vBlocks );
+    vLength.push_back( vBlocks.size() - ixBlock );
+  }
+  stats.tdEncode = boost::posix_time::microsec_clock::universal_time() - dtStart;
+  stats.nBytesEncoded = vBlocks.size();
+
+  std::vector<unsigned char> vRecords;
+  vRecords.reserve( stats.nBytesRaw );
+  dtStart = boost::posix_time::microsec_clock::universal_time();
+  size_t ixBlock( 0 );
+  for ( std::vector<size_t>::const_iterator iter = vLength.begin(); vLength.end() != iter; ++iter ) {
+    Decode( &vBlocks[ ixBlock ], *iter, vRecords );
+    ixBlock += *iter;
+  }
+  stats.tdDecode = boost::posix_time::microsec_clock::universal_time() - dtStart;
+
+  stats.bLossless = ( vRecords.size() == stats.nBytesRaw )
+    && ( ( 0 == nRecords ) || ( 0 == std::memcmp( &vRecords[ 0 ], pRecords, stats.nBytesRaw ) ) );
+
+  return stats;
+}
+
+void TickCodec::RegisterFilter( void ) {
+  if ( 0 < H5Zfilter_avail( static_cast<H5Z_filter_t>( nFilterId ) ) ) return;
+  static const H5Z_class2_t filter = {
+    H5Z_CLASS_T_VERS,
+    static_cast<H5Z_filter_t>( nFilterId ),
+    1, 1,  // encoder and decoder present
+    "ou tick codec",
+    NULL, NULL,  // can_apply, set_local
+    FilterTick
+  };
+  if ( 0 > H5Zregister( &filter ) ) throw std::runtime_error( "TickCodec::RegisterFilter: not registered" );
+}
+
+void TickCodec::SetFilter( H5::DSetCreatPropList& pl, EKind kind, double dblMinTick ) {
+  if ( 0 == RecordSize( kind ) ) throw std::runtime_error( "TickCodec::SetFilter: unknown kind" );
+  RegisterFilter();
+  boost::uint64_t nBits;
+  std::memcpy( &nBits, &dblMinTick, 8 );
+  const unsigned int cd_values[ 3 ] = {
+    static_cast<unsigned int>( kind ),
+    static_cast<unsigned int>( nBits & 0xffffffff ),
+    static_cast<unsigned int>( nBits >> 32 )
+  };
+  pl.setFilter( static_cast<H5Z_filter_t>( nFilterId ), H5Z_FLAG_OPTIONAL, 3, cd_values );
+}
+
+//
+// TickFileWriter
+//
+
+TickFileWriter::TickFileWriter( const std::string& sFileName, TickCodec::EKind kind, double dblMinTick, size_t nBlock )
+  : m_kind( kind ), m_dblMinTick( dblMinTick ), m_nBlock( nBlock ), m_nRecord( TickCodec::RecordSize( kind ) ),
+  m_cntRecords( 0 ), m_cntBytes( 0 )
+{
+  if ( 0 == m_nRecord ) throw std::runtime_error( "TickFileWriter: unknown kind" );
+  if ( 0 == m_nBlock ) throw std::runtime_error( "TickFileWriter: empty block" );
+  m_ofs.open( sFileName.c_str(), std::ios::binary | std::ios::trunc );
+  if ( !m_ofs.is_open() ) throw std::runtime_error( "TickFileWriter: can not open " + sFileName );
+  m_vStaged.reserve( m_nBlock * m_nRecord );
+
+  unsigned char rHeader[ nHeaderFile ];
+  std::memcpy( rHeader, szMagicFile, nMagicFile );
+  boost::uint32_t n( nVersionFile );
+  std::memcpy( rHeader + nMagicFile, &n, 4 );
+  n = static_cast<boost::uint32_t>( kind );
+  std::memcpy( rHeader + nMagicFile + 4, &n, 4 );
+  std::memcpy( rHeader + nMagicFile + 8, &dblMinTick, 8 );
+  m_ofs.write( reinterpret_cast<const char*>( rHeader ), nHeaderFile );
+  m_cntBytes += nHeaderFile;
+}
+
+TickFileWriter::~TickFileWriter( void ) {
+  Close();
+}
+
+unsigned char* TickFileWriter::Stage( TickCodec::EKind kind ) {
+  if ( m_kind != kind ) throw std::runtime_error( "TickFileWriter::Append: datum is of another kind" );
+  if ( !m_ofs.is_open() ) throw std::runtime_error( "TickFileWriter::Append: closed" );
+  size_t ix( m_vStaged.size() );
+  m_vStaged.resize( ix + m_nRecord );
+  ++m_cntRecords;
+  return &m_vStaged[ ix ];
+}
+
+void TickFileWriter::Append( const Quote& quote ) {
+  TickCodec::Pack( quote, Stage( TickCodec::EQuote ) );
+  if ( m_vStaged.size() >= m_nBlock * m_nRecord ) WriteBlock();
+}
+
+void TickFileWriter::Append( const Trade& trade ) {
+  TickCodec::Pack( trade, Stage( TickCodec::ETrade ) );
+  if ( m_vStaged.size() >= m_nBlock * m_nRecord ) WriteBlock();
+}
+
+void TickFileWriter::Append( const Bar& bar ) {
+  TickCodec::Pack( bar, Stage( TickCodec::EBar ) );
+  if ( m_vStaged.size() >= m_nBlock * m_nRecord ) WriteBlock();
+}
+
+void TickFileWriter::WriteBlock( void ) {
+  if ( m_vStaged.empty() ) return;
+  m_vBlock.clear();
+  TickCodec::Encode( m_kind, m_dblMinTick, &m_vStaged[ 0 ], m_vStaged.size() / m_nRecord, m_vBlock );
+  boost::uint32_t nLength( static_cast<boost::uint32_t>( m_vBlock.size() ) );
+  m_ofs.write( reinterpret_cast<const char*>( &nLength ), 4 );
+  m_ofs.write( reinterpret_cast<const char*>( &m_vBlock[ 0 ] ), m_vBlock.size() );
+  m_cntBytes += 4 + m_vBlock.size();
+  m_vStaged.clear();
+}
+
+void TickFileWriter::Close( void ) {
+  if ( m_ofs.is_open() ) {
+    WriteBlock();
+    m_ofs.close();
+  }
+}
+
+//
+// TickFileReader
+//
+
+TickFileReader::TickFileReader( const std::string& sFileName )
+  : m_ixNext( nHeaderFile ), m_kind( TickCodec::ENone ), m_dblMinTick( 0.0 )
+{
+  std::ifstream ifs( sFileName.c_str(), std::ios::binary );
+  if ( !ifs.is_open() ) throw std::runtime_error( "TickFileReader: can not open " + sFileName );
+  ifs.seekg( 0, std::ios::end );
+  std::streamoff nSize( ifs.tellg() );
+  ifs.seekg( 0, std::ios::beg );
+  if ( static_cast<std::streamoff>( nHeaderFile ) > nSize ) throw std::runtime_error( "TickFileReader: no header in " + sFileName );
+  m_vFile.resize( static_cast<size_t>( nSize ) );
+  ifs.read( reinterpret_cast<char*>( &m_vFile[ 0 ] ), nSize );
+  if ( nSize != ifs.gcount() ) throw std::runtime_error( "TickFileReader: short read of " + sFileName );
+
+  if ( 0 != std::memcmp( &m_vFile[ 0 ], szMagicFile, nMagicFile ) ) throw std::runtime_error( "TickFileReader: not a tick file " + sFileName );
+  boost::uint32_t n;
+  std::memcpy( &n, &m_vFile[ nMagicFile ], 4 );
+  if ( nVersionFile != n ) throw std::runtime_error( "TickFileReader: unknown version of " + sFileName );
+  std::memcpy( &n, &m_vFile[ nMagicFile + 4 ], 4 );
+  m_kind = static_cast<TickCodec::EKind>( n );
+  if ( 0 == TickCodec::RecordSize( m_kind ) ) throw std::runtime_error( "TickFileReader: unknown kind in " + sFileName );
+  std::memcpy( &m_dblMinTick, &m_vFile[ nMagicFile + 8 ], 8 );
+}
+
+bool TickFileReader::Next( std::vector<unsigned char>& vRecords ) {
+  vRecords.clear();
+  if ( ( m_vFile.size() - m_ixNext ) < 4 ) return false;  // a length cut short, by a writer which did not get to close, ends the file
+  boost::uint32_t nLength;
+  std::memcpy( &nLength, &m_vFile[ m_ixNext ], 4 );
+  if ( ( m_vFile.size() - m_ixNext - 4 ) < nLength ) return false;  // as is a block cut short
+  TickCodec::EKind kind;
+  TickCodec::Decode( &m_vFile[ m_ixNext + 4 ], nLength, vRecords, &kind );
+  if ( m_kind != kind ) throw std::runtime_error( "TickFileReader::Next: block is of another kind" );
+  m_ixNext += 4 + nLength;
+  return true;
+}
+
+} // namespace tf
+} // namespace ou
@@ -0,0 +1,260 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// lossless compression of quotes, trades and bars, in place of shuffle and deflate:
+//   the codec works on records packed as HDF5 stores them (DefineDataType, packed), so it serves
+//     as an HDF5 filter on the chunks of a dataset, and as the block of a standalone tick file
+//   timestamps are delta of delta, so a steady or bursty stream costs a byte or two per record
+//   prices are integers of a scale, from the instrument's minimum tick, each as a delta on its
+//     prior, a quote's ask as the spread, a bar's open on the prior close, its high and low from
+//     the body, sizes and volumes are deltas or values
+//   each is zigzag encoded, so small negatives are small, then a varint, 7 bits per byte, low first
+//   the scale is checked against every price of a block: when the minimum tick does not reproduce
+//     each price exactly, a power of ten is tried, and failing that, the bits of the doubles are
+//     encoded, so a decoded block is always byte for byte the records encoded
+
+// block layout:
+//   4 byte magic "OUTC", uint8 version, uint8 kind, varint records, varint scale (0 for raw doubles),
+//   then per record, the varints for its fields, in the order of the record
+
+// tick file layout:
+//   header: 8 byte magic "OUTICKS1", uint32 version, uint32 kind, 8 byte double of the minimum tick
+//   then blocks: uint32 length, the block
+
+// usage, an HDF5 dataset:
+//   HDF5WriteTimeSeries<Quotes> wts( dm, true, true, 5, 4096 );
+//   wts.SetTickCodec( pInstrument->GetMinTick() );  // rather than deflate
+//   wts.Write( sPathName, &quotes );  // read back as any other, HDF5DataManager registers the filter
+
+// usage, a tick file:
+//   TickFileWriter writer( "GLD.quotes", TickCodec::EQuote, pInstrument->GetMinTick() );
+//   writer.Write( quotes );
+//   writer.Close();
+//   Quotes quotes2;
+//   TickFileReader( "GLD.quotes" ).Read( quotes2 );
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+
+#include <boost/cstdint.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <hdf5/H5Cpp.h>
+
+#include <TFTimeSeries/DatedDatum.h>
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+class TickCodec {
+public:
+
+  enum EKind { ENone = 0, EQuote, ETrade, EBar };
+
+  enum { nFilterId = 305 };  // HDF5 leaves 256 to 511 for private filters
+
+  struct Stats {
+    size_t nRecords;
+    size_t nBytesRaw;  // packed records
+    size_t nBytesEncoded;
+    bool bLossless;  // decoded records match
+    boost::posix_time::time_duration tdEncode;
+    boost::posix_time::time_duration tdDecode;
+    Stats( void ): nRecords( 0 ), nBytesRaw( 0 ), nBytesEncoded( 0 ), bLossless( false ) {};
+    double Ratio( void ) const { return ( 0 == nBytesEncoded ) ? 0.0 : static_cast<double>( nBytesRaw ) / nBytesEncoded; };
+    double EncodeMBps( void ) const {  // of raw bytes
+      return ( 0 == tdEncode.total_microseconds() ) ? 0.0 : static_cast<double>( nBytesRaw ) / tdEncode.total_microseconds();
+    }
+    double DecodeMBps( void ) const {  // of raw bytes
+      return ( 0 == tdDecode.total_microseconds() ) ? 0.0 : static_cast<double>( nBytesRaw ) / tdDecode.total_microseconds();
+    }
+  };
+
+  static EKind Kind( const DatedDatum* ) { return ENone; };
+  static EKind Kind( const Quote* ) { return EQuote; };
+  static EKind Kind( const Trade* ) { return ETrade; };
+  static EKind Kind( const Bar* ) { return EBar; };
+
+  static size_t RecordSize( EKind kind );  // packed, as HDF5 stores the datum, 0 for ENone
+
+  static void Pack( const Quote& quote, unsigned char* pRecord );
+  static void Pack( const Trade& trade, unsigned char* pRecord );
+  static void Pack( const Bar& bar, unsigned char* pRecord );
+  static void Unpack( const unsigned char* pRecord, Quote& quote );
+  static void Unpack( const unsigned char* pRecord, Trade& trade );
+  static void Unpack( const unsigned char* pRecord, Bar& bar );
+
+  // packed records to a block, appended to vBlock, a dblMinTick of 0 leaves the scale to be found
+  static void Encode( EKind kind, double dblMinTick, const unsigned char* pRecords, size_t nRecords, std::vector<unsigned char>& vBlock );
+  // a block to packed records, appended to vRecords, returns the bytes of the block used
+  //   throws std::runtime_error when the block is damaged
+  static size_t Decode( const unsigned char* pBlock, size_t nBlock, std::vector<unsigned char>& vRecords, EKind* pKind = 0 );
+
+  template<typename TS> static void Encode( const TS& series, double dblMinTick, std::vector<unsigned char>& vBlock );
+  template<typename TS> static void Decode( const unsigned char* pBlock, size_t nBlock, TS& series );  // appended
+
+  // encodes and decodes a series in blocks, timed, a benchmark on captured data
+  template<typename TS> static Stats Measure( const TS& series, double dblMinTick, size_t nBlock = 4096 );
+  static Stats Measure( EKind kind, double dblMinTick, const unsigned char* pRecords, size_t nRecords, size_t nBlock );
+
+  // the filter is to be registered before a dataset using it is read or written, HDF5DataManager does so
+  static void RegisterFilter( void );
+  static void SetFilter( H5::DSetCreatPropList& pl, EKind kind, double dblMinTick );  // the dataset is to be chunked
+
+  template<typename TS> static void Pack( const TS& series, std::vector<unsigned char>& vRecords );  // appended
+  template<typename TS> static void Unpack( const unsigned char* pRecords, size_t nRecords, TS& series );  // appended
+
+protected:
+private:
+};
+
+template<typename TS>
+void TickCodec::Pack( const TS& series, std::vector<unsigned char>& vRecords ) {
+  typedef typename TS::datum_t DD;
+  const size_t nRecord( RecordSize( Kind( static_cast<const DD*>( 0 ) ) ) );
+  size_t ix( vRecords.size() );
+  vRecords.resize( ix + series.Size() * nRecord );
+  for ( typename TS::const_iterator iter = series.begin(); series.end() != iter; ++iter ) {
+    Pack( *iter, &vRecords[ ix ] );
+    ix += nRecord;
+  }
+}
+
+template<typename TS>
+void TickCodec::Unpack( const unsigned char* pRecords, size_t nRecords, TS& series ) {
+  typedef typename TS::datum_t DD;
+  const size_t nRecord( RecordSize( Kind( static_cast<const DD*>( 0 ) ) ) );
+  DD datum;
+  for ( size_t ix = 0; ix < nRecords; ++ix ) {
+    Unpack( pRecords + ix * nRecord, datum );
+    series.Append( datum );
+  }
+}
+
+template<typename TS>
+void TickCodec::Encode( const TS& series, double dblMinTick, std::vector<unsigned char>& vBlock ) {
+  typedef typename TS::datum_t DD;
+  std::vector<unsigned char> vRecords;
+  Pack( series, vRecords );
+  Encode( Kind( static_cast<const DD*>( 0 ) ), dblMinTick, vRecords.empty() ? 0 : &vRecords[ 0 ], series.Size(), vBlock );
+}
+
+template<typename TS>
+void TickCodec::Decode( const unsigned char* pBlock, size_t nBlock, TS& series ) {
+  typedef typename TS::datum_t DD;
+  std::vector<unsigned char> vRecords;
+  EKind kind;
+  Decode( pBlock, nBlock, vRecords, &kind );
+  if ( Kind( static_cast<const DD*>( 0 ) ) != kind ) throw std::runtime_error( "TickCodec::Decode: block is of another kind" );
+  Unpack( vRecords.empty() ? 0 : &vRecords[ 0 ], vRecords.size() / RecordSize( kind ), series );
+}
+
+template<typename TS>
+TickCodec::Stats TickCodec::Measure( const TS& series, double dblMinTick, size_t nBlock ) {
+  typedef typename TS::datum_t DD;
+  std::vector<unsigned char> vRecords;
+  Pack( series, vRecords );
+  return Measure( Kind( static_cast<const DD*>( 0 ) ), dblMinTick, vRecords.empty() ? 0 : &vRecords[ 0 ], series.Size(), nBlock );
+}
+
+//
+// TickFileWriter
+//
+
+class TickFileWriter {
+public:
+
+  // throws std::runtime_error when the file can not be created
+  TickFileWriter( const std::string& sFileName, TickCodec::EKind kind, double dblMinTick, size_t nBlock = 4096 );
+  ~TickFileWriter( void );  // closes
+
+  void Append( const Quote& quote );  // the datum is to be of the kind of the file
+  void Append( const Trade& trade );
+  void Append( const Bar& bar );
+  template<typename TS> void Write( const TS& series );
+
+  void Close( void );  // writes out what is staged
+
+  size_t Records( void ) const { return m_cntRecords; };
+  size_t Bytes( void ) const { return m_cntBytes; };  // written to the file, header included
+
+protected:
+private:
+
+  std::ofstream m_ofs;
+  TickCodec::EKind m_kind;
+  double m_dblMinTick;
+  size_t m_nBlock;
+  size_t m_nRecord;
+  size_t m_cntRecords;
+  size_t m_cntBytes;
+  std::vector<unsigned char> m_vStaged;  // packed records
+  std::vector<unsigned char> m_vBlock;
+
+  unsigned char* Stage( TickCodec::EKind kind );
+  void WriteBlock( void );
+};
+
+template<typename TS>
+void TickFileWriter::Write( const TS& series ) {
+  for ( typename TS::const_iterator iter = series.begin(); series.end() != iter; ++iter ) {
+    Append( *iter );
+  }
+}
+
+//
+// TickFileReader
+//
+
+class TickFileReader {
+public:
+
+  // the file is loaded, throws std::runtime_error when it can not be read, or is not a tick file
+  TickFileReader( const std::string& sFileName );
+  ~TickFileReader( void ) {};
+
+  TickCodec::EKind Kind( void ) const { return m_kind; };
+  double MinTick( void ) const { return m_dblMinTick; };
+
+  // the next block's packed records, replacing those in vRecords, false at the end of the file
+  //   throws std::runtime_error on a damaged block
+  bool Next( std::vector<unsigned char>& vRecords );
+  template<typename TS> void Read( TS& series );  // the blocks remaining, appended
+
+protected:
+private:
+
+  std::vector<unsigned char> m_vFile;
+  size_t m_ixNext;
+  TickCodec::EKind m_kind;
+  double m_dblMinTick;
+
+};
+
+template<typename TS>
+void TickFileReader::Read( TS& series ) {
+  typedef typename TS::datum_t DD;
+  if ( TickCodec::Kind( static_cast<const DD*>( 0 ) ) != m_kind ) throw std::runtime_error( "TickFileReader::Read: file is of another kind" );
+  std::vector<unsigned char> vRecords;
+  while ( Next( vRecords ) ) {
+    TickCodec::Unpack( vRecords.empty() ? 0 : &vRecords[ 0 ], vRecords.size() / TickCodec::RecordSize( m_kind ), series );
+  }
+}
+
+} // namespace tf
+} // namespace ou
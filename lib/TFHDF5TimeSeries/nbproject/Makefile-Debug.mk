@@ -36,7 +36,10 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 # Object Files
 OBJECTFILES= \
 	${OBJECTDIR}/HDF5Attribute.o \
-	${OBJECTDIR}/HDF5DataManager.o
+	${OBJECTDIR}/HDF5BarResampler.o \
+	${OBJECTDIR}/HDF5DataManager.o \
+	${OBJECTDIR}/HDF5TickCapture.o \
+	${OBJECTDIR}/TickCodec.o
 
 
 # C Compiler Flags
@@ -70,11 +73,26 @@ ${OBJECTDIR}/HDF5Attribute.o: HDF5Attribute.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/HDF5Attribute.o HDF5Attribute.cpp
 
+${OBJECTDIR}/HDF5BarResampler.o: HDF5BarResampler.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/HDF5BarResampler.o HDF5BarResampler.cpp
+
 ${OBJECTDIR}/HDF5DataManager.o: HDF5DataManager.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/HDF5DataManager.o HDF5DataManager.cpp
 
+${OBJECTDIR}/HDF5TickCapture.o: HDF5TickCapture.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/HDF5TickCapture.o HDF5TickCapture.cpp
+
+${OBJECTDIR}/TickCodec.o: TickCodec.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TickCodec.o TickCodec.cpp
+
 # Subprojects
 .build-subprojects:
 
@@ -0,0 +1,188 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+//#include "stdafx.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "FeedRecorder.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+namespace iqfeed { // IQFeed
+
+namespace {
+
+  const char szMagic[] = "OUIQFRAW";
+  const size_t nMagic = 8;
+  const boost::uint32_t nVersion = 1;
+  const size_t nHeader = nMagic + 4 + 4 + 8;
+
+  const boost::posix_time::ptime dtEpoch( boost::gregorian::date( 1970, 1, 1 ) );
+
+  inline void AppendVarint( std::vector<char>& v, boost::uint64_t n ) {
+    while ( 0x80 <= n ) {
+      v.push_back( static_cast<char>( 0x80 | ( n & 0x7f ) ) );
+      n >>= 7;
+    }
+    v.push_back( static_cast<char>( n ) );
+  }
+
+  inline void AppendFixed( std::vector<char>& v, boost::uint64_t n, size_t nBytes ) {  // little endian
+    for ( size_t ix = 0; ix < nBytes; ++ix ) {
+      v.push_back( static_cast<char>( n & 0xff ) );
+      n >>= 8;
+    }
+  }
+
+  inline boost::uint64_t ReadFixed( const char* p, size_t nBytes ) {
+    boost::uint64_t n( 0 );
+    for ( size_t ix = nBytes; 0 < ix; --ix ) {
+      n = ( n << 8 ) | static_cast<unsigned char>( p[ ix - 1 ] );
+    }
+    return n;
+  }
+
+} // namespace anonymous
+
+// FeedRecorder
+
+FeedRecorder::FeedRecorder( size_t nBufferSize )
+  : m_nBufferSize( nBufferSize ), m_bOpen( false ), m_cntLines( 0 ), m_cntBytes( 0 )
+{
+}
+
+FeedRecorder::~FeedRecorder( void ) {
+  Close();
+}
+
+void FeedRecorder::Open( const std::string& sFileName ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  if ( m_bOpen ) throw std::runtime_error( "FeedRecorder::Open: already open" );
+  m_ofs.open( sFileName.c_str(), std::ios::binary | std::ios::trunc );
+  if ( !m_ofs.is_open() ) throw std::runtime_error( "FeedRecorder::Open: can not open " + sFileName );
+  m_bOpen = true;
+  m_cntLines = m_cntBytes = 0;
+  m_vBuffer.clear();
+  m_vBuffer.reserve( m_nBufferSize + 1024 );
+  m_dtPrior = boost::posix_time::microsec_clock::universal_time();
+  m_vBuffer.insert( m_vBuffer.end(), szMagic, szMagic + nMagic );
+  AppendFixed( m_vBuffer, nVersion, 4 );
+  AppendFixed( m_vBuffer, 0, 4 );
+  AppendFixed( m_vBuffer, ( m_dtPrior - dtEpoch ).total_microseconds(), 8 );
+}
+
+void FeedRecorder::Close( void ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  if ( m_bOpen ) {
+    Write();
+    m_ofs.close();
+    m_bOpen = false;
+  }
+}
+
+void FeedRecorder::Record( const void* pLine, size_t nLength ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  if ( m_bOpen ) {
+    boost::posix_time::ptime dtNow( boost::posix_time::microsec_clock::universal_time() );
+    boost::int64_t nDelta( ( dtNow - m_dtPrior ).total_microseconds() );
+    if ( 0 > nDelta ) nDelta = 0;  // the clock was stepped back, keep the file in order
+    else m_dtPrior = dtNow;
+    AppendVarint( m_vBuffer, nDelta );
+    AppendVarint( m_vBuffer, nLength );
+    const char* p( static_cast<const char*>( pLine ) );
+    m_vBuffer.insert( m_vBuffer.end(), p, p + nLength );
+    ++m_cntLines;
+    if ( m_nBufferSize <= m_vBuffer.size() ) Write();
+  }
+}
+
+void FeedRecorder::Write( void ) {
+  if ( !m_vBuffer.empty() ) {
+    m_ofs.write( &m_vBuffer[ 0 ], m_vBuffer.size() );
+    m_cntBytes += m_vBuffer.size();
+    m_vBuffer.clear();
+  }
+}
+
+// FeedRecording
+
+FeedRecording::FeedRecording( const std::string& sFileName )
+  : m_ixFirst( nHeader ), m_ixNext( nHeader ), m_cntLines( 0 )
+{
+  std::ifstream ifs( sFileName.c_str(), std::ios::binary );
+  if ( !ifs.is_open() ) throw std::runtime_error( "FeedRecording: can not open " + sFileName );
+  ifs.seekg( 0, std::ios::end );
+  std::streamoff nSize( ifs.tellg() );
+  ifs.seekg( 0, std::ios::beg );
+  if ( static_cast<std::streamoff>( nHeader ) > nSize ) throw std::runtime_error( "FeedRecording: no header in " + sFileName );
+  m_vFile.resize( static_cast<size_t>( nSize ) );
+  ifs.read( &m_vFile[ 0 ], nSize );
+  if ( nSize != ifs.gcount() ) throw std::runtime_error( "FeedRecording: short read of " + sFileName );
+
+  if ( 0 != std::memcmp( &m_vFile[ 0 ], szMagic, nMagic ) ) throw std::runtime_error( "FeedRecording: not a recording " + sFileName );
+  if ( nVersion != ReadFixed( &m_vFile[ nMagic ], 4 ) ) throw std::runtime_error( "FeedRecording: unknown version of " + sFileName );
+  m_dtStart = dtEpoch + boost::posix_time::microseconds( static_cast<boost::int64_t>( ReadFixed( &m_vFile[ nMagic + 8 ], 8 ) ) );
+  m_dtPrior = m_dtStart;
+
+  // count the lines, and check the framing, so Next need not report a damaged file
+  //   a record cut short, by a recorder which did not get to close, ends the recording
+  size_t ix( m_ixFirst );
+  while ( m_vFile.size() > ix ) {
+    size_t ixRecord( ix );
+    boost::uint64_t nDelta, nLength;
+    if ( !Scan( ix, nDelta ) || !Scan( ix, nLength ) || ( ( m_vFile.size() - ix ) < nLength ) ) {
+      m_vFile.resize( ixRecord );
+      break;
+    }
+    ix += static_cast<size_t>( nLength );
+    ++m_cntLines;
+  }
+}
+
+bool FeedRecording::Scan( size_t& ix, boost::uint64_t& nValue ) const {
+  nValue = 0;
+  unsigned int nShift( 0 );
+  while ( m_vFile.size() > ix ) {
+    unsigned char c( static_cast<unsigned char>( m_vFile[ ix++ ] ) );
+    nValue |= static_cast<boost::uint64_t>( c & 0x7f ) << nShift;
+    if ( 0 == ( c & 0x80 ) ) return true;
+    nShift += 7;
+    if ( 63 < nShift ) return false;
+  }
+  return false;
+}
+
+bool FeedRecording::Next( Line& line ) {
+  if ( m_vFile.size() <= m_ixNext ) return false;
+  boost::uint64_t nDelta, nLength;
+  Scan( m_ixNext, nDelta );  // framing was checked on load
+  Scan( m_ixNext, nLength );
+  m_dtPrior += boost::posix_time::microseconds( static_cast<boost::int64_t>( nDelta ) );
+  line.dtReceived = m_dtPrior;
+  line.pText = &m_vFile[ 0 ] + m_ixNext;
+  line.nLength = static_cast<size_t>( nLength );
+  m_ixNext += line.nLength;
+  return true;
+}
+
+void FeedRecording::Rewind( void ) {
+  m_ixNext = m_ixFirst;
+  m_dtPrior = m_dtStart;
+}
+
+} // namespace iqfeed
+} // namespace tf
+} // namespace ou
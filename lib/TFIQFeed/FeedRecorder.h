@@ -0,0 +1,108 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// raw level 1 lines, as they come off the socket, with their time of receipt:
+//   FeedRecorder is attached to IQFeed<T> with SetRecorder, and records each line
+//     on the network thread before it is parsed
+//   FeedRecording loads a recording into memory, for FeedReplayServer or for driving a parser directly
+
+// file layout:
+//   header: 8 byte magic "OUIQFRAW", uint32 version, uint32 reserved, int64 microseconds since 1970-01-01 (utc) of the start
+//   then one record per line: varint microseconds since the prior record (since the start for the first),
+//     varint length, the line's bytes, without its terminator
+//   the varints are 7 bits per byte, low bits first, high bit set on all but the last byte,
+//     so a busy feed costs two or three bytes of framing per line
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+namespace iqfeed { // IQFeed
+
+class FeedRecorder {
+public:
+
+  FeedRecorder( size_t nBufferSize = 256 * 1024 );  // records are staged, and written in blocks of this size
+  ~FeedRecorder( void );  // closes
+
+  void Open( const std::string& sFileName );  // throws std::runtime_error
+  void Close( void );  // writes out what is staged
+  bool IsOpen( void ) const { return m_bOpen; };
+
+  // [pLine, pLine + nLength) is the line without its terminator, stamped with the time of the call
+  //   a no-op when not open
+  void Record( const void* pLine, size_t nLength );
+
+  size_t Lines( void ) const { return m_cntLines; };
+  size_t Bytes( void ) const { return m_cntBytes; };  // written to the file, header included
+
+protected:
+private:
+
+  size_t m_nBufferSize;
+  boost::mutex m_mutex;
+  bool m_bOpen;
+  std::ofstream m_ofs;
+  std::vector<char> m_vBuffer;
+  boost::posix_time::ptime m_dtPrior;
+  size_t m_cntLines;
+  size_t m_cntBytes;
+
+  void Write( void );  // the staged records, with m_mutex held
+};
+
+class FeedRecording {
+public:
+
+  struct Line {
+    boost::posix_time::ptime dtReceived;
+    const char* pText;  // into the recording, valid while it exists
+    size_t nLength;
+    Line( void ): pText( 0 ), nLength( 0 ) {};
+  };
+
+  FeedRecording( const std::string& sFileName );  // throws std::runtime_error on a missing or malformed file
+  ~FeedRecording( void ) {};
+
+  bool Next( Line& line );  // false at the end
+  void Rewind( void );
+
+  boost::posix_time::ptime Start( void ) const { return m_dtStart; };
+  size_t Lines( void ) const { return m_cntLines; };  // in the file
+  size_t Bytes( void ) const { return m_vFile.size(); };
+
+protected:
+private:
+
+  std::vector<char> m_vFile;
+  size_t m_ixFirst;  // first record
+  size_t m_ixNext;
+  boost::posix_time::ptime m_dtStart;
+  boost::posix_time::ptime m_dtPrior;
+  size_t m_cntLines;
+
+  bool Scan( size_t& ix, boost::uint64_t& nValue ) const;  // decodes a varint at ix
+};
+
+} // namespace iqfeed
+} // namespace tf
+} // namespace ou
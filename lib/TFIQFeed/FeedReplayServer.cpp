@@ -0,0 +1,159 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+//#include "stdafx.h"
+
+#include <boost/thread/thread.hpp>
+
+#include "FeedReplayServer.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+namespace iqfeed { // IQFeed
+
+using boost::asio::ip::tcp;
+
+namespace {
+
+  // sleeps are coarse, so sleep to short of the mark, and yield the rest of the way
+  void WaitUntil( const boost::posix_time::ptime& dt ) {
+    while ( true ) {
+      boost::posix_time::time_duration td( dt - boost::posix_time::microsec_clock::universal_time() );
+      if ( 0 >= td.total_microseconds() ) break;
+      if ( boost::posix_time::milliseconds( 2 ) < td ) {
+        boost::this_thread::sleep( td - boost::posix_time::milliseconds( 1 ) );
+      }
+      else {
+        boost::this_thread::yield();
+      }
+    }
+  }
+
+  bool ClientGone( const boost::system::error_code& ec ) {
+    return ( boost::asio::error::eof == ec )
+      || ( boost::asio::error::broken_pipe == ec )
+      || ( boost::asio::error::connection_reset == ec )
+      || ( boost::asio::error::connection_aborted == ec );
+  }
+
+} // namespace anonymous
+
+FeedReplayServer::FeedReplayServer( unsigned short nPort )
+  : m_acceptor( m_io )
+{
+  tcp::endpoint endpoint( boost::asio::ip::address_v4::loopback(), nPort );
+  m_acceptor.open( endpoint.protocol() );
+  m_acceptor.set_option( tcp::acceptor::reuse_address( true ) );
+  m_acceptor.bind( endpoint );
+  m_acceptor.listen();
+  m_vBuffer.reserve( nWriteSize + 4096 );
+}
+
+FeedReplayServer::~FeedReplayServer( void ) {
+  boost::system::error_code ec;
+  m_acceptor.close( ec );
+}
+
+FeedReplayServer::Stats FeedReplayServer::Replay( FeedRecording& recording, double dblSpeed ) {
+
+  Stats stats;
+
+  tcp::socket socket( m_io );
+  m_acceptor.accept( socket );
+  socket.set_option( tcp::no_delay( true ) );
+
+  const bool bPaced( 0.0 < dblSpeed );
+  bool bConnected( true );
+  bool bFirst( true );
+  boost::posix_time::ptime dtFirstLine;  // recorded time of the first line
+  boost::posix_time::ptime dtStart;  // when it went out
+  boost::posix_time::ptime dtBatchDue;  // schedule of the first line in m_vBuffer
+
+  m_vBuffer.clear();
+  FeedRecording::Line line;
+  while ( bConnected && recording.Next( line ) ) {
+    if ( bFirst ) {
+      bFirst = false;
+      dtFirstLine = line.dtReceived;
+      dtStart = boost::posix_time::microsec_clock::universal_time();
+    }
+    if ( bPaced ) {
+      boost::posix_time::ptime dtDue( dtStart + boost::posix_time::microseconds(
+        static_cast<boost::int64_t>( ( line.dtReceived - dtFirstLine ).total_microseconds() / dblSpeed ) ) );
+      if ( boost::posix_time::microsec_clock::universal_time() < dtDue ) {
+        // not due yet: send what is, then wait
+        if ( !m_vBuffer.empty() ) {
+          bConnected = Write( socket, dtBatchDue, stats );
+          if ( !bConnected ) break;
+        }
+        WaitUntil( dtDue );
+      }
+      if ( m_vBuffer.empty() ) dtBatchDue = dtDue;
+    }
+    m_vBuffer.insert( m_vBuffer.end(), line.pText, line.pText + line.nLength );
+    m_vBuffer.push_back( '\n' );
+    ++stats.nLines;
+    stats.nBytes += line.nLength + 1;
+    if ( nWriteSize <= m_vBuffer.size() ) {
+      bConnected = Write( socket, bPaced ? dtBatchDue : boost::posix_time::ptime(), stats );
+    }
+  }
+  if ( bConnected && !m_vBuffer.empty() ) {
+    bConnected = Write( socket, bPaced ? dtBatchDue : boost::posix_time::ptime(), stats );
+  }
+  if ( !bFirst ) {
+    stats.tdElapsed = boost::posix_time::microsec_clock::universal_time() - dtStart;
+  }
+
+  // closing with unread input resets the connection, which can lose lines the client has yet to read,
+  //   so half close, and read until the client closes
+  boost::system::error_code ec;
+  if ( bConnected ) {
+    socket.shutdown( tcp::socket::shutdown_send, ec );
+    while ( !ec ) {
+      stats.nCommandBytes += socket.read_some( boost::asio::buffer( m_rbCommand ), ec );
+    }
+  }
+  socket.close( ec );
+
+  return stats;
+}
+
+void FeedReplayServer::DrainCommands( tcp::socket& socket, Stats& stats ) {
+  boost::system::error_code ec;
+  while ( !ec && ( 0 < socket.available( ec ) ) ) {
+    stats.nCommandBytes += socket.read_some( boost::asio::buffer( m_rbCommand ), ec );
+  }
+}
+
+bool FeedReplayServer::Write( tcp::socket& socket, const boost::posix_time::ptime& dtDue, Stats& stats ) {
+  DrainCommands( socket, stats );
+  boost::system::error_code ec;
+  boost::asio::write( socket, boost::asio::buffer( m_vBuffer ), ec );
+  m_vBuffer.clear();
+  if ( ec ) {
+    if ( ClientGone( ec ) ) return false;
+    throw boost::system::system_error( ec );
+  }
+  ++stats.nWrites;
+  if ( !dtDue.is_not_a_date_time() ) {
+    boost::posix_time::time_duration tdBehind( boost::posix_time::microsec_clock::universal_time() - dtDue );
+    if ( stats.tdBehindMax < tdBehind ) stats.tdBehindMax = tdBehind;
+  }
+  return true;
+}
+
+} // namespace iqfeed
+} // namespace tf
+} // namespace ou
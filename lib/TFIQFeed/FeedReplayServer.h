@@ -0,0 +1,84 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// stands in for the level 1 port of IQConnect, for load testing without a live feed:
+//   listens on the loopback, on 5009 by default, where IQFeed<T> connects
+//   Replay takes one client, sends it the lines of a FeedRecording, then disconnects it
+//   dblSpeed of 1.0 keeps the recorded pace, 10.0 ten times faster, 0.0 as fast as the client reads
+//   lines due at the same moment go out in one write, as they tend to arrive from the real feed
+//   what the client sends (watches, S,NEWSON, ...) is read and counted, but not acted on,
+//     the recording is what it is
+//   the recording's lines carry no '\r', so lines are terminated with '\n' only, which Network accepts
+
+// usage:
+//  FeedRecording recording( "feed.raw" );
+//  FeedReplayServer server;
+//  FeedReplayServer::Stats stats = server.Replay( recording, 0.0 );  // blocks until the client has gone
+
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "FeedRecorder.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+namespace iqfeed { // IQFeed
+
+class FeedReplayServer {
+public:
+
+  struct Stats {
+    size_t nLines;
+    size_t nBytes;
+    size_t nWrites;  // socket writes, lines are batched
+    size_t nCommandBytes;  // received from the client
+    boost::posix_time::time_duration tdElapsed;  // first write to last
+    boost::posix_time::time_duration tdBehindMax;  // worst lag of a write behind its schedule, paced replay only
+    Stats( void ): nLines( 0 ), nBytes( 0 ), nWrites( 0 ), nCommandBytes( 0 ) {};
+    double LinesPerSecond( void ) const {
+      return ( 0 == tdElapsed.total_microseconds() ) ? 0.0 : ( 1e6 * nLines ) / tdElapsed.total_microseconds();
+    }
+  };
+
+  FeedReplayServer( unsigned short nPort = 5009 );  // throws boost::system::system_error when the port is taken
+  ~FeedReplayServer( void );
+
+  // waits for a client, replays from the current position of recording to its end,
+  //   then closes the send side, and returns once the client has closed its end
+  //   throws boost::system::system_error on a socket failure, a client going away early is not one
+  Stats Replay( FeedRecording& recording, double dblSpeed = 1.0 );
+
+protected:
+private:
+
+  enum { nWriteSize = 64 * 1024 };  // flush the batch once it reaches this
+
+  boost::asio::io_service m_io;
+  boost::asio::ip::tcp::acceptor m_acceptor;
+
+  std::vector<char> m_vBuffer;  // lines to go in the next write
+  char m_rbCommand[ 1024 ];
+
+  void DrainCommands( boost::asio::ip::tcp::socket& socket, Stats& stats );  // whatever the client has sent so far
+  // false once the client has gone, dtDue is the schedule of the first line in the batch, not_a_date_time when unpaced
+  bool Write( boost::asio::ip::tcp::socket& socket, const boost::posix_time::ptime& dtDue, Stats& stats );
+};
+
+} // namespace iqfeed
+} // namespace tf
+} // namespace ou
@@ -26,6 +26,7 @@
 #include <OUCommon/ReusableBuffers.h>
 
 #include "IQFeedMessages.h"
+#include "FeedRecorder.h"
 
 // In the future, for auxilliary routines making use of IQFeed, 
 //   think about incorporating the following concept:
@@ -77,6 +78,9 @@ public:
   void SetNewsOn( void );
   void SetNewsOff( void );
 
+  // lines are passed to the recorder as they arrive, before they are parsed, 0 to stop
+  void SetRecorder( iqfeed::FeedRecorder* pRecorder ) { m_pRecorder = pRecorder; };
+
 protected:
 
   enum enumNewsState {
@@ -121,6 +125,8 @@ protected:
 
 private:
 
+  iqfeed::FeedRecorder* m_pRecorder;
+
   typename ou::BufferRepository<IQFUpdateMessage> m_reposUpdateMessages;
   typename ou::BufferRepository<IQFSummaryMessage> m_reposSummaryMessages;
   typename ou::BufferRepository<IQFNewsMessage> m_reposNewsMessages;
@@ -133,7 +139,7 @@ private:
 template <typename T>
 IQFeed<T>::IQFeed( void ) 
 : ou::Network<IQFeed<T> >( "127.0.0.1", 5009 ),
-  m_stateNews( NEWSISOFF )
+  m_stateNews( NEWSISOFF ), m_pRecorder( 0 )
 {
 }
 
@@ -176,6 +182,12 @@ void IQFeed<T>::OnNetworkLineBuffer( linebuffer_t* pBuffer ) {
 
   BOOST_ASSERT( iter != end );
 
+  OU_LATENCY_LINE();
+
+  if ( 0 != m_pRecorder ) {
+    m_pRecorder->Record( &(*pBuffer)[0], pBuffer->size() );
+  }
+
   switch ( *iter ) {
     case 'Q': 
       {
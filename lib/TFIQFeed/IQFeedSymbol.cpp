@@ -31,7 +31,8 @@ IQFeedSymbol::IQFeedSymbol(const symbol_id_t& sSymbol, pInstrument_t pInstrument
   m_dblOpen( 0 ), m_dblClose( 0 ), m_cntTrades( 0 ), m_dblHigh( 0 ), m_dblLow( 0 ), 
   m_nShortInterest( 0 ), m_dblPriceEarnings( 0 ), m_dbl52WkHi( 0 ), m_dbl52WkLo( 0 ), m_dblDividendYield( 0.0 ),
   m_nOpenInterest( 0 ), m_QStatus( qUnknown ),
-  m_bQuoteTradeWatchInProgress( false ), m_bDepthWatchInProgress( false )
+  m_bQuoteTradeWatchInProgress( false ), m_bDepthWatchInProgress( false ),
+  m_pLatency( OU_LATENCY_REGISTER( "IQF", sSymbol ) )
 {
 }
 
@@ -138,6 +139,8 @@ void IQFeedSymbol::HandleSummaryMessage( IQFSummaryMessage *pMsg ) {
 
 void IQFeedSymbol::HandleUpdateMessage( IQFUpdateMessage *pMsg ) {
 
+  OU_LATENCY_KEY( m_pLatency );
+
   if ( qUnknown == m_QStatus ) {
     m_QStatus = ( "Not Found" == pMsg->Field( IQFPricingMessage<IQFUpdateMessage>::QPLast ) ) ? qNotFound : qFound;
     if ( qNotFound == m_QStatus ) {
@@ -146,9 +149,11 @@ void IQFeedSymbol::HandleUpdateMessage( IQFUpdateMessage *pMsg ) {
   }
   if ( qFound == m_QStatus ) {
     DecodePricingMessage<IQFUpdateMessage>( pMsg );
+    OU_LATENCY_STAGE( ou::LatencyTrace::EParse );
     OnUpdateMessage( *this );
     //ptime dt( microsec_clock::local_time() );
     ptime dt( ou::TimeSource::Instance().External() );
+    OU_LATENCY_STAGE( ou::LatencyTrace::EDispatch );
     // quote needs to be sent before the trade
     if ( m_bNewQuote ) {
       Quote quote( dt, m_dblBid, m_nBidSize, m_dblAsk, m_nAskSize );
@@ -18,6 +18,7 @@
 #include <string>
 
 #include <OUCommon/Delegate.h>
+#include <OUCommon/LatencyTrace.h>
 
 #include <TFTrading/Symbol.h>
 
@@ -97,6 +98,8 @@ protected:
   bool GetDepthWatchInProgress( void ) { return m_bDepthWatchInProgress; };
   bool m_bDepthWatchInProgress;
 
+  ou::LatencyStages* m_pLatency;  // 0 unless OU_LATENCY_TRACE
+
   void HandleFundamentalMessage( IQFFundamentalMessage *pMsg );
   void HandleUpdateMessage( IQFUpdateMessage *pMsg );
   void HandleSummaryMessage( IQFSummaryMessage *pMsg );
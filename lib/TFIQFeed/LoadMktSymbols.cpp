@@ -18,11 +18,12 @@
 
 #include <stdexcept>
 
+#include <vector>
 #include <fstream>
 
 #include "CurlGetMktSymbols.h"
 #include "UnzipMktSymbols.h"
-#include "ParseMktSymbolDiskFile.h"
+#include "ParseMktSymbolChunks.h"
 #include "ValidateMktSymbolLine.h"
 
 #include "LoadMktSymbols.h"
@@ -35,6 +36,7 @@ namespace detail {
   // shared between debug and release
   const std::string sFileNameMarketSymbolsText( "../mktsymbols_v2.txt" );
   const std::string sFileNameMarketSymbolsBinary( "../symbols.ser" );
+  const std::string sFileNameMarketSymbolsCache( "../symbols.cache" );
 }
 
 typedef MarketSymbol::TableRowDef trd_t;
@@ -55,8 +57,7 @@ void LoadMktSymbols( InMemoryMktSymbolList& symbols, MktSymbolLoadType::Enum e,
 
   symbols.Clear();
 
-  ValidateMktSymbolLine validator;
-  validator.SetOnProcessLine( MakeDelegate( &symbols, &InMemoryMktSymbolList::InsertParsedStructure ) );
+  ValidateMktSymbolLine validator;  // lines are parsed by ParseMktSymbolChunks, which fills symbols
 
   switch ( e ) {
   case MktSymbolLoadType::Download:
@@ -84,24 +85,38 @@ void LoadMktSymbols( InMemoryMktSymbolList& symbols, MktSymbolLoadType::Enum e,
       std::cout << "Processing Contents" << std::endl;
       const char* pBegin = pUnZippedFile.get();
       const char* pEnd = pBegin + uzmsf.UnZippedFileSize();
-      validator.ParseHeaderLine( pBegin, pEnd );
-      while ( pBegin != pEnd ) {
-        validator.Parse( pBegin, pEnd );
-      } 
+      ParseMktSymbolChunks chunks;
+      chunks.Run( pBegin, pEnd, validator, symbols );
+      std::cout << chunks.Lines() << " lines parsed in " << chunks.Duration() << " on " << chunks.Threads() << " threads" << std::endl;
     }
     catch( ... ) {
       std::cout << "Some Sort of failure in Download" << std::endl;
     }
     break;
   case MktSymbolLoadType::LoadTextFromDisk:
-    typedef ParseMktSymbolDiskFile diskfile_t;
-
     try {
 
-      diskfile_t diskfile;
-      diskfile.SetOnProcessLine( MakeDelegate( &validator, &ValidateMktSymbolLine::Parse<diskfile_t::iterator_t> ) );
-
-      diskfile.Run( detail::sFileNameMarketSymbolsText );
+      // whole file in memory, so it can be parsed in chunks
+      std::cout << "Opening Input Symbol File " << sName << " ... " << std::endl;
+      std::ifstream file( sName.c_str(), std::ios_base::in | std::ios_base::binary );
+      if ( !file ) {
+        throw std::runtime_error( "Can't open input file" );
+      }
+      std::vector<char> vText;
+      file.seekg( 0, std::ios_base::end );
+      vText.resize( file.tellg() );
+      file.seekg( 0, std::ios_base::beg );
+      if ( !vText.empty() ) {
+        file.read( &vText[ 0 ], vText.size() );
+      }
+      file.close();
+
+      std::cout << "Loading Symbols ..." << std::endl;
+      const char* pBegin = vText.empty() ? 0 : &vText[ 0 ];
+      const char* pEnd = pBegin + vText.size();
+      ParseMktSymbolChunks chunks;
+      chunks.Run( pBegin, pEnd, validator, symbols );
+      std::cout << chunks.Lines() << " lines parsed in " << chunks.Duration() << " on " << chunks.Threads() << " threads" << std::endl;
     }
     catch (...) {
       std::cout << "Some sort of failure on disk read" << std::endl;
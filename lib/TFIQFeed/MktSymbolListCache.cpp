@@ -0,0 +1,317 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+//#include "StdAfx.h"
+
+#include <vector>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "MktSymbolListCache.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+namespace iqfeed { // IQFeed
+
+namespace {
+
+  const char szMagic[ 8 ] = { 'O', 'U', 'M', 'K', 'T', 'S', 'Y', 'M' };
+  const boost::uint32_t nVersion( 1 );
+
+  struct Header {
+    char szMagic[ 8 ];
+    boost::uint32_t nVersion;
+    boost::uint32_t nRecordSize;  // guards against a file written with a different layout
+    boost::uint32_t nRecords;
+    boost::uint32_t nIndexes;
+    boost::uint64_t nPool;  // bytes in the string pool
+    boost::uint64_t offsetRecords;
+    boost::uint64_t offsetIndex;  // nIndexes arrays of nRecords record numbers, back to back
+    boost::uint64_t offsetPool;
+    boost::uint64_t nFileSize;
+  };
+
+  class StringPool {
+  public:
+    StringPool( void ): m_sPool( 1, '\0' ) {  // offset 0 is the empty string
+      m_mapOffset.insert( mapOffset_t::value_type( std::string(), 0 ) );
+    };
+    boost::uint32_t Intern( const std::string& s ) {
+      mapOffset_t::const_iterator iter = m_mapOffset.find( s );
+      if ( m_mapOffset.end() != iter ) return iter->second;
+      boost::uint32_t ix( m_sPool.size() );
+      m_sPool.append( s.c_str(), s.size() + 1 );  // includes terminator
+      m_mapOffset.insert( mapOffset_t::value_type( s, ix ) );
+      return ix;
+    }
+    const std::string& Pool( void ) const { return m_sPool; };
+  private:
+    typedef boost::unordered_map<std::string,boost::uint32_t> mapOffset_t;
+    mapOffset_t m_mapOffset;
+    std::string m_sPool;
+  };
+
+} // namespace anonymous
+
+struct MktSymbolListCache::Mapping {
+  boost::interprocess::file_mapping file;
+  boost::interprocess::mapped_region region;
+  Mapping( const std::string& sFileName )
+    : file( sFileName.c_str(), boost::interprocess::read_only ),
+      region( file, boost::interprocess::read_only ) {};
+};
+
+void MktSymbolListCache::Row::Fill( trd_t& trd ) const {
+  trd.sSymbol = Symbol();
+  trd.sDescription = Description();
+  trd.sExchange = Exchange();
+  trd.sListedMarket = ListedMarket();
+  trd.sc = SymbolClass();
+  trd.nMultiplier = Multiplier();
+  trd.nSIC = SIC();
+  trd.nNAICS = NAICS();
+  trd.sUnderlying = Underlying();
+  trd.eOptionSide = OptionSide();
+  trd.dblStrike = Strike();
+  trd.nYear = Year();
+  trd.nMonth = Month();
+  trd.nDay = Day();
+  trd.bFrontMonth = FrontMonth();
+  trd.bHasOptions = HasOptions();
+}
+
+MktSymbolListCache::MktSymbolListCache( void )
+  : m_pMapping( 0 ), m_nRecords( 0 ), m_pRecords( 0 ), m_pPool( 0 )
+{
+  std::fill( m_rpIndex, m_rpIndex + IndexCount, static_cast<const boost::uint32_t*>( 0 ) );
+}
+
+MktSymbolListCache::~MktSymbolListCache( void ) {
+  Close();
+}
+
+namespace {
+
+  // the record's member holding the key of each index, strings and numbers in separate tables
+  struct LessRecord {
+    const std::vector<MktSymbolListCache::trd_t>& m_vTrd;
+    int m_ix;
+    LessRecord( const std::vector<MktSymbolListCache::trd_t>& vTrd, int ix ): m_vTrd( vTrd ), m_ix( ix ) {};
+    bool operator()( boost::uint32_t lhs, boost::uint32_t rhs ) const {
+      const MktSymbolListCache::trd_t& l( m_vTrd[ lhs ] );
+      const MktSymbolListCache::trd_t& r( m_vTrd[ rhs ] );
+      switch ( m_ix ) {
+        case 0: return 0 > std::strcmp( l.sExchange.c_str(), r.sExchange.c_str() );
+        case 1: return l.sc < r.sc;
+        case 2: return l.nSIC < r.nSIC;
+        case 3: return l.nNAICS < r.nNAICS;
+        case 4: return 0 > std::strcmp( l.sUnderlying.c_str(), r.sUnderlying.c_str() );
+      }
+      return false;
+    }
+  };
+
+  struct Collect {
+    std::vector<MktSymbolListCache::trd_t>& m_vTrd;
+    Collect( std::vector<MktSymbolListCache::trd_t>& vTrd ): m_vTrd( vTrd ) {};
+    void operator()( const MktSymbolListCache::trd_t& trd ) { m_vTrd.push_back( trd ); };
+  };
+
+} // namespace anonymous
+
+void MktSymbolListCache::Write( const InMemoryMktSymbolList& list, const std::string& sFileName ) {
+
+  std::vector<trd_t> vTrd;  // in symbol order
+  vTrd.reserve( list.Size() );
+  list.ScanSymbols( Collect( vTrd ) );
+
+  StringPool pool;
+  std::vector<Record> vRecord( vTrd.size() );
+  for ( size_t ix = 0; ix < vTrd.size(); ++ix ) {
+    const trd_t& trd( vTrd[ ix ] );
+    Record& record( vRecord[ ix ] );
+    std::memset( &record, 0, sizeof( Record ) );  // padding is written out as well
+    record.ixSymbol = pool.Intern( trd.sSymbol );
+    record.ixDescription = pool.Intern( trd.sDescription );
+    record.ixExchange = pool.Intern( trd.sExchange );
+    record.ixListedMarket = pool.Intern( trd.sListedMarket );
+    record.ixUnderlying = pool.Intern( trd.sUnderlying );
+    record.sc = trd.sc;
+    record.nSIC = trd.nSIC;
+    record.nNAICS = trd.nNAICS;
+    record.dblStrike = trd.dblStrike;
+    record.nMultiplier = trd.nMultiplier;
+    record.nYear = trd.nYear;
+    record.nMonth = trd.nMonth;
+    record.nDay = trd.nDay;
+    record.eOptionSide = static_cast<boost::uint8_t>( trd.eOptionSide );
+    record.flags = ( trd.bFrontMonth ? FlagFrontMonth : 0 ) | ( trd.bHasOptions ? FlagHasOptions : 0 );
+  }
+
+  std::vector<boost::uint32_t> vIndex( IndexCount * vTrd.size() );
+  for ( int ix = 0; ix < IndexCount; ++ix ) {
+    std::vector<boost::uint32_t>::iterator begin( vIndex.begin() + ix * vTrd.size() );
+    std::vector<boost::uint32_t>::iterator end( begin + vTrd.size() );
+    for ( boost::uint32_t n = 0; n < vTrd.size(); ++n ) *( begin + n ) = n;
+    std::stable_sort( begin, end, LessRecord( vTrd, ix ) );  // stable, so ties remain in symbol order
+  }
+
+  Header header;
+  std::memset( &header, 0, sizeof( Header ) );
+  std::copy( szMagic, szMagic + sizeof( szMagic ), header.szMagic );
+  header.nVersion = nVersion;
+  header.nRecordSize = sizeof( Record );
+  header.nRecords = vRecord.size();
+  header.nIndexes = IndexCount;
+  header.nPool = pool.Pool().size();
+  header.offsetRecords = sizeof( Header );
+  header.offsetIndex = header.offsetRecords + vRecord.size() * sizeof( Record );
+  header.offsetPool = header.offsetIndex + vIndex.size() * sizeof( boost::uint32_t );
+  header.nFileSize = header.offsetPool + header.nPool;
+
+  // written aside, and renamed over the old file once complete, so a reader never maps a partial file
+  std::string sFileNameTemp( sFileName + ".tmp" );
+  {
+    std::ofstream ofs( sFileNameTemp.c_str(), std::ios::binary | std::ios::trunc );
+    if ( !ofs ) {
+      throw std::runtime_error( "MktSymbolListCache::Write can't create " + sFileNameTemp );
+    }
+    ofs.write( reinterpret_cast<const char*>( &header ), sizeof( Header ) );
+    if ( !vRecord.empty() ) {
+      ofs.write( reinterpret_cast<const char*>( &vRecord[ 0 ] ), vRecord.size() * sizeof( Record ) );
+      ofs.write( reinterpret_cast<const char*>( &vIndex[ 0 ] ), vIndex.size() * sizeof( boost::uint32_t ) );
+    }
+    ofs.write( pool.Pool().data(), pool.Pool().size() );
+    ofs.close();
+    if ( !ofs ) {
+      boost::system::error_code ec;
+      boost::filesystem::remove( sFileNameTemp, ec );
+      throw std::runtime_error( "MktSymbolListCache::Write failed on " + sFileNameTemp );
+    }
+  }
+  boost::system::error_code ec;
+  boost::filesystem::rename( sFileNameTemp, sFileName, ec );
+  if ( ec ) {
+    boost::filesystem::remove( sFileNameTemp, ec );
+    throw std::runtime_error( "MktSymbolListCache::Write can't replace " + sFileName );
+  }
+}
+
+bool MktSymbolListCache::Open( const std::string& sFileName ) {
+
+  Close();
+
+  {
+    std::ifstream ifs( sFileName.c_str(), std::ios::binary );
+    if ( !ifs ) return false;
+  }
+
+  try {
+    m_pMapping = new Mapping( sFileName );
+  }
+  catch ( boost::interprocess::interprocess_exception& ) {
+    return false;
+  }
+
+  const char* pBase( static_cast<const char*>( m_pMapping->region.get_address() ) );
+  const size_t nSize( m_pMapping->region.get_size() );
+  const Header* pHeader( reinterpret_cast<const Header*>( pBase ) );
+
+  bool bValid(
+    ( sizeof( Header ) <= nSize )
+    && std::equal( szMagic, szMagic + sizeof( szMagic ), pHeader->szMagic )
+    && ( nVersion == pHeader->nVersion )
+    && ( sizeof( Record ) == pHeader->nRecordSize )
+    && ( IndexCount == pHeader->nIndexes )
+    && ( nSize == pHeader->nFileSize )
+    && ( 0 < pHeader->nPool )
+    );
+  if ( bValid ) {  // the sections are to be laid out as Write lays them out, and end at the end of the mapping
+    const boost::uint64_t nRecords( pHeader->nRecords );
+    bValid =
+      ( sizeof( Header ) == pHeader->offsetRecords )
+      && ( pHeader->offsetRecords + nRecords * sizeof( Record ) == pHeader->offsetIndex )
+      && ( pHeader->offsetIndex + nRecords * IndexCount * sizeof( boost::uint32_t ) == pHeader->offsetPool )
+      && ( pHeader->offsetPool + pHeader->nPool == nSize )
+      && ( '\0' == pBase[ nSize - 1 ] );  // the last string of the pool is terminated
+  }
+  if ( !bValid ) {
+    Close();
+    return false;
+  }
+
+  m_nRecords = pHeader->nRecords;
+  m_pRecords = reinterpret_cast<const Record*>( pBase + pHeader->offsetRecords );
+  for ( int ix = 0; ix < IndexCount; ++ix ) {
+    m_rpIndex[ ix ] = reinterpret_cast<const boost::uint32_t*>( pBase + pHeader->offsetIndex ) + ix * m_nRecords;
+  }
+  m_pPool = pBase + pHeader->offsetPool;
+
+  return true;
+}
+
+void MktSymbolListCache::Close( void ) {
+  m_nRecords = 0;
+  m_pRecords = 0;
+  std::fill( m_rpIndex, m_rpIndex + IndexCount, static_cast<const boost::uint32_t*>( 0 ) );
+  m_pPool = 0;
+  if ( 0 != m_pMapping ) {
+    delete m_pMapping;
+    m_pMapping = 0;
+  }
+}
+
+namespace {
+  struct LessSymbol {
+    const char* m_pPool;
+    LessSymbol( const char* pPool ): m_pPool( pPool ) {};
+    template<typename R>
+    bool operator()( const R& record, const char* sz ) const { return 0 > std::strcmp( m_pPool + record.ixSymbol, sz ); };
+  };
+} // namespace anonymous
+
+const MktSymbolListCache::Record* MktSymbolListCache::Find( const std::string& sName ) const {
+  if ( 0 == m_nRecords ) return 0;
+  const Record* end( m_pRecords + m_nRecords );
+  const Record* iter = std::lower_bound( m_pRecords, end, sName.c_str(), LessSymbol( m_pPool ) );
+  if ( ( end != iter ) && ( sName == String( iter->ixSymbol ) ) ) return iter;
+  return 0;
+}
+
+MktSymbolListCache::trd_t MktSymbolListCache::GetTrd( const std::string& sName ) const {
+  const Record* pRecord = Find( sName );
+  if ( 0 == pRecord ) {
+    throw std::runtime_error( "GetTrd can't find " + sName );
+  }
+  trd_t trd;
+  Row( *this, *pRecord ).Fill( trd );
+  return trd;
+}
+
+void MktSymbolListCache::Populate( InMemoryMktSymbolList& list ) const {
+  list.Clear();
+  trd_t trd;
+  for ( const Record* pRecord = m_pRecords; ( m_pRecords + m_nRecords ) != pRecord; ++pRecord ) {
+    Row( *this, *pRecord ).Fill( trd );
+    list.InsertParsedStructure( trd );
+  }
+}
+
+} // namespace iqfeed
+} // namespace tf
+} // namespace ou
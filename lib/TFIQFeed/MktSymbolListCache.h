@@ -0,0 +1,216 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// compact read-only image of an InMemoryMktSymbolList, memory mapped rather than deserialized:
+//   a string pool (each distinct string stored once), fixed width records sorted by symbol,
+//   and prebuilt sorted index arrays for exchange, symbol class, sic, naics and underlying
+// queries run directly against the mapped file, a row is only expanded to a trd_t when asked for
+// Write builds the file from a list, usually right after the list has been saved with SaveToFile
+// How to Use:
+/*
+  MktSymbolListCache cache;
+  if ( !cache.Open( detail::sFileNameMarketSymbolsCache ) ) {
+    // absent or from a different format version, rebuild from the list
+  }
+  cache.SelectOptionsByUnderlying( "GLD", f );  // f( const MktSymbolListCache::Row& )
+*/
+
+#include <string>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+
+#include "InMemoryMktSymbolList.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+namespace iqfeed { // IQFeed
+
+class MktSymbolListCache {
+private:
+  struct Record;
+public:
+
+  typedef InMemoryMktSymbolList::trd_t trd_t;
+  typedef MarketSymbol::enumSymbolClassifier classifier_t;
+
+  class Row {  // view of a record in the mapped file, valid while the cache is open
+  public:
+    Row( const MktSymbolListCache& cache, const Record& record ): m_cache( cache ), m_record( record ) {};
+    const char* Symbol( void ) const { return m_cache.String( m_record.ixSymbol ); };
+    const char* Description( void ) const { return m_cache.String( m_record.ixDescription ); };
+    const char* Exchange( void ) const { return m_cache.String( m_record.ixExchange ); };
+    const char* ListedMarket( void ) const { return m_cache.String( m_record.ixListedMarket ); };
+    const char* Underlying( void ) const { return m_cache.String( m_record.ixUnderlying ); };
+    classifier_t SymbolClass( void ) const { return static_cast<classifier_t>( m_record.sc ); };
+    boost::uint16_t Multiplier( void ) const { return m_record.nMultiplier; };
+    boost::uint32_t SIC( void ) const { return m_record.nSIC; };
+    boost::uint32_t NAICS( void ) const { return m_record.nNAICS; };
+    ou::tf::OptionSide::enumOptionSide OptionSide( void ) const { return static_cast<ou::tf::OptionSide::enumOptionSide>( m_record.eOptionSide ); };
+    double Strike( void ) const { return m_record.dblStrike; };
+    boost::uint16_t Year( void ) const { return m_record.nYear; };
+    boost::uint8_t Month( void ) const { return m_record.nMonth; };
+    boost::uint8_t Day( void ) const { return m_record.nDay; };
+    bool FrontMonth( void ) const { return 0 != ( m_record.flags & FlagFrontMonth ); };
+    bool HasOptions( void ) const { return 0 != ( m_record.flags & FlagHasOptions ); };
+    void Fill( trd_t& trd ) const;  // expand to the structure used by InMemoryMktSymbolList
+  private:
+    const MktSymbolListCache& m_cache;
+    const Record& m_record;
+  };
+
+  MktSymbolListCache( void );
+  ~MktSymbolListCache( void );
+
+  static void Write( const InMemoryMktSymbolList& list, const std::string& sFileName );
+
+  bool Open( const std::string& sFileName );  // false when absent, or not of the current format
+  void Close( void );
+  bool IsOpen( void ) const { return 0 != m_pRecords; };
+
+  size_t Size( void ) const { return m_nRecords; };
+
+  bool Exists( const std::string& sName ) const { return 0 != Find( sName ); };
+  trd_t GetTrd( const std::string& sName ) const;  // throws if not found
+
+  void Populate( InMemoryMktSymbolList& list ) const;  // for code requiring the full container
+
+  template<typename Function>
+  void ScanSymbols( Function f ) const {  // in symbol order
+    for ( const Record* pRecord = m_pRecords; ( m_pRecords + m_nRecords ) != pRecord; ++pRecord ) {
+      f( Row( *this, *pRecord ) );
+    }
+  }
+
+  template<typename ExchangeIterator, typename Function>
+  void SelectSymbolsByExchange( ExchangeIterator beginExchange, ExchangeIterator endExchange, Function f ) const {
+    while ( beginExchange != endExchange ) {
+      std::string sExchange( *beginExchange );
+      SelectByString( IndexExchange, &Record::ixExchange, sExchange.c_str(), f );
+      ++beginExchange;
+    }
+  }
+
+  template<typename Function>
+  void SelectOptionsByUnderlying( const std::string& sUnderlying, Function f ) const {
+    SelectByString( IndexUnderlying, &Record::ixUnderlying, sUnderlying.c_str(), f );
+  }
+
+  template<typename Function>
+  void SelectSymbolsByClass( classifier_t sc, Function f ) const {
+    SelectByNumber( IndexSymbolClass, &Record::sc, static_cast<boost::uint32_t>( sc ), f );
+  }
+
+  template<typename Function>
+  void SelectSymbolsBySic( boost::uint32_t nSIC, Function f ) const {
+    SelectByNumber( IndexSic, &Record::nSIC, nSIC, f );
+  }
+
+  template<typename Function>
+  void SelectSymbolsByNaics( boost::uint32_t nNAICS, Function f ) const {
+    SelectByNumber( IndexNaics, &Record::nNAICS, nNAICS, f );
+  }
+
+protected:
+private:
+
+  enum EIndex { IndexExchange = 0, IndexSymbolClass, IndexSic, IndexNaics, IndexUnderlying, IndexCount };
+  enum EFlag { FlagFrontMonth = 0x01, FlagHasOptions = 0x02 };
+
+  struct Record {  // fixed width, strings are byte offsets into the pool
+    boost::uint32_t ixSymbol;
+    boost::uint32_t ixDescription;
+    boost::uint32_t ixExchange;
+    boost::uint32_t ixListedMarket;
+    boost::uint32_t ixUnderlying;
+    boost::uint32_t sc;
+    boost::uint32_t nSIC;
+    boost::uint32_t nNAICS;
+    double dblStrike;
+    boost::uint16_t nMultiplier;
+    boost::uint16_t nYear;
+    boost::uint8_t nMonth;
+    boost::uint8_t nDay;
+    boost::uint8_t eOptionSide;
+    boost::uint8_t flags;
+  };
+
+  typedef boost::uint32_t Record::*pString_t;  // member holding a pool offset
+  typedef boost::uint32_t Record::*pNumber_t;
+
+  struct Mapping;  // the mapped file, kept out of the header
+  Mapping* m_pMapping;
+
+  size_t m_nRecords;
+  const Record* m_pRecords;
+  const boost::uint32_t* m_rpIndex[ IndexCount ];  // record numbers, ordered by key then symbol
+  const char* m_pPool;
+
+  const char* String( boost::uint32_t ix ) const { return m_pPool + ix; };
+
+  const Record* Find( const std::string& sName ) const;
+
+  // comparisons against an index entry for lower_bound/upper_bound
+  struct LessString {
+    const MktSymbolListCache& m_cache;
+    pString_t m_pString;
+    LessString( const MktSymbolListCache& cache, pString_t pString ): m_cache( cache ), m_pString( pString ) {};
+    bool operator()( boost::uint32_t ix, const char* sz ) const { return 0 > std::strcmp( m_cache.String( m_cache.m_pRecords[ ix ].*m_pString ), sz ); };
+    bool operator()( const char* sz, boost::uint32_t ix ) const { return 0 > std::strcmp( sz, m_cache.String( m_cache.m_pRecords[ ix ].*m_pString ) ); };
+  };
+
+  struct Number {  // distinguishes the key from an index entry
+    boost::uint32_t n;
+    explicit Number( boost::uint32_t n_ ): n( n_ ) {};
+  };
+
+  struct LessNumber {
+    const MktSymbolListCache& m_cache;
+    pNumber_t m_pNumber;
+    LessNumber( const MktSymbolListCache& cache, pNumber_t pNumber ): m_cache( cache ), m_pNumber( pNumber ) {};
+    bool operator()( boost::uint32_t ix, const Number& key ) const { return m_cache.m_pRecords[ ix ].*m_pNumber < key.n; };
+    bool operator()( const Number& key, boost::uint32_t ix ) const { return key.n < m_cache.m_pRecords[ ix ].*m_pNumber; };
+  };
+
+  template<typename Function>
+  void SelectByString( EIndex ix, pString_t pString, const char* sz, Function& f ) const {
+    const boost::uint32_t* begin( m_rpIndex[ ix ] );
+    const boost::uint32_t* end( begin + m_nRecords );
+    std::pair<const boost::uint32_t*,const boost::uint32_t*> range
+      = std::equal_range( begin, end, sz, LessString( *this, pString ) );
+    for ( const boost::uint32_t* iter = range.first; range.second != iter; ++iter ) {
+      f( Row( *this, m_pRecords[ *iter ] ) );
+    }
+  }
+
+  template<typename Function>
+  void SelectByNumber( EIndex ix, pNumber_t pNumber, boost::uint32_t n, Function& f ) const {
+    const boost::uint32_t* begin( m_rpIndex[ ix ] );
+    const boost::uint32_t* end( begin + m_nRecords );
+    std::pair<const boost::uint32_t*,const boost::uint32_t*> range
+      = std::equal_range( begin, end, Number( n ), LessNumber( *this, pNumber ) );
+    for ( const boost::uint32_t* iter = range.first; range.second != iter; ++iter ) {
+      f( Row( *this, m_pRecords[ *iter ] ) );
+    }
+  }
+
+};
+
+} // namespace iqfeed
+} // namespace tf
+} // namespace ou
@@ -0,0 +1,194 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+//#include "stdafx.h"
+
+#include <cstring>
+#include <cctype>
+
+#include "IQFeedMessages.h"
+#include "NewsTagger.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+namespace iqfeed { // IQFeed
+
+namespace {
+
+  // words closing a description which a headline would leave off
+  const char* rszSuffix[] = {
+    "INC", "CORP", "CORPORATION", "CO", "COMPANY", "COS", "LTD", "LIMITED", "PLC", "LP", "LLC", "NV", "SA", "AG", "SE",
+    "HOLDINGS", "HOLDING", "HLDGS", "GROUP", "GRP", "TRUST", "FUND", "ETF", "ADR", "ADS", "SPONSORED",
+    "CLASS", "CL", "A", "B", "C", "COM", "COMMON", "STOCK", "SHS", "SHARES", "NEW",
+    0
+  };
+
+  bool IsSuffix( const std::string& sWord ) {
+    for ( const char** psz = rszSuffix; 0 != *psz; ++psz ) {
+      if ( sWord == *psz ) return true;
+    }
+    return false;
+  }
+
+} // namespace anonymous
+
+NewsTagger::NewsTagger( size_t nMinimumTicker, size_t nMinimumName )
+  : m_nMinimumTicker( nMinimumTicker ), m_nMinimumName( nMinimumName ),
+  m_nSerial( 0 ), m_cntTags( 0 ),
+  m_pMatcher( 0 ), m_eMatch( ETicker ), m_psStoryId( 0 ), m_pText( 0 ), m_nLength( 0 )
+{
+}
+
+std::string NewsTagger::Name( const std::string& sDescription ) {
+  std::vector<std::string> vWord;
+  std::string sWord;
+  for ( std::string::const_iterator iter = sDescription.begin(); ; ++iter ) {
+    if ( ( sDescription.end() != iter ) && std::isalnum( static_cast<unsigned char>( *iter ) ) ) {
+      sWord += static_cast<char>( std::toupper( static_cast<unsigned char>( *iter ) ) );
+    }
+    else {
+      if ( !sWord.empty() ) {
+        vWord.push_back( sWord );
+        sWord.clear();
+      }
+      if ( sDescription.end() == iter ) break;
+    }
+  }
+  while ( !vWord.empty() && IsSuffix( vWord.back() ) ) vWord.pop_back();
+  size_t ixFirst( 0 );
+  if ( ( 1 < vWord.size() ) && ( "THE" == vWord[ 0 ] ) ) ixFirst = 1;
+  std::string sName;
+  for ( size_t ix = ixFirst; ix < vWord.size(); ++ix ) {
+    if ( !sName.empty() ) sName += ' ';
+    sName += vWord[ ix ];
+  }
+  return sName;
+}
+
+void NewsTagger::Add( Matcher& matcher, const std::string& sPattern, size_t ixSymbol ) {
+  matcher.vPattern.push_back( ' ' + sPattern + ' ' );
+  matcher.vixSymbol.push_back( ixSymbol );
+  matcher.bCompiled = false;
+}
+
+void NewsTagger::AddSymbol( const std::string& sSymbol, const std::string& sName ) {
+  size_t ixSymbol( m_vSymbol.size() );
+  m_vSymbol.push_back( sSymbol );
+  if ( m_nMinimumTicker <= sSymbol.size() ) {
+    Add( m_ticker, sSymbol, ixSymbol );
+  }
+  std::string sMatch( Name( sName ) );
+  if ( ( m_nMinimumName <= sMatch.size() ) && ( sMatch != sSymbol ) ) {
+    Add( m_name, sMatch, ixSymbol );
+  }
+}
+
+void NewsTagger::AddSymbol( const InMemoryMktSymbolList& list, const std::string& sSymbol ) {
+  AddSymbol( sSymbol, list.GetTrd( sSymbol ).sDescription );
+}
+
+void NewsTagger::Compile( Matcher& matcher, bool bCaseSensitive ) {
+  matcher.vpPattern.clear();
+  for ( std::vector<std::string>::const_iterator iter = matcher.vPattern.begin(); matcher.vPattern.end() != iter; ++iter ) {
+    matcher.vpPattern.push_back( iter->c_str() );
+  }
+  matcher.bCompiled = !matcher.vpPattern.empty();
+  if ( matcher.bCompiled ) {
+    matcher.wm.Initialize( matcher.vpPattern, bCaseSensitive );
+  }
+}
+
+void NewsTagger::Compile( void ) {
+  Compile( m_ticker, true );
+  Compile( m_name, false );
+  m_vSeen.assign( m_vSymbol.size(), 0 );
+  m_nSerial = 0;
+}
+
+void NewsTagger::HandleMatch( size_t ixPattern, size_t ixOffset ) {
+  size_t ixSymbol( m_pMatcher->vixSymbol[ ixPattern ] );
+  if ( m_nSerial == m_vSeen[ ixSymbol ] ) return;  // already tagged in this story
+  m_vSeen[ ixSymbol ] = m_nSerial;
+  ++m_cntTags;
+  // the pattern's leading space is at ixOffset in the padded text, so the ticker or name is at ixOffset in the text
+  OnTag( Tag( m_vSymbol[ ixSymbol ], *m_psStoryId, m_eMatch, m_pText, m_nLength, ixOffset ) );
+}
+
+void NewsTagger::Scan( const std::string& sStoryId, const char* pText, size_t nLength ) {
+
+  if ( 0 == ++m_nSerial ) {  // wrapped
+    m_vSeen.assign( m_vSymbol.size(), 0 );
+    m_nSerial = 1;
+  }
+
+  // padded with a space each side, so a ticker or name at either end is bounded like one within
+  m_vText.resize( nLength + 2 );
+  m_vText[ 0 ] = ' ';
+  if ( 0 != nLength ) std::memcpy( &m_vText[ 1 ], pText, nLength );
+  m_vText[ nLength + 1 ] = ' ';
+
+  m_psStoryId = &sStoryId;
+  m_pText = pText;
+  m_nLength = nLength;
+
+  if ( m_ticker.bCompiled ) {
+    m_pMatcher = &m_ticker;
+    m_eMatch = ETicker;
+    m_ticker.wm.Search( m_vText.size(), &m_vText[ 0 ], m_ticker.vpPattern, MakeDelegate( this, &NewsTagger::HandleMatch ) );
+  }
+  if ( m_name.bCompiled ) {
+    m_pMatcher = &m_name;
+    m_eMatch = EName;
+    m_name.wm.Search( m_vText.size(), &m_vText[ 0 ], m_name.vpPattern, MakeDelegate( this, &NewsTagger::HandleMatch ) );
+  }
+}
+
+void NewsTagger::Scan( IQFNewsMessage& msg ) {
+  IQFNewsMessage::fielddelimiter_t fd( msg.HeadLine_iter() );
+  size_t nLength( fd.second - fd.first );
+  Scan( msg.StoryId(), ( 0 == nLength ) ? "" : reinterpret_cast<const char*>( &( *fd.first ) ), nLength );
+}
+
+NewsTagger::Stats NewsTagger::Scan( FeedRecording& recording ) {
+
+  Stats stats;
+  size_t cntTags( m_cntTags );
+  boost::posix_time::ptime dtStart( boost::posix_time::microsec_clock::universal_time() );
+
+  // N,distributor,story id,symbol list,date time,headline
+  FeedRecording::Line line;
+  while ( recording.Next( line ) ) {
+    if ( ( 2 > line.nLength ) || ( 'N' != line.pText[ 0 ] ) || ( ',' != line.pText[ 1 ] ) ) continue;
+    const char* pEnd( line.pText + line.nLength );
+    const char* rpComma[ 5 ];
+    size_t nComma( 0 );
+    for ( const char* p = line.pText; ( pEnd != p ) && ( 5 > nComma ); ++p ) {
+      if ( ',' == *p ) rpComma[ nComma++ ] = p;
+    }
+    if ( 5 > nComma ) continue;  // malformed
+    m_sStoryId.assign( rpComma[ 1 ] + 1, rpComma[ 2 ] );
+    const char* pHeadline( rpComma[ 4 ] + 1 );
+    Scan( m_sStoryId, pHeadline, pEnd - pHeadline );
+    ++stats.nStories;
+    stats.nBytes += pEnd - pHeadline;
+  }
+
+  stats.tdElapsed = boost::posix_time::microsec_clock::universal_time() - dtStart;
+  stats.nTags = m_cntTags - cntTags;
+  return stats;
+}
+
+} // namespace iqfeed
+} // namespace tf
+} // namespace ou
@@ -0,0 +1,144 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// tags news headlines and stories with the symbols of a watched universe, by what the text says,
+//   rather than by the symbol list the distributor attached:
+//   each symbol contributes its ticker, matched case sensitive, and its company name, from the
+//     description in the symbol list, matched case insensitive, with suffixes like INC and CORP dropped
+//   both are compiled into WuManber matchers, patterns padded with a space each side, and anything not
+//     a letter or digit reads as a space, so "(NASDAQ:AAPL)" and "Apple's" match, but "SNAPPLE" does not
+//   OnTag is emitted once per symbol per story, ticker or name, whichever is met first
+//   Scan reuses buffers sized by the largest text so far, so, once warmed up, nothing is allocated per story
+//   an instance is for one thread
+
+// usage:
+//   NewsTagger tagger;
+//   tagger.AddSymbol( list, "AAPL" );  // for each symbol watched
+//   tagger.Compile();
+//   tagger.OnTag.Add( MakeDelegate( this, &App::HandleTag ) );
+//   ... in IQFeed<T>::OnIQFeedNewsMessage:
+//   tagger.Scan( *pMsg );
+
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <OUCommon/Delegate.h>
+#include <OUCommon/WuManber.h>
+
+#include "InMemoryMktSymbolList.h"
+#include "FeedRecorder.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+class IQFNewsMessage;
+
+namespace iqfeed { // IQFeed
+
+class NewsTagger {
+public:
+
+  enum EMatch { ETicker, EName };
+
+  struct Tag {
+    const std::string& sSymbol;
+    const std::string& sStoryId;
+    EMatch eMatch;
+    const char* pText;  // the text scanned, valid for the call only
+    size_t nLength;
+    size_t ixOffset;  // of the match in the text
+    Tag( const std::string& sSymbol_, const std::string& sStoryId_, EMatch eMatch_, const char* pText_, size_t nLength_, size_t ixOffset_ )
+      : sSymbol( sSymbol_ ), sStoryId( sStoryId_ ), eMatch( eMatch_ ), pText( pText_ ), nLength( nLength_ ), ixOffset( ixOffset_ ) {};
+  };
+
+  struct Stats {
+    size_t nStories;
+    size_t nBytes;
+    size_t nTags;
+    boost::posix_time::time_duration tdElapsed;
+    Stats( void ): nStories( 0 ), nBytes( 0 ), nTags( 0 ) {};
+    double StoriesPerSecond( void ) const {
+      return ( 0 == tdElapsed.total_microseconds() ) ? 0.0 : ( 1e6 * nStories ) / tdElapsed.total_microseconds();
+    }
+    double MegaBytesPerSecond( void ) const {
+      return ( 0 == tdElapsed.total_microseconds() ) ? 0.0 : static_cast<double>( nBytes ) / tdElapsed.total_microseconds();
+    }
+  };
+
+  NewsTagger( size_t nMinimumTicker = 2, size_t nMinimumName = 4 );  // shorter tickers and names are too often ordinary words
+  ~NewsTagger( void ) {};
+
+  // an empty sName adds the ticker only, call Compile once all are added
+  void AddSymbol( const std::string& sSymbol, const std::string& sName );
+  void AddSymbol( const InMemoryMktSymbolList& list, const std::string& sSymbol );  // name from the description, throws if not listed
+  void Compile( void );
+  size_t Symbols( void ) const { return m_vSymbol.size(); };
+
+  void Scan( const std::string& sStoryId, const char* pText, size_t nLength );
+  void Scan( IQFNewsMessage& msg );  // the headline
+
+  // scans the headline of each news line in a raw feed recording, from its current position, timed, a benchmark
+  Stats Scan( FeedRecording& recording );
+
+  ou::Delegate<const Tag&> OnTag;
+
+  static std::string Name( const std::string& sDescription );  // the part of a description matched as a name
+
+protected:
+private:
+
+  struct Matcher {
+    ou::WuManber wm;
+    std::vector<std::string> vPattern;  // padded
+    std::vector<const char*> vpPattern;  // for WuManber, into vPattern
+    std::vector<size_t> vixSymbol;  // of each pattern
+    bool bCompiled;
+    Matcher( void ): bCompiled( false ) {};
+  };
+
+  size_t m_nMinimumTicker;
+  size_t m_nMinimumName;
+
+  std::vector<std::string> m_vSymbol;
+  std::vector<boost::uint32_t> m_vSeen;  // story serial a symbol was last tagged in
+
+  Matcher m_ticker;
+  Matcher m_name;
+
+  std::vector<char> m_vText;  // the text, padded
+  boost::uint32_t m_nSerial;
+  size_t m_cntTags;
+
+  // for HandleMatch, of the story being scanned
+  Matcher* m_pMatcher;
+  EMatch m_eMatch;
+  const std::string* m_psStoryId;
+  const char* m_pText;
+  size_t m_nLength;
+  std::string m_sStoryId;  // for Scan( recording )
+
+  void Add( Matcher& matcher, const std::string& sPattern, size_t ixSymbol );
+  void Compile( Matcher& matcher, bool bCaseSensitive );
+  void HandleMatch( size_t ixPattern, size_t ixOffset );
+
+};
+
+} // namespace iqfeed
+} // namespace tf
+} // namespace ou
@@ -0,0 +1,107 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+//#include "stdafx.h"
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "ParseMktSymbolChunks.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+namespace iqfeed { // IQFeed
+
+ParseMktSymbolChunks::ParseMktSymbolChunks( unsigned int nThreads )
+  : m_nThreads( nThreads ), m_cntLines( 0 )
+{
+  if ( 0 == m_nThreads ) {
+    m_nThreads = boost::thread::hardware_concurrency();
+    if ( 0 == m_nThreads ) m_nThreads = 1;  // not determinable
+  }
+}
+
+void ParseMktSymbolChunks::Chunk::Parse( void ) {
+  pValidator->SetOnProcessLine( MakeDelegate( this, &Chunk::HandleLine ) );
+  const char* pLine( pBegin );
+  while ( pEnd != pLine ) {
+    const char* pPrior( pLine );
+    pValidator->Parse( pLine, pEnd );
+    if ( pPrior == pLine ) {  // no progress on a malformed line, skip it
+      while ( ( pEnd != pLine ) && ( '\n' != *pLine ) ) ++pLine;
+      if ( pEnd != pLine ) ++pLine;
+    }
+  }
+  // the symbol index of the list is built much faster from symbols in order,
+  //   stable, so a symbol repeated in the file keeps its first occurrence first
+  std::stable_sort( vTrd.begin(), vTrd.end(), LessSymbol() );
+}
+
+void ParseMktSymbolChunks::Run( const char* pBegin, const char* pEnd, ValidateMktSymbolLine& validator, InMemoryMktSymbolList& symbols ) {
+
+  boost::posix_time::ptime dtStart( boost::posix_time::microsec_clock::universal_time() );
+
+  validator.ParseHeaderLine( pBegin, pEnd );
+
+  // chunk boundaries are moved forward to the start of the next line
+  typedef std::vector<Chunk> vChunk_t;
+  vChunk_t vChunk;
+  vChunk.reserve( m_nThreads );
+  const size_t nSize( pEnd - pBegin );
+  const char* pChunk( pBegin );
+  for ( unsigned int ix = 1; ix <= m_nThreads; ++ix ) {
+    const char* pNext( ( m_nThreads == ix ) ? pEnd : pBegin + ( nSize * ix ) / m_nThreads );
+    if ( pNext < pChunk ) pNext = pChunk;
+    while ( ( pEnd != pNext ) && ( pBegin != pNext ) && ( '\n' != *( pNext - 1 ) ) ) ++pNext;
+    if ( pChunk != pNext ) {
+      vChunk.push_back( Chunk( pChunk, pNext ) );
+    }
+    pChunk = pNext;
+  }
+
+  boost::thread_group threads;
+  for ( vChunk_t::iterator iter = vChunk.begin(); vChunk.end() != iter; ++iter ) {
+    threads.create_thread( boost::bind( &Chunk::Parse, &( *iter ) ) );
+  }
+  threads.join_all();
+
+  // merge the sorted chunks into the list, on equal symbols the earlier chunk goes first, as it is earlier in the file
+  std::vector<size_t> vCursor( vChunk.size(), 0 );
+  while ( true ) {
+    size_t ixNext( vChunk.size() );
+    for ( size_t ix = 0; ix < vChunk.size(); ++ix ) {
+      if ( vChunk[ ix ].vTrd.size() == vCursor[ ix ] ) continue;
+      if ( ( vChunk.size() == ixNext )
+        || ( vChunk[ ix ].vTrd[ vCursor[ ix ] ].sSymbol < vChunk[ ixNext ].vTrd[ vCursor[ ixNext ] ].sSymbol ) ) {
+        ixNext = ix;
+      }
+    }
+    if ( vChunk.size() == ixNext ) break;
+    symbols.InsertParsedStructure( vChunk[ ixNext ].vTrd[ vCursor[ ixNext ] ] );
+    ++vCursor[ ixNext ];
+  }
+
+  for ( vChunk_t::iterator iter = vChunk.begin(); vChunk.end() != iter; ++iter ) {
+    validator.Merge( *iter->pValidator );
+  }
+
+  m_cntLines = validator.LinesProcessed();
+  m_tdRun = boost::posix_time::microsec_clock::universal_time() - dtStart;
+}
+
+} // namespace iqfeed
+} // namespace tf
+} // namespace ou
@@ -0,0 +1,81 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// parses the mktsymbols text, held in memory, on a number of threads:
+//   the text is split into one newline aligned chunk per thread,
+//   each chunk has its own ValidateMktSymbolLine, as the spirit parsers and the counts are not shared,
+//   parsed records are kept per chunk and sorted by symbol on the chunk's thread,
+//   then merged into the list in symbol order, which builds the container about three times faster
+//   than insertion in file order (ties go to the earlier chunk, so a repeated symbol keeps its first line)
+//   validators are merged in file order, so the list, and the PostProcess which follows,
+//   match a single threaded pass
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "InMemoryMktSymbolList.h"
+#include "ValidateMktSymbolLine.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+namespace iqfeed { // IQFeed
+
+class ParseMktSymbolChunks {
+public:
+
+  typedef ValidateMktSymbolLine::trd_t trd_t;
+
+  ParseMktSymbolChunks( unsigned int nThreads = 0 );  // 0 uses hardware concurrency
+  ~ParseMktSymbolChunks( void ) {};
+
+  // [pBegin, pEnd) is the whole file, header line included
+  // validator receives the merged counts, ready for PostProcess and Summary
+  void Run( const char* pBegin, const char* pEnd, ValidateMktSymbolLine& validator, InMemoryMktSymbolList& symbols );
+
+  unsigned int Threads( void ) const { return m_nThreads; };
+  size_t Lines( void ) const { return m_cntLines; };
+  boost::posix_time::time_duration Duration( void ) const { return m_tdRun; };
+
+protected:
+private:
+
+  struct LessSymbol {
+    bool operator()( const trd_t& lhs, const trd_t& rhs ) const { return lhs.sSymbol < rhs.sSymbol; };
+  };
+
+  struct Chunk {
+    const char* pBegin;
+    const char* pEnd;
+    boost::shared_ptr<ValidateMktSymbolLine> pValidator;
+    std::vector<trd_t> vTrd;
+    Chunk( const char* pBegin_, const char* pEnd_ )
+      : pBegin( pBegin_ ), pEnd( pEnd_ ), pValidator( new ValidateMktSymbolLine ) {};
+    void HandleLine( const trd_t& trd ) { vTrd.push_back( trd ); };
+    void Parse( void );
+  };
+
+  unsigned int m_nThreads;
+
+  size_t m_cntLines;
+  boost::posix_time::time_duration m_tdRun;
+
+};
+
+} // namespace iqfeed
+} // namespace tf
+} // namespace ou
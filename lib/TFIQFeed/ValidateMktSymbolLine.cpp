@@ -100,6 +100,39 @@ void ValidateMktSymbolLine::PostProcess( void ) {
   }
 }
 
+void ValidateMktSymbolLine::Merge( const ValidateMktSymbolLine& rhs ) {
+
+  cntLinesTotal += rhs.cntLinesTotal;
+  cntLinesParsed += rhs.cntLinesParsed;
+  cntSIC += rhs.cntSIC;
+  cntNAICS += rhs.cntNAICS;
+  nUnderlyingSize = std::max<unsigned short>( nUnderlyingSize, rhs.nUnderlyingSize );
+
+  for ( size_t ix = 0; ix < vSymbolTypeStats.size(); ++ix ) {
+    vSymbolTypeStats[ ix ] += rhs.vSymbolTypeStats[ ix ];
+  }
+
+  vSymbolsPerExchange[ 0 ].cnt += rhs.vSymbolsPerExchange[ 0 ].cnt;
+  for ( size_t ixRhs = 1; ixRhs < rhs.vSymbolsPerExchange.size(); ++ixRhs ) {
+    const structCountPerString& cps( rhs.vSymbolsPerExchange[ ixRhs ] );
+    size_t ix = kwmExchanges.FindMatch( cps.s );
+    if ( ( 0 == ix ) || ( cps.s.length() != vSymbolsPerExchange[ ix ].s.length() ) ) {
+      size_t cnt = kwmExchanges.GetPatternCount();
+      kwmExchanges.AddPattern( cps.s, cnt );
+      vSymbolsPerExchange.push_back( cps );
+    }
+    else {
+      vSymbolsPerExchange[ ix ].cnt += cps.cnt;
+    }
+  }
+
+  // later in the file replaces earlier, as when assigned line by line
+  for ( mapUnderlying_t::const_iterator iter = rhs.mapUnderlying.begin(); rhs.mapUnderlying.end() != iter; ++iter ) {
+    mapUnderlying[ iter->first ] = iter->second;
+  }
+
+}
+
 void ValidateMktSymbolLine::Summary( void ) {
 
   struct processSymbols {
@@ -62,6 +62,9 @@ public:
 
   void PostProcess( void );
 
+  // folds in the counts and underlyings of a validator run over a later part of the same file
+  void Merge( const ValidateMktSymbolLine& rhs );
+
   void Summary( void );
 
   size_t LinesProcessed( void ) const { return cntLinesTotal; };
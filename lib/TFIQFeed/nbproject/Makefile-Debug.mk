@@ -38,6 +38,8 @@ OBJECTFILES= \
 	${OBJECTDIR}/BuildInstrument.o \
 	${OBJECTDIR}/BuildSymbolName.o \
 	${OBJECTDIR}/CurlGetMktSymbols.o \
+	${OBJECTDIR}/FeedRecorder.o \
+	${OBJECTDIR}/FeedReplayServer.o \
 	${OBJECTDIR}/IQFeed.o \
 	${OBJECTDIR}/IQFeedMessages.o \
 	${OBJECTDIR}/IQFeedProvider.o \
@@ -46,8 +48,11 @@ OBJECTFILES= \
 	${OBJECTDIR}/LoadMktSymbols.o \
 	${OBJECTDIR}/MarketSymbol.o \
 	${OBJECTDIR}/MarketSymbols.o \
+	${OBJECTDIR}/MktSymbolListCache.o \
+	${OBJECTDIR}/NewsTagger.o \
 	${OBJECTDIR}/Option.o \
 	${OBJECTDIR}/OptionChainQuery.o \
+	${OBJECTDIR}/ParseMktSymbolChunks.o \
 	${OBJECTDIR}/ParseMktSymbolDiskFile.o \
 	${OBJECTDIR}/ParseMktSymbolLine.o \
 	${OBJECTDIR}/UnzipMktSymbols.o \
@@ -95,6 +100,16 @@ ${OBJECTDIR}/CurlGetMktSymbols.o: CurlGetMktSymbols.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/CurlGetMktSymbols.o CurlGetMktSymbols.cpp
 
+${OBJECTDIR}/FeedRecorder.o: FeedRecorder.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/FeedRecorder.o FeedRecorder.cpp
+
+${OBJECTDIR}/FeedReplayServer.o: FeedReplayServer.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/FeedReplayServer.o FeedReplayServer.cpp
+
 ${OBJECTDIR}/IQFeed.o: IQFeed.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -135,6 +150,16 @@ ${OBJECTDIR}/MarketSymbols.o: MarketSymbols.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MarketSymbols.o MarketSymbols.cpp
 
+${OBJECTDIR}/MktSymbolListCache.o: MktSymbolListCache.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MktSymbolListCache.o MktSymbolListCache.cpp
+
+${OBJECTDIR}/NewsTagger.o: NewsTagger.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/NewsTagger.o NewsTagger.cpp
+
 ${OBJECTDIR}/Option.o: Option.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -145,6 +170,11 @@ ${OBJECTDIR}/OptionChainQuery.o: OptionChainQuery.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/OptionChainQuery.o OptionChainQuery.cpp
 
+${OBJECTDIR}/ParseMktSymbolChunks.o: ParseMktSymbolChunks.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ParseMktSymbolChunks.o ParseMktSymbolChunks.cpp
+
 ${OBJECTDIR}/ParseMktSymbolDiskFile.o: ParseMktSymbolDiskFile.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -112,7 +112,8 @@ template<typename T>
 void TSHomogenization<T>::HandleFirstDatum( const T& datum ) {
   m_ts.OnAppend.Remove( MakeDelegate( this, &TSHomogenization<T>::HandleFirstDatum ) );
   m_datum = datum;
-  m_dtMarker = datum.DateTime() % m_tdHomogenizingInterval;
+  // the marker at or before the datum, markers are multiples of the interval from midnight
+  m_dtMarker = datum.DateTime() - time_duration( 0, 0, 0, datum.DateTime().time_of_day().ticks() % m_tdHomogenizingInterval.ticks() );
   if ( m_dtMarker == datum.DateTime() ) {
     HandleDatum( datum );
   }
@@ -127,18 +128,20 @@ template<typename T>
 void TSHomogenization<T>::HandleDatum( const T& datum ) {
   if ( m_dtMarker == datum.DateTime() ) {
     OnAppend( datum );
+    m_dtMarker += m_tdHomogenizingInterval;
   }
   else {
     if ( datum.DateTime() > m_dtMarker ) {
       switch ( m_interpolation ) {
       case ePreviousTick:
-        OnAppend( m_datum );
+        CalcDatum( datum, 0.0 );  // the previous tick, stamped with the marker, so homogenized series align
         break;
-      case eLinear:
+      case eLinear: {
         time_duration numerator( m_dtMarker - m_datum.DateTime() );
         time_duration denomenator( datum.DateTime() - m_datum.DateTime() );
-        double ratio = ( (double) numerator.total_microseconds() ) / ( (double) denomenator.total_microseconds );
+        double ratio = ( (double) numerator.total_microseconds() ) / ( (double) denomenator.total_microseconds() );
         CalcDatum( datum, ratio );
+        }
         break;
       }
       while ( m_dtMarker <= datum.DateTime() ) m_dtMarker += m_tdHomogenizingInterval;
@@ -149,13 +152,13 @@ void TSHomogenization<T>::HandleDatum( const T& datum ) {
 
 template<typename T>
 void TSHomogenization<T>::CalcDatum( const Price& datum, double ratio ) {
-  Price price( m_dtMarker, m_datum.Price() + ratio * ( datum.Value() - m_datum.Price ) );
+  Price price( m_dtMarker, m_datum.Value() + ratio * ( datum.Value() - m_datum.Value() ) );
   OnAppend( price );
 }
 
 template<typename T>
 void TSHomogenization<T>::CalcDatum( const Trade& datum, double ratio ) {
-  Trade trade( m_dtMarker, m_datum.Trade() + ratio * ( datum.Price() - m_datum.Trade ), m_datum.Volume() );
+  Trade trade( m_dtMarker, m_datum.Price() + ratio * ( datum.Price() - m_datum.Price() ), m_datum.Volume() );
   OnAppend( trade );
 }
 
@@ -0,0 +1,316 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#include "stdafx.h"
+
+#include <math.h>
+
+#include <stdexcept>
+
+#include "TSSWCovarianceMatrix.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+//
+// Snapshot
+//
+
+double TSSWCovarianceMatrix::Snapshot::StdDev( size_t ix ) const {
+  return sqrt( Covariance( ix, ix ) );
+}
+
+double TSSWCovarianceMatrix::Snapshot::Correlation( size_t ix1, size_t ix2 ) const {
+  double dblVariances( vCoMoment[ Index( nStreams, ix1, ix1 ) ] * vCoMoment[ Index( nStreams, ix2, ix2 ) ] );
+  return ( 0.0 >= dblVariances ) ? 0.0 : vCoMoment[ Index( nStreams, ix1, ix2 ) ] / sqrt( dblVariances );
+}
+
+void TSSWCovarianceMatrix::Snapshot::Correlations( std::vector<double>& v ) const {
+  v.resize( vCoMoment.size() );
+  std::vector<double> vScale( nStreams );
+  for ( size_t ix = 0; ix < nStreams; ++ix ) {
+    double dblCoMoment( vCoMoment[ Index( nStreams, ix, ix ) ] );
+    vScale[ ix ] = ( 0.0 >= dblCoMoment ) ? 0.0 : 1.0 / sqrt( dblCoMoment );
+  }
+  size_t ixPacked( 0 );
+  for ( size_t ix1 = 0; ix1 < nStreams; ++ix1 ) {
+    for ( size_t ix2 = ix1; ix2 < nStreams; ++ix2 ) {
+      v[ ixPacked ] = vCoMoment[ ixPacked ] * vScale[ ix1 ] * vScale[ ix2 ];
+      ++ixPacked;
+    }
+  }
+}
+
+//
+// TSSWCovarianceMatrix
+//
+
+TSSWCovarianceMatrix::TSSWCovarianceMatrix( size_t nStreams, size_t nWindow, EInput eInput, size_t nRecompute )
+  : m_nStreams( nStreams ), m_nWindow( nWindow ), m_eInput( eInput ), m_nRecompute( nRecompute ), m_cntSinceRecompute( 0 ),
+  m_ixOldest( 0 ), m_nObservations( 0 ), m_dtStep( not_a_date_time ),
+  m_bPrior( false ),
+  m_dtPending( not_a_date_time ), m_nHave( 0 ), m_nSeen( 0 )
+{
+  if ( 0 == nStreams ) throw std::runtime_error( "TSSWCovarianceMatrix: no streams" );
+  if ( 0 == nWindow ) throw std::runtime_error( "TSSWCovarianceMatrix: empty window" );
+  m_vWindow.resize( nStreams * nWindow );
+  m_vMean.resize( nStreams );
+  m_vCoMoment.resize( ( nStreams * ( nStreams + 1 ) ) / 2 );
+  m_vPrior.resize( nStreams );
+  m_vRow.resize( nStreams );
+  m_vDeltaAdd.resize( nStreams );
+  m_vDeltaExpire.resize( nStreams );
+  m_vPending.resize( nStreams );
+  m_vHave.resize( nStreams );
+  m_vLast.resize( nStreams );
+  m_vSeen.resize( nStreams );
+  Reset();
+}
+
+TSSWCovarianceMatrix::~TSSWCovarianceMatrix( void ) {
+  while ( !m_vFollower.empty() ) {
+    Detach( m_vFollower.back()->ixStream );
+  }
+}
+
+void TSSWCovarianceMatrix::Reset( void ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  m_ixOldest = 0;
+  m_nObservations = 0;
+  m_cntSinceRecompute = 0;
+  m_dtStep = not_a_date_time;
+  std::fill( m_vMean.begin(), m_vMean.end(), 0.0 );
+  std::fill( m_vCoMoment.begin(), m_vCoMoment.end(), 0.0 );
+  m_bPrior = false;
+  m_dtPending = not_a_date_time;
+  std::fill( m_vHave.begin(), m_vHave.end(), 0 );
+  m_nHave = 0;
+  std::fill( m_vSeen.begin(), m_vSeen.end(), 0 );
+  m_nSeen = 0;
+}
+
+void TSSWCovarianceMatrix::Attach( size_t ixStream, hf::TSHomogenization<Price>& homogenizer ) {
+  if ( m_nStreams <= ixStream ) throw std::runtime_error( "TSSWCovarianceMatrix::Attach: no such stream" );
+  pFollower_t pFollower( new Follower );
+  pFollower->pMatrix = this;
+  pFollower->ixStream = ixStream;
+  pFollower->pHomogenizer = &homogenizer;
+  m_vFollower.push_back( pFollower );
+  homogenizer.OnAppend.Add( MakeDelegate( pFollower.get(), &Follower::HandleAppend ) );
+}
+
+void TSSWCovarianceMatrix::Detach( size_t ixStream ) {
+  std::vector<pFollower_t>::iterator iter = m_vFollower.begin();
+  while ( m_vFollower.end() != iter ) {
+    if ( ixStream == ( *iter )->ixStream ) {
+      ( *iter )->pHomogenizer->OnAppend.Remove( MakeDelegate( iter->get(), &Follower::HandleAppend ) );
+      iter = m_vFollower.erase( iter );
+    }
+    else {
+      ++iter;
+    }
+  }
+}
+
+void TSSWCovarianceMatrix::Step( const ptime& dt, const double* pPrice ) {
+  bool bStepped;
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    bStepped = StepLocked( dt, pPrice );
+  }
+  if ( bStepped ) OnStep( dt );
+}
+
+void TSSWCovarianceMatrix::Append( size_t ixStream, const Price& price ) {
+
+  ptime rdtStepped[ 2 ];  // a filled step, and the step this price completes
+  size_t nStepped( 0 );
+
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+
+    const ptime dt( price.DateTime() );
+    if ( m_dtPending.is_not_a_date_time() ) {
+      if ( !m_dtStep.is_not_a_date_time() && ( dt <= m_dtStep ) ) return;  // stepped past
+      m_dtPending = dt;
+    }
+    else {
+      if ( dt < m_dtPending ) return;  // stepped past
+      if ( dt > m_dtPending ) {
+        // the pending step is done with, streams missing from it take their last price
+        if ( m_nStreams == m_nSeen ) {
+          for ( size_t ix = 0; ix < m_nStreams; ++ix ) {
+            if ( 0 == m_vHave[ ix ] ) m_vPending[ ix ] = m_vLast[ ix ];
+          }
+          if ( StepLocked( m_dtPending, &m_vPending[ 0 ] ) ) rdtStepped[ nStepped++ ] = m_dtPending;
+        }
+        // otherwise a stream has yet to price at all, so the step is dropped
+        std::fill( m_vHave.begin(), m_vHave.end(), 0 );
+        m_nHave = 0;
+        m_dtPending = dt;
+      }
+    }
+
+    m_vPending[ ixStream ] = price.Value();
+    if ( 0 == m_vHave[ ixStream ] ) {
+      m_vHave[ ixStream ] = 1;
+      ++m_nHave;
+    }
+    m_vLast[ ixStream ] = price.Value();
+    if ( 0 == m_vSeen[ ixStream ] ) {
+      m_vSeen[ ixStream ] = 1;
+      ++m_nSeen;
+    }
+
+    if ( m_nStreams == m_nHave ) {
+      if ( StepLocked( m_dtPending, &m_vPending[ 0 ] ) ) rdtStepped[ nStepped++ ] = m_dtPending;
+      std::fill( m_vHave.begin(), m_vHave.end(), 0 );
+      m_nHave = 0;
+      m_dtPending = not_a_date_time;
+    }
+  }
+
+  for ( size_t ix = 0; ix < nStepped; ++ix ) OnStep( rdtStepped[ ix ] );
+}
+
+bool TSSWCovarianceMatrix::StepLocked( const ptime& dt, const double* pPrice ) {
+
+  switch ( m_eInput ) {
+  case ELevel:
+    std::copy( pPrice, pPrice + m_nStreams, m_vRow.begin() );
+    break;
+  case ELogReturn:
+    for ( size_t ix = 0; ix < m_nStreams; ++ix ) {
+      if ( 0.0 >= pPrice[ ix ] ) return false;  // no return to be had, the prior stays as it was
+    }
+    if ( !m_bPrior ) {
+      std::copy( pPrice, pPrice + m_nStreams, m_vPrior.begin() );
+      m_bPrior = true;
+      m_dtStep = dt;
+      return false;  // the first step is a base for the returns
+    }
+    for ( size_t ix = 0; ix < m_nStreams; ++ix ) {
+      m_vRow[ ix ] = log( pPrice[ ix ] / m_vPrior[ ix ] );
+      m_vPrior[ ix ] = pPrice[ ix ];
+    }
+    break;
+  }
+
+  Slide( &m_vRow[ 0 ] );
+  m_dtStep = dt;
+
+  if ( 0 != m_nRecompute ) {
+    if ( m_nRecompute <= ++m_cntSinceRecompute ) RecomputeLocked();
+  }
+
+  return true;
+}
+
+// the co-moment matrix C is the sum over the window of ( x - mean )( x - mean )'
+//   adding row x to n rows:  d = x - mean, mean += d / ( n + 1 ), C += n / ( n + 1 ) d d'
+//   expiring row o of n + 1: e = o - mean, mean -= e / n, C -= ( n + 1 ) / n e e'
+// with a full window, the two deltas are known before C is touched, so C is passed over once
+void TSSWCovarianceMatrix::Slide( const double* x ) {
+
+  const size_t n( m_nStreams );
+  double* mean( &m_vMean[ 0 ] );
+  double* dx( &m_vDeltaAdd[ 0 ] );
+  double* c( &m_vCoMoment[ 0 ] );
+
+  if ( m_nObservations < m_nWindow ) {
+    double* pSlot( &m_vWindow[ ( ( m_ixOldest + m_nObservations ) % m_nWindow ) * n ] );
+    ++m_nObservations;
+    const double dblAdd( static_cast<double>( m_nObservations - 1 ) / m_nObservations );
+    for ( size_t ix = 0; ix < n; ++ix ) {
+      pSlot[ ix ] = x[ ix ];
+      dx[ ix ] = x[ ix ] - mean[ ix ];
+      mean[ ix ] += dx[ ix ] / m_nObservations;
+    }
+    for ( size_t ix1 = 0; ix1 < n; ++ix1 ) {
+      const double a( dblAdd * dx[ ix1 ] );
+      for ( size_t ix2 = ix1; ix2 < n; ++ix2 ) {
+        *c++ += a * dx[ ix2 ];
+      }
+    }
+  }
+  else {
+    double* de( &m_vDeltaExpire[ 0 ] );
+    double* pSlot( &m_vWindow[ m_ixOldest * n ] );
+    const double N( static_cast<double>( m_nWindow ) );
+    const double dblAdd( N / ( N + 1.0 ) );
+    const double dblExpire( ( N + 1.0 ) / N );
+    for ( size_t ix = 0; ix < n; ++ix ) {
+      dx[ ix ] = x[ ix ] - mean[ ix ];
+      const double dblMean( mean[ ix ] + dx[ ix ] / ( N + 1.0 ) );  // with both rows
+      de[ ix ] = pSlot[ ix ] - dblMean;
+      mean[ ix ] = dblMean - de[ ix ] / N;
+      pSlot[ ix ] = x[ ix ];
+    }
+    m_ixOldest = ( m_ixOldest + 1 ) % m_nWindow;
+    for ( size_t ix1 = 0; ix1 < n; ++ix1 ) {
+      const double a( dblAdd * dx[ ix1 ] );
+      const double b( dblExpire * de[ ix1 ] );
+      for ( size_t ix2 = ix1; ix2 < n; ++ix2 ) {
+        *c++ += a * dx[ ix2 ] - b * de[ ix2 ];
+      }
+    }
+  }
+}
+
+void TSSWCovarianceMatrix::Recompute( void ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  RecomputeLocked();
+}
+
+void TSSWCovarianceMatrix::RecomputeLocked( void ) {
+  m_cntSinceRecompute = 0;
+  const size_t n( m_nStreams );
+  std::fill( m_vMean.begin(), m_vMean.end(), 0.0 );
+  std::fill( m_vCoMoment.begin(), m_vCoMoment.end(), 0.0 );
+  if ( 0 == m_nObservations ) return;
+  for ( size_t ixRow = 0; ixRow < m_nObservations; ++ixRow ) {
+    const double* pRow( &m_vWindow[ ( ( m_ixOldest + ixRow ) % m_nWindow ) * n ] );
+    for ( size_t ix = 0; ix < n; ++ix ) m_vMean[ ix ] += pRow[ ix ];
+  }
+  for ( size_t ix = 0; ix < n; ++ix ) m_vMean[ ix ] /= m_nObservations;
+  double* d( &m_vDeltaAdd[ 0 ] );
+  for ( size_t ixRow = 0; ixRow < m_nObservations; ++ixRow ) {
+    const double* pRow( &m_vWindow[ ( ( m_ixOldest + ixRow ) % m_nWindow ) * n ] );
+    for ( size_t ix = 0; ix < n; ++ix ) d[ ix ] = pRow[ ix ] - m_vMean[ ix ];
+    double* c( &m_vCoMoment[ 0 ] );
+    for ( size_t ix1 = 0; ix1 < n; ++ix1 ) {
+      const double a( d[ ix1 ] );
+      for ( size_t ix2 = ix1; ix2 < n; ++ix2 ) {
+        *c++ += a * d[ ix2 ];
+      }
+    }
+  }
+}
+
+void TSSWCovarianceMatrix::Take( Snapshot& snapshot ) const {
+  boost::mutex::scoped_lock lock( m_mutex );
+  snapshot.nStreams = m_nStreams;
+  snapshot.nObservations = m_nObservations;
+  snapshot.dtStep = m_dtStep;
+  snapshot.vMean.assign( m_vMean.begin(), m_vMean.end() );
+  snapshot.vCoMoment.assign( m_vCoMoment.begin(), m_vCoMoment.end() );
+}
+
+size_t TSSWCovarianceMatrix::Observations( void ) const {
+  boost::mutex::scoped_lock lock( m_mutex );
+  return m_nObservations;
+}
+
+} // namespace tf
+} // namespace ou
@@ -0,0 +1,156 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// rolling covariance and correlation of a basket of synchronised price streams, over the last nWindow steps
+//   a step is a price for each stream at a common time, as TSHomogenization emits at its markers
+//   the window holds log returns from step to step, or the prices themselves, per EInput
+//   a step adds the new row and expires the oldest as two rank one updates of the co-moments, fused
+//     into one pass over the matrix, so a step is O( streams^2 ), independent of the window length
+//   the co-moments are kept as a packed upper triangle, row after row, each row contiguous, so the
+//     update's inner loop is a straight multiply add over doubles, which the compiler vectorizes
+//   the updates are of deviations from the running mean, so rounding stays small, a Recompute
+//     every nRecompute steps rebuilds from the window to bound any drift over a long session
+//   with log returns, the first step is the base, and a step with a price not above 0 is dropped
+//   Append collects prices by time, a stream yet to arrive when a later time shows up is filled
+//     with its last price, a price for a time already stepped past is dropped
+//   Take copies the current state for a strategy or the risk engine, from any thread
+
+// usage:
+//   TSSWCovarianceMatrix cov( 3, 60 );  // three streams, an hour of minutes
+//   hf::TSHomogenization<Price> homogenizeGld( pricesGld, minutes( 1 ), hf::TSHomogenization<Price>::ePreviousTick );
+//   cov.Attach( 0, homogenizeGld );  // ... and streams 1 and 2
+//   ... on OnStep:
+//   TSSWCovarianceMatrix::Snapshot snapshot;
+//   cov.Take( snapshot );
+//   double dblCorrelation( snapshot.Correlation( 0, 1 ) );
+
+#include <vector>
+#include <algorithm>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <OUCommon/Delegate.h>
+
+#include <TFTimeSeries/DatedDatum.h>
+
+#include "TSHomogenization.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+class TSSWCovarianceMatrix {
+public:
+
+  enum EInput { ELogReturn, ELevel };
+
+  struct Snapshot {
+    size_t nStreams;
+    size_t nObservations;  // rows in the window
+    ptime dtStep;  // of the latest step
+    std::vector<double> vMean;
+    std::vector<double> vCoMoment;  // packed upper triangle, sums of products of deviations
+
+    Snapshot( void ): nStreams( 0 ), nObservations( 0 ), dtStep( not_a_date_time ) {};
+
+    static size_t Index( size_t nStreams, size_t ix1, size_t ix2 ) {  // into the packed triangle
+      if ( ix1 > ix2 ) std::swap( ix1, ix2 );
+      return ix1 * nStreams - ( ix1 * ( ix1 + 1 ) ) / 2 + ix2;
+    }
+    double Covariance( size_t ix1, size_t ix2 ) const {  // sample
+      return ( 2 > nObservations ) ? 0.0 : vCoMoment[ Index( nStreams, ix1, ix2 ) ] / ( nObservations - 1 );
+    }
+    double Correlation( size_t ix1, size_t ix2 ) const;  // 0 when either stream is flat over the window
+    double StdDev( size_t ix ) const;
+    void Correlations( std::vector<double>& v ) const;  // the whole matrix, packed as vCoMoment
+  };
+
+  TSSWCovarianceMatrix( size_t nStreams, size_t nWindow, EInput eInput = ELogReturn, size_t nRecompute = 0 );  // nRecompute of 0 never rebuilds
+  ~TSSWCovarianceMatrix( void );  // detaches
+
+  size_t Streams( void ) const { return m_nStreams; };
+  size_t Window( void ) const { return m_nWindow; };
+
+  // prices for the streams, in order, at one time
+  void Step( const ptime& dt, const double* pPrice );
+  // a stream's price, stepped once each stream has one for its time, or a later time arrives
+  void Append( size_t ixStream, const Price& price );
+  // follows OnAppend, the homogenizer is to outlive this, or be detached first
+  void Attach( size_t ixStream, hf::TSHomogenization<Price>& homogenizer );
+  void Detach( size_t ixStream );
+
+  void Take( Snapshot& snapshot ) const;
+  size_t Observations( void ) const;
+
+  void Recompute( void );  // the co-moments afresh from the window
+  void Reset( void );
+
+  ou::Delegate<const ptime&> OnStep;  // after a row is windowed, on the appending thread
+
+protected:
+private:
+
+  struct Follower {
+    TSSWCovarianceMatrix* pMatrix;
+    size_t ixStream;
+    hf::TSHomogenization<Price>* pHomogenizer;
+    void HandleAppend( const Price& price ) { pMatrix->Append( ixStream, price ); };
+  };
+  typedef boost::shared_ptr<Follower> pFollower_t;
+
+  mutable boost::mutex m_mutex;
+
+  size_t m_nStreams;
+  size_t m_nWindow;
+  EInput m_eInput;
+  size_t m_nRecompute;
+  size_t m_cntSinceRecompute;
+
+  // window
+  std::vector<double> m_vWindow;  // rows of nStreams, a ring of nWindow
+  size_t m_ixOldest;
+  size_t m_nObservations;
+  std::vector<double> m_vMean;
+  std::vector<double> m_vCoMoment;  // packed upper triangle
+  ptime m_dtStep;
+
+  // prior step, for returns
+  std::vector<double> m_vPrior;
+  bool m_bPrior;
+
+  // workspace
+  std::vector<double> m_vRow;
+  std::vector<double> m_vDeltaAdd;
+  std::vector<double> m_vDeltaExpire;
+
+  // collection for Append
+  ptime m_dtPending;
+  std::vector<double> m_vPending;
+  std::vector<char> m_vHave;  // in the pending step
+  size_t m_nHave;
+  std::vector<double> m_vLast;  // latest price of each stream, for filling
+  size_t m_nSeen;  // streams with a latest price
+  std::vector<char> m_vSeen;
+
+  std::vector<pFollower_t> m_vFollower;
+
+  bool StepLocked( const ptime& dt, const double* pPrice );  // with m_mutex held, true when a row was windowed
+  void Slide( const double* pRow );  // a row into the window, the oldest out when full
+  void RecomputeLocked( void );
+};
+
+} // namespace tf
+} // namespace ou
@@ -48,6 +48,7 @@ OBJECTFILES= \
 	${OBJECTDIR}/TSMA.o \
 	${OBJECTDIR}/TSNorm.o \
 	${OBJECTDIR}/TSReturns.o \
+	${OBJECTDIR}/TSSWCovarianceMatrix.o \
 	${OBJECTDIR}/TSSWEfficiencyRatio.o \
 	${OBJECTDIR}/TSSWRateOfChange.o \
 	${OBJECTDIR}/TSSWRealizedVolatility.o \
@@ -152,6 +153,11 @@ ${OBJECTDIR}/TSReturns.o: TSReturns.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TSReturns.o TSReturns.cpp
 
+${OBJECTDIR}/TSSWCovarianceMatrix.o: TSSWCovarianceMatrix.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TSSWCovarianceMatrix.o TSSWCovarianceMatrix.cpp
+
 ${OBJECTDIR}/TSSWEfficiencyRatio.o: TSSWEfficiencyRatio.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -0,0 +1,111 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#ifdef _WIN32
+#include "StdAfx.h"
+#else
+#include "linux/StdAfx.h"
+#endif
+
+#include <cstring>
+#include <algorithm>
+
+#include "DepthBook.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+DepthBook::DepthBook( size_t nLevels ): m_nCapacity( nLevels ) {
+  m_rSide[ SideAsk ].vLevels.resize( m_nCapacity );
+  m_rSide[ SideBid ].vLevels.resize( m_nCapacity );
+}
+
+DepthBook::~DepthBook( void ) {
+}
+
+MarketDepth::MMID_t DepthBook::PackMMID( const std::string& sMarketMaker ) {
+  MarketDepth::MMID_t mmid( 0 );
+  std::memcpy( &mmid, sMarketMaker.c_str(), std::min<size_t>( 4, sMarketMaker.size() ) );
+  return mmid;
+}
+
+bool DepthBook::Update( const ptime& dt, int position, int operation, int side, double price, int size, MarketDepth::MMID_t mmid ) {
+
+  if ( ( SideAsk != side ) && ( SideBid != side ) ) return false;
+  if ( ( 0 > position ) || ( m_nCapacity <= (size_t) position ) ) return false;
+
+  Side& book( m_rSide[ side ] );
+  std::vector<Level>& v( book.vLevels );
+  size_t ix( position );
+
+  if ( ( OpUpdate == operation ) && ( book.nLevels == ix ) ) {
+    operation = OpInsert;  // an update just past the bottom of the book adds a level
+  }
+
+  switch ( operation ) {
+    case OpInsert: {
+      if ( book.nLevels < ix ) return false;
+      if ( m_nCapacity == book.nLevels ) {
+        --book.nLevels;  // bottom level is pushed off
+        Emit( dt, side, v[ book.nLevels ], 0 );
+      }
+      std::copy_backward( v.begin() + ix, v.begin() + book.nLevels, v.begin() + book.nLevels + 1 );
+      v[ ix ] = Level( mmid, price, size );
+      ++book.nLevels;
+      Emit( dt, side, v[ ix ], size );
+      }
+      break;
+    case OpUpdate: {
+      if ( book.nLevels <= ix ) return false;
+      Level& level( v[ ix ] );
+      if ( ( level.dblPrice != price ) || ( level.mmid != mmid ) ) {
+        Emit( dt, side, level, 0 );
+        level = Level( mmid, price, size );
+        Emit( dt, side, level, size );
+      }
+      else {
+        if ( level.nSize != size ) {
+          level.nSize = size;
+          Emit( dt, side, level, size );
+        }
+      }
+      }
+      break;
+    case OpDelete: {
+      if ( book.nLevels <= ix ) return false;
+      Level level( v[ ix ] );
+      std::copy( v.begin() + ix + 1, v.begin() + book.nLevels, v.begin() + ix );
+      --book.nLevels;
+      Emit( dt, side, level, 0 );
+      }
+      break;
+    default:
+      return false;
+  }
+
+  return true;
+}
+
+void DepthBook::Clear( const ptime& dt ) {
+  for ( int side = SideAsk; side <= SideBid; ++side ) {
+    Side& book( m_rSide[ side ] );
+    for ( size_t ix = 0; ix < book.nLevels; ++ix ) {
+      Emit( dt, side, book.vLevels[ ix ], 0 );
+    }
+    book.nLevels = 0;
+  }
+}
+
+} // namespace tf
+} // namespace ou
@@ -0,0 +1,94 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// market depth book as maintained by the IB updateMktDepth and updateMktDepthL2 messages:
+//   each side is an array of levels addressed by the position supplied by IB:
+//     an insert shifts the levels at and below the position down one, a delete shifts them up one,
+//     an update replaces the level in place
+//   capacity is fixed at construction, normally the number of rows requested, so there is no allocation while running
+// each change is reported as price based deltas, in the form used by Symbol::m_OnDepth:
+//   a level which goes away (deleted, pushed off the bottom, or replaced by another price) is reported with size zero,
+//   a level which appears, or changes size, is reported with its new size
+//   for L2, the market maker is part of the key, so the same price from two market makers are distinct levels
+// the book is updated on the IB message thread, readers elsewhere need to take that into account
+
+#include <vector>
+#include <string>
+
+#include <OUCommon/FastDelegate.h>
+using namespace fastdelegate;
+
+#include <TFTimeSeries/DatedDatum.h>
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+class DepthBook {
+public:
+
+  enum EOperation { OpInsert = 0, OpUpdate = 1, OpDelete = 2 };  // as supplied by IB
+  enum ESide { SideAsk = 0, SideBid = 1 };  // as supplied by IB
+
+  struct Level {
+    MarketDepth::MMID_t mmid;  // zero when not L2
+    double dblPrice;
+    int nSize;
+    Level( void ): mmid( 0 ), dblPrice( 0.0 ), nSize( 0 ) {};
+    Level( MarketDepth::MMID_t mmid_, double dblPrice_, int nSize_ ): mmid( mmid_ ), dblPrice( dblPrice_ ), nSize( nSize_ ) {};
+  };
+
+  typedef FastDelegate1<const MarketDepth&> OnDepthHandler_t;
+
+  explicit DepthBook( size_t nLevels = 10 );
+  ~DepthBook( void );
+
+  void SetOnDepth( OnDepthHandler_t function ) { m_OnDepth = function; };
+
+  // false when the position or operation is not usable, the book is left unchanged
+  bool Update( const ptime& dt, int position, int operation, int side, double price, int size, MarketDepth::MMID_t mmid = 0 );
+
+  void Clear( const ptime& dt );  // removes all levels, each reported with size zero
+
+  size_t Capacity( void ) const { return m_nCapacity; };
+  size_t Levels( ESide side ) const { return m_rSide[ side ].nLevels; };
+  const Level& At( ESide side, size_t ix ) const { return m_rSide[ side ].vLevels[ ix ]; };  // ix < Levels( side )
+
+  static MarketDepth::MMID_t PackMMID( const std::string& sMarketMaker );  // first four characters, as in MarketDepth
+
+protected:
+private:
+
+  struct Side {
+    size_t nLevels;
+    std::vector<Level> vLevels;  // sized to capacity
+    Side( void ): nLevels( 0 ) {};
+  };
+
+  size_t m_nCapacity;
+  Side m_rSide[ 2 ];
+
+  OnDepthHandler_t m_OnDepth;
+
+  void Emit( const ptime& dt, int side, const Level& level, int size ) {
+    if ( 0 != m_OnDepth ) {
+      m_OnDepth( MarketDepth( dt, ( SideBid == side ) ? 'B' : 'S', size, level.dblPrice, level.mmid ) );
+    }
+  }
+
+};
+
+} // namespace tf
+} // namespace ou
@@ -40,6 +40,7 @@ IBSymbol::IBSymbol( inherited_t::symbol_id_t idSym, pInstrument_t pInstrument, T
     m_dblOptionPrice( 0 ), m_dblUnderlyingPrice( 0 ), m_dblPvDividend( 0 )
 {
   inherited_t::m_id = idSym;
+  m_depthBook.SetOnDepth( MakeDelegate( this, &IBSymbol::HandleDepth ) );
 }
 
 IBSymbol::IBSymbol( pInstrument_t pInstrument, TickerId idTicker )
@@ -56,6 +57,7 @@ IBSymbol::IBSymbol( pInstrument_t pInstrument, TickerId idTicker )
     m_bQuoteTradeWatchInProgress( false ), m_bDepthWatchInProgress( false ),
     m_dblOptionPrice( 0 ), m_dblUnderlyingPrice( 0 ), m_dblPvDividend( 0 )
 {
+  m_depthBook.SetOnDepth( MakeDelegate( this, &IBSymbol::HandleDepth ) );
 }
 
 IBSymbol::~IBSymbol(void) {
@@ -146,6 +148,16 @@ void IBSymbol::AcceptTickString(TickType tickType, const std::string& value) {
   }
 }
 
+void IBSymbol::AcceptDepth( int position, int operation, int side, double price, int size, MarketDepth::MMID_t mmid ) {
+  if ( !m_depthBook.Update( ou::TimeSource::Instance().External(), position, operation, side, price, size, mmid ) ) {
+    std::cout << "IBSymbol::AcceptDepth " << GetId() << " ignored: " << position << "," << operation << "," << side << std::endl;
+  }
+}
+
+void IBSymbol::ClearDepth( void ) {
+  m_depthBook.Clear( ou::TimeSource::Instance().External() );
+}
+
 void IBSymbol::BuildQuote() {
 //  if ( m_bAskFound && m_bBidFound && m_bAskSizeFound && m_bBidSizeFound ) {
     if ( m_bAskFound || m_bBidFound ) {
@@ -25,6 +25,8 @@
 
 #include "Shared/EWrapper.h"
 
+#include "DepthBook.h"
+
 namespace ou { // One Unified
 namespace tf { // TradeFrame
 
@@ -48,6 +50,8 @@ public:
 
   double OptionPrice( void ) { return m_dblOptionPrice; };
 
+  const DepthBook& Depth( void ) const { return m_depthBook; };  // current book, maintained while a depth watch is in progress
+
 protected:
 
   TickerId m_TickerId;
@@ -88,9 +92,13 @@ protected:
   bool GetDepthWatchInProgress( void ) { return m_bDepthWatchInProgress; };
   bool m_bDepthWatchInProgress;
 
+  DepthBook m_depthBook;
+
   void AcceptTickPrice( TickType tickType, double price );
   void AcceptTickSize( TickType tickType, int size );
   void AcceptTickString( TickType tickType, const std::string& value );
+  void AcceptDepth( int position, int operation, int side, double price, int size, MarketDepth::MMID_t mmid = 0 );
+  void ClearDepth( void );
 
   void BuildQuote( void );
   void BuildTrade( void );
@@ -99,6 +107,8 @@ private:
 
   long m_conId;  // matches IB contract id
 
+  void HandleDepth( const MarketDepth& md ) { m_OnDepth( md ); };
+
 };
 
 } // namespace tf
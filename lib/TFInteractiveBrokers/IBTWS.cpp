@@ -298,7 +298,13 @@ void IBTWS::StopQuoteTradeWatch( pSymbol_t pIBSymbol ) {
 void IBTWS::StartDepthWatch( pSymbol_t pIBSymbol) {  // overridden from base class
   if ( !pIBSymbol->GetDepthWatchInProgress() ) {
     // start watch
+    Contract contract;
+    contract.conId = pIBSymbol->GetInstrument()->GetContract();  // mostly enough to have contract id
+    contract.exchange = pIBSymbol->GetInstrument()->GetExchangeName();
+    contract.currency = pIBSymbol->GetInstrument()->GetCurrencyName();
     pIBSymbol->SetDepthWatchInProgress();
+    TagValueListSPtr pMktDepthOptions;
+    pTWS->reqMktDepth( pIBSymbol->GetTickerId(), contract, pIBSymbol->Depth().Capacity(), pMktDepthOptions );
   }
 }
 
@@ -307,7 +313,9 @@ void IBTWS::StopDepthWatch( pSymbol_t pIBSymbol) {  // overridden from base clas
   }
   else {
     // stop watch
+    pTWS->cancelMktDepth( pIBSymbol->GetTickerId() );
     pIBSymbol->ResetDepthWatchInProgress();
+    pIBSymbol->ClearDepth();
   }
 }
 
@@ -385,7 +393,7 @@ void IBTWS::tickPrice( TickerId tickerId, TickType tickType, double price, int c
   // we seem to get ticks even though we havn't requested them, so ensure we only accept 
   //   when a valid symbol has been defined
   if ( ( tickerId > 0 ) && ( tickerId <= m_curTickerId ) ) {
-    IBSymbol::pSymbol_t pSym( m_vTickerToSymbol[ tickerId ] );
+    IBSymbol* pSym( m_vTickerToSymbol[ tickerId ].get() );  // symbol is held by the provider, no reference count traffic per tick
     //std::cout << "tickPrice " << pSym->Name() << ", " << TickTypeStrings[tickType] << ", " << price << std::endl;
     pSym->AcceptTickPrice( tickType, price );
   }
@@ -395,7 +403,7 @@ void IBTWS::tickSize( TickerId tickerId, TickType tickType, int size) {
   // we seem to get ticks even though we havn't requested them, so ensure we only accept 
   //   when a valid symbol has been defined
   if ( ( tickerId > 0 ) && ( tickerId <= m_curTickerId ) ) {
-    IBSymbol::pSymbol_t pSym( m_vTickerToSymbol[ tickerId ] );
+    IBSymbol* pSym( m_vTickerToSymbol[ tickerId ].get() );
     //std::cout << "tickSize " << pSym->Name() << ", " << TickTypeStrings[tickType] << ", " << size << std::endl;
     pSym->AcceptTickSize( tickType, size );
   }
@@ -404,7 +412,7 @@ void IBTWS::tickSize( TickerId tickerId, TickType tickType, int size) {
 void IBTWS::tickOptionComputation( TickerId tickerId, TickType tickType, double impliedVol, double delta,
 	   double optPrice, double pvDividend, double gamma, double vega, double theta, double undPrice ) {
 
-  IBSymbol::pSymbol_t pSym( m_vTickerToSymbol[ tickerId ] );
+  IBSymbol* pSym( m_vTickerToSymbol[ tickerId ].get() );
   switch ( tickType ) {
     case MODEL_OPTION: 
       pSym->Greeks( optPrice, undPrice, pvDividend, impliedVol, delta, gamma, vega, theta );
@@ -428,7 +436,7 @@ void IBTWS::tickString(TickerId tickerId, TickType tickType, const std::string&
   // we seem to get ticks even though we havn't requested them, so ensure we only accept 
   //   when a valid symbol has been defined
   if ( ( tickerId > 0 ) && ( tickerId <= m_curTickerId ) ) {
-    IBSymbol::pSymbol_t pSym( m_vTickerToSymbol[ tickerId ] );
+    IBSymbol* pSym( m_vTickerToSymbol[ tickerId ].get() );
     //std::cout << "tickString " << pSym->Name() << ", " 
     //  << TickTypeStrings[tickType] << ", " << value;
     //std::cout << std::endl;
@@ -1223,10 +1231,18 @@ void IBTWS::connectionClosed() {
 
 void IBTWS::updateMktDepth(TickerId id, int position, int operation, int side,
                             double price, int size) {
+  if ( ( id > 0 ) && ( id <= m_curTickerId ) ) {
+    IBSymbol* pSym( m_vTickerToSymbol[ id ].get() );
+    pSym->AcceptDepth( position, operation, side, price, size );
+  }
 }
 
 void IBTWS::updateMktDepthL2(TickerId id, int position, std::string marketMaker, int operation,
                               int side, double price, int size) {
+  if ( ( id > 0 ) && ( id <= m_curTickerId ) ) {
+    IBSymbol* pSym( m_vTickerToSymbol[ id ].get() );
+    pSym->AcceptDepth( position, operation, side, price, size, DepthBook::PackMMID( marketMaker ) );
+  }
 }
 
 void IBTWS::managedAccounts( const std::string& accountsList) {
@@ -162,6 +162,8 @@ private:
 
 	static bool CheckOffset(const char* ptr, const char* endPtr);
 	static const char* FindFieldEnd(const char* ptr, const char* endPtr);
+	static bool ParseInteger(int&, const char* fieldBeg, const char* fieldEnd);
+	static bool ParseDecimal(double&, const char* fieldBeg, const char* fieldEnd);
 
 	// decoders
 	static bool DecodeField(bool&, const char*& ptr, const char* endPtr);
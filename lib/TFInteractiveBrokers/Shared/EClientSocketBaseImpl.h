@@ -368,6 +368,73 @@ const char* EClientSocketBase::FindFieldEnd(const char* ptr, const char* endPtr)
 	return (const char*)memchr(ptr, 0, endPtr - ptr);
 }
 
+// fields are converted in place in the receive buffer.
+// the plain forms sent for ids, sizes and prices ([-]digits[.digits]) are parsed directly,
+// anything else (exponents, long mantissas, etc) returns false, and is left to atoi/atof.
+
+static const double PowersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+
+bool EClientSocketBase::ParseInteger(int& intValue, const char* fieldBeg, const char* fieldEnd)
+{
+	const char* p = fieldBeg;
+	bool negative = false;
+	if( p < fieldEnd && '-' == *p) {
+		negative = true;
+		++p;
+	}
+	if( p == fieldEnd || fieldEnd - p > 9) // no overflow with up to nine digits
+		return false;
+	int value = 0;
+	for( ; p < fieldEnd; ++p) {
+		const unsigned digit = (unsigned)(*p - '0');
+		if( digit > 9)
+			return false;
+		value = value * 10 + (int)digit;
+	}
+	intValue = negative ? -value : value;
+	return true;
+}
+
+bool EClientSocketBase::ParseDecimal(double& doubleValue, const char* fieldBeg, const char* fieldEnd)
+{
+	// the digits are accumulated as an integer, which is exact up to fifteen digits,
+	// then divided once by an exact power of ten, giving the same correctly rounded result as atof
+	const char* p = fieldBeg;
+	bool negative = false;
+	if( p < fieldEnd && '-' == *p) {
+		negative = true;
+		++p;
+	}
+	unsigned long long mantissa = 0;
+	int digits = 0;
+	int fraction = -1; // digits after the point, -1 until a point is seen
+	for( ; p < fieldEnd; ++p) {
+		const unsigned digit = (unsigned)(*p - '0');
+		if( digit <= 9) {
+			if( ++digits > 15)
+				return false;
+			mantissa = mantissa * 10 + digit;
+			if( fraction >= 0)
+				++fraction;
+		}
+		else if( '.' == *p && fraction < 0) {
+			fraction = 0;
+		}
+		else {
+			return false;
+		}
+	}
+	if( !digits)
+		return false;
+	doubleValue = (double)mantissa;
+	if( fraction > 0)
+		doubleValue /= PowersOfTen[fraction];
+	if( negative)
+		doubleValue = -doubleValue;
+	return true;
+}
+
 bool EClientSocketBase::DecodeField(bool& boolValue, const char*& ptr, const char* endPtr)
 {
 	int intValue;
@@ -385,7 +452,8 @@ bool EClientSocketBase::DecodeField(int& intValue, const char*& ptr, const char*
 	const char* fieldEnd = FindFieldEnd(fieldBeg, endPtr);
 	if( !fieldEnd)
 		return false;
-	intValue = atoi(fieldBeg);
+	if( !ParseInteger(intValue, fieldBeg, fieldEnd))
+		intValue = atoi(fieldBeg);
 	ptr = ++fieldEnd;
 	return true;
 }
@@ -407,7 +475,8 @@ bool EClientSocketBase::DecodeField(double& doubleValue, const char*& ptr, const
 	const char* fieldEnd = FindFieldEnd(fieldBeg, endPtr);
 	if( !fieldEnd)
 		return false;
-	doubleValue = atof(fieldBeg);
+	if( !ParseDecimal(doubleValue, fieldBeg, fieldEnd))
+		doubleValue = atof(fieldBeg);
 	ptr = ++fieldEnd;
 	return true;
 }
@@ -421,18 +490,21 @@ bool EClientSocketBase::DecodeField(std::string& stringValue,
 	const char* fieldEnd = FindFieldEnd(ptr, endPtr);
 	if( !fieldEnd)
 		return false;
-	stringValue = fieldBeg; // better way?
+	stringValue.assign(fieldBeg, fieldEnd); // length already known from the terminator search
 	ptr = ++fieldEnd;
 	return true;
 }
 
 bool EClientSocketBase::DecodeFieldMax(int& intValue, const char*& ptr, const char* endPtr)
 {
-	std::string stringValue;
-	if( !DecodeField(stringValue, ptr, endPtr))
+	if( !CheckOffset(ptr, endPtr))
 		return false;
-	intValue = stringValue.empty() ? UNSET_INTEGER : atoi(stringValue.c_str());
-	return true;
+	if( !*ptr) { // empty field
+		intValue = UNSET_INTEGER;
+		++ptr;
+		return true;
+	}
+	return DecodeField(intValue, ptr, endPtr);
 }
 
 bool EClientSocketBase::DecodeFieldMax(long& longValue, const char*& ptr, const char* endPtr)
@@ -446,11 +518,14 @@ bool EClientSocketBase::DecodeFieldMax(long& longValue, const char*& ptr, const
 
 bool EClientSocketBase::DecodeFieldMax(double& doubleValue, const char*& ptr, const char* endPtr)
 {
-	std::string stringValue;
-	if( !DecodeField(stringValue, ptr, endPtr))
+	if( !CheckOffset(ptr, endPtr))
 		return false;
-	doubleValue = stringValue.empty() ? UNSET_DOUBLE : atof(stringValue.c_str());
-	return true;
+	if( !*ptr) { // empty field
+		doubleValue = UNSET_DOUBLE;
+		++ptr;
+		return true;
+	}
+	return DecodeField(doubleValue, ptr, endPtr);
 }
 
 ///////////////////////////////////////////////////////////
@@ -2570,7 +2645,7 @@ int EClientSocketBase::bufferedSend(const std::string& msg)
 
 int EClientSocketBase::bufferedRead()
 {
-	char buf[8192];
+	char buf[65536]; // drain more per call under heavy market data, such as option chains
 	int nResult = receive( buf, sizeof(buf));
 
 	if( nResult > 0) {
@@ -4487,8 +4562,8 @@ int EClientSocketBase::processOnePrefixedMsg(const char*& beginPtr, const char*
 	const char* msgStart = beginPtr + HEADER_LEN;
 	const char* msgEnd = msgStart + msgLen;
 
-	// handle incomplete messages
-	if( msgStart > endPtr) {
+	// handle incomplete messages:  the decoder must not run past what has been received
+	if( msgEnd > endPtr) {
 		return 0;
 	}
 
@@ -35,6 +35,7 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
+	${OBJECTDIR}/DepthBook.o \
 	${OBJECTDIR}/EventIBInstrument.o \
 	${OBJECTDIR}/IBSymbol.o \
 	${OBJECTDIR}/IBTWS.o \
@@ -69,6 +70,11 @@ ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libtfinteractivebrokers.a: ${OBJECTFI
 	${AR} -rv ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libtfinteractivebrokers.a ${OBJECTFILES} 
 	$(RANLIB) ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libtfinteractivebrokers.a
 
+${OBJECTDIR}/DepthBook.o: DepthBook.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DepthBook.o DepthBook.cpp
+
 ${OBJECTDIR}/EventIBInstrument.o: EventIBInstrument.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
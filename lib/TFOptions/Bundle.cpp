@@ -47,6 +47,7 @@ void ExpiryBundle::SaveAtmIv( const std::string& sPrefix60sec, const std::string
 
   std::string sPathName;
 
+  ou::tf::HDF5DataManager::mutex_t::scoped_lock lock( ou::tf::HDF5DataManager::Mutex() );
   ou::tf::HDF5DataManager dm( ou::tf::HDF5DataManager::RDWR );
 
   if ( 0 != m_tsAtmIv.Size() ) {
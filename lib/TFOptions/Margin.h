@@ -29,7 +29,7 @@ namespace margin { // options
 // need validation function for each style
 // margin requirements not correct, need option contract multiplier
 
-typedef ou::tf::Instrument::pInstrument_cref pInstrument_cref;
+typedef ou::tf::Instrument::pInstrument_t pInstrument_t;
 
 struct MarginRequirement { 
   double margin; 
@@ -45,9 +45,10 @@ struct Cash: CashOrRegTIra {};
 struct RegTIra: CashOrRegTIra {};
 
 struct Source {
-  pInstrument_cref pInstrument;
+  pInstrument_t pInstrument;  // held, the structures are filled and passed on
   unsigned int quantity;
   double price;
+  Source( void ): quantity( 0 ), price( 0 ) {};
 };
 
 struct Underlying: Source {};
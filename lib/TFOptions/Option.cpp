@@ -196,6 +196,7 @@ void Option::SaveSeries( const std::string& sPrefix ) {
 
   Watch::SaveSeries( sPrefix );
 
+  ou::tf::HDF5DataManager::mutex_t::scoped_lock lock( ou::tf::HDF5DataManager::Mutex() );
   ou::tf::HDF5DataManager dm( ou::tf::HDF5DataManager::RDWR );
 
   // add in option attributes to the already written quotes and trades.
@@ -0,0 +1,589 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+//#include "stdafx.h"
+
+#include <stdexcept>
+#include <cstdlib>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Formula.h"
+#include "Margin.h"
+#include "RiskEngine.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+namespace option { // options
+
+namespace {
+
+  double Mid( const ou::tf::Quote& quote ) {
+    if ( ( 0.0 < quote.Bid() ) && ( 0.0 < quote.Ask() ) ) return 0.5 * ( quote.Bid() + quote.Ask() );
+    return 0.0;
+  }
+
+  // the slots of each combo, in the order given to AddCombo, and the sign of the quantity the slot needs
+  struct ComboShape {
+    size_t nLegs;
+    int rKind[ 4 ];  // 0 underlying, 1 call, 2 put
+    int rSign[ 4 ];
+  };
+
+  const ComboShape rComboShape[] = {
+    { 2, { 1, 1, 0, 0 }, {  1, -1, 0, 0 } },  // call spread
+    { 2, { 2, 2, 0, 0 }, {  1, -1, 0, 0 } },  // put spread
+    { 2, { 0, 1, 0, 0 }, {  1, -1, 0, 0 } },  // covered call
+    { 2, { 0, 2, 0, 0 }, {  1,  1, 0, 0 } },  // protective put
+    { 2, { 1, 2, 0, 0 }, { -1, -1, 0, 0 } },  // short strangle
+    { 4, { 2, 2, 1, 1 }, { -1,  1, -1, 1 } }  // iron condor
+  };
+
+  // the margin structures differ only in type, so are filled from a Source
+  template<typename S>
+  S As( const margin::Source& source ) {
+    S s;
+    s.pInstrument = source.pInstrument;
+    s.quantity = source.quantity;
+    s.price = source.price;
+    return s;
+  }
+
+} // namespace anonymous
+
+// a thread's share of the legs in Evaluate, with its own grids, merged once all are done
+struct RiskEngine::Chunk {
+
+  struct Priced {
+    size_t ixPortfolio;
+    size_t ixUnderlying;
+    EKind kind;
+    double dblQuantity;  // quantity * multiplier
+    double dblStrike;
+    double dblExpiry;  // years to expiry
+    double dblImpliedVolatility;
+  };
+  typedef std::vector<Priced> vPriced_t;
+
+  const vPriced_t* pvPriced;
+  size_t ixBegin;
+  size_t ixEnd;
+  const std::vector<double>* pvSpot;
+  const Scenario* pScenario;
+  size_t nCells;
+  std::vector<double> vPortfolio;  // [ portfolio ][ cell ]
+  std::vector<double> vUnderlying;  // [ underlying ][ cell ]
+
+  static double Value( const Priced& priced, double dblRate, double S, double dblVolatility ) {
+    switch ( priced.kind ) {
+    case ECall:
+      if ( ( 0.0 >= priced.dblExpiry ) || ( 0.0 >= dblVolatility ) ) return std::max<double>( S - priced.dblStrike, 0.0 );
+      else {
+        BSM_Euro bsm( dblRate, dblVolatility, priced.dblExpiry );
+        return bsm.Call( S, priced.dblStrike );
+      }
+    case EPut:
+      if ( ( 0.0 >= priced.dblExpiry ) || ( 0.0 >= dblVolatility ) ) return std::max<double>( priced.dblStrike - S, 0.0 );
+      else {
+        BSM_Euro bsm( dblRate, dblVolatility, priced.dblExpiry );
+        return bsm.Put( S, priced.dblStrike );
+      }
+    default:
+      return S;
+    }
+  }
+
+  void Run( void ) {
+    const Scenario& scenario( *pScenario );
+    const size_t nVolatility( scenario.vVolatility.size() );
+    for ( size_t ix = ixBegin; ix < ixEnd; ++ix ) {
+      const Priced& priced( (*pvPriced)[ ix ] );
+      const double S( (*pvSpot)[ priced.ixUnderlying ] );
+      const double dblBase( Value( priced, scenario.dblRate, S, priced.dblImpliedVolatility ) );
+      double* pPortfolio( &vPortfolio[ priced.ixPortfolio * nCells ] );
+      double* pUnderlying( &vUnderlying[ priced.ixUnderlying * nCells ] );
+      size_t ixCell( 0 );
+      for ( size_t ixSpot = 0; ixSpot < scenario.vSpot.size(); ++ixSpot ) {
+        const double dblSpot( std::max<double>( S * ( 1.0 + scenario.vSpot[ ixSpot ] ), 0.01 ) );
+        for ( size_t ixVolatility = 0; ixVolatility < nVolatility; ++ixVolatility, ++ixCell ) {
+          double dblVolatility( priced.dblImpliedVolatility );
+          if ( 0.0 < dblVolatility ) {
+            dblVolatility = std::max<double>( dblVolatility + scenario.vVolatility[ ixVolatility ], 0.01 );
+          }
+          const double dblPL( priced.dblQuantity * ( Value( priced, scenario.dblRate, dblSpot, dblVolatility ) - dblBase ) );
+          pPortfolio[ ixCell ] += dblPL;
+          pUnderlying[ ixCell ] += dblPL;
+        }
+      }
+    }
+  }
+};
+
+void RiskEngine::Follower::HandleOptionQuote( const ou::tf::Quote& quote ) {
+  double dblMid( Mid( quote ) );
+  if ( 0.0 < dblMid ) pEngine->UpdatePrice( id, dblMid );
+}
+
+void RiskEngine::Follower::HandleUnderlyingQuote( const ou::tf::Quote& quote ) {
+  double dblMid( Mid( quote ) );
+  if ( 0.0 < dblMid ) pEngine->UpdateSpot( id, dblMid );
+}
+
+RiskEngine::RiskEngine( void ) {
+}
+
+RiskEngine::~RiskEngine( void ) {
+  for ( std::vector<pFollower_t>::iterator iter = m_vFollower.begin(); m_vFollower.end() != iter; ++iter ) {
+    Follower* pFollower( iter->get() );
+    if ( 0 != pFollower->pOption.get() ) {
+      pFollower->pOption->OnGreek.Remove( MakeDelegate( pFollower, &Follower::HandleGreek ) );
+      pFollower->pOption->OnQuote.Remove( MakeDelegate( pFollower, &Follower::HandleOptionQuote ) );
+    }
+    else {
+      pFollower->pWatch->OnQuote.Remove( MakeDelegate( pFollower, &Follower::HandleUnderlyingQuote ) );
+    }
+  }
+}
+
+size_t RiskEngine::IndexPortfolio( const std::string& sPortfolio ) {
+  mapIndex_t::iterator iter = m_mapPortfolio.find( sPortfolio );
+  if ( m_mapPortfolio.end() == iter ) {
+    iter = m_mapPortfolio.insert( mapIndex_t::value_type( sPortfolio, m_vPortfolio.size() ) ).first;
+    m_vPortfolio.push_back( Aggregate( sPortfolio ) );
+  }
+  return iter->second;
+}
+
+size_t RiskEngine::IndexUnderlying( const std::string& sUnderlying ) {
+  mapIndex_t::iterator iter = m_mapUnderlying.find( sUnderlying );
+  if ( m_mapUnderlying.end() == iter ) {
+    iter = m_mapUnderlying.insert( mapIndex_t::value_type( sUnderlying, m_vUnderlying.size() ) ).first;
+    m_vUnderlying.push_back( UnderlyingState( sUnderlying ) );
+  }
+  return iter->second;
+}
+
+void RiskEngine::Apply( Leg& leg ) {
+  const double dblScale( leg.nQuantity * leg.dblMultiplier );
+  Greeks contribution;
+  contribution.dblDelta = leg.greeks.dblDelta * dblScale;
+  contribution.dblGamma = leg.greeks.dblGamma * dblScale;
+  contribution.dblVega = leg.greeks.dblVega * dblScale;
+  contribution.dblTheta = leg.greeks.dblTheta * dblScale;
+  Greeks change( contribution );
+  change -= leg.contribution;
+  m_vPortfolio[ leg.ixPortfolio ].greeks += change;
+  m_vUnderlying[ leg.ixUnderlying ].greeks += change;
+  m_total += change;
+  leg.contribution = contribution;
+}
+
+RiskEngine::idLeg_t RiskEngine::AddLeg( const std::string& sPortfolio, const std::string& sUnderlying, pInstrument_t pInstrument, int nQuantity ) {
+  Leg leg;
+  if ( pInstrument->IsOption() || pInstrument->IsFuturesOption() ) {
+    switch ( pInstrument->GetOptionSide() ) {
+    case ou::tf::OptionSide::Call:
+      leg.kind = ECall;
+      break;
+    case ou::tf::OptionSide::Put:
+      leg.kind = EPut;
+      break;
+    default:
+      throw std::runtime_error( "RiskEngine::AddLeg: option has no side" );
+    }
+    leg.dblStrike = pInstrument->GetStrike();
+    leg.dtExpiry = pInstrument->GetExpiryUtc();
+  }
+  else {
+    if ( !( pInstrument->IsStock() || pInstrument->IsFuture() ) ) {
+      throw std::runtime_error( "RiskEngine::AddLeg: not an option nor an underlying" );
+    }
+    leg.kind = EUnderlying;
+    leg.dblStrike = 0.0;
+    leg.greeks.dblDelta = 1.0;
+  }
+  leg.pInstrument = pInstrument;
+  leg.nQuantity = nQuantity;
+  leg.dblMultiplier = ( 0 == pInstrument->GetMultiplier() ) ? 1.0 : pInstrument->GetMultiplier();
+  leg.dblImpliedVolatility = 0.0;
+  leg.dblPrice = 0.0;
+
+  boost::mutex::scoped_lock lock( m_mutex );
+  leg.ixPortfolio = IndexPortfolio( sPortfolio );
+  leg.ixUnderlying = IndexUnderlying( sUnderlying );
+  m_vLeg.push_back( leg );
+  Apply( m_vLeg.back() );
+  return m_vLeg.size() - 1;
+}
+
+RiskEngine::idLeg_t RiskEngine::AddOption( const std::string& sPortfolio, const std::string& sUnderlying, pOption_t pOption, int nQuantity ) {
+  idLeg_t id( AddLeg( sPortfolio, sUnderlying, pOption->GetInstrument(), nQuantity ) );
+  pFollower_t pFollower( new Follower );
+  pFollower->pEngine = this;
+  pFollower->id = id;
+  pFollower->pOption = pOption;
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    m_vFollower.push_back( pFollower );
+  }
+  pOption->OnGreek.Add( MakeDelegate( pFollower.get(), &Follower::HandleGreek ) );
+  pOption->OnQuote.Add( MakeDelegate( pFollower.get(), &Follower::HandleOptionQuote ) );
+  return id;
+}
+
+void RiskEngine::AddUnderlying( const std::string& sUnderlying, pWatch_t pWatch ) {
+  pFollower_t pFollower( new Follower );
+  pFollower->pEngine = this;
+  pFollower->pWatch = pWatch;
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    pFollower->id = IndexUnderlying( sUnderlying );
+    m_vFollower.push_back( pFollower );
+  }
+  pWatch->OnQuote.Add( MakeDelegate( pFollower.get(), &Follower::HandleUnderlyingQuote ) );
+}
+
+void RiskEngine::SetQuantity( idLeg_t id, int nQuantity ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  if ( m_vLeg.size() <= id ) throw std::runtime_error( "RiskEngine::SetQuantity: no such leg" );
+  Leg& leg( m_vLeg[ id ] );
+  leg.nQuantity = nQuantity;
+  Apply( leg );
+}
+
+void RiskEngine::UpdateGreek( idLeg_t id, const ou::tf::Greek& greek ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  if ( m_vLeg.size() <= id ) throw std::runtime_error( "RiskEngine::UpdateGreek: no such leg" );
+  Leg& leg( m_vLeg[ id ] );
+  if ( EUnderlying == leg.kind ) return;
+  leg.dblImpliedVolatility = greek.ImpliedVolatility();
+  leg.greeks.dblDelta = greek.Delta();
+  leg.greeks.dblGamma = greek.Gamma();
+  leg.greeks.dblVega = greek.Vega();
+  leg.greeks.dblTheta = greek.Theta();
+  Apply( leg );
+}
+
+void RiskEngine::UpdatePrice( idLeg_t id, double dblPrice ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  if ( m_vLeg.size() <= id ) throw std::runtime_error( "RiskEngine::UpdatePrice: no such leg" );
+  m_vLeg[ id ].dblPrice = dblPrice;
+}
+
+void RiskEngine::UpdateUnderlying( const std::string& sUnderlying, double dblSpot ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  m_vUnderlying[ IndexUnderlying( sUnderlying ) ].dblSpot = dblSpot;
+}
+
+void RiskEngine::UpdateSpot( size_t ixUnderlying, double dblSpot ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  m_vUnderlying[ ixUnderlying ].dblSpot = dblSpot;
+}
+
+RiskEngine::Greeks RiskEngine::Underlying( const std::string& sUnderlying ) const {
+  boost::mutex::scoped_lock lock( m_mutex );
+  mapIndex_t::const_iterator iter = m_mapUnderlying.find( sUnderlying );
+  return ( m_mapUnderlying.end() == iter ) ? Greeks() : m_vUnderlying[ iter->second ].greeks;
+}
+
+RiskEngine::Greeks RiskEngine::Portfolio( const std::string& sPortfolio ) const {
+  boost::mutex::scoped_lock lock( m_mutex );
+  mapIndex_t::const_iterator iter = m_mapPortfolio.find( sPortfolio );
+  return ( m_mapPortfolio.end() == iter ) ? Greeks() : m_vPortfolio[ iter->second ].greeks;
+}
+
+RiskEngine::Greeks RiskEngine::Total( void ) const {
+  boost::mutex::scoped_lock lock( m_mutex );
+  return m_total;
+}
+
+size_t RiskEngine::Legs( void ) const {
+  boost::mutex::scoped_lock lock( m_mutex );
+  return m_vLeg.size();
+}
+
+void RiskEngine::Evaluate( const Scenario& scenario, mapGrid_t& mapByPortfolio, mapGrid_t& mapByUnderlying, unsigned int nThreads ) {
+
+  mapByPortfolio.clear();
+  mapByUnderlying.clear();
+
+  const size_t nCells( scenario.vSpot.size() * scenario.vVolatility.size() );
+
+  // a copy of what is needed, so the feeds are held up only for the copy, not the repricing
+  //   legs without a quantity, or whose underlying is yet to have a price, are left out
+  Chunk::vPriced_t vPriced;
+  std::vector<double> vSpot;
+  std::vector<std::string> vPortfolioName;
+  std::vector<std::string> vUnderlyingName;
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    vPriced.reserve( m_vLeg.size() );
+    for ( std::vector<Leg>::const_iterator iter = m_vLeg.begin(); m_vLeg.end() != iter; ++iter ) {
+      if ( ( 0 == iter->nQuantity ) || ( 0.0 >= m_vUnderlying[ iter->ixUnderlying ].dblSpot ) ) continue;
+      Chunk::Priced priced;
+      priced.ixPortfolio = iter->ixPortfolio;
+      priced.ixUnderlying = iter->ixUnderlying;
+      priced.kind = iter->kind;
+      priced.dblQuantity = iter->nQuantity * iter->dblMultiplier;
+      priced.dblStrike = iter->dblStrike;
+      priced.dblExpiry = ( EUnderlying == iter->kind ) ? 0.0
+        : ( iter->dtExpiry - scenario.dtNow ).total_seconds() / ( 365.0 * 24.0 * 60.0 * 60.0 );
+      priced.dblImpliedVolatility = iter->dblImpliedVolatility;
+      vPriced.push_back( priced );
+    }
+    for ( std::vector<Aggregate>::const_iterator iter = m_vPortfolio.begin(); m_vPortfolio.end() != iter; ++iter ) {
+      vPortfolioName.push_back( iter->sName );
+    }
+    for ( std::vector<UnderlyingState>::const_iterator iter = m_vUnderlying.begin(); m_vUnderlying.end() != iter; ++iter ) {
+      vUnderlyingName.push_back( iter->sName );
+      vSpot.push_back( iter->dblSpot );
+    }
+  }
+
+  if ( 0 == nThreads ) {
+    nThreads = boost::thread::hardware_concurrency();
+    if ( 0 == nThreads ) nThreads = 1;  // not determinable
+  }
+  const size_t nMinimumPerThread( 16 );  // fewer, and the thread costs more than the legs
+  if ( vPriced.size() < nThreads * nMinimumPerThread ) {
+    nThreads = static_cast<unsigned int>( std::max<size_t>( vPriced.size() / nMinimumPerThread, 1 ) );
+  }
+
+  std::vector<Chunk> vChunk( nThreads );
+  for ( size_t ix = 0; ix < nThreads; ++ix ) {
+    Chunk& chunk( vChunk[ ix ] );
+    chunk.pvPriced = &vPriced;
+    chunk.ixBegin = ( vPriced.size() * ix ) / nThreads;
+    chunk.ixEnd = ( vPriced.size() * ( ix + 1 ) ) / nThreads;
+    chunk.pvSpot = &vSpot;
+    chunk.pScenario = &scenario;
+    chunk.nCells = nCells;
+    chunk.vPortfolio.assign( vPortfolioName.size() * nCells, 0.0 );
+    chunk.vUnderlying.assign( vUnderlyingName.size() * nCells, 0.0 );
+  }
+
+  if ( 1 == nThreads ) {
+    vChunk[ 0 ].Run();
+  }
+  else {
+    boost::thread_group threads;
+    for ( std::vector<Chunk>::iterator iter = vChunk.begin(); vChunk.end() != iter; ++iter ) {
+      threads.create_thread( boost::bind( &Chunk::Run, &( *iter ) ) );
+    }
+    threads.join_all();
+  }
+
+  Grid grid;
+  grid.nSpot = scenario.vSpot.size();
+  grid.nVolatility = scenario.vVolatility.size();
+  grid.vPL.assign( nCells, 0.0 );
+  for ( size_t ix = 0; ix < vPortfolioName.size(); ++ix ) {
+    Grid& result( mapByPortfolio.insert( mapGrid_t::value_type( vPortfolioName[ ix ], grid ) ).first->second );
+    for ( std::vector<Chunk>::const_iterator iter = vChunk.begin(); vChunk.end() != iter; ++iter ) {
+      for ( size_t ixCell = 0; ixCell < nCells; ++ixCell ) {
+        result.vPL[ ixCell ] += iter->vPortfolio[ ix * nCells + ixCell ];
+      }
+    }
+  }
+  for ( size_t ix = 0; ix < vUnderlyingName.size(); ++ix ) {
+    Grid& result( mapByUnderlying.insert( mapGrid_t::value_type( vUnderlyingName[ ix ], grid ) ).first->second );
+    for ( std::vector<Chunk>::const_iterator iter = vChunk.begin(); vChunk.end() != iter; ++iter ) {
+      for ( size_t ixCell = 0; ixCell < nCells; ++ixCell ) {
+        result.vPL[ ixCell ] += iter->vUnderlying[ ix * nCells + ixCell ];
+      }
+    }
+  }
+}
+
+void RiskEngine::AddCombo( ECombo combo, idLeg_t id1, idLeg_t id2 ) {
+  std::vector<idLeg_t> vLeg;
+  vLeg.push_back( id1 );
+  vLeg.push_back( id2 );
+  AddCombo( combo, vLeg );
+}
+
+void RiskEngine::AddCombo( ECombo combo, idLeg_t id1, idLeg_t id2, idLeg_t id3, idLeg_t id4 ) {
+  std::vector<idLeg_t> vLeg;
+  vLeg.push_back( id1 );
+  vLeg.push_back( id2 );
+  vLeg.push_back( id3 );
+  vLeg.push_back( id4 );
+  AddCombo( combo, vLeg );
+}
+
+void RiskEngine::AddCombo( ECombo combo, const std::vector<idLeg_t>& vLeg ) {
+  if ( EComboCount <= combo ) throw std::runtime_error( "RiskEngine::AddCombo: unknown combo" );
+  const ComboShape& shape( rComboShape[ combo ] );
+  if ( shape.nLegs != vLeg.size() ) throw std::runtime_error( "RiskEngine::AddCombo: wrong number of legs" );
+  boost::mutex::scoped_lock lock( m_mutex );
+  for ( size_t ix = 0; ix < vLeg.size(); ++ix ) {
+    if ( m_vLeg.size() <= vLeg[ ix ] ) throw std::runtime_error( "RiskEngine::AddCombo: no such leg" );
+    const Leg& leg( m_vLeg[ vLeg[ ix ] ] );
+    if ( shape.rKind[ ix ] != leg.kind ) throw std::runtime_error( "RiskEngine::AddCombo: leg is the wrong kind" );
+    if ( leg.ixUnderlying != m_vLeg[ vLeg[ 0 ] ].ixUnderlying ) throw std::runtime_error( "RiskEngine::AddCombo: legs on different underlyings" );
+  }
+  Combo entry;
+  entry.combo = combo;
+  entry.vLeg = vLeg;
+  m_vCombo.push_back( entry );
+}
+
+void RiskEngine::ClearCombos( void ) {
+  boost::mutex::scoped_lock lock( m_mutex );
+  m_vCombo.clear();
+}
+
+double RiskEngine::Margin( const std::string& sPortfolio ) const {
+
+  boost::mutex::scoped_lock lock( m_mutex );
+
+  size_t ixPortfolio( m_vPortfolio.size() );  // all
+  if ( !sPortfolio.empty() ) {
+    mapIndex_t::const_iterator iter = m_mapPortfolio.find( sPortfolio );
+    if ( m_mapPortfolio.end() == iter ) return 0.0;
+    ixPortfolio = iter->second;
+  }
+
+  // combos take what they can of their legs, in the order they were added, the remainder is naked
+  std::vector<int> vRemaining( m_vLeg.size() );
+  for ( size_t ix = 0; ix < m_vLeg.size(); ++ix ) {
+    vRemaining[ ix ] = std::abs( m_vLeg[ ix ].nQuantity );
+  }
+
+  double dblMargin( 0.0 );
+
+  for ( std::vector<Combo>::const_iterator iter = m_vCombo.begin(); m_vCombo.end() != iter; ++iter ) {
+    const ComboShape& shape( rComboShape[ iter->combo ] );
+    const double dblSpot( m_vUnderlying[ m_vLeg[ iter->vLeg[ 0 ] ].ixUnderlying ].dblSpot );
+
+    // contracts are paired one for one, an underlying leg covers one contract for each multiplier's worth
+    double dblOptionMultiplier( 1.0 );
+    for ( size_t ix = 0; ix < shape.nLegs; ++ix ) {
+      const Leg& leg( m_vLeg[ iter->vLeg[ ix ] ] );
+      if ( EUnderlying != leg.kind ) dblOptionMultiplier = leg.dblMultiplier;
+    }
+    bool bFits( true );
+    int nUnits( 0 );
+    for ( size_t ix = 0; bFits && ( ix < shape.nLegs ); ++ix ) {
+      const Leg& leg( m_vLeg[ iter->vLeg[ ix ] ] );
+      if ( 0 > ( shape.rSign[ ix ] * leg.nQuantity ) ) bFits = false;  // the position has flipped since the combo was added
+      int nContracts( vRemaining[ iter->vLeg[ ix ] ] );
+      if ( EUnderlying == leg.kind ) {
+        nContracts = static_cast<int>( ( nContracts * leg.dblMultiplier ) / dblOptionMultiplier );
+      }
+      if ( ( 0 == ix ) || ( nContracts < nUnits ) ) nUnits = nContracts;
+    }
+    if ( !bFits || ( 0 == nUnits ) ) continue;
+
+    // quantities in shares, so the results are in currency
+    std::vector<margin::Source> vSource( shape.nLegs );
+    for ( size_t ix = 0; ix < shape.nLegs; ++ix ) {
+      const Leg& leg( m_vLeg[ iter->vLeg[ ix ] ] );
+      margin::Source& source( vSource[ ix ] );
+      source.pInstrument = leg.pInstrument;
+      source.quantity = static_cast<unsigned int>( nUnits * dblOptionMultiplier );
+      source.price = ( EUnderlying == leg.kind ) ? dblSpot : leg.dblPrice;
+      vRemaining[ iter->vLeg[ ix ] ] -= ( EUnderlying == leg.kind )
+        ? static_cast<int>( ( nUnits * dblOptionMultiplier ) / leg.dblMultiplier )
+        : nUnits;
+    }
+
+    if ( ( m_vPortfolio.size() != ixPortfolio ) && ( ixPortfolio != m_vLeg[ iter->vLeg[ 0 ] ].ixPortfolio ) ) continue;
+
+    switch ( iter->combo ) {
+    case ECallSpread: {
+        margin::RegT mr;
+        margin::Calc( mr, As<margin::LongCall>( vSource[ 0 ] ), As<margin::ShortCall>( vSource[ 1 ] ) );
+        dblMargin += mr.margin;
+      }
+      break;
+    case EPutSpread: {
+        margin::RegT mr;
+        margin::Calc( mr, As<margin::LongPut>( vSource[ 0 ] ), As<margin::ShortPut>( vSource[ 1 ] ) );
+        dblMargin += mr.margin;
+      }
+      break;
+    case ECoveredCall: {
+        margin::RegT mr;
+        margin::Calc( mr, As<margin::LongUnderlying>( vSource[ 0 ] ), As<margin::ShortCall>( vSource[ 1 ] ) );
+        dblMargin += mr.margin;
+      }
+      break;
+    case EProtectivePut: {
+        margin::RegTInitial mr;
+        margin::Calc( mr, As<margin::LongUnderlying>( vSource[ 0 ] ), As<margin::LongPut>( vSource[ 1 ] ) );
+        dblMargin += mr.margin;
+      }
+      break;
+    case EShortStrangle: {
+        margin::RegT mr;
+        margin::ZeroUnderlying under;
+        under.price = dblSpot;
+        margin::Calc( mr, under, As<margin::ShortCall>( vSource[ 0 ] ), As<margin::ShortPut>( vSource[ 1 ] ) );
+        dblMargin += mr.margin;
+      }
+      break;
+    case EIronCondor: {
+        margin::RegT mr;
+        margin::Calc( mr,
+          As<margin::ShortPut>( vSource[ 0 ] ), As<margin::LongPut>( vSource[ 1 ] ),
+          As<margin::ShortCall>( vSource[ 2 ] ), As<margin::LongCall>( vSource[ 3 ] ) );
+        dblMargin += mr.margin;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  for ( size_t ix = 0; ix < m_vLeg.size(); ++ix ) {
+    const Leg& leg( m_vLeg[ ix ] );
+    if ( 0 == vRemaining[ ix ] ) continue;
+    if ( ( m_vPortfolio.size() != ixPortfolio ) && ( ixPortfolio != leg.ixPortfolio ) ) continue;
+    const double dblSpot( m_vUnderlying[ leg.ixUnderlying ].dblSpot );
+    margin::Source source;
+    source.pInstrument = leg.pInstrument;
+    source.quantity = static_cast<unsigned int>( vRemaining[ ix ] * leg.dblMultiplier );
+    source.price = ( EUnderlying == leg.kind ) ? dblSpot : leg.dblPrice;
+    if ( EUnderlying == leg.kind ) {
+      margin::RegTInitial mr;
+      if ( 0 < leg.nQuantity ) margin::Calc( mr, As<margin::LongUnderlying>( source ) );
+      else margin::Calc( mr, As<margin::ShortUnderlying>( source ) );
+      dblMargin += mr.margin;
+    }
+    else {
+      if ( 0 < leg.nQuantity ) {
+        margin::MarginRequirement mr;
+        margin::Calc( mr, As<margin::LongOption>( source ) );
+        dblMargin += mr.margin;
+      }
+      else {
+        margin::RegT mr;
+        margin::ZeroUnderlying under;
+        under.price = dblSpot;
+        if ( ECall == leg.kind ) margin::Calc( mr, under, As<margin::ShortCall>( source ) );
+        else margin::Calc( mr, under, As<margin::ShortPut>( source ) );
+        dblMargin += mr.margin;
+      }
+    }
+  }
+
+  return dblMargin;
+}
+
+} // namespace option
+} // namespace tf
+} // namespace ou
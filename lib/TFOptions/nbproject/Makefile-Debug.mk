@@ -42,6 +42,7 @@ OBJECTFILES= \
 	${OBJECTDIR}/Margin.o \
 	${OBJECTDIR}/Option.o \
 	${OBJECTDIR}/PopulateWithIBOptions.o \
+	${OBJECTDIR}/RiskEngine.o \
 	${OBJECTDIR}/Strike.o
 
 
@@ -106,6 +107,11 @@ ${OBJECTDIR}/PopulateWithIBOptions.o: PopulateWithIBOptions.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/PopulateWithIBOptions.o PopulateWithIBOptions.cpp
 
+${OBJECTDIR}/RiskEngine.o: RiskEngine.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/RiskEngine.o RiskEngine.cpp
+
 ${OBJECTDIR}/Strike.o: Strike.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
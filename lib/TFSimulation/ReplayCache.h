@@ -0,0 +1,155 @@
+/************************************************************************
+ * Copyright(c) 2012, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// holds series read from hdf5 for re-use by subsequent simulations of the same data,
+//   such as the individuals in an optimization run
+// when enabled, each path is read from disk once, and later requests are copied from the in-memory master
+//   the cache's lock covers only the lookup, each path has its own lock for its one read, so a load of one path
+//     does not hold up requests for paths already loaded, the hdf5 reads themselves take HDF5DataManager::Mutex,
+//     and a loaded master is only read, so copies from it run unlocked
+// a copy is still required for each simulation:  MergeDatedDatums walks a series with First/Next,
+//   which keeps its position in the series itself
+
+#include <map>
+#include <cassert>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <OUCommon/Singleton.h>
+
+#include "TFTimeSeries/TimeSeries.h"
+#include "TFHDF5TimeSeries/HDF5TimeSeriesContainer.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+class ReplayCache: public ou::Singleton<ReplayCache> {
+public:
+
+  ReplayCache( void ): m_bEnabled( false ), m_cntReads( 0 ), m_cntCopies( 0 ) {};
+  ~ReplayCache( void ) {};
+
+  void Enable( bool bEnabled = true ) { m_bEnabled = bEnabled; };
+  bool Enabled( void ) const { return m_bEnabled; };
+
+  void Clear( void ) {
+    boost::mutex::scoped_lock lock( m_mutex );
+    m_mapSeries.clear();
+  }
+
+  template<typename T>
+  void Load( const std::string& sPath, TimeSeries<T>& series );  // from cache when enabled, otherwise from disk
+
+  template<typename T>
+  static void Read( const std::string& sPath, TimeSeries<T>& series );  // from disk, empty if not available
+
+  size_t CountReads( void ) const { return m_cntReads; };
+  size_t CountCopies( void ) const { return m_cntCopies; };
+
+protected:
+private:
+
+  typedef boost::shared_ptr<TimeSeriesBase> pSeries_t;
+
+  struct Entry {
+    boost::mutex mutex;  // held for the read
+    bool bLoaded;
+    pSeries_t pSeries;  // master series
+    Entry( void ): bLoaded( false ) {};
+  };
+  typedef boost::shared_ptr<Entry> pEntry_t;
+  typedef std::map<std::string,pEntry_t> mapSeries_t;  // path, entry
+
+  bool m_bEnabled;
+
+  boost::atomic<size_t> m_cntReads;
+  boost::atomic<size_t> m_cntCopies;
+
+  boost::mutex m_mutex;  // the map
+  mapSeries_t m_mapSeries;
+
+};
+
+template<typename T>
+void ReplayCache::Read( const std::string& sPath, TimeSeries<T>& series ) {
+  try {
+    ou::tf::HDF5DataManager::mutex_t::scoped_lock lock( ou::tf::HDF5DataManager::Mutex() );
+    ou::tf::HDF5DataManager dm( ou::tf::HDF5DataManager::RO );
+    HDF5TimeSeriesContainer<T> repository( dm, sPath );
+    typename HDF5TimeSeriesContainer<T>::iterator begin, end;
+    begin = repository.begin();
+    end = repository.end();
+    series.Resize( end - begin );
+    repository.Read( begin, end, &series );
+  }
+  catch ( std::runtime_error &e ) {
+    // couldn't do read, so leave as empty
+  }
+}
+
+template<typename T>
+void ReplayCache::Load( const std::string& sPath, TimeSeries<T>& series ) {
+
+  if ( !m_bEnabled ) {
+    Read( sPath, series );
+    return;
+  }
+
+  pEntry_t pEntry;  // keeps the entry through a Clear
+  {
+    boost::mutex::scoped_lock lock( m_mutex );
+    mapSeries_t::iterator iter = m_mapSeries.find( sPath );
+    if ( m_mapSeries.end() == iter ) {
+      pEntry.reset( new Entry );
+      m_mapSeries.insert( mapSeries_t::value_type( sPath, pEntry ) );
+    }
+    else {
+      pEntry = iter->second;
+    }
+  }
+
+  TimeSeries<T>* pMaster;
+  {
+    boost::mutex::scoped_lock lock( pEntry->mutex );  // the first in reads, others for the path wait on it
+    if ( !pEntry->bLoaded ) {
+      pMaster = new TimeSeries<T>;
+      pEntry->pSeries.reset( pMaster );
+      Read( sPath, *pMaster );  // an unavailable series is cached as empty as well
+      pEntry->bLoaded = true;
+      ++m_cntReads;
+    }
+    else {
+      pMaster = dynamic_cast<TimeSeries<T>*>( pEntry->pSeries.get() );
+      assert( 0 != pMaster );
+    }
+  }
+
+  // datum by datum, the destination may be segmented
+  series.Clear();
+  series.Reserve( pMaster->Size() );
+  for ( typename TimeSeries<T>::const_iterator iter = pMaster->begin(); pMaster->end() != iter; ++iter ) {
+    series.Append( *iter );
+  }
+  ++m_cntCopies;
+}
+
+} // namespace tf
+} // namespace ou
@@ -19,6 +19,8 @@
 #include "TFHDF5TimeSeries/HDF5TimeSeriesContainer.h"
 #include "TFHDF5TimeSeries/HDF5IterateGroups.h"
 
+#include "ReplayCache.h"
+
 namespace ou { // One Unified
 namespace tf { // TradeFrame
 
@@ -42,19 +44,7 @@ SimulationSymbol::~SimulationSymbol(void) {
 
 void SimulationSymbol::StartTradeWatch( void ) {
   if ( 0 == m_trades.Size() ) {
-    try {
-      std::string sPath( m_sDirectory + "/trades/" + GetId() );
-      ou::tf::HDF5DataManager dm( ou::tf::HDF5DataManager::RO );
-      HDF5TimeSeriesContainer<Trade> tradeRepository( dm, sPath );
-      HDF5TimeSeriesContainer<Trade>::iterator begin, end;
-      begin = tradeRepository.begin();
-      end = tradeRepository.end();
-      m_trades.Resize( end - begin );
-      tradeRepository.Read( begin, end, &m_trades );
-    }
-    catch ( std::runtime_error &e ) {
-      // couldn't do read, so leave as empty
-    }
+    ReplayCache::GlobalInstance().Load( m_sDirectory + "/trades/" + GetId(), m_trades );  // left empty if not available
   }
 }
 
@@ -63,19 +53,7 @@ void SimulationSymbol::StopTradeWatch( void ) {
 
 void SimulationSymbol::StartQuoteWatch( void ) {
   if ( 0 == m_quotes.Size() ) {
-    try {
-      std::string sPath( m_sDirectory + "/quotes/" + GetId() );
-      ou::tf::HDF5DataManager dm( ou::tf::HDF5DataManager::RO );
-      HDF5TimeSeriesContainer<Quote> quoteRepository( dm, sPath );
-      HDF5TimeSeriesContainer<Quote>::iterator begin, end;
-      begin = quoteRepository.begin();
-      end = quoteRepository.end();
-      m_quotes.Resize( end - begin );
-      quoteRepository.Read( begin, end, &m_quotes );
-    }
-    catch ( std::runtime_error &e ) {
-      // couldn't do read, so leave as empty
-    }
+    ReplayCache::GlobalInstance().Load( m_sDirectory + "/quotes/" + GetId(), m_quotes );  // left empty if not available
   }
 }
 
@@ -84,19 +62,7 @@ void SimulationSymbol::StopQuoteWatch( void ) {
 
 void SimulationSymbol::StartGreekWatch( void ) {
   if ( ( 0 == m_greeks.Size() ) && ( m_pInstrument->IsOption() ) )  {
-    try {
-      std::string sPath( m_sDirectory + "/greeks/" + GetId() );
-      ou::tf::HDF5DataManager dm( ou::tf::HDF5DataManager::RO );
-      HDF5TimeSeriesContainer<Greek> greekRepository( dm, sPath );
-      HDF5TimeSeriesContainer<Greek>::iterator begin, end;
-      begin = greekRepository.begin();
-      end = greekRepository.end();
-      m_greeks.Resize( end - begin );
-      greekRepository.Read( begin, end, &m_greeks );
-    }
-    catch ( std::runtime_error &e ) {
-      // couldn't do read, so leave as empty
-    }
+    ReplayCache::GlobalInstance().Load( m_sDirectory + "/greeks/" + GetId(), m_greeks );  // left empty if not available
   }
 }
 
@@ -0,0 +1,257 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#include "stdafx.h"
+
+#include <cassert>
+#include <algorithm>
+
+#include "BarFactoryCascade.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+BarFactoryCascade::BarFactoryCascade( void ): m_1Sec( time_duration( 0, 0, 1 ) ) {
+}
+
+BarFactoryCascade::~BarFactoryCascade( void ) {
+}
+
+BarFactoryCascade::idWidth_t BarFactoryCascade::AddTimeWidth( duration_t nSeconds ) {
+  return AddWidth( Width( ETime, std::max<duration_t>( 1, nSeconds ), 0.0 ) );
+}
+
+BarFactoryCascade::idWidth_t BarFactoryCascade::AddTickWidth( unsigned long nTicks ) {
+  return AddWidth( Width( ETick, std::max<unsigned long>( 1, nTicks ), 0.0 ) );
+}
+
+BarFactoryCascade::idWidth_t BarFactoryCascade::AddVolumeWidth( volume_t nVolume ) {
+  return AddWidth( Width( EVolume, std::max<volume_t>( 1, nVolume ), 0.0 ) );
+}
+
+BarFactoryCascade::idWidth_t BarFactoryCascade::AddDollarWidth( double dblDollars ) {
+  assert( 0.0 < dblDollars );
+  return AddWidth( Width( EDollar, 0, dblDollars ) );
+}
+
+BarFactoryCascade::idWidth_t BarFactoryCascade::AddWidth( const Width& width ) {
+  for ( vWidth_t::const_iterator iter = m_vWidth.begin(); m_vWidth.end() != iter; ++iter ) {
+    assert( !iter->bActive );  // widths are configured before the first trade
+  }
+  idWidth_t id( m_vWidth.size() );
+  m_vWidth.push_back( width );
+  Link();
+  return id;
+}
+
+// time and tick widths are sourced from the largest finer width of the same type which divides them
+void BarFactoryCascade::Link( void ) {
+  m_vRoots.clear();
+  for ( vWidth_t::iterator iter = m_vWidth.begin(); m_vWidth.end() != iter; ++iter ) {
+    iter->ixParent = NoParent;
+    iter->vChildren.clear();
+  }
+  for ( idWidth_t ix = 0; ix < m_vWidth.size(); ++ix ) {
+    Width& width( m_vWidth[ ix ] );
+    if ( ( ETime == width.eType ) || ( ETick == width.eType ) ) {
+      for ( idWidth_t ixCandidate = 0; ixCandidate < m_vWidth.size(); ++ixCandidate ) {
+        const Width& candidate( m_vWidth[ ixCandidate ] );
+        if ( ( candidate.eType == width.eType ) 
+          && ( candidate.nWidth < width.nWidth ) 
+          && ( 0 == ( width.nWidth % candidate.nWidth ) ) ) {
+          if ( ( NoParent == width.ixParent ) || ( m_vWidth[ width.ixParent ].nWidth < candidate.nWidth ) ) {
+            width.ixParent = ixCandidate;
+          }
+        }
+      }
+    }
+    if ( NoParent == width.ixParent ) {
+      m_vRoots.push_back( ix );
+    }
+    else {
+      m_vWidth[ width.ixParent ].vChildren.push_back( ix );
+    }
+  }
+}
+
+void BarFactoryCascade::Add( const ptime& dt, price_t price, volume_t volume ) {
+
+  if ( m_dtLastIntermediateEmission.is_not_a_date_time() ) {
+    m_dtLastIntermediateEmission = dt - m_1Sec;  // prime the value
+  }
+
+  for ( std::vector<idWidth_t>::const_iterator iter = m_vRoots.begin(); m_vRoots.end() != iter; ++iter ) {
+    idWidth_t ix( *iter );
+    Width& width( m_vWidth[ ix ] );
+    if ( !width.bActive ) {
+      StartBar( ix, dt, price, volume );
+    }
+    else {
+      if ( ( ETime == width.eType ) && ( dt >= width.dtEnd ) ) {
+        CompleteBar( ix );
+        StartBar( ix, dt, price, volume );
+      }
+      else { // update current bar
+        Bar& bar( width.bar );
+        bar.Close( price );
+        bar.High( std::max( bar.High(), price ) );
+        bar.Low( std::min( bar.Low(), price ) );
+        bar.Volume( bar.Volume() + volume );
+        ++width.nCount;
+        width.dblDollars += price * volume;
+      }
+    }
+    switch ( width.eType ) {
+      case ETime:
+        break;
+      case ETick:
+        if ( width.nCount >= width.nWidth ) CompleteBar( ix );
+        break;
+      case EVolume:
+        if ( width.bar.Volume() >= width.nWidth ) CompleteBar( ix );
+        break;
+      case EDollar:
+        if ( width.dblDollars >= width.dblWidth ) CompleteBar( ix );
+        break;
+    }
+  }
+
+  if ( m_1Sec <= ( dt - m_dtLastIntermediateEmission ) ) {
+    for ( idWidth_t ix = 0; ix < m_vWidth.size(); ++ix ) {
+      const Width& width( m_vWidth[ ix ] );
+      if ( width.bActive && ( 0 != width.OnBarUpdated ) ) width.OnBarUpdated( getCurrentBar( ix ) );
+    }
+    m_dtLastIntermediateEmission = dt;
+  }
+
+}
+
+// interval aligned to the start of the day, as with BarFactory, but ending no later than midnight
+void BarFactoryCascade::StartInterval( Width& width, const ptime& dt ) {
+  duration_t seconds = dt.time_of_day().total_seconds();
+  duration_t interval = seconds / width.nWidth;
+  width.bar.DateTime( ptime( dt.date(), time_duration( 0, 0, interval * width.nWidth, 0 ) ) );
+  width.dtEnd = std::min<ptime>( 
+    ptime( dt.date(), time_duration( 0, 0, ( interval + 1 ) * width.nWidth, 0 ) ), 
+    ptime( dt.date() + boost::gregorian::days( 1 ) ) );
+}
+
+void BarFactoryCascade::StartBar( idWidth_t ix, const ptime& dt, price_t price, volume_t volume ) {
+  Width& width( m_vWidth[ ix ] );
+  Bar& bar( width.bar );
+  bar.Close( price );
+  bar.High( price );
+  bar.Low( price );
+  bar.Open( price );
+  bar.Volume( volume );
+  if ( ETime == width.eType ) {
+    StartInterval( width, dt );
+  }
+  else {
+    bar.DateTime( dt );
+  }
+  width.bActive = true;
+  width.nCount = 1;
+  width.dblDollars = price * volume;
+  if ( 0 != width.OnNewBarStarted ) width.OnNewBarStarted( bar );
+  for ( std::vector<idWidth_t>::const_iterator iter = width.vChildren.begin(); width.vChildren.end() != iter; ++iter ) {
+    ParentStarted( *iter, dt );
+  }
+}
+
+void BarFactoryCascade::CompleteBar( idWidth_t ix ) {
+  Width& width( m_vWidth[ ix ] );
+  assert( width.bActive );
+  width.bActive = false;
+  if ( 0 != width.OnBarComplete ) width.OnBarComplete( width.bar );
+  for ( std::vector<idWidth_t>::const_iterator iter = width.vChildren.begin(); width.vChildren.end() != iter; ++iter ) {
+    ParentCompleted( *iter, width.bar );
+  }
+}
+
+// a time width completes when its parent starts a bar beyond its interval,
+//   a tick width completes along with the parent bar which fills it
+void BarFactoryCascade::ParentStarted( idWidth_t ix, const ptime& dtParent ) {
+  Width& width( m_vWidth[ ix ] );
+  if ( width.bActive ) {
+    if ( ( ETime == width.eType ) && ( dtParent >= width.dtEnd ) ) {
+      CompleteBar( ix );
+    }
+    else {
+      return;  // parent bar is part of the one in progress
+    }
+  }
+  width.bActive = true;
+  width.bHasContent = false;
+  width.nCount = 0;
+  if ( ETime == width.eType ) {
+    StartInterval( width, dtParent );
+  }
+  else {
+    width.bar.DateTime( dtParent );
+  }
+  if ( 0 != width.OnNewBarStarted ) width.OnNewBarStarted( getCurrentBar( ix ) );
+  for ( std::vector<idWidth_t>::const_iterator iter = width.vChildren.begin(); width.vChildren.end() != iter; ++iter ) {
+    ParentStarted( *iter, dtParent );
+  }
+}
+
+void BarFactoryCascade::ParentCompleted( idWidth_t ix, const Bar& bar ) {
+  Width& width( m_vWidth[ ix ] );
+  assert( width.bActive );
+  Bar& accumulated( width.bar );
+  if ( width.bHasContent ) {
+    accumulated.Close( bar.Close() );
+    accumulated.High( std::max( accumulated.High(), bar.High() ) );
+    accumulated.Low( std::min( accumulated.Low(), bar.Low() ) );
+    accumulated.Volume( accumulated.Volume() + bar.Volume() );
+  }
+  else {
+    accumulated.Open( bar.Open() );
+    accumulated.High( bar.High() );
+    accumulated.Low( bar.Low() );
+    accumulated.Close( bar.Close() );
+    accumulated.Volume( bar.Volume() );
+    width.bHasContent = true;
+  }
+  ++width.nCount;
+  if ( ETick == width.eType ) {
+    if ( ( width.nCount * m_vWidth[ width.ixParent ].nWidth ) >= width.nWidth ) CompleteBar( ix );
+  }
+}
+
+// cascaded widths merge the parent bar in progress with the parent bars already absorbed
+Bar BarFactoryCascade::getCurrentBar( idWidth_t id ) const {
+  const Width& width( m_vWidth[ id ] );
+  if ( !width.bActive ) return Bar();
+  if ( NoParent == width.ixParent ) return width.bar;
+  const Width& parent( m_vWidth[ width.ixParent ] );
+  if ( !parent.bActive ) return width.bar;  // tick parent completed, next trade not yet arrived
+  Bar current( getCurrentBar( width.ixParent ) );
+  if ( width.bHasContent ) {
+    Bar bar( width.bar );
+    bar.Close( current.Close() );
+    bar.High( std::max( bar.High(), current.High() ) );
+    bar.Low( std::min( bar.Low(), current.Low() ) );
+    bar.Volume( bar.Volume() + current.Volume() );
+    return bar;
+  }
+  else {
+    current.DateTime( width.bar.DateTime() );
+    return current;
+  }
+}
+
+} // namespace tf
+} // namespace ou
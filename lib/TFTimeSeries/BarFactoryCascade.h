@@ -0,0 +1,110 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// builds bars at several widths from one trade stream, in one pass, rather than one BarFactory per width
+//   time bars:  a width which is a multiple of a finer time width is aggregated from the completed finer bars,
+//     only the finest width looks at each trade, and with a single comparison against the end of its interval
+//   tick bars:  cascade in the same way, when the count is a multiple of a finer count
+//   volume and dollar bars:  built from the trades, as a trade crossing the threshold stays whole in its bar,
+//     so coarser widths can not be assembled exactly from finer bars
+// callbacks match BarFactory, per configured width:
+//   OnNewBarStarted and OnBarComplete as bars start and finish,
+//   OnBarUpdated with the bar so far, at most once a second
+// time bars complete on the first trade of the next interval, as BarFactory does,
+//   threshold bars complete on the trade which reaches the threshold
+// widths are to be configured before the first trade
+
+#include <vector>
+
+#include "BarFactory.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+class BarFactoryCascade {
+public:
+
+  typedef BarFactory::duration_t duration_t;  // seconds
+  typedef Bar::volume_t volume_t;
+  typedef Bar::price_t price_t;
+
+  typedef size_t idWidth_t;  // returned by the Add* calls, used to attach handlers
+
+  BarFactoryCascade( void );
+  ~BarFactoryCascade( void );
+
+  idWidth_t AddTimeWidth( duration_t nSeconds );
+  idWidth_t AddTickWidth( unsigned long nTicks );
+  idWidth_t AddVolumeWidth( volume_t nVolume );
+  idWidth_t AddDollarWidth( double dblDollars );
+
+  void SetOnNewBarStarted( idWidth_t id, BarFactory::OnNewBarStartedHandler function ) { m_vWidth[ id ].OnNewBarStarted = function; };
+  void SetOnBarUpdated( idWidth_t id, BarFactory::OnBarUpdatedHandler function ) { m_vWidth[ id ].OnBarUpdated = function; };
+  void SetOnBarComplete( idWidth_t id, BarFactory::OnBarCompleteHandler function ) { m_vWidth[ id ].OnBarComplete = function; };
+
+  void Add( const ptime&, price_t, volume_t );
+  void Add( const Trade& trade ) { Add( trade.DateTime(), trade.Price(), trade.Volume() ); };
+
+  Bar getCurrentBar( idWidth_t id ) const;  // null bar when none in progress
+
+protected:
+private:
+
+  enum EType { ETime, ETick, EVolume, EDollar };
+
+  static const idWidth_t NoParent = (idWidth_t) -1;  // built from trades
+
+  struct Width {
+    EType eType;
+    unsigned long nWidth;  // seconds, ticks or volume
+    double dblWidth;  // dollars
+    idWidth_t ixParent;
+    std::vector<idWidth_t> vChildren;
+    bool bActive;  // a bar is in progress
+    bool bHasContent;  // cascaded: at least one parent bar has been absorbed
+    Bar bar;  // from trades: the bar in progress; cascaded: the completed parent bars so far
+    ptime dtEnd;  // time bars: end of the interval in progress
+    unsigned long nCount;  // ticks, or parent bars absorbed
+    double dblDollars;
+    BarFactory::OnNewBarStartedHandler OnNewBarStarted;
+    BarFactory::OnBarUpdatedHandler OnBarUpdated;
+    BarFactory::OnBarCompleteHandler OnBarComplete;
+    Width( EType eType_, unsigned long nWidth_, double dblWidth_ )
+      : eType( eType_ ), nWidth( nWidth_ ), dblWidth( dblWidth_ ), ixParent( NoParent ),
+      bActive( false ), bHasContent( false ), nCount( 0 ), dblDollars( 0.0 ) {};
+  };
+
+  typedef std::vector<Width> vWidth_t;
+  vWidth_t m_vWidth;
+
+  std::vector<idWidth_t> m_vRoots;  // widths built from trades
+
+  ptime m_dtLastIntermediateEmission;
+  boost::posix_time::time_duration m_1Sec;
+
+  idWidth_t AddWidth( const Width& width );
+  void Link( void );
+
+  void StartInterval( Width& width, const ptime& dt );  // time bars
+  void StartBar( idWidth_t ix, const ptime& dt, price_t, volume_t );  // from a trade
+  void CompleteBar( idWidth_t ix );
+  void ParentStarted( idWidth_t ix, const ptime& dtParent );
+  void ParentCompleted( idWidth_t ix, const Bar& bar );
+
+};
+
+} // namespace tf
+} // namespace ou
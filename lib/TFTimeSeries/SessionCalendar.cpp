@@ -0,0 +1,126 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#include "stdafx.h"
+
+#include <cassert>
+#include <stdexcept>
+
+#include <OUCommon/TimeSource.h>
+
+#include "SessionCalendar.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+const size_t SessionCalendar::NotTradingDay;
+
+SessionCalendar::SessionCalendar( 
+  boost::gregorian::date dateBegin, boost::gregorian::date dateEnd, 
+  const vOffset_t& vOffset, 
+  const std::string& sZone, const setDates_t& setHolidays )
+  : m_nBoundaries( vOffset.size() ), m_dateBegin( dateBegin ), m_dateEnd( dateEnd ),
+  m_nTicksPerDay( boost::posix_time::hours( 24 ).ticks() )
+{
+  if ( m_dateEnd < m_dateBegin ) throw std::invalid_argument( "SessionCalendar: end before begin" );
+  if ( 2 > m_nBoundaries ) throw std::invalid_argument( "SessionCalendar: an open and a close are required" );
+
+  const boost::posix_time::time_duration tdDay( boost::posix_time::hours( 24 ) );
+
+  for ( boost::gregorian::date date = m_dateBegin; date <= m_dateEnd; date += boost::gregorian::days( 1 ) ) {
+    boost::gregorian::greg_weekday wd( date.day_of_week() );
+    if ( ( boost::gregorian::Saturday == wd ) || ( boost::gregorian::Sunday == wd ) 
+      || ( setHolidays.end() != setHolidays.find( date ) ) ) {
+      m_vDayToSession.push_back( NotTradingDay );
+    }
+    else {
+      m_vDayToSession.push_back( m_vDate.size() );
+      m_vDate.push_back( date );
+      for ( vOffset_t::const_iterator iter = vOffset.begin(); vOffset.end() != iter; ++iter ) {
+        // split the offset into a day and a time of day for the conversion
+        boost::posix_time::time_duration td( *iter );
+        boost::gregorian::date dateBoundary( date );
+        while ( td.is_negative() ) { td += tdDay; dateBoundary -= boost::gregorian::days( 1 ); }
+        while ( td >= tdDay ) { td -= tdDay; dateBoundary += boost::gregorian::days( 1 ); }
+        boost::posix_time::ptime dt( ou::TimeSource::Instance().ConvertRegionalToUtc( dateBoundary, td, sZone, true ) );
+        if ( !m_vBoundary.empty() && ( dt < m_vBoundary.back() ) ) {
+          throw std::invalid_argument( "SessionCalendar: boundaries out of order, or sessions overlap" );
+        }
+        m_vBoundary.push_back( dt );
+      }
+    }
+  }
+
+  // utc days spanned by the boundaries, the index of each leads to the first boundary of that utc day
+  if ( m_vBoundary.empty() ) {
+    m_dtUtcBegin = boost::posix_time::ptime( m_dateBegin );
+  }
+  else {
+    m_dtUtcBegin = boost::posix_time::ptime( m_vBoundary.front().date() );
+    boost::posix_time::ptime dtMidnight( m_dtUtcBegin );
+    size_t ix( 0 );
+    while ( ix < m_vBoundary.size() ) {
+      while ( ( ix < m_vBoundary.size() ) && ( m_vBoundary[ ix ] < dtMidnight ) ) ++ix;
+      m_vUtcDayToBoundary.push_back( ix );
+      dtMidnight += tdDay;
+    }
+  }
+}
+
+SessionCalendar::~SessionCalendar( void ) {
+}
+
+bool SessionCalendar::IsTradingDay( boost::gregorian::date date ) const {
+  if ( ( date < m_dateBegin ) || ( m_dateEnd < date ) ) return false;
+  return NotTradingDay != m_vDayToSession[ ( date - m_dateBegin ).days() ];
+}
+
+boost::posix_time::ptime SessionCalendar::Boundary( boost::gregorian::date date, size_t ix ) const {
+  assert( ix < m_nBoundaries );
+  if ( !IsTradingDay( date ) ) return boost::posix_time::ptime( boost::posix_time::not_a_date_time );
+  return m_vBoundary[ m_vDayToSession[ ( date - m_dateBegin ).days() ] * m_nBoundaries + ix ];
+}
+
+size_t SessionCalendar::Upper( const boost::posix_time::ptime& dt ) const {
+  if ( m_vBoundary.empty() || ( dt < m_dtUtcBegin ) ) return 0;
+  size_t ixDay( ( dt - m_dtUtcBegin ).ticks() / m_nTicksPerDay );
+  if ( ixDay >= m_vUtcDayToBoundary.size() ) return m_vBoundary.size();
+  size_t ix( m_vUtcDayToBoundary[ ixDay ] );
+  while ( ( ix < m_vBoundary.size() ) && ( m_vBoundary[ ix ] <= dt ) ) ++ix;  // a few boundaries a day at most
+  return ix;
+}
+
+int SessionCalendar::Phase( const boost::posix_time::ptime& dt ) const {
+  size_t ix( Upper( dt ) );
+  if ( 0 == ix ) return -1;  // before the first session
+  size_t nPhase( ( ix - 1 ) % m_nBoundaries );
+  if ( ( m_nBoundaries - 1 ) == nPhase ) return -1;  // after a close
+  return nPhase;
+}
+
+boost::posix_time::ptime SessionCalendar::NextBoundary( const boost::posix_time::ptime& dt ) const {
+  size_t ix( Upper( dt ) );
+  if ( m_vBoundary.size() == ix ) return boost::posix_time::ptime( boost::posix_time::not_a_date_time );
+  return m_vBoundary[ ix ];
+}
+
+boost::gregorian::date SessionCalendar::TradingDay( const boost::posix_time::ptime& dt ) const {
+  size_t ix( Upper( dt ) );
+  size_t ixSession( ix / m_nBoundaries );  // the session dt is in, otherwise the next one
+  if ( m_vDate.size() == ixSession ) return boost::gregorian::date( boost::gregorian::not_a_date_time );
+  return m_vDate[ ixSession ];
+}
+
+} // namespace tf
+} // namespace ou
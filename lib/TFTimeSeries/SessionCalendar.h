@@ -0,0 +1,89 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// session boundaries of an exchange, in utc, precomputed for each trading day of a date range:
+//   time zone conversions happen once, as the table is built, rather than as each day is set up
+//   lookups of the session phase of a timestamp, or of the next boundary, are O(1):
+//     a per utc day index leads to the day's first boundary, followed by a short scan through that day
+// boundaries are supplied as exchange local offsets from midnight of the trading day, ascending,
+//   and may be negative for sessions opening the evening before (24 hour futures)
+//   the first offset opens the session, the last closes it, sessions are not to overlap
+// weekends and holidays are not trading days, and have no session
+
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "ExchangeHolidays.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+class SessionCalendar {
+public:
+
+  typedef std::vector<boost::posix_time::time_duration> vOffset_t;
+  typedef holidays::exchange::setDates_t setDates_t;
+
+  SessionCalendar( 
+    boost::gregorian::date dateBegin, boost::gregorian::date dateEnd,  // trading days, inclusive
+    const vOffset_t& vOffset,
+    const std::string& sZone = "America/New_York", const setDates_t& setHolidays = holidays::exchange::setUSDates );
+  ~SessionCalendar( void );
+
+  size_t Boundaries( void ) const { return m_nBoundaries; };  // per trading day
+  boost::gregorian::date Begin( void ) const { return m_dateBegin; };
+  boost::gregorian::date End( void ) const { return m_dateEnd; };
+
+  bool IsTradingDay( boost::gregorian::date date ) const;
+  boost::posix_time::ptime Boundary( boost::gregorian::date date, size_t ix ) const;  // not_a_date_time when not a trading day
+
+  // -1 when outside of a session, otherwise ix where Boundary( ix ) <= dt < Boundary( ix + 1 )
+  int Phase( const boost::posix_time::ptime& dt ) const;
+  // first boundary after dt, not_a_date_time beyond the range
+  boost::posix_time::ptime NextBoundary( const boost::posix_time::ptime& dt ) const;
+  // the trading day of the session dt is in, or of the next session, not_a_date_time beyond the range
+  boost::gregorian::date TradingDay( const boost::posix_time::ptime& dt ) const;
+
+protected:
+private:
+
+  typedef std::vector<boost::posix_time::ptime> vBoundary_t;
+  typedef std::vector<boost::gregorian::date> vDate_t;
+  typedef std::vector<size_t> vIndex_t;
+
+  static const size_t NotTradingDay = (size_t) -1;
+
+  size_t m_nBoundaries;
+
+  boost::gregorian::date m_dateBegin;
+  boost::gregorian::date m_dateEnd;
+
+  boost::posix_time::ptime m_dtUtcBegin;  // midnight of the first utc day indexed
+  boost::posix_time::time_duration::tick_type m_nTicksPerDay;
+
+  vBoundary_t m_vBoundary;  // m_nBoundaries per trading day, ascending
+  vDate_t m_vDate;  // trading day of each group of boundaries
+  vIndex_t m_vDayToSession;  // calendar day from m_dateBegin to its group of boundaries, or NotTradingDay
+  vIndex_t m_vUtcDayToBoundary;  // utc day from m_dtUtcBegin to the first boundary at or after its midnight
+
+  size_t Upper( const boost::posix_time::ptime& dt ) const;  // index of the first boundary after dt
+
+};
+
+} // namespace tf
+} // namespace ou
@@ -28,6 +28,13 @@
 
 //#include <OUCommon/FastDelegate.h>
 
+#include <new>
+#include <cstddef>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 namespace ou { // One Unified
 
 template<typename T>
@@ -123,6 +130,72 @@ public:
   
 };
 
+// backs allocations with huge pages, fewer tlb misses when scanning long series
+//   linux: an anonymous mapping with MAP_HUGETLB when huge pages have been reserved
+//     (vm.nr_hugepages), otherwise a mapping advised with MADV_HUGEPAGE (transparent huge pages)
+//   elsewhere: as heap
+// allocations are rounded up to whole huge pages, so suits large blocks only
+template<typename T>
+class huge_page {
+public:
+
+  ALLOCATOR_TRAITS(T)
+
+  template<typename U>
+  struct rebind {
+      typedef huge_page<U> other;
+  };
+
+  static const size_type nHugePageSize = 2 * 1024 * 1024;
+
+  // Default Constructor
+  huge_page(void){}
+
+  // Copy Constructor
+  template<typename U>
+  huge_page(huge_page<U> const& other){}
+
+  // Allocate memory
+  pointer allocate(size_type count, const_pointer /* hint */ = 0) {
+    if(count > max_size()){throw std::bad_alloc();}
+#if defined(__linux__)
+    size_type nBytes( Rounded( count ) );
+    void* p( MAP_FAILED );
+#if defined(MAP_HUGETLB)
+    p = mmap( 0, nBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+#endif
+    if ( MAP_FAILED == p ) {  // no reserved huge pages
+      p = mmap( 0, nBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+      if ( MAP_FAILED == p ) throw std::bad_alloc();
+#if defined(MADV_HUGEPAGE)
+      madvise( p, nBytes, MADV_HUGEPAGE );
+#endif
+    }
+    return static_cast<pointer>( p );
+#else
+    return static_cast<pointer>(::operator new(count * sizeof(type), ::std::nothrow));
+#endif
+  }
+
+  // Delete memory, count as supplied to allocate
+  void deallocate(pointer ptr, size_type count ) {
+#if defined(__linux__)
+    munmap( ptr, Rounded( count ) );
+#else
+    ::operator delete(ptr);
+#endif
+  }
+
+  // Max number of objects that can be allocated in one call
+  size_type max_size(void) const {return max_allocations<T>::value;}
+
+private:
+  static size_type Rounded( size_type count ) {
+    return ( ( count * sizeof(type) + nHugePageSize - 1 ) / nHugePageSize ) * nHugePageSize;
+  }
+
+};
+
 #define FORWARD_ALLOCATOR_TRAITS(C)                  \
 typedef typename C::value_type      value_type;      \
 typedef typename C::pointer         pointer;         \
@@ -223,4 +296,22 @@ bool operator!=(allocator<T, heap<T>, TraitsT> const& left,
    return !(left == right);
 }
 
+// Specialize for the huge_page policy
+template<typename T, typename TraitsT,
+         typename U, typename TraitsU>
+bool operator==(allocator<T, huge_page<T>, TraitsT> const& left,
+                allocator<U, huge_page<U>, TraitsU> const& right)
+{
+   return true;
+}
+
+// Also implement inequality
+template<typename T, typename TraitsT,
+         typename U, typename TraitsU>
+bool operator!=(allocator<T, huge_page<T>, TraitsT> const& left,
+                allocator<U, huge_page<U>, TraitsU> const& right)
+{
+   return !(left == right);
+}
+
 } // namespace ou
@@ -0,0 +1,311 @@
+/************************************************************************
+ * Copyright(c) 2017, One Unified. All rights reserved.                 *
+ * email: info@oneunified.net                                           *
+ *                                                                      *
+ * This file is provided as is WITHOUT ANY WARRANTY                     *
+ *  without even the implied warranty of                                *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.                *
+ *                                                                      *
+ * This software may not be used nor distributed without proper license *
+ * agreement.                                                           *
+ *                                                                      *
+ * See the file LICENSE.txt for redistribution information.             *
+ ************************************************************************/
+
+#pragma once
+
+// element storage for TimeSeries, a table of blocks:
+//   contiguous (the default): a single block, grown by doubling, behaves as the std::vector it replaces
+//   segmented: fixed power of two blocks, a new block is added when the last one fills,
+//     so a push_back never copies the series, and element addresses remain valid until clear,
+//     element ix is found at block[ ix >> shift ][ ix & mask ]
+//   blocks come from the heap policy, or from the huge_page policy when requested
+
+#include <vector>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_convertible.hpp>
+#include <boost/type_traits/remove_const.hpp>
+
+#include "TSAllocator.h"
+
+namespace ou { // One Unified
+namespace tf { // TradeFrame
+
+template<typename T>
+class TimeSeriesStorage {
+public:
+
+  typedef T value_type;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+
+  // an index into the storage, so it survives the addition of blocks
+  template<typename V>
+  class Iterator {
+  public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef typename boost::remove_const<V>::type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef V* pointer;
+    typedef V& reference;
+    Iterator( void ): m_pStorage( 0 ), m_ix( 0 ) {};
+    Iterator( const TimeSeriesStorage* pStorage, size_type ix ): m_pStorage( pStorage ), m_ix( ix ) {};
+    template<typename U>  // iterator to const_iterator
+    Iterator( const Iterator<U>& rhs, typename boost::enable_if<boost::is_convertible<U*, V*> >::type* = 0 )
+      : m_pStorage( rhs.Storage() ), m_ix( rhs.Index() ) {};
+    V& operator*( void ) const { return m_pStorage->Element( m_ix ); };
+    V* operator->( void ) const { return &m_pStorage->Element( m_ix ); };
+    V& operator[]( difference_type n ) const { return m_pStorage->Element( m_ix + n ); };
+    Iterator& operator++( void ) { ++m_ix; return *this; };
+    Iterator& operator--( void ) { --m_ix; return *this; };
+    Iterator operator++( int ) { Iterator iter( *this ); ++m_ix; return iter; };
+    Iterator operator--( int ) { Iterator iter( *this ); --m_ix; return iter; };
+    Iterator& operator+=( difference_type n ) { m_ix += n; return *this; };
+    Iterator& operator-=( difference_type n ) { m_ix -= n; return *this; };
+    Iterator operator+( difference_type n ) const { return Iterator( m_pStorage, m_ix + n ); };
+    Iterator operator-( difference_type n ) const { return Iterator( m_pStorage, m_ix - n ); };
+    friend Iterator operator+( difference_type n, const Iterator& rhs ) { return rhs + n; };
+    template<typename U>
+    difference_type operator-( const Iterator<U>& rhs ) const { return difference_type( m_ix ) - difference_type( rhs.Index() ); };
+    template<typename U> bool operator==( const Iterator<U>& rhs ) const { return m_ix == rhs.Index(); };
+    template<typename U> bool operator!=( const Iterator<U>& rhs ) const { return m_ix != rhs.Index(); };
+    template<typename U> bool operator<( const Iterator<U>& rhs ) const { return m_ix < rhs.Index(); };
+    template<typename U> bool operator>( const Iterator<U>& rhs ) const { return m_ix > rhs.Index(); };
+    template<typename U> bool operator<=( const Iterator<U>& rhs ) const { return m_ix <= rhs.Index(); };
+    template<typename U> bool operator>=( const Iterator<U>& rhs ) const { return m_ix >= rhs.Index(); };
+    const TimeSeriesStorage* Storage( void ) const { return m_pStorage; };
+    size_type Index( void ) const { return m_ix; };
+  private:
+    const TimeSeriesStorage* m_pStorage;
+    size_type m_ix;
+  };
+
+  typedef Iterator<T> iterator;
+  typedef Iterator<const T> const_iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  TimeSeriesStorage( void )
+    : m_nSize( 0 ), m_nCapacity( 0 ), m_nShift( nShiftContiguous ), m_nMask( ~size_type( 0 ) ), m_bHugePages( false ) {};
+  TimeSeriesStorage( const TimeSeriesStorage& rhs )
+    : m_nSize( 0 ), m_nCapacity( 0 ), m_nShift( rhs.m_nShift ), m_nMask( rhs.m_nMask ), m_bHugePages( rhs.m_bHugePages ) {
+    Copy( rhs );
+  };
+  ~TimeSeriesStorage( void ) { Release(); };
+
+  TimeSeriesStorage& operator=( const TimeSeriesStorage& rhs ) {
+    if ( this != &rhs ) {
+      Release();
+      m_nShift = rhs.m_nShift;
+      m_nMask = rhs.m_nMask;
+      m_bHugePages = rhs.m_bHugePages;
+      Copy( rhs );
+    }
+    return *this;
+  }
+
+  // nBlockSize, in elements, is rounded down to a power of two, 0 picks a size:
+  //   a huge page worth of elements with bHugePages, otherwise about 256KB worth
+  // only while empty, any capacity is released
+  void SetSegmented( size_type nBlockSize = 0, bool bHugePages = false ) {
+    if ( 0 != m_nSize ) throw std::logic_error( "TimeSeriesStorage::SetSegmented: not empty" );
+    Release();
+    if ( 0 == nBlockSize ) {
+      nBlockSize = ( bHugePages ? huge_page<T>::nHugePageSize : ( 256 * 1024 ) ) / sizeof( T );
+    }
+    m_nShift = 0;
+    while ( ( size_type( 2 ) << m_nShift ) <= nBlockSize ) ++m_nShift;
+    m_nMask = ( size_type( 1 ) << m_nShift ) - 1;
+    m_bHugePages = bHugePages;
+  }
+
+  void SetContiguous( void ) {
+    if ( 0 != m_nSize ) throw std::logic_error( "TimeSeriesStorage::SetContiguous: not empty" );
+    Release();
+    m_nShift = nShiftContiguous;
+    m_nMask = ~size_type( 0 );
+    m_bHugePages = false;
+  }
+
+  bool Segmented( void ) const { return nShiftContiguous != m_nShift; };
+  size_type BlockSize( void ) const { return Segmented() ? ( m_nMask + 1 ) : m_nCapacity; };
+
+  size_type size( void ) const { return m_nSize; };
+  bool empty( void ) const { return 0 == m_nSize; };
+  size_type capacity( void ) const { return m_nCapacity; };
+
+  reference operator[]( size_type ix ) { return Element( ix ); };
+  const_reference operator[]( size_type ix ) const { return Element( ix ); };
+  reference at( size_type ix ) {
+    if ( ix >= m_nSize ) throw std::out_of_range( "TimeSeriesStorage::at" );
+    return Element( ix );
+  }
+  const_reference at( size_type ix ) const {
+    if ( ix >= m_nSize ) throw std::out_of_range( "TimeSeriesStorage::at" );
+    return Element( ix );
+  }
+  reference back( void ) { assert( 0 != m_nSize ); return Element( m_nSize - 1 ); };
+  const_reference back( void ) const { assert( 0 != m_nSize ); return Element( m_nSize - 1 ); };
+
+  void push_back( const T& value ) {
+    if ( m_nCapacity == m_nSize ) {
+      Grow( m_nSize + 1 );
+    }
+    new( &Element( m_nSize ) ) T( value );
+    ++m_nSize;
+  }
+
+  void pop_back( void ) {
+    assert( 0 != m_nSize );
+    --m_nSize;
+    Element( m_nSize ).~T();
+  }
+
+  // by rotation, elements after pos are moved along
+  iterator insert( const_iterator pos, const T& value ) {
+    size_type ix( pos.Index() );
+    push_back( value );
+    std::rotate( begin() + ix, end() - 1, end() );
+    return begin() + ix;
+  }
+
+  void reserve( size_type n ) { if ( m_nCapacity < n ) Grow( n ); };
+
+  void resize( size_type n ) {
+    while ( n < m_nSize ) pop_back();
+    if ( m_nCapacity < n ) Grow( n );
+    while ( m_nSize < n ) push_back( T() );
+  }
+
+  // segmented, and holding at least a block:  the oldest block of elements is dropped, and its memory
+  //   is reused for later growth, indexes, and so iterators, shift down by a block
+  void pop_front_block( void ) {
+    assert( Segmented() && ( BlockSize() <= m_nSize ) );
+    T* pBlock( m_vBlock[ 0 ] );
+    for ( size_type ix = 0; ix < BlockSize(); ++ix ) {
+      pBlock[ ix ].~T();
+    }
+    std::rotate( m_vBlock.begin(), m_vBlock.begin() + 1, m_vBlock.end() );
+    m_nSize -= BlockSize();
+  }
+
+  void clear( void ) {  // capacity is kept, as with vector
+    while ( 0 != m_nSize ) pop_back();
+  }
+
+  // contiguous runs of elements, for bulk transfers such as hdf5 writes, a single run unless segmented
+  size_type Blocks( void ) const { return ( 0 == m_nSize ) ? 0 : ( ( m_nSize - 1 ) >> m_nShift ) + 1; };
+  const T* BlockBegin( size_type ix ) const { return m_vBlock[ ix ]; };
+  const T* BlockEnd( size_type ix ) const { return m_vBlock[ ix ] + std::min<size_type>( m_nSize - ( ix << m_nShift ), BlockSize() ); };
+
+  iterator begin( void ) { return iterator( this, 0 ); };
+  iterator end( void ) { return iterator( this, m_nSize ); };
+  const_iterator begin( void ) const { return const_iterator( this, 0 ); };
+  const_iterator end( void ) const { return const_iterator( this, m_nSize ); };
+  const_iterator cbegin( void ) const { return const_iterator( this, 0 ); };
+  const_iterator cend( void ) const { return const_iterator( this, m_nSize ); };
+  reverse_iterator rbegin( void ) { return reverse_iterator( end() ); };
+  reverse_iterator rend( void ) { return reverse_iterator( begin() ); };
+  const_reverse_iterator rbegin( void ) const { return const_reverse_iterator( end() ); };
+  const_reverse_iterator rend( void ) const { return const_reverse_iterator( begin() ); };
+  const_reverse_iterator crbegin( void ) const { return const_reverse_iterator( end() ); };
+  const_reverse_iterator crend( void ) const { return const_reverse_iterator( begin() ); };
+
+protected:
+private:
+
+  // contiguous indexes all fit in the one block: ix >> shift is 0, ix & mask is ix
+  static const size_type nShiftContiguous = sizeof( size_type ) * 8 - 1;
+
+  typedef std::vector<T*> vBlock_t;
+  vBlock_t m_vBlock;
+
+  size_type m_nSize;
+  size_type m_nCapacity;
+  size_type m_nShift;
+  size_type m_nMask;
+  bool m_bHugePages;
+
+  T& Element( size_type ix ) const {
+    assert( ix < m_nCapacity );
+    return m_vBlock[ ix >> m_nShift ][ ix & m_nMask ];
+  }
+
+  T* Allocate( size_type n ) {
+    T* p;
+    if ( m_bHugePages ) {
+      p = huge_page<T>().allocate( n );
+    }
+    else {
+      p = heap<T>().allocate( n );
+    }
+    if ( 0 == p ) throw std::bad_alloc();
+    return p;
+  }
+
+  void Deallocate( T* p, size_type n ) {
+    if ( m_bHugePages ) {
+      huge_page<T>().deallocate( p, n );
+    }
+    else {
+      heap<T>().deallocate( p, n );
+    }
+  }
+
+  void Grow( size_type n ) {  // capacity for at least n elements
+    if ( Segmented() ) {
+      while ( m_nCapacity < n ) {
+        m_vBlock.reserve( m_vBlock.size() + 1 );  // so a throw does not lose the block
+        m_vBlock.push_back( Allocate( BlockSize() ) );
+        m_nCapacity += BlockSize();
+      }
+    }
+    else {
+      size_type nCapacity( std::max<size_type>( n, 2 * m_nCapacity ) );
+      T* pBlock( Allocate( nCapacity ) );
+      if ( !m_vBlock.empty() ) {
+        T* pOld( m_vBlock[ 0 ] );
+        for ( size_type ix = 0; ix < m_nSize; ++ix ) {
+          new( pBlock + ix ) T( pOld[ ix ] );
+          pOld[ ix ].~T();
+        }
+        Deallocate( pOld, m_nCapacity );
+        m_vBlock[ 0 ] = pBlock;
+      }
+      else {
+        m_vBlock.push_back( pBlock );
+      }
+      m_nCapacity = nCapacity;
+    }
+  }
+
+  void Copy( const TimeSeriesStorage& rhs ) {
+    reserve( rhs.m_nSize );
+    for ( size_type ix = 0; ix < rhs.m_nSize; ++ix ) {
+      push_back( rhs.Element( ix ) );
+    }
+  }
+
+  void Release( void ) {  // elements and blocks
+    clear();
+    for ( typename vBlock_t::iterator iter = m_vBlock.begin(); m_vBlock.end() != iter; ++iter ) {
+      Deallocate( *iter, BlockSize() );
+    }
+    m_vBlock.clear();
+    m_nCapacity = 0;
+  }
+
+};
+
+} // namespace tf
+} // namespace ou
@@ -25,7 +25,7 @@
 #include <OUCommon/Delegate.h>
 
 #include "DatedDatum.h"
-#include "TSAllocator.h"
+#include "TSStorage.h"
 
 // 2012/04/01 use Intel Thread Building Blocks to use concurrent_vector?
 // not sure:  the time series here are typically just used for batch mode processing into and out of hdf5 files
@@ -100,9 +100,7 @@ public:
 
   typedef T datum_t;
   
-  typedef typename ou::allocator<T, heap<T> > allocator_t;
-  
-  typedef typename std::vector<T, allocator_t> vTimeSeries_t;
+  typedef TimeSeriesStorage<T> vTimeSeries_t;  // a vector, unless SetSegmented
 
   typedef typename vTimeSeries_t::size_type size_type;
 
@@ -167,6 +165,30 @@ public:
   
   size_type Capacity( void ) const { return m_vSeries.capacity(); }
 
+  // storage is contiguous by default, growth then copies the whole series, as with a vector
+  // segmented storage grows a block at a time: Append never copies, element addresses stay valid,
+  //   suits long running live series, such as those of a Watch
+  //   First()/Last() pointers are then only contiguous within a block, use Blocks() for bulk access
+  //   nBlockSize 0 picks a size, bHugePages backs blocks with huge pages where available
+  // call while empty
+  void SetSegmented( size_type nBlockSize = 0, bool bHugePages = false ) { m_vSeries.SetSegmented( nBlockSize, bHugePages ); m_vIterator = m_vSeries.end(); };
+  bool Segmented( void ) const { return m_vSeries.Segmented(); };
+
+  // contiguous runs of the series, a single run unless segmented
+  size_type Blocks( void ) const { return m_vSeries.Blocks(); };
+  const T* BlockBegin( size_type ix ) const { return m_vSeries.BlockBegin( ix ); };
+  const T* BlockEnd( size_type ix ) const { return m_vSeries.BlockEnd( ix ); };
+
+  // a rolling window for a segmented series:  drops the oldest block, once there is a full one,
+  //   returns the count dropped, 0 when contiguous, indexes and iterators shift down by that count
+  size_type DropOldestBlock( void ) {
+    if ( !m_vSeries.Segmented() || ( m_vSeries.size() < m_vSeries.BlockSize() ) ) return 0;
+    size_type n( m_vSeries.BlockSize() );
+    m_vSeries.pop_front_block();
+    m_vIterator = m_vSeries.end();
+    return n;
+  };
+
   // TSVariance, TSMA uses this, sets to false
   void DisableAppend( void ) { m_bAppendToVector = false; };
   bool AppendEnabled( void ) const { return m_bAppendToVector; };  // affects Append(...) only
@@ -248,7 +270,7 @@ void TimeSeries<T>::Insert( const ptime& dt, const T& datum ) {
   T key( dt );
   std::pair<iterator, iterator> p;
   //strict_lock<TimeSeries<T> > guard(*this);
-  p = equal_range( m_vSeries.begin(), m_vSeries.end(), key );
+  p = std::equal_range( m_vSeries.begin(), m_vSeries.end(), key );
   if ( m_vSeries.end() == p.second ) {
     m_vSeries.push_back( datum );
   }
@@ -261,7 +283,7 @@ template<typename T>
 void TimeSeries<T>::Insert( const T& datum ) {
   std::pair<iterator, iterator> p;
   //strict_lock<TimeSeries<T> > guard(*this);
-  p = equal_range( m_vSeries.begin(), m_vSeries.end(), datum );
+  p = std::equal_range( m_vSeries.begin(), m_vSeries.end(), datum );
   if ( m_vSeries.end() == p.second ) {
     m_vSeries.push_back( datum );
   }
@@ -350,7 +372,7 @@ typename TimeSeries<T>::const_reference TimeSeries<T>::At( const ptime& dt ) {
   // TODO: Check that this is correct
   T key( dt );
   std::pair<iterator, iterator> p;
-  p = equal_range( m_vSeries.begin(), m_vSeries.end(), key );
+  p = std::equal_range( m_vSeries.begin(), m_vSeries.end(), key );
 //  if ( p.first != p.second ) {
 //    m_vIterator = p.first;
 //  }
@@ -367,7 +389,7 @@ typename TimeSeries<T>::const_iterator TimeSeries<T>::AtOrAfter( const ptime &dt
   T key( dt );
   std::pair<const_iterator, const_iterator> p;
   //strict_lock<TimeSeries<T> > guard(*this);
-  p = equal_range( m_vSeries.begin(), m_vSeries.end(), key );
+  p = std::equal_range( m_vSeries.begin(), m_vSeries.end(), key );
 //  if ( p.first != p.second ) {
 //    m_vIterator = p.first;
 //  }
@@ -383,14 +405,14 @@ typename TimeSeries<T>::const_iterator TimeSeries<T>::After( const ptime &dt ) c
   T key( dt );
   std::pair<const_iterator, const_iterator> p;
   //strict_lock<TimeSeries<T> > guard(*this);
-  p = equal_range( m_vSeries.begin(), m_vSeries.end(), key );
+  p = std::equal_range( m_vSeries.begin(), m_vSeries.end(), key );
   return p.second;
 }
 
 template<typename T> 
 void TimeSeries<T>::Sort( void ) {
   //strict_lock<TimeSeries<T> > guard(*this);
-  sort( m_vSeries.begin(), m_vSeries.end() );  // may not keep time series with identical keys in acquired order (may not be an issue, as external clock is written to be monotonically increasing)
+  std::sort( m_vSeries.begin(), m_vSeries.end() );  // may not keep time series with identical keys in acquired order (may not be an issue, as external clock is written to be monotonically increasing)
 }
 
 template<typename T> 
@@ -399,7 +421,7 @@ TimeSeries<T>* TimeSeries<T>::Subset( const ptime &dt ) {
   TimeSeries<T>* series = nullptr;
   const_iterator iter;
   //strict_lock<TimeSeries<T> > guard(*this);
-  iter = lower_bound( m_vSeries.begin(), m_vSeries.end(), datum );
+  iter = std::lower_bound( m_vSeries.begin(), m_vSeries.end(), datum );
   if ( m_vSeries.end() != iter ) {
     series = new TimeSeries<T>( (unsigned int) (m_vSeries.end() - iter) );
     while ( m_vSeries.end() != iter ) {
@@ -419,7 +441,7 @@ TimeSeries<T>* TimeSeries<T>::Subset( const ptime &dt, unsigned int n ) { // n i
   TimeSeries<T>* series = NULL;
   const_iterator iter;
   //strict_lock<TimeSeries<T> > guard(*this);
-  iter = lower_bound( m_vSeries.begin(), m_vSeries.end(), datum );
+  iter = std::lower_bound( m_vSeries.begin(), m_vSeries.end(), datum );
   if ( m_vSeries.end() != iter ) {
     unsigned int todo = std::min<unsigned int>( n, (unsigned int) ( m_vSeries.end() - iter ) );
     series = new TimeSeries<T>( todo );
@@ -36,10 +36,12 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 # Object Files
 OBJECTFILES= \
 	${OBJECTDIR}/BarFactory.o \
+	${OBJECTDIR}/BarFactoryCascade.o \
 	${OBJECTDIR}/DatedDatum.o \
 	${OBJECTDIR}/DoubleBuffer.o \
 	${OBJECTDIR}/ExchangeHolidays.o \
 	${OBJECTDIR}/MergeDatedDatums.o \
+	${OBJECTDIR}/SessionCalendar.o \
 	${OBJECTDIR}/TSAllocator.o \
 	${OBJECTDIR}/TSMicrostructure.o \
 	${OBJECTDIR}/TimeSeries.o \
@@ -77,6 +79,11 @@ ${OBJECTDIR}/BarFactory.o: BarFactory.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/BarFactory.o BarFactory.cpp
 
+${OBJECTDIR}/BarFactoryCascade.o: BarFactoryCascade.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/BarFactoryCascade.o BarFactoryCascade.cpp
+
 ${OBJECTDIR}/DatedDatum.o: DatedDatum.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -97,6 +104,11 @@ ${OBJECTDIR}/MergeDatedDatums.o: MergeDatedDatums.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MergeDatedDatums.o MergeDatedDatums.cpp
 
+${OBJECTDIR}/SessionCalendar.o: SessionCalendar.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -D_DEBUG -I../ -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/SessionCalendar.o SessionCalendar.cpp
+
 ${OBJECTDIR}/TSAllocator.o: TSAllocator.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
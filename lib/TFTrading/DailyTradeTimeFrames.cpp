@@ -18,7 +18,35 @@
 
 namespace ou { // One Unified
 namespace tf { // TradeFrame
-  
+namespace TimeFrame {
+
+SessionCalendar::vOffset_t OffsetsUSEquity( void ) {
+  SessionCalendar::vOffset_t vOffset;
+  vOffset.push_back( boost::posix_time::time_duration(  7,  0,  0 ) );
+  vOffset.push_back( boost::posix_time::time_duration(  9, 30,  0 ) );
+  vOffset.push_back( boost::posix_time::time_duration(  9, 30, 30 ) );
+  vOffset.push_back( boost::posix_time::time_duration( 15, 57,  0 ) );
+  vOffset.push_back( boost::posix_time::time_duration( 15, 57, 15 ) );
+  vOffset.push_back( boost::posix_time::time_duration( 15, 58,  0 ) );
+  vOffset.push_back( boost::posix_time::time_duration( 16,  0,  0 ) );
+  vOffset.push_back( boost::posix_time::time_duration( 17, 30,  0 ) );
+  return vOffset;
+}
+
+SessionCalendar::vOffset_t OffsetsUS24HourFutures( void ) {
+  SessionCalendar::vOffset_t vOffset;
+  vOffset.push_back( boost::posix_time::time_duration( 17, 45,  0 ) - boost::posix_time::hours( 24 ) );  // evening before
+  vOffset.push_back( boost::posix_time::time_duration(  9, 30,  0 ) );
+  vOffset.push_back( boost::posix_time::time_duration(  9, 30, 30 ) );
+  vOffset.push_back( boost::posix_time::time_duration( 15, 57,  0 ) );
+  vOffset.push_back( boost::posix_time::time_duration( 15, 57, 15 ) );
+  vOffset.push_back( boost::posix_time::time_duration( 15, 58,  0 ) );
+  vOffset.push_back( boost::posix_time::time_duration( 16,  0,  0 ) );
+  vOffset.push_back( boost::posix_time::time_duration( 17, 15,  0 ) );
+  return vOffset;
+}
+
+} // namespace TimeFrame
 
 } // namespace tf
 } // namespace ou
@@ -14,15 +14,24 @@
 
 #pragma once
 
+#include <stdexcept>
+
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include <OUCommon/TimeSource.h>
 
+#include <TFTimeSeries/SessionCalendar.h>
+
 namespace ou { // One Unified
 namespace tf { // TradeFrame
 
 namespace TimeFrame {
   enum enumTimeFrame { Closed, PreRH, BellHeard, PauseForQuotes, RHTrading, Cancel, Cancelling, GoNeutral, GoingNeutral, WaitForRHClose, AfterRH };
+
+  // SessionCalendar boundaries, in the order of InitFromCalendar:
+  //   market open, rh open, start trading, cancellation, go neutral, wait for rh close, rh close, market close
+  SessionCalendar::vOffset_t OffsetsUSEquity( void );  // as InitForUSEquityExchanges
+  SessionCalendar::vOffset_t OffsetsUS24HourFutures( void );  // as InitForUS24HourFutures, but from the trading day
 }
 
 // 20121223 note a weakness in the statemachine: assumes continuous quotes to update statemachine
@@ -38,6 +47,7 @@ public:
 
   DailyTradeTimeFrame(void); // uses today's date
   DailyTradeTimeFrame( boost::gregorian::date );  // simulation date
+  DailyTradeTimeFrame( const SessionCalendar&, boost::gregorian::date );  // trading day
   virtual ~DailyTradeTimeFrame(void) {};
 
   template<typename DD>  // DD is DatedDatum construct
@@ -49,6 +59,7 @@ public:
   }
 
   void InitForUS24HourFutures( boost::gregorian::date date );
+  void InitFromCalendar( const SessionCalendar&, boost::gregorian::date );  // no time zone conversions, date is to be a trading day
 
   void SetMarketOpen( boost::posix_time::ptime dtMarketOpen ) { m_dtMarketOpen = dtMarketOpen; };
   void SetRegularHoursOpen( boost::posix_time::ptime dtRHOpen ) { m_dtRHOpen = dtRHOpen; };
@@ -114,6 +125,13 @@ DailyTradeTimeFrame<T>::DailyTradeTimeFrame( boost::gregorian::date date )
   InitForUSEquityExchanges( date );
 };
 
+template<class T>
+DailyTradeTimeFrame<T>::DailyTradeTimeFrame( const SessionCalendar& calendar, boost::gregorian::date date ) 
+  : m_stateTimeFrame( TimeFrame::Closed )
+{
+  InitFromCalendar( calendar, date );
+};
+
 template<class T>
 void DailyTradeTimeFrame<T>::InitForUSEquityExchanges( boost::gregorian::date date ) {
   m_dtMarketOpen          = Normalize( date, boost::posix_time::time_duration(  7,  0,  0 ), "America/New_York" );
@@ -151,6 +169,22 @@ void DailyTradeTimeFrame<T>::InitForUS24HourFutures( boost::gregorian::date date
   m_dtMarketClose         = Normalize( date + boost::gregorian::date_duration(1), boost::posix_time::time_duration( 17, 15,  0 ), "America/New_York" );
 }
 
+template<class T>
+void DailyTradeTimeFrame<T>::InitFromCalendar( const SessionCalendar& calendar, boost::gregorian::date date ) {
+  assert( 8 == calendar.Boundaries() );
+  if ( !calendar.IsTradingDay( date ) ) {
+    throw std::runtime_error( "DailyTradeTimeFrame::InitFromCalendar: not a trading day" );
+  }
+  m_dtMarketOpen          = calendar.Boundary( date, 0 );
+  m_dtRHOpen              = calendar.Boundary( date, 1 );
+  m_dtStartTrading        = calendar.Boundary( date, 2 );
+  m_dtTimeForCancellation = calendar.Boundary( date, 3 );
+  m_dtGoNeutral           = calendar.Boundary( date, 4 );
+  m_dtWaitForRHClose      = calendar.Boundary( date, 5 );
+  m_dtRHClose             = calendar.Boundary( date, 6 );
+  m_dtMarketClose         = calendar.Boundary( date, 7 );
+}
+
 template<class T>
 template<typename DD>
 void DailyTradeTimeFrame<T>::TimeTick( DD& dd ) {  // DD is DatedDatum
@@ -89,6 +89,7 @@ void InstrumentData::SaveSeries( const std::string& sPrefix ) {
   std::string sPathName;
 
 //  CHDF5Attributes::structFuture future( m_pInstrument->GetExpiryYear(), m_pInstrument->GetExpiryMonth(), m_pInstrument->GetExpiryDay() );
+  ou::tf::HDF5DataManager::mutex_t::scoped_lock lock( ou::tf::HDF5DataManager::Mutex() );
   ou::tf::HDF5DataManager dm( ou::tf::HDF5DataManager::RDWR );
 
   if ( 0 != m_quotes.Size() ) {
@@ -13,6 +13,9 @@
 
 #include "stdafx.h"
 
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
 #include <OUCommon/TimeSource.h>
 
 #include "OrderManager.h"
@@ -24,13 +27,262 @@ namespace tf { // TradeFrame
 // OrderManager
 //
 
+namespace OrderManagerQueries {
+  // structures are bound by value, so they survive until the journal gets to them
+  template<class F>
+  void Write( ou::db::Session* pSession, const std::string& sSql, F f ) {
+    pSession->SQLCached<F>( sSql, f );
+  }
+  template<class F>
+  void Insert( ou::db::Session* pSession, F f ) {
+    pSession->InsertCached<F>( f );
+  }
+}
+
 OrderManager::OrderManager(void) 
-//: 
+: m_bWriteBehind( false ), m_bJournalStop( false ), m_bJournalBusy( false ), m_bJournalRunning( false ),
+  m_cntJournalFailures( 0 ), m_cntJournalDropped( 0 ), m_pThreadJournal( 0 ), m_pSessionJournal( 0 )
 //   m_orderIds( Trading::DbFileName, "OrderId" )  // need to remove dependency on DB4 and migrate to sql
 {
 }
 
 OrderManager::~OrderManager(void) {
+  EnableWriteBehind( false );
+}
+
+void OrderManager::EnableWriteBehind( bool bEnable ) {
+  if ( bEnable ) {
+    if ( 0 == m_pThreadJournal ) {
+      if ( 0 == m_pSession ) {
+        throw std::runtime_error( "OrderManager::EnableWriteBehind: no session" );
+      }
+      const std::string sDbFileName( m_pSession->DbFileName() );
+      if ( sDbFileName.empty() || !boost::filesystem::exists( sDbFileName ) ) {
+        throw std::runtime_error( "OrderManager::EnableWriteBehind: session has no database file" );
+      }
+      // the session is not thread safe, so the journal has a connection of its own
+      ou::db::Session* pSession( new ou::db::Session );
+      try {
+        pSession->ImplOpen( sDbFileName );
+        HandleRegisterRows( *pSession );
+      }
+      catch (...) {
+        delete pSession;
+        throw;
+      }
+      boost::mutex::scoped_lock lock( m_mutexJournal );
+      m_pSessionJournal = pSession;
+      m_bJournalStop = false;
+      m_bJournalRunning = true;
+      m_bWriteBehind = true;
+      m_pThreadJournal = new boost::thread( boost::bind( &OrderManager::Journal, this ) );
+    }
+  }
+  else {
+    if ( 0 != m_pThreadJournal ) {
+      {
+        boost::mutex::scoped_lock lock( m_mutexJournal );
+        m_bJournalStop = true;  // writes continue to be queued until the thread has drained the queue
+        m_cvJournalWork.notify_one();
+      }
+      m_pThreadJournal->join();
+      delete m_pThreadJournal;
+      m_pThreadJournal = 0;
+      boost::mutex::scoped_lock lock( m_mutexJournal );
+      m_bWriteBehind = false;  // from here, writes are direct
+      delete m_pSessionJournal;
+      m_pSessionJournal = 0;
+      if ( !m_dequeJournal.empty() && ( 0 != m_pSession ) ) {
+        // queued after the thread exited, or not written by it
+        try {
+          WriteQueued();
+        }
+        catch ( std::exception& e ) {
+          std::cout << "OrderManager::EnableWriteBehind:  " << e.what() << std::endl;
+        }
+      }
+    }
+  }
+}
+
+bool OrderManager::FlushJournal( void ) {
+  boost::mutex::scoped_lock lock( m_mutexJournal );
+  size_t cntFailures( m_cntJournalFailures );
+  while ( m_bJournalRunning && ( cntFailures == m_cntJournalFailures ) && ( !m_dequeJournal.empty() || m_bJournalBusy ) ) {
+    m_cvJournalIdle.wait( lock );
+  }
+  return m_dequeJournal.empty() && !m_bJournalBusy && ( cntFailures == m_cntJournalFailures );
+}
+
+size_t OrderManager::JournalDropped( void ) {
+  boost::mutex::scoped_lock lock( m_mutexJournal );
+  return m_cntJournalDropped;
+}
+
+void OrderManager::Persist( fJournalEntry_t f ) {
+  boost::mutex::scoped_lock lock( m_mutexJournal );
+  m_dequeJournal.push_back( f );
+  if ( m_bWriteBehind ) {
+    m_cvJournalWork.notify_one();
+  }
+  else {
+    WriteQueued();  // anything the journal left is written first
+  }
+}
+
+void OrderManager::WriteQueued( void ) {
+  static const size_t nRetries( 3 );  // for a lock held elsewhere
+  size_t cntRetries( 0 );
+  size_t cntDropped( 0 );
+  std::string sError;
+  boost::mutex::scoped_lock lockSession( m_mutexSession );
+  while ( !m_dequeJournal.empty() ) {
+    bool bFailed( false );
+    try {
+      m_dequeJournal.front()( m_pSession );
+    }
+    catch ( std::exception& e ) {
+      bFailed = true;
+      sError = e.what();
+    }
+    catch (...) {
+      bFailed = true;
+      sError = "unknown error";
+    }
+    if ( bFailed ) {
+      if ( m_pSession->IsBusy() && ( nRetries > cntRetries ) ) {
+        ++cntRetries;
+        boost::this_thread::sleep( boost::posix_time::milliseconds( 100 ) );
+        continue;
+      }
+      // dropped rather than left at the front, where it would fail every later write
+      std::cout << "OrderManager::WriteQueued:  write dropped: " << sError << std::endl;
+      ++m_cntJournalDropped;
+      ++cntDropped;
+    }
+    cntRetries = 0;
+    m_dequeJournal.pop_front();
+  }
+  if ( 0 != cntDropped ) {
+    throw std::runtime_error( 
+      "OrderManager::WriteQueued: " + boost::lexical_cast<std::string>( cntDropped ) + " writes dropped, last: " + sError );
+  }
+}
+
+void OrderManager::Journal( void ) {
+  static const size_t nRetries( 3 );  // for a lock held elsewhere
+  size_t cntRetries( 0 );
+  boost::mutex::scoped_lock lock( m_mutexJournal );
+  while ( true ) {
+    while ( m_dequeJournal.empty() && !m_bJournalStop ) {
+      m_cvJournalWork.wait( lock );
+    }
+    if ( m_dequeJournal.empty() ) break;  // stopped, and nothing remaining
+    dequeJournal_t dequeBatch;
+    dequeBatch.swap( m_dequeJournal );
+    m_bJournalBusy = true;
+    lock.unlock();
+    bool bBusy( false );
+    bool bCommitted = JournalBatch( dequeBatch, bBusy );
+    bool bRetry( !bCommitted && bBusy && ( nRetries > cntRetries ) );
+    if ( !bCommitted && !bRetry ) {
+      JournalSingly( dequeBatch );  // isolates the failing writes, so the remainder are not held up by them
+    }
+    lock.lock();
+    m_bJournalBusy = false;
+    if ( bCommitted || !bRetry ) {
+      cntRetries = 0;
+    }
+    if ( !bCommitted ) {
+      ++m_cntJournalFailures;
+      m_cvJournalIdle.notify_all();  // FlushJournal returns on a failure
+    }
+    if ( bRetry ) {
+      // back ahead of anything queued meanwhile, so the order of writes is kept
+      m_dequeJournal.insert( m_dequeJournal.begin(), dequeBatch.begin(), dequeBatch.end() );
+      ++cntRetries;
+      boost::system_time tRetry( boost::get_system_time() + boost::posix_time::seconds( 1 ) );
+      while ( !m_bJournalStop && m_cvJournalWork.timed_wait( lock, tRetry ) ) {}  // a pause before the retry
+    }
+    m_cvJournalIdle.notify_all();
+  }
+  m_bJournalRunning = false;
+  m_cvJournalIdle.notify_all();
+}
+
+bool OrderManager::JournalBatch( dequeJournal_t& dequeBatch, bool& bBusy ) {
+  // one transaction for the batch:  one sync to disk rather than one per statement,
+  //   and the batch is either completely in the database, or not at all
+  m_vExecutionWritten.clear();
+  bBusy = false;
+  try {
+    m_pSessionJournal->BeginTransaction();
+    try {
+      for ( dequeJournal_t::iterator iter = dequeBatch.begin(); dequeBatch.end() != iter; ++iter ) {
+        ( *iter )( m_pSessionJournal );
+      }
+      m_pSessionJournal->CommitTransaction();
+    }
+    catch (...) {
+      bBusy = m_pSessionJournal->IsBusy();  // before the rollback replaces the error
+      try {
+        m_pSessionJournal->RollbackTransaction();
+      }
+      catch (...) {
+        // sqlite will have already rolled back on some errors
+      }
+      throw;
+    }
+  }
+  catch ( std::exception& e ) {
+    std::cout << "OrderManager::Journal:  batch of " << dequeBatch.size() << " rolled back: " << e.what() << std::endl;
+    m_vExecutionWritten.clear();
+    return false;
+  }
+  catch (...) {
+    std::cout << "OrderManager::Journal:  batch of " << dequeBatch.size() << " rolled back" << std::endl;
+    m_vExecutionWritten.clear();
+    return false;
+  }
+  if ( !m_vExecutionWritten.empty() ) {
+    boost::mutex::scoped_lock lockSession( m_mutexSession );
+    for ( vExecutionWritten_t::iterator iter = m_vExecutionWritten.begin(); m_vExecutionWritten.end() != iter; ++iter ) {
+      iter->pmapExecutions->insert( pairExecution_t( iter->idExecution, iter->pExecution ) );
+    }
+    m_vExecutionWritten.clear();
+  }
+  return true;
+}
+
+void OrderManager::JournalSingly( dequeJournal_t& dequeBatch ) {
+  static const size_t nRetries( 3 );  // for a lock held elsewhere
+  for ( dequeJournal_t::iterator iter = dequeBatch.begin(); dequeBatch.end() != iter; ++iter ) {
+    dequeJournal_t dequeOne( 1, *iter );
+    bool bBusy( false );
+    size_t cntRetries( 0 );
+    while ( !JournalBatch( dequeOne, bBusy ) ) {
+      if ( !bBusy || ( nRetries <= cntRetries ) ) {
+        std::cout << "OrderManager::Journal:  write dropped" << std::endl;
+        boost::mutex::scoped_lock lock( m_mutexJournal );
+        ++m_cntJournalDropped;
+        break;
+      }
+      ++cntRetries;
+      boost::this_thread::sleep( boost::posix_time::milliseconds( 100 ) );
+    }
+  }
+}
+
+void OrderManager::WriteExecution( ou::db::Session* pSession, pExecution_t pExecution, pmapExecutions_t pmapExecutions ) {
+  pSession->InsertCached<Execution::TableRowDefNoKey>( 
+    const_cast<Execution::TableRowDefNoKey&>( dynamic_cast<const Execution::TableRowDefNoKey&>( pExecution->GetRow() ) ) );
+  idExecution_t idExecution = pSession->GetLastRowId();
+  if ( m_pSessionJournal == pSession ) {
+    m_vExecutionWritten.push_back( ExecutionWritten( idExecution, pExecution, pmapExecutions ) );  // the batch may yet roll back
+  }
+  else {
+    pmapExecutions->insert( pairExecution_t( idExecution, pExecution ) );  // m_mutexSession is held by WriteQueued
+  }
 }
 
 Order::idOrder_t OrderManager::CheckOrderId( idOrder_t id ) {
@@ -97,8 +349,7 @@ void OrderManager::ConstructOrder( pOrder_t& pOrder ) {
       if ( 0 != m_pSession ) {
         // add to database
         assert( 0 != pOrder->GetRow().idPosition );
-        ou::db::QueryFields<Order::TableRowDef>::pQueryFields_t pQuery
-          = m_pSession->Insert<Order::TableRowDef>( const_cast<Order::TableRowDef&>( pOrder->GetRow() ) );
+        Persist( boost::bind( &OrderManagerQueries::Insert<Order::TableRowDef>, _1, pOrder->GetRow() ) );
       }
     }
   }
@@ -136,9 +387,8 @@ void OrderManager::PlaceOrder(ProviderInterfaceBase *pProvider, pOrder_t pOrder)
       if ( 0 != m_pSession ) {
         OrderManagerQueries::UpdateAtPlaceOrder 
           update( pOrder->GetOrderId(), pOrder->GetRow().eOrderStatus, pOrder->GetRow().dtOrderSubmitted );
-        ou::db::QueryFields<OrderManagerQueries::UpdateAtPlaceOrder>::pQueryFields_t pQuery
-          = m_pSession->SQL<OrderManagerQueries::UpdateAtPlaceOrder>( // todo:  cache this query
-            "update orders set orderstatus=?, datetimesubmitted=?", update ).Where( "orderid=?" );
+        Persist( boost::bind( &OrderManagerQueries::Write<OrderManagerQueries::UpdateAtPlaceOrder>, _1,
+          std::string( "update orders set orderstatus=?, datetimesubmitted=? where orderid=?" ), update ) );
       }
     }
     else {
@@ -181,6 +431,7 @@ bool OrderManager::LocateOrder( idOrder_t nOrderId, iterOrders_t& iter ) {
   else {
     // check in database first, and if found, load order and executions
     if ( 0 != m_pSession ) {
+      boost::mutex::scoped_lock lock( m_mutexSession );
       OrderManagerQueries::OrderKey keyOrder( nOrderId );
       ou::db::QueryFields<OrderManagerQueries::OrderKey>::pQueryFields_t pOrderExistsQuery
         = m_pSession->SQL<OrderManagerQueries::OrderKey>( "select * from orders", keyOrder ).Where( "orderid=?" ).NoExecute();
@@ -264,9 +515,8 @@ void OrderManager::ReportCancellation( idOrder_t nOrderId ) {
       if ( 0 != m_pSession ) {
         OrderManagerQueries::UpdateAtOrderClose 
           close( pOrder->GetOrderId(), pOrder->GetRow().eOrderStatus, pOrder->GetRow().dtOrderClosed );
-        ou::db::QueryFields<OrderManagerQueries::UpdateAtOrderClose>::pQueryFields_t pQuery
-          = m_pSession->SQL<OrderManagerQueries::UpdateAtOrderClose>( // todo:  cache this query
-            "update orders set orderstatus=?, datetimeclosed=?", close ).Where( "orderid=?" );
+        Persist( boost::bind( &OrderManagerQueries::Write<OrderManagerQueries::UpdateAtOrderClose>, _1,
+          std::string( "update orders set orderstatus=?, datetimeclosed=? where orderid=?" ), close ) );
       }
     }
     else {
@@ -302,7 +552,7 @@ namespace OrderManagerQueries {
       dblAverageFillPrice( dblAverageFillPrice_ ), dtClosed( dtClosed_ ) {};
   };
 
-  std::string sUpdateOrderQuery( "update orders set orderstatus=?, quantityremaining=?, quantityfilled=?, averagefillprice=?, datetimeclosed=?" );
+  std::string sUpdateOrderQuery( "update orders set orderstatus=?, quantityremaining=?, quantityfilled=?, averagefillprice=?, datetimeclosed=? where orderid=?" );
 }
 
 void OrderManager::ReportExecution( idOrder_t nOrderId, const Execution& exec) { 
@@ -319,30 +569,24 @@ void OrderManager::ReportExecution( idOrder_t nOrderId, const Execution& exec) {
           {
             OrderManagerQueries::UpdateOrder 
               order( nOrderId, row.eOrderStatus, row.nQuantityRemaining, row.nQuantityFilled, row.dblAverageFillPrice, ou::TimeSource::LocalCommonInstance().Internal() );
-            ou::db::QueryFields<OrderManagerQueries::UpdateOrder>::pQueryFields_t pQuery
-              = m_pSession->SQL<OrderManagerQueries::UpdateOrder>( // todo:  cache this query
-              OrderManagerQueries::sUpdateOrderQuery, order ).Where( "orderid=?" );
+            Persist( boost::bind( &OrderManagerQueries::Write<OrderManagerQueries::UpdateOrder>, _1,
+              OrderManagerQueries::sUpdateOrderQuery, order ) );
           }
           break;
         default:
           {
             OrderManagerQueries::UpdateOrder 
               order( nOrderId, row.eOrderStatus, row.nQuantityRemaining, row.nQuantityFilled, row.dblAverageFillPrice );
-            ou::db::QueryFields<OrderManagerQueries::UpdateOrder>::pQueryFields_t pQuery
-              = m_pSession->SQL<OrderManagerQueries::UpdateOrder>( // todo:  cache this query
-              OrderManagerQueries::sUpdateOrderQuery, order ).Where( "orderid=?" );
+            Persist( boost::bind( &OrderManagerQueries::Write<OrderManagerQueries::UpdateOrder>, _1,
+              OrderManagerQueries::sUpdateOrderQuery, order ) );
           }
           break;
         }
         // add execution record
         pExecution_t pExecution( new Execution( exec ) );
         pExecution->SetOrderId( nOrderId );
-        ou::db::QueryFields<Execution::TableRowDefNoKey>::pQueryFields_t pQueryExecutionWrite
-          = m_pSession->Insert<Execution::TableRowDefNoKey>( 
-            const_cast<Execution::TableRowDefNoKey&>( dynamic_cast<const Execution::TableRowDefNoKey&>( pExecution->GetRow() ) ) );
-        idExecution_t idExecution = m_pSession->GetLastRowId();
-        pairExecution_t pair( idExecution, pExecution );
-        iter->second.pmapExecutions->insert( pair );
+        // keyed by the row id, so recorded in the map once written
+        Persist( boost::bind( &OrderManager::WriteExecution, this, _1, pExecution, iter->second.pmapExecutions ) );
       }
   //    switch ( status ) {
   //      case OrderStatus::Filled:
@@ -381,9 +625,8 @@ void OrderManager::ReportCommission( idOrder_t nOrderId, double dblCommission )
       if ( 0 != m_pSession ) {
         OrderManagerQueries::UpdateCommission 
           commission( pOrder->GetOrderId(), dblCommission );
-        ou::db::QueryFields<OrderManagerQueries::UpdateCommission>::pQueryFields_t pQuery
-          = m_pSession->SQL<OrderManagerQueries::UpdateCommission>( // todo:  cache this query
-            "update orders set commission=?", commission ).Where( "orderid=?" );
+        Persist( boost::bind( &OrderManagerQueries::Write<OrderManagerQueries::UpdateCommission>, _1,
+          std::string( "update orders set commission=? where orderid=?" ), commission ) );
       }
       pOrder->SetCommission( dblCommission );  // need to do afterwards as delegated objects may query the db (other stuff above may not obey this format)
       // as a result, may need to set delegates here so database is updated before order calls delegates.
@@ -423,9 +666,8 @@ void OrderManager::ReportErrors( idOrder_t nOrderId, OrderErrors::enumOrderError
       if ( 0 != m_pSession ) {
         OrderManagerQueries::UpdateOnOrderError 
           error( pOrder->GetOrderId(), pOrder->GetRow().eOrderStatus, pOrder->GetRow().dtOrderClosed );
-        ou::db::QueryFields<OrderManagerQueries::UpdateOnOrderError>::pQueryFields_t pQuery
-          = m_pSession->SQL<OrderManagerQueries::UpdateOnOrderError>( // todo:  cache this query
-            "update orders set orderstatus=?, datetimeclosed=?", error ).Where( "orderid=?" );
+        Persist( boost::bind( &OrderManagerQueries::Write<OrderManagerQueries::UpdateOnOrderError>, _1,
+          std::string( "update orders set orderstatus=?, datetimeclosed=? where orderid=?" ), error ) );
       }
     }
     else {
@@ -464,6 +706,7 @@ void OrderManager::DetachFromSession( ou::db::Session* pSession ) {
   pSession->OnRegisterTables.Remove( MakeDelegate( this, &OrderManager::HandleRegisterTables ) );
   pSession->OnRegisterRows.Remove( MakeDelegate( this, &OrderManager::HandleRegisterRows ) );
   pSession->OnPopulate.Remove( MakeDelegate( this, &OrderManager::HandlePopulateTables ) );
+  EnableWriteBehind( false );  // drained while the session is still attached
   ManagerBase::DetachFromSession( pSession );
 }
 
@@ -17,9 +17,13 @@
 // At some point, make order manager responsible for constructing Order
 
 #include <map>
+#include <deque>
 #include <vector>
 #include <stdexcept>
 
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+
 #include <OUCommon/Delegate.h>
 #include <OUCommon/ManagerBase.h>
 
@@ -94,6 +98,18 @@ public:
   void AttachToSession( ou::db::Session* pSession );
   void DetachFromSession( ou::db::Session* pSession );
 
+  // write-behind:  database writes are queued to a journal thread rather than run on the provider's callback thread.
+  //   The thread writes through its own connection to the session's database file, so the session itself
+  //   remains with the threads already using it.  The in-memory orders remain authoritative.
+  //   The thread applies whatever has accumulated as one transaction.  When the transaction fails, it is rolled back.
+  //   A batch which failed on a lock held elsewhere remains queued, ahead of later writes, and is retried a few times.
+  //   Otherwise the batch is written one write per transaction, so only the writes which fail are dropped, and counted.
+  //   The journal is drained on disable, on detach from the session, and on destruction, before writes become direct.
+  //   Writes the journal could not complete are then written, in order, ahead of the next direct write.
+  void EnableWriteBehind( bool bEnable = true );  // throws std::runtime_error when the session has no database file
+  bool FlushJournal( void );  // returns once everything queued so far is in the database, false on a failed batch
+  size_t JournalDropped( void );  // writes which failed, and were not retried further
+
 protected:
 
   typedef std::pair<idExecution_t, pExecution_t> pairExecution_t;
@@ -142,6 +158,43 @@ private:
 
   void ConstructOrder( pOrder_t& pOrder );
 
+  typedef boost::function<void( ou::db::Session* )> fJournalEntry_t;  // written to the session supplied
+  typedef std::deque<fJournalEntry_t> dequeJournal_t;
+
+  struct ExecutionWritten {
+    idExecution_t idExecution;
+    pExecution_t pExecution;
+    pmapExecutions_t pmapExecutions;
+    ExecutionWritten( idExecution_t idExecution_, pExecution_t pExecution_, pmapExecutions_t pmapExecutions_ )
+      : idExecution( idExecution_ ), pExecution( pExecution_ ), pmapExecutions( pmapExecutions_ ) {};
+  };
+  typedef std::vector<ExecutionWritten> vExecutionWritten_t;
+
+  boost::mutex m_mutexSession;  // serializes direct writes with disk lookups, and guards pmapExecutions while writing
+
+  // all guarded by m_mutexJournal
+  bool m_bWriteBehind;
+  bool m_bJournalStop;
+  bool m_bJournalBusy;  // a batch is being written
+  bool m_bJournalRunning;
+  size_t m_cntJournalFailures;  // batches rolled back
+  size_t m_cntJournalDropped;  // writes abandoned after failing
+  boost::mutex m_mutexJournal;
+  boost::condition_variable m_cvJournalWork;
+  boost::condition_variable m_cvJournalIdle;
+  dequeJournal_t m_dequeJournal;
+  boost::thread* m_pThreadJournal;
+  ou::db::Session* m_pSessionJournal;  // the journal thread's connection
+
+  vExecutionWritten_t m_vExecutionWritten;  // journal thread only, in the open transaction, mapped once committed
+
+  void Persist( fJournalEntry_t f );  // runs now, or queues to the journal when write-behind is enabled
+  void WriteQueued( void );  // with m_mutexJournal held, writes the queue directly, throws once done if a write was dropped
+  void Journal( void );  // journal thread
+  bool JournalBatch( dequeJournal_t& dequeBatch, bool& bBusy );  // true when committed, bBusy when a retry may succeed
+  void JournalSingly( dequeJournal_t& dequeBatch );  // one transaction per write, failing writes are dropped
+  void WriteExecution( ou::db::Session* pSession, pExecution_t pExecution, pmapExecutions_t pmapExecutions );
+
   void HandleRegisterTables( ou::db::Session& session );
   void HandleRegisterRows( ou::db::Session& session );
   void HandlePopulateTables( ou::db::Session& session );
@@ -14,6 +14,7 @@
 
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
 
 #include "Portfolio.h"
 
@@ -29,6 +30,8 @@
 namespace ou { // One Unified
 namespace tf { // TradeFrame
 
+boost::atomic<unsigned int> Portfolio::m_nStructureVersion( 1 );  // a new portfolio, at 0, flattens on its first sum
+
 
 //Portfolio::Portfolio( // in memory
 //  const idPortfolio_t& idPortfolio, EPortfolioType ePortfolioType, currency_t sCurrency, const std::string& sDescription ) 
@@ -50,7 +53,9 @@ Portfolio::Portfolio( // portfolio record
   const idPortfolio_t& idPortfolio, const idAccountOwner_t& idAccountOwner, const idPortfolio_t& idOwner,
    EPortfolioType ePortfolioType, currency_t sCurrency, const std::string& sDescription ) 
 : m_row( idPortfolio, idAccountOwner, idOwner, ePortfolioType, sCurrency, sDescription ),
-  m_bCanUseDb( true )
+  m_bCanUseDb( true ),
+  m_eUnRealizedPLMode( UnRealizedPerQuote ), m_tdUnRealizedPLCadence( boost::posix_time::milliseconds( 250 ) ),
+  m_nFlatVersion( 0 )
 {
   bool bOk = true;
   if ( "" == idPortfolio ) bOk = false;
@@ -62,7 +67,9 @@ Portfolio::Portfolio( // portfolio record
 }
 
 Portfolio::Portfolio( const TableRowDef& row ) 
-  : m_row( row ), m_bCanUseDb( true )
+  : m_row( row ), m_bCanUseDb( true ),
+  m_eUnRealizedPLMode( UnRealizedPerQuote ), m_tdUnRealizedPLCadence( boost::posix_time::milliseconds( 250 ) ),
+  m_nFlatVersion( 0 )
 {
   m_plCurrent.dblCommissionsPaid = m_row.dblCommissionsPaid;
   m_plCurrent.dblRealized = m_row.dblRealizedPL;
@@ -92,10 +99,14 @@ Portfolio::pPosition_t Portfolio::AddPosition( const std::string &sName, pPositi
   m_mapPositionsViaUserName.insert( mapPositions_pair_t( sName, pPosition ) );
   m_mapPositionsViaInstrumentName.insert( mapPositions_pair_t( sInstrumentName, pPosition ) );
 
-  pPosition->OnUnRealizedPL.Add( MakeDelegate( this, &Portfolio::HandleUnRealizedPL ) );
+  if ( UnRealizedPerQuote == m_eUnRealizedPLMode ) {
+    pPosition->OnUnRealizedPL.Add( MakeDelegate( this, &Portfolio::HandleUnRealizedPL ) );
+  }
   pPosition->OnExecution.Add( MakeDelegate( this, &Portfolio::HandleExecution ) );
   pPosition->OnCommission.Add( MakeDelegate( this, &Portfolio::HandleCommission ) );
 
+  ++m_nStructureVersion;
+
   return pPosition;
 }
 
@@ -114,11 +125,15 @@ void Portfolio::DeletePosition( const std::string& sName ) {
 
   iterUser->second->OnCommission.Remove( MakeDelegate( this, &Portfolio::HandleCommission ) );
   iterUser->second->OnExecution.Remove( MakeDelegate( this, &Portfolio::HandleExecution ) );
-  iterUser->second->OnUnRealizedPL.Remove( MakeDelegate( this, &Portfolio::HandleUnRealizedPL ) );
+  if ( UnRealizedPerQuote == m_eUnRealizedPLMode ) {
+    iterUser->second->OnUnRealizedPL.Remove( MakeDelegate( this, &Portfolio::HandleUnRealizedPL ) );
+  }
 
   m_mapPositionsViaUserName.erase( iterUser );
   m_mapPositionsViaInstrumentName.erase( iterInst );
 
+  ++m_nStructureVersion;
+
 }
 
 void Portfolio::RenamePosition( const std::string& sOld, const std::string& sNew ) {
@@ -153,6 +168,8 @@ Portfolio::pPosition_t Portfolio::GetPosition( const std::string& sName ) {
 // not used
 void Portfolio::ReCalc( void ) {
 
+  boost::mutex::scoped_lock lock( m_mutexPL );
+
   m_plCurrent.Zero();
 
   for ( mapPositions_iter_t iter = m_mapPositionsViaUserName.begin(); iter != m_mapPositionsViaUserName.end(); ++iter ) {
@@ -196,6 +213,10 @@ void Portfolio::AddSubPortfolio( pPortfolio_t& pPortfolio ) {
     pPortfolio->OnCommission.Add( MakeDelegate( this, &Portfolio::HandleCommission ) );
     pPortfolio->OnExecution.Add( MakeDelegate( this, &Portfolio::HandleExecution ) );
     pPortfolio->OnUnRealizedPL.Add( MakeDelegate( this, &Portfolio::HandleUnRealizedPL ) );
+
+    pPortfolio->SetUnRealizedPLMode( m_eUnRealizedPLMode );
+
+    ++m_nStructureVersion;
   }
 }
 
@@ -214,6 +235,108 @@ void Portfolio::RemoveSubPortfolio( const idPortfolio_t& idPortfolio ) {
   pPortfolio->OnUnRealizedPL.Add( MakeDelegate( this, &Portfolio::HandleUnRealizedPL ) );
 
   m_mapSubPortfolios.erase( iter );
+
+  ++m_nStructureVersion;
+}
+
+void Portfolio::SetUnRealizedPLMode( EUnRealizedPLMode mode ) {
+  if ( ( UnRealizedPerQuote == mode ) && ( UnRealizedCoalesced == m_eUnRealizedPLMode ) ) {
+    ReSumUnRealizedPL();  // totals are brought current, for the deltas to carry on from
+  }
+  ApplyUnRealizedPLMode( mode );
+}
+
+void Portfolio::ApplyUnRealizedPLMode( EUnRealizedPLMode mode ) {
+  if ( mode != m_eUnRealizedPLMode ) {
+    for ( mapPositions_iter_t iter = m_mapPositionsViaUserName.begin(); m_mapPositionsViaUserName.end() != iter; ++iter ) {
+      if ( UnRealizedCoalesced == mode ) {
+        iter->second->OnUnRealizedPL.Remove( MakeDelegate( this, &Portfolio::HandleUnRealizedPL ) );
+      }
+      else {
+        iter->second->OnUnRealizedPL.Add( MakeDelegate( this, &Portfolio::HandleUnRealizedPL ) );
+      }
+    }
+    m_eUnRealizedPLMode = mode;
+  }
+  for ( mapPortfolios_iter_t iter = m_mapSubPortfolios.begin(); m_mapSubPortfolios.end() != iter; ++iter ) {
+    iter->second->ApplyUnRealizedPLMode( mode );
+  }
+}
+
+void Portfolio::Flatten( void ) {
+  m_nFlatVersion = m_nStructureVersion.load( boost::memory_order_acquire );  // taken first, a change during the walk shows up next time
+  m_vFlatPosition.clear();
+  m_vFlatPositionOwner.clear();
+  m_vFlatPortfolio.clear();
+  m_vFlatPortfolioOwner.clear();
+  Flatten( this, 0 );  // the top is its own owner, and is not summed into anything
+  m_vFlatUnRealized.assign( m_vFlatPortfolio.size(), 0.0 );
+}
+
+void Portfolio::Flatten( Portfolio* pPortfolio, size_t ixOwner ) {
+  size_t ix( m_vFlatPortfolio.size() );
+  m_vFlatPortfolio.push_back( pPortfolio );
+  m_vFlatPortfolioOwner.push_back( ixOwner );
+  for ( mapPositions_iter_t iter = pPortfolio->m_mapPositionsViaUserName.begin(); pPortfolio->m_mapPositionsViaUserName.end() != iter; ++iter ) {
+    m_vFlatPosition.push_back( iter->second.get() );
+    m_vFlatPositionOwner.push_back( ix );
+  }
+  for ( mapPortfolios_iter_t iter = pPortfolio->m_mapSubPortfolios.begin(); pPortfolio->m_mapSubPortfolios.end() != iter; ++iter ) {
+    Flatten( iter->second.get(), ix );
+  }
+}
+
+bool Portfolio::ReSumUnRealizedPL( const boost::posix_time::ptime& dtNow ) {
+  if ( !m_dtUnRealizedPLSummed.is_not_a_date_time() && ( m_tdUnRealizedPLCadence > ( dtNow - m_dtUnRealizedPLSummed ) ) ) {
+    return false;
+  }
+  m_dtUnRealizedPLSummed = dtNow;
+  return ReSumUnRealizedPL();
+}
+
+bool Portfolio::ReSumUnRealizedPL( void ) {
+
+  bool bDirty( false );
+  if ( m_nStructureVersion.load( boost::memory_order_acquire ) != m_nFlatVersion ) {
+    Flatten();
+    bDirty = true;  // attached or detached, a full pass is due
+  }
+  // every flag is taken, so a change is not counted twice
+  for ( std::vector<Position*>::iterator iter = m_vFlatPosition.begin(); m_vFlatPosition.end() != iter; ++iter ) {
+    if ( (*iter)->TakeUnRealizedPLDirty() ) bDirty = true;
+  }
+  if ( !bDirty ) return false;
+
+  // sums are complete from the bottom up, as sub-portfolios follow their owner in pre-order
+  std::fill( m_vFlatUnRealized.begin(), m_vFlatUnRealized.end(), 0.0 );
+  for ( size_t ix = 0; ix < m_vFlatPosition.size(); ++ix ) {
+    m_vFlatUnRealized[ m_vFlatPositionOwner[ ix ] ] += m_vFlatPosition[ ix ]->GetUnRealizedPL();
+  }
+  for ( size_t ix = m_vFlatPortfolio.size() - 1; 0 < ix; --ix ) {
+    m_vFlatUnRealized[ m_vFlatPortfolioOwner[ ix ] ] += m_vFlatUnRealized[ ix ];
+  }
+
+  bool bUpdated( false );
+  for ( size_t ix = 0; ix < m_vFlatPortfolio.size(); ++ix ) {
+    Portfolio& portfolio( *m_vFlatPortfolio[ ix ] );
+    bool bChanged( false );
+    {
+      boost::mutex::scoped_lock lock( portfolio.m_mutexPL );
+      if ( portfolio.m_plCurrent.dblUnRealized != m_vFlatUnRealized[ ix ] ) {
+        portfolio.m_plCurrent.dblUnRealized = m_vFlatUnRealized[ ix ];
+        portfolio.m_plCurrent.Sum();
+        if ( portfolio.m_plCurrent > portfolio.m_plMax ) portfolio.m_plMax.dblUnRealized = portfolio.m_plCurrent.dblUnRealized;
+        if ( portfolio.m_plCurrent < portfolio.m_plMin ) portfolio.m_plMin.dblUnRealized = portfolio.m_plCurrent.dblUnRealized;
+        bChanged = true;
+      }
+    }
+    if ( bChanged ) {  // fired without the lock, a handler will likely query the totals
+      portfolio.OnUnRealizedPLUpdate( portfolio );
+      bUpdated = true;
+    }
+  }
+
+  return bUpdated;
 }
 /*
 void Portfolio::SetOwnerPortfolio( const idPortfolio_t& idOwner, pPortfolio_t& pPortfolio ) {
@@ -228,13 +351,17 @@ void Portfolio::SetOwnerPortfolio( const idPortfolio_t& idOwner, pPortfolio_t& p
 
 void Portfolio::HandleUnRealizedPL( const PositionDelta_delegate_t& position ) {
 
-  m_plCurrent.dblUnRealized += ( -position.get<1>() + position.get<2>() );
+  {
+    boost::mutex::scoped_lock lock( m_mutexPL );
+
+    m_plCurrent.dblUnRealized += ( -position.get<1>() + position.get<2>() );
 
 //  m_row.db.dblUnRealized = m_plCurrent.dblUnRealized;
 
-  m_plCurrent.Sum();
-  if ( m_plCurrent > m_plMax ) m_plMax.dblUnRealized = m_plCurrent.dblUnRealized;
-  if ( m_plCurrent < m_plMin ) m_plMin.dblUnRealized = m_plCurrent.dblUnRealized;
+    m_plCurrent.Sum();
+    if ( m_plCurrent > m_plMax ) m_plMax.dblUnRealized = m_plCurrent.dblUnRealized;
+    if ( m_plCurrent < m_plMin ) m_plMin.dblUnRealized = m_plCurrent.dblUnRealized;
+  }
 
   // need to propogate up portfolios yet
   OnUnRealizedPL( position );
@@ -246,11 +373,15 @@ void Portfolio::HandleExecution( const PositionDelta_delegate_t& position ) {
 
   m_row.dblRealizedPL += ( -position.get<1>() + position.get<2>() );
 
-  m_plCurrent.dblRealized = m_row.dblRealizedPL;
+  {
+    boost::mutex::scoped_lock lock( m_mutexPL );
 
-  m_plCurrent.Sum();
-  if ( m_plCurrent > m_plMax ) m_plMax.dblRealized = m_plCurrent.dblRealized;
-  if ( m_plCurrent < m_plMin ) m_plMin.dblRealized = m_plCurrent.dblRealized;
+    m_plCurrent.dblRealized = m_row.dblRealizedPL;
+
+    m_plCurrent.Sum();
+    if ( m_plCurrent > m_plMax ) m_plMax.dblRealized = m_plCurrent.dblRealized;
+    if ( m_plCurrent < m_plMin ) m_plMin.dblRealized = m_plCurrent.dblRealized;
+  }
 
   // need to propogate up portfolios yet
   OnExecution( position );
@@ -261,11 +392,15 @@ void Portfolio::HandleCommission( const PositionDelta_delegate_t& position ) {
 
   m_row.dblCommissionsPaid += ( -position.get<1>() + position.get<2>() );
 
-  m_plCurrent.dblCommissionsPaid = m_row.dblCommissionsPaid;
+  {
+    boost::mutex::scoped_lock lock( m_mutexPL );
 
-  m_plCurrent.Sum();
-  if ( m_plCurrent > m_plMax ) m_plMax.dblCommissionsPaid = m_plCurrent.dblCommissionsPaid;
-  if ( m_plCurrent < m_plMin ) m_plMin.dblCommissionsPaid = m_plCurrent.dblCommissionsPaid;
+    m_plCurrent.dblCommissionsPaid = m_row.dblCommissionsPaid;
+
+    m_plCurrent.Sum();
+    if ( m_plCurrent > m_plMax ) m_plMax.dblCommissionsPaid = m_plCurrent.dblCommissionsPaid;
+    if ( m_plCurrent < m_plMin ) m_plMin.dblCommissionsPaid = m_plCurrent.dblCommissionsPaid;
+  }
 
   // need to propogate up portfolios yet
   OnCommission( position );
@@ -281,6 +416,7 @@ std::ostream& operator<<( std::ostream& os, const Portfolio& portfolio ) {
       os << iter->second;
 //    iter->second->EmitStatus( ss );
   }
+  boost::mutex::scoped_lock lock( portfolio.m_mutexPL );
   os << "Portfolio URPL=" << portfolio.m_plCurrent.dblUnRealized
     << ", RPL=" << portfolio.m_plCurrent.dblRealized 
     << ", Comm=" << portfolio.m_plCurrent.dblCommissionsPaid
@@ -13,9 +13,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <map>
 
+#include <boost/atomic.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 
 #include <OUCommon/Delegate.h>
 
@@ -39,6 +43,13 @@ namespace tf { // TradeFrame
 //   sub portfolios for subsequent instrument collections under appropriate master portfolio
 // monitor delta at each portfolio/sub-portfolio level.  Each level may have different master hedging positions.
 
+// unrealized p/l, two modes, set on the top portfolio, and taken on by sub-portfolios as they are attached:
+//   UnRealizedPerQuote: each changed quote in a position is applied, and passed up, as it arrives, through the delegates
+//   UnRealizedCoalesced: positions only mark themselves dirty, ReSumUnRealizedPL, called on demand or from a timer,
+//     sums the whole tree over flat arrays built from it, and fires OnUnRealizedPLUpdate once for each portfolio which changed
+//     OnUnRealizedPL is not fired, min/max of unrealized are taken at each sum rather than at each quote
+//     realized p/l and commissions are as in the other mode, they change at the rate of executions
+
 class Portfolio {
 public:
 
@@ -59,6 +70,7 @@ public:
   typedef Currency::type currency_t;
 
   enum EPortfolioType { Master=1, CurrencySummary=2, Standard=10, MultiLeggedPosition, Basket };
+  enum EUnRealizedPLMode { UnRealizedPerQuote, UnRealizedCoalesced };
   // only one Master, can only have AlternateCurrency at next level below
   // AlternateCurrency only at level below Master, can have any combination of lower three Portfolio types
   // Standard can have variety of position types
@@ -147,15 +159,24 @@ public:
   // are std::map references only in order to perform in-memory recalcs
   void AddSubPortfolio( pPortfolio_t& pPortfolio );
   void RemoveSubPortfolio( const idPortfolio_t& idPortfolio );
+
+  void SetUnRealizedPLMode( EUnRealizedPLMode mode );  // this portfolio and its sub-portfolios
+  EUnRealizedPLMode GetUnRealizedPLMode( void ) const { return m_eUnRealizedPLMode; };
+  void SetUnRealizedPLCadence( const boost::posix_time::time_duration& td ) { m_tdUnRealizedPLCadence = td; };
+  // coalesced mode, call on the top portfolio, true when any total changed
+  bool ReSumUnRealizedPL( void );  // on demand
+  bool ReSumUnRealizedPL( const boost::posix_time::ptime& dtNow );  // once the cadence has passed since the prior sum
 //  void SetOwnerPortfolio( const idPortfolio_t& idPortfolio, pPortfolio_t& pPortfolio );
 
 //  void EmitStats( std::stringstream& ss );
   void QueryStats( double& dblUnRealized, double& dblRealized, double& dblCommissionsPaid, double& dblTotal ) const {
+    boost::mutex::scoped_lock lock( m_mutexPL );
     dblTotal  = ( dblUnRealized = m_plCurrent.dblUnRealized );
     dblTotal += ( dblRealized = m_plCurrent.dblRealized );
     dblTotal -= ( dblCommissionsPaid = m_plCurrent.dblCommissionsPaid );
   }
   void AddStats( double& dblUnRealized, double& dblRealized, double& dblCommissionsPaid ) const {
+    boost::mutex::scoped_lock lock( m_mutexPL );
     dblUnRealized += m_plCurrent.dblUnRealized;
     dblRealized += m_plCurrent.dblRealized;
     dblCommissionsPaid += m_plCurrent.dblCommissionsPaid;
@@ -202,12 +223,31 @@ private:
     bool operator<( const structPL& pl ) const { return  dblNet < pl.dblNet; };
   };
 
+  // ReSumUnRealizedPL may run on another thread (a gui timer) than executions and commissions (the provider)
+  mutable boost::mutex m_mutexPL;  // m_plCurrent, m_plMax, m_plMin
   structPL m_plCurrent;
   structPL m_plMax;
   structPL m_plMin;
 
   void ReCalc( void );  // not used at the moment, may require tuning
 
+  EUnRealizedPLMode m_eUnRealizedPLMode;
+  boost::posix_time::time_duration m_tdUnRealizedPLCadence;
+  boost::posix_time::ptime m_dtUnRealizedPLSummed;
+
+  // the tree flattened for ReSumUnRealizedPL, portfolios in pre-order, so an owner comes before its sub-portfolios
+  static boost::atomic<unsigned int> m_nStructureVersion;  // changed on any position or sub-portfolio attach or detach, in any portfolio
+  unsigned int m_nFlatVersion;
+  std::vector<Position*> m_vFlatPosition;
+  std::vector<size_t> m_vFlatPositionOwner;  // index into m_vFlatPortfolio
+  std::vector<Portfolio*> m_vFlatPortfolio;
+  std::vector<size_t> m_vFlatPortfolioOwner;
+  std::vector<double> m_vFlatUnRealized;
+
+  void ApplyUnRealizedPLMode( EUnRealizedPLMode mode );
+  void Flatten( void );
+  void Flatten( Portfolio* pPortfolio, size_t ixOwner );
+
   void HandleExecution( const PositionDelta_delegate_t& );
   void HandleCommission( const PositionDelta_delegate_t& );
   void HandleUnRealizedPL( const PositionDelta_delegate_t& );
@@ -13,6 +13,8 @@
 
 #include "stdafx.h"
 
+#include <OUCommon/LatencyTrace.h>
+
 #include "OrderManager.h"
 
 #include "Position.h"
@@ -27,7 +29,8 @@ Position::Position( pInstrument_cref pInstrument, pProvider_t pExecutionProvider
   m_pInstrument( pInstrument ), 
   m_dblMultiplier( 1 ), m_bConnectedToDataProvider( false ),
   m_bInstrumentAssigned ( true ), m_bExecutionAccountAssigned( true ), m_bDataAccountAssigned( true ),
-  m_row( idPortfolio, sName, pInstrument->GetInstrumentName(), idExecutionAccount, idDataAccount, sAlgorithm )
+  m_row( idPortfolio, sName, pInstrument->GetInstrumentName(), idExecutionAccount, idDataAccount, sAlgorithm ),
+  m_bUnRealizedPLDirty( false )
 {
   Construction();
 }
@@ -36,7 +39,8 @@ Position::Position( pInstrument_cref pInstrument, pProvider_t pExecutionProvider
 : m_pExecutionProvider( pExecutionProvider ), m_pDataProvider( pDataProvider ), 
   m_pInstrument( pInstrument ), 
   m_dblMultiplier( 1 ), m_bConnectedToDataProvider( false ),
-  m_bInstrumentAssigned ( true ), m_bExecutionAccountAssigned( true ), m_bDataAccountAssigned( true )
+  m_bInstrumentAssigned ( true ), m_bExecutionAccountAssigned( true ), m_bDataAccountAssigned( true ),
+  m_bUnRealizedPLDirty( false )
 {
   Construction();
 }
@@ -45,7 +49,8 @@ Position::Position( pInstrument_cref pInstrument, pProvider_t pExecutionProvider
 : m_pExecutionProvider( pExecutionProvider ), m_pDataProvider( pDataProvider ), 
   m_pInstrument( pInstrument ), 
   m_dblMultiplier( 1 ), m_bConnectedToDataProvider( false ),
-  m_bInstrumentAssigned ( true ), m_bExecutionAccountAssigned( true ), m_bDataAccountAssigned( true )
+  m_bInstrumentAssigned ( true ), m_bExecutionAccountAssigned( true ), m_bDataAccountAssigned( true ),
+  m_bUnRealizedPLDirty( false )
 {
   m_row.sNotes = sNotes;
   Construction();
@@ -57,7 +62,8 @@ Position::Position( pInstrument_cref pInstrument, pProvider_t pExecutionProvider
   m_pExecutionProvider( pExecutionProvider ), m_pDataProvider( pDataProvider ), 
   m_pInstrument( pInstrument ), 
   m_dblMultiplier( 1 ), m_bConnectedToDataProvider( false ),
-  m_bInstrumentAssigned ( true ), m_bExecutionAccountAssigned( true ), m_bDataAccountAssigned( true )
+  m_bInstrumentAssigned ( true ), m_bExecutionAccountAssigned( true ), m_bDataAccountAssigned( true ),
+  m_bUnRealizedPLDirty( false )
 {
   Construction();
 }
@@ -65,14 +71,16 @@ Position::Position( pInstrument_cref pInstrument, pProvider_t pExecutionProvider
 Position::Position( const TableRowDef& row ) 
 : m_row( row ),
   m_dblMultiplier( 1 ), m_bConnectedToDataProvider( false ),
-  m_bInstrumentAssigned ( false ), m_bExecutionAccountAssigned( false ), m_bDataAccountAssigned( false )
+  m_bInstrumentAssigned ( false ), m_bExecutionAccountAssigned( false ), m_bDataAccountAssigned( false ),
+  m_bUnRealizedPLDirty( false )
 {
   // need flags to wait for execution, data, instrument variables to be set
 }
 
 Position::Position( void ) 
 : m_dblMultiplier( 1 ), m_bConnectedToDataProvider( false ),
-  m_bInstrumentAssigned ( false ), m_bExecutionAccountAssigned( false ), m_bDataAccountAssigned( false )
+  m_bInstrumentAssigned ( false ), m_bExecutionAccountAssigned( false ), m_bDataAccountAssigned( false ),
+  m_bUnRealizedPLDirty( false )
 {
   // need flags to wait for execution, data, instrument variables to be set
 }
@@ -136,6 +144,8 @@ void Position::DisconnectFromDataProvider( int ) {
 
 void Position::HandleQuote( quote_t quote ) {
 
+  OU_LATENCY_STAGE( ou::LatencyTrace::EPosition );
+
   if ( ( 0 == quote.Ask() ) || ( 0 == quote.Bid() ) ) return;
 
   OnQuote( quote );
@@ -160,6 +170,7 @@ void Position::HandleQuote( quote_t quote ) {
   if ( bProcessed ) {
     OnQuotePostProcess( quote_pair_t( *this, quote ) );
     if ( dblPreviousUnRealizedPL != m_row.dblUnRealizedPL ) {
+      m_bUnRealizedPLDirty.store( true, boost::memory_order_release );
       OnUnRealizedPL( PositionDelta_delegate_t( *this, dblPreviousUnRealizedPL, m_row.dblUnRealizedPL ) );
     }
   }
@@ -167,6 +178,7 @@ void Position::HandleQuote( quote_t quote ) {
 }
 
 void Position::HandleTrade( trade_t trade ) {
+  OU_LATENCY_STAGE( ou::LatencyTrace::EPosition );
   OnTrade( trade );
 }
 
@@ -464,6 +476,9 @@ void Position::HandleExecution( const std::pair<const Order&, const Execution&>&
     throw std::runtime_error( "Position::HandleExecution doesn't have an Open Order" );
   }
 
+  if ( dblOldUnRealizedPL != m_row.dblUnRealizedPL ) {
+    m_bUnRealizedPLDirty.store( true, boost::memory_order_release );
+  }
   OnUnRealizedPL( PositionDelta_delegate_t( *this, dblOldUnRealizedPL, m_row.dblUnRealizedPL ) );  // used by portfolio updates
 
   OnExecutionRaw( execution_pair_t( *this, exec ) );
@@ -16,6 +16,7 @@
 #include <vector>
 #include <sstream>
 
+#include <boost/atomic.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/tuple/tuple.hpp>
 
@@ -178,6 +179,8 @@ public:
 
   pInstrument_cref GetInstrument( void ) const { assert( 0 != m_pInstrument ); return m_pInstrument; };
   double GetUnRealizedPL( void ) const { return m_row.dblUnRealizedPL; };
+  // set on each change to unrealized p/l, taken (and cleared) by a portfolio summing at its own cadence
+  bool TakeUnRealizedPLDirty( void ) { return m_bUnRealizedPLDirty.exchange( false, boost::memory_order_acquire ); };
   double GetRealizedPL( void ) const { return m_row.dblRealizedPL; };
   double GetCommissionPaid( void ) const { return m_row.dblCommissionPaid; };
 
@@ -283,6 +286,8 @@ private:
 
   double m_dblMultiplier;
 
+  boost::atomic<bool> m_bUnRealizedPLDirty;  // last, as the constructors initialize it last
+
   void Construction( void );
   void DisconnectFromDataProvider( int );
 
@@ -18,8 +18,10 @@
 #include <TFHDF5TimeSeries/HDF5WriteTimeSeries.h>
 #include <TFHDF5TimeSeries/HDF5IterateGroups.h>
 #include <TFHDF5TimeSeries/HDF5Attribute.h>
+#include <TFHDF5TimeSeries/HDF5TickCapture.h>
 
 #include <OUCommon/TimeSource.h>
+#include <OUCommon/LatencyTrace.h>
 
 #include <TFIQFeed/IQFeedProvider.h>
 
@@ -31,7 +33,9 @@ namespace tf { // TradeFrame
 Watch::Watch( pInstrument_t pInstrument, pProvider_t pDataProvider ) :
   m_pInstrument( pInstrument ), 
   m_pDataProvider( pDataProvider ), 
-  m_cntWatching( 0 ), m_bWatching( false ), m_bWatchingEnabled( false )
+  m_cntWatching( 0 ), m_bWatching( false ), m_bWatchingEnabled( false ),
+  m_pCapture( 0 ), m_nCaptureBatch( 0 ), m_nCaptureRetain( 0 ),
+  m_nCaptureQuotesDue( 0 ), m_nCaptureTradesDue( 0 ), m_nCaptureQuotesSkip( 0 ), m_nCaptureTradesSkip( 0 )
 {
   assert( 0 != pInstrument.get() );
   assert( 0 != pDataProvider.get() );
@@ -42,7 +46,9 @@ Watch::Watch( const Watch& rhs ) :
   m_pInstrument( rhs.m_pInstrument ),
   m_pDataProvider( rhs.m_pDataProvider ),
   m_quote( rhs.m_quote ), m_trade( rhs.m_trade ), 
-  m_cntWatching( 0 ), m_bWatching( false ), m_bWatchingEnabled( false )
+  m_cntWatching( 0 ), m_bWatching( false ), m_bWatchingEnabled( false ),
+  m_pCapture( 0 ), m_nCaptureBatch( 0 ), m_nCaptureRetain( 0 ),
+  m_nCaptureQuotesDue( 0 ), m_nCaptureTradesDue( 0 ), m_nCaptureQuotesSkip( 0 ), m_nCaptureTradesSkip( 0 )
 {
   assert( 0 == rhs.m_cntWatching );
   assert( !rhs.m_bWatching );
@@ -53,6 +59,7 @@ Watch::~Watch(void) {
   while ( 0 != m_cntWatching ) {
     StopWatch();
   }
+  DisableCapture();
 }
 
 Watch& Watch::operator=( const Watch& rhs ) {
@@ -72,8 +79,9 @@ void Watch::Initialize( void ) {
   assert( 0 != m_pDataProvider.get() );
   assert( m_pDataProvider->ProvidesQuotes() );
   assert( m_pDataProvider->ProvidesTrades() );
-  m_quotes.Reserve( 1024 );  // reduce startup allocations
-  m_trades.Reserve( 1024 );  // reduce startup allocations
+  // live series grow a block at a time, so an append on the feed thread never copies the day so far
+  if ( 0 == m_quotes.Size() ) m_quotes.SetSegmented();
+  if ( 0 == m_trades.Size() ) m_trades.SetSegmented();
   AddEvents();
 }
 
@@ -182,12 +190,23 @@ void Watch::EmitValues( void ) const {
 }
 
 void Watch::HandleQuote( const Quote& quote ) {
+  OU_LATENCY_STAGE( ou::LatencyTrace::EWatch );
   m_quote = quote;
   //OnPossibleResizeBegin( stateTimeSeries_t( m_quotes.Capacity(), m_quotes.Size() ) );
   {
     //boost::mutex::scoped_lock lock(m_mutexLockAppend);
+    if ( ( 0 != m_nCaptureRetain ) && ( m_nCaptureRetain <= m_quotes.Size() ) ) m_quotes.DropOldestBlock();
     m_quotes.Append( quote );
   }
+  if ( 0 != m_pCapture ) {
+    if ( 0 != m_nCaptureQuotesSkip ) {
+      --m_nCaptureQuotesSkip;  // already on disk
+    }
+    else {
+      m_pQuotesStaged->Append( quote );
+      if ( m_nCaptureQuotesDue <= m_pQuotesStaged->Size() ) CaptureQuotes();
+    }
+  }
   
   //OnPossibleResizeEnd( stateTimeSeries_t( m_quotes.Capacity(), m_quotes.Size() ) );
   //if ( 0 != m_OnQuote ) m_OnQuote( quote );
@@ -195,12 +214,23 @@ void Watch::HandleQuote( const Quote& quote ) {
 }
 
 void Watch::HandleTrade( const Trade& trade ) {
+  OU_LATENCY_STAGE( ou::LatencyTrace::EWatch );
   m_trade = trade;
   //OnPossibleResizeBegin( stateTimeSeries_t( m_trades.Capacity(), m_trades.Size() ) );
   {
     //boost::mutex::scoped_lock lock(m_mutexLockAppend);
+    if ( ( 0 != m_nCaptureRetain ) && ( m_nCaptureRetain <= m_trades.Size() ) ) m_trades.DropOldestBlock();
     m_trades.Append( trade );
   }
+  if ( 0 != m_pCapture ) {
+    if ( 0 != m_nCaptureTradesSkip ) {
+      --m_nCaptureTradesSkip;  // already on disk
+    }
+    else {
+      m_pTradesStaged->Append( trade );
+      if ( m_nCaptureTradesDue <= m_pTradesStaged->Size() ) CaptureTrades();
+    }
+  }
   //OnPossibleResizeEnd( stateTimeSeries_t( m_trades.Capacity(), m_trades.Size() ) );
   //if ( 0 != m_OnTrade ) m_OnTrade( trade );
   OnTrade( trade );
@@ -230,6 +260,7 @@ void Watch::SaveSeries( const std::string& sPrefix ) {
 
   std::string sPathName;
 
+  ou::tf::HDF5DataManager::mutex_t::scoped_lock lock( ou::tf::HDF5DataManager::Mutex() );  // shared with any capture
   ou::tf::HDF5DataManager dm( ou::tf::HDF5DataManager::RDWR );
 
   try {
@@ -263,6 +294,61 @@ void Watch::SaveSeries( const std::string& sPrefix ) {
 
 }
 
+void Watch::EnableCapture( HDF5TickCapture& capture, const std::string& sPrefix, size_t nBatch, size_t nRetain ) {
+  assert( 0 == m_cntWatching );
+  assert( 0 < nBatch );
+  DisableCapture();
+  m_sCaptureQuotes = sPrefix + "/quotes/" + m_pInstrument->GetInstrumentName();
+  m_sCaptureTrades = sPrefix + "/trades/" + m_pInstrument->GetInstrumentName();
+  // batches of whole chunks, so a flushed chunk is not rewritten
+  const size_t nChunk( capture.ChunkSize() );
+  nBatch = ( ( nBatch + nChunk - 1 ) / nChunk ) * nChunk;
+  // carry on after what a previous run captured, the first batch fills out any partial chunk it left
+  size_t nCaptured( 0 );
+  capture.LastCaptured<ou::tf::Quotes>( m_sCaptureQuotes, &nCaptured );
+  m_nCaptureQuotesSkip = nCaptured;
+  m_nCaptureQuotesDue = nBatch - ( nCaptured % nChunk );
+  capture.LastCaptured<ou::tf::Trades>( m_sCaptureTrades, &nCaptured );
+  m_nCaptureTradesSkip = nCaptured;
+  m_nCaptureTradesDue = nBatch - ( nCaptured % nChunk );
+  m_nCaptureBatch = nBatch;
+  m_nCaptureRetain = nRetain;
+  m_pQuotesStaged.reset( new ou::tf::Quotes( nBatch ) );
+  m_pTradesStaged.reset( new ou::tf::Trades( nBatch ) );
+  m_pCapture = &capture;
+}
+
+void Watch::DisableCapture( void ) {
+  if ( 0 != m_pCapture ) {
+    assert( 0 == m_cntWatching );
+    CaptureQuotes();  // the final batches, which may be partial chunks
+    CaptureTrades();
+    m_pCapture = 0;
+    m_nCaptureRetain = 0;
+    m_nCaptureQuotesSkip = m_nCaptureTradesSkip = 0;
+    m_pQuotesStaged.reset();
+    m_pTradesStaged.reset();
+  }
+}
+
+void Watch::CaptureQuotes( void ) {
+  if ( 0 != m_pQuotesStaged->Size() ) {
+    m_pCapture->Append( m_sCaptureQuotes, m_pQuotesStaged,
+      HDF5TickCapture::Attributes( ou::tf::Quote::Signature(), m_pInstrument->GetMultiplier(), m_pInstrument->GetSignificantDigits(), m_pDataProvider->ID() ) );
+    m_pQuotesStaged.reset( new ou::tf::Quotes( m_nCaptureBatch ) );  // the capture owns the batch now
+    m_nCaptureQuotesDue = m_nCaptureBatch;
+  }
+}
+
+void Watch::CaptureTrades( void ) {
+  if ( 0 != m_pTradesStaged->Size() ) {
+    m_pCapture->Append( m_sCaptureTrades, m_pTradesStaged,
+      HDF5TickCapture::Attributes( ou::tf::Trade::Signature(), m_pInstrument->GetMultiplier(), m_pInstrument->GetSignificantDigits(), m_pDataProvider->ID() ) );
+    m_pTradesStaged.reset( new ou::tf::Trades( m_nCaptureBatch ) );
+    m_nCaptureTradesDue = m_nCaptureBatch;
+  }
+}
+
 
 } // namespace tf
 } // namespace ou
@@ -35,6 +35,8 @@
 namespace ou { // One Unified
 namespace tf { // TradeFrame
 
+class HDF5TickCapture;
+
 class Watch {
 public:
 
@@ -99,6 +101,17 @@ public:
 
   virtual void SaveSeries( const std::string& sPrefix );
 
+  // write-behind capture, in place of SaveSeries at end of day, set up before StartWatch:
+  //   ticks are staged, and handed to the capture's writer thread every nBatch ticks,
+  //   nBatch is rounded up to whole chunks of the capture, the first batch is short when it tops up
+  //     a partial chunk left by an earlier run, and DisableCapture hands over the remainder as the final batch,
+  //   following a restart, the feed delivers the day's ticks again:  as many as the file already holds are
+  //     counted off, rather than compared by time, so ticks sharing a timestamp are not lost,
+  //   nRetain, when not 0, bounds the in-memory series to a rolling window:  once holding nRetain ticks,
+  //     the oldest block of the series is dropped, the latest ticks remain
+  void EnableCapture( HDF5TickCapture& capture, const std::string& sPrefix, size_t nBatch = 4096, size_t nRetain = 0 );
+  void DisableCapture( void );  // hands over what is staged, after StopWatch
+
 protected:
 
   // use an iterator instead?  or keep as is as it facilitates multi-thread append and access operations
@@ -126,8 +139,23 @@ private:
 
   Fundamentals_t m_fundamentals;
   Summary_t m_summary;
+
+  HDF5TickCapture* m_pCapture;
+  size_t m_nCaptureBatch;
+  size_t m_nCaptureRetain;
+  size_t m_nCaptureQuotesDue;  // staged size at which the batch is handed over
+  size_t m_nCaptureTradesDue;
+  std::string m_sCaptureQuotes;  // dataset paths
+  std::string m_sCaptureTrades;
+  size_t m_nCaptureQuotesSkip;  // on disk from an earlier run, still to be counted off
+  size_t m_nCaptureTradesSkip;
+  boost::shared_ptr<Quotes> m_pQuotesStaged;
+  boost::shared_ptr<Trades> m_pTradesStaged;
   
   void Initialize( void );
+
+  void CaptureQuotes( void );  // hand over what is staged
+  void CaptureTrades( void );
   
   void AddEvents( void );
   void RemoveEvents( void );
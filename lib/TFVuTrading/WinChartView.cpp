@@ -221,6 +221,7 @@ void WinChartView::DrawChart( void ) {
 // could change this into a worker future/promise solution, or use asio to submit jobs or packages
 void WinChartView::ThreadDrawChart1( void ) {
   m_bThreadDrawChartActive = true;
+  m_chartMaster.SetRedrawOnChangeOnly( true );  // timer driven, HandlePaint re-uses the last bitmap
   boost::unique_lock<boost::mutex> lock(m_mutexThreadDrawChart);
   while ( m_bThreadDrawChartActive ) {
     m_cvThreadDrawChart.wait( lock );